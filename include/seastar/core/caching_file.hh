@@ -0,0 +1,150 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include <seastar/core/memory.hh>
+#include <seastar/core/metrics_registration.hh>
+#include <seastar/core/shared_future.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <boost/intrusive/list.hpp>
+#include <cstdint>
+#include <memory>
+#include <unordered_map>
+
+namespace seastar {
+
+namespace testing {
+class block_cache_test;
+}
+
+/// \addtogroup fileio-module
+/// @{
+
+class caching_file_impl;
+
+/// \brief Shard-local cache of file blocks
+///
+/// Files opened with O_DIRECT bypass the kernel page cache, so every read of
+/// a hot block (index pages, for example) goes to the device. A block_cache
+/// keeps aligned blocks read through files wrapped with make_caching_file()
+/// in seastar memory. When full it evicts blocks in CLOCK order, and it also
+/// gives memory back through a \ref memory::reclaimer when the shard runs low.
+/// Concurrent misses for the same block are served by a single read.
+///
+/// Writes through a caching file go to the underlying file and invalidate
+/// the blocks they touch. Writes made bypassing the caching file are not
+/// seen by it.
+///
+/// The cache may only be used on the shard that created it, and must
+/// outlive all the files wrapped with it.
+class block_cache {
+public:
+    struct config {
+        size_t capacity = 64 << 20;    ///< Memory the cached blocks may take, in bytes
+        size_t block_size = 4096;      ///< Caching granularity; a power of two, multiple of the files' disk read alignment
+        sstring name = "default";      ///< Value of the \c cache label on the metrics
+    };
+
+    struct stats {
+        uint64_t hits = 0;             ///< Blocks found in the cache
+        uint64_t misses = 0;           ///< Blocks read from the underlying file
+        uint64_t shared_misses = 0;    ///< Misses that waited for a read issued by another miss
+        uint64_t evictions = 0;        ///< Blocks evicted to make room for new ones
+        uint64_t reclaimed = 0;        ///< Blocks evicted to relieve memory pressure
+        uint64_t invalidations = 0;    ///< Blocks dropped because they were written to
+    };
+
+private:
+    struct block_key {
+        uint64_t file_id;
+        uint64_t index;
+        bool operator==(const block_key&) const = default;
+    };
+    struct block_key_hash {
+        size_t operator()(const block_key& k) const noexcept {
+            return std::hash<uint64_t>()(k.file_id * 0x9e3779b97f4a7c15ull ^ k.index);
+        }
+    };
+    using link_type = boost::intrusive::list_member_hook<boost::intrusive::link_mode<boost::intrusive::auto_unlink>>;
+    struct block {
+        block_key key;
+        temporary_buffer<char> data;
+        // Owns data's memory. Readers are handed shares of data, so this is
+        // referenced by more than data while they hold on to it.
+        deleter::impl* owner = nullptr;
+        bool referenced = false;
+        link_type clock_link;
+        link_type file_link;
+    };
+    using clock_list = boost::intrusive::list<block,
+            boost::intrusive::member_hook<block, link_type, &block::clock_link>,
+            boost::intrusive::constant_time_size<false>>;
+    using file_block_list = boost::intrusive::list<block,
+            boost::intrusive::member_hook<block, link_type, &block::file_link>,
+            boost::intrusive::constant_time_size<false>>;
+
+    const config _cfg;
+    std::unordered_map<block_key, std::unique_ptr<block>, block_key_hash> _blocks;
+    // Reads in progress, so that concurrent misses don't read the same block again
+    std::unordered_map<block_key, shared_promise<>, block_key_hash> _pending;
+    clock_list _clock;
+    clock_list::iterator _hand = _clock.end();
+    size_t _memory_used = 0;
+    uint64_t _next_file_id = 0;
+    stats _stats;
+    memory::reclaimer _reclaimer;
+    metrics::metric_groups _metrics;
+
+    friend class caching_file_impl;
+    friend testing::block_cache_test;
+
+    static size_t block_memory(const block& b) noexcept;
+    static bool in_use(const block& b) noexcept;
+    future<temporary_buffer<char>> get_block(caching_file_impl& f, uint64_t index);
+    temporary_buffer<char> insert(caching_file_impl& f, uint64_t index, temporary_buffer<char> data);
+    void erase(block& b) noexcept;
+    void evict_one() noexcept;
+    memory::reclaiming_result reclaim(size_t bytes) noexcept;
+
+public:
+    explicit block_cache(config cfg);
+    ~block_cache();
+    block_cache(const block_cache&) = delete;
+
+    size_t block_size() const noexcept { return _cfg.block_size; }
+    size_t capacity() const noexcept { return _cfg.capacity; }
+    size_t memory_used() const noexcept { return _memory_used; }
+    size_t blocks() const noexcept { return _blocks.size(); }
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+/// \brief Wraps a file so that its reads are cached in \c cache
+///
+/// \param f the file to cache, usually opened with open_file_dma()
+/// \param cache shard-local cache to use; must outlive the returned file
+file make_caching_file(file f, block_cache& cache);
+
+/// @}
+
+}
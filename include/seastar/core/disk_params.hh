@@ -55,6 +55,9 @@ class disk_config_params {
     std::chrono::duration<double> _latency_goal;
     std::chrono::milliseconds _stall_threshold;
     double _flow_ratio_backpressure_threshold;
+    bool _auto_calibrate = false;
+    double _auto_calibrate_min_ratio;
+    std::chrono::microseconds _merge_max_latency;
 
 public:
     explicit disk_config_params(unsigned max_queues) noexcept
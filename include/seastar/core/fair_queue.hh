@@ -112,21 +112,29 @@ class fair_queue_entry {
     // a 'normalized' form -- converted from floating-point to fixed-point number
     // and scaled accrding to fair-group's token-bucket duration
     using capacity_t = uint64_t;
+    using deadline_type = std::chrono::steady_clock::time_point;
     friend class fair_queue;
 
 private:
     capacity_t _capacity;
+    deadline_type _deadline = deadline_type::max();
     bi::slist_member_hook<> _hook;
 
 public:
     explicit fair_queue_entry(capacity_t c) noexcept
         : _capacity(c) {}
+    fair_queue_entry(capacity_t c, deadline_type deadline) noexcept
+        : _capacity(c), _deadline(deadline) {}
     using container_list_t = bi::slist<fair_queue_entry,
             bi::constant_time_size<false>,
             bi::cache_last<true>,
             bi::member_hook<fair_queue_entry, bi::slist_member_hook<>, &fair_queue_entry::_hook>>;
 
     capacity_t capacity() const noexcept { return _capacity; }
+    /// The time by which the entry should have been dispatched, or
+    /// \c deadline_type::max() if it has none
+    deadline_type deadline() const noexcept { return _deadline; }
+    bool has_deadline() const noexcept { return _deadline != deadline_type::max(); }
 };
 
 /// \brief Fair queuing class
@@ -148,6 +156,15 @@ class fair_queue_entry {
 /// When the classes that lag behind start seeing requests, the fair queue will serve
 /// them first, until balance is restored. This balancing is expected to happen within
 /// a certain time window that obeys an exponential decay.
+///
+/// Entries may carry a deadline. Within a class, entries with deadlines are served
+/// first, earliest deadline first, and the rest in FIFO order. The entry with
+/// the earliest deadline of all classes, if it is less than
+/// \ref config::deadline_urgency away, is served ahead of the other classes
+/// too, as long as this doesn't put its class (and the groups it belongs to)
+/// more than \ref config::deadline_slack ahead of the class that would have
+/// been served otherwise. The class is charged for it once it gets its regular
+/// turn. Entries popped after their deadline passed are not charged for.
 class fair_queue {
 public:
     /// \brief Fair Queue configuration structure.
@@ -157,6 +174,11 @@ class fair_queue {
     struct config {
         sstring label = "";
         uint64_t forgiving_factor = 0;
+        /// How close to its deadline an entry must be to be served out of turn
+        std::chrono::steady_clock::duration deadline_urgency = std::chrono::steady_clock::duration(0);
+        /// How much capacity a class can get ahead of its fair share by
+        /// serving entries out of turn; zero disables it
+        uint64_t deadline_slack = 0;
     };
 
     using class_id = unsigned int;
@@ -172,6 +194,9 @@ class fair_queue {
     protected:
         uint32_t _shares = 0;
         capacity_t _accumulated = 0;
+        // Cost of the entries served out of turn, added to _accumulated
+        // when the entry is out of its parent's queue
+        capacity_t _borrowed = 0;
         bool _queued = false;
         uint32_t _activations = 0;
         priority_class_group_data* _parent = nullptr;
@@ -251,6 +276,16 @@ class fair_queue {
 
     // Total capacity of all requests waiting in the queue.
     capacity_t _queued_capacity = 0;
+    // Classes with queued deadline entries, as a binary min-heap on the
+    // earliest deadline of each
+    std::vector<priority_class_data*> _deadline_heap;
+    // The class whose entry top() returned out of turn, to be popped by pop_front()
+    priority_class_data* _urgent = nullptr;
+
+    priority_class_data* find_urgent_class() noexcept;
+    bool deadline_heap_less(size_t a, size_t b) const noexcept;
+    void deadline_heap_swap(size_t a, size_t b) noexcept;
+    void update_deadline_heap(priority_class_data& pc) noexcept;
 
     void plug_priority_class(priority_class_data& pc) noexcept;
     void unplug_priority_class(priority_class_data& pc) noexcept;
@@ -303,7 +338,9 @@ class fair_queue {
 
     void notify_request_cancelled(fair_queue_entry& ent) noexcept;
 
+    /// \return the entry to be dispatched next, or \c nullptr if there is none
     fair_queue_entry* top();
+    /// Removes the entry returned by the preceding call to \ref top()
     void pop_front();
 
     capacity_t queued_capacity() const noexcept { return _queued_capacity; }
@@ -311,6 +348,8 @@ class fair_queue {
     capacity_t accumulated(class_id cid) const noexcept;
     capacity_t pure_accumulated(class_id cid) const noexcept;
     unsigned activations(class_id cid) const noexcept;
+    /// \return the number of entries of the class served out of turn for their deadline
+    uint64_t deadline_dispatches(class_id cid) const noexcept;
 };
 /// @}
 
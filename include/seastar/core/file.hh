@@ -45,6 +45,8 @@
 #include <cstdint>
 #include <functional>
 #include <optional>
+#include <span>
+#include <vector>
 
 namespace seastar {
 
@@ -360,6 +362,22 @@ class file {
         return _file_impl->_write_max_length;
     }
 
+    /// Allocates a buffer suitable for DMA reads and writes on this file.
+    ///
+    /// When the reactor runs on an io_uring backend with a registered buffer
+    /// pool (see the \c --io-uring-registered-buffers option), the buffer is
+    /// taken from that pool and I/O into it is submitted as fixed-buffer I/O,
+    /// which avoids pinning the pages on every request. Otherwise, or when the
+    /// pool is exhausted, a regular buffer aligned to \ref memory_dma_alignment()
+    /// is returned.
+    ///
+    /// \param size size of the buffer, in bytes
+    template <typename CharType>
+    temporary_buffer<CharType> allocate_registered_buffer(size_t size) {
+        auto t = allocate_registered_buffer_impl(size);
+        return temporary_buffer<CharType>(reinterpret_cast<CharType*>(t.get_write()), t.size(), t.release());
+    }
+
     /**
      * Perform a single DMA read operation.
      *
@@ -655,6 +673,49 @@ class file {
         });
     }
 
+    /// A byte range of the file, see \ref dma_read_ranges()
+    struct read_range {
+        uint64_t offset;
+        size_t size;
+    };
+
+    /// Default for the \c max_gap parameter of \ref dma_read_ranges()
+    static constexpr size_t default_read_ranges_max_gap = 16 << 10;
+
+    /**
+     * Read several disjoint ranges of the file at once.
+     *
+     * Ranges closer to each other than \c max_gap bytes (after alignment)
+     * are coalesced into a single read of at most \ref disk_read_max_length()
+     * bytes, and all the reads are issued before waiting for any of them,
+     * so they are queued together in the \ref io_queue. This is cheaper
+     * than a \ref dma_read_bulk() per range for lookups touching a handful
+     * of blocks scattered over a file.
+     *
+     * @param ranges ranges to read; they don't need to be aligned, sorted
+     *        or disjoint
+     * @param max_gap largest number of unrequested bytes read to save a
+     *        separate request
+     * @param intent the IO intention confirmation (\ref seastar::io_intent)
+     *
+     * @return a buffer per range, in the order of \c ranges, or an
+     *         exceptional future if any of the reads failed. A buffer is
+     *         shorter than its range if EOF is reached. Buffers of coalesced
+     *         ranges share memory, which is freed when all of them are.
+     */
+    template <typename CharType>
+    future<std::vector<temporary_buffer<CharType>>>
+    dma_read_ranges(std::span<const read_range> ranges, size_t max_gap = default_read_ranges_max_gap, io_intent* intent = nullptr) noexcept {
+        return dma_read_ranges_impl(ranges, max_gap, intent).then([] (std::vector<temporary_buffer<uint8_t>> bufs) {
+            std::vector<temporary_buffer<CharType>> ret;
+            ret.reserve(bufs.size());
+            for (auto& t : bufs) {
+                ret.emplace_back(reinterpret_cast<CharType*>(t.get_write()), t.size(), t.release());
+            }
+            return ret;
+        });
+    }
+
     /// \brief Creates a handle that can be transported across shards.
     ///
     /// Creates a handle that can be transported across shards, and then
@@ -668,6 +729,9 @@ class file {
     future<temporary_buffer<uint8_t>>
     dma_read_bulk_impl(uint64_t offset, size_t range_size, io_intent* intent) noexcept;
 
+    future<std::vector<temporary_buffer<uint8_t>>>
+    dma_read_ranges_impl(std::span<const read_range> ranges, size_t max_gap, io_intent* intent) noexcept;
+
     future<size_t>
     dma_write_impl(uint64_t pos, const uint8_t* buffer, size_t len, io_intent* intent) noexcept;
 
@@ -686,6 +750,8 @@ class file {
     future<temporary_buffer<uint8_t>>
     dma_read_exactly_impl(uint64_t pos, size_t len, io_intent* intent) noexcept;
 
+    temporary_buffer<uint8_t> allocate_registered_buffer_impl(size_t size);
+
     future<uint64_t> get_lifetime_hint_impl(int op) noexcept;
     future<> set_lifetime_hint_impl(int op, uint64_t hint) noexcept;
 
@@ -60,8 +60,21 @@ struct file_input_stream_options {
     size_t buffer_size = 8192;    ///< I/O buffer size
     unsigned read_ahead = 0;      ///< Maximum number of extra read-ahead operations
     lw_shared_ptr<file_input_stream_history> dynamic_adjustments = { }; ///< Input stream history, if null dynamic adjustments are disabled
+    /// Keep just enough reads outstanding to hide the device latency at the
+    /// rate the stream is consumed. \ref read_ahead, if set, caps the number
+    /// of read-aheads, and all adaptive streams of a shard share the memory
+    /// budget set with \ref set_file_input_stream_read_ahead_budget().
+    bool adaptive_read_ahead = false;
 };
 
+/// \brief Sets the per-shard memory budget for adaptive read-ahead
+///
+/// Streams opened with \ref file_input_stream_options::adaptive_read_ahead
+/// don't issue read-aheads that would make the buffers they have in flight
+/// on this shard exceed \c bytes. The read that the consumer is waiting
+/// for is never held back. By default the budget is 1/32 of the shard's memory.
+void set_file_input_stream_read_ahead_budget(size_t bytes) noexcept;
+
 /// \brief Creates an input_stream to read a portion of a file.
 ///
 /// \param file File to read; multiple streams for the same file may coexist
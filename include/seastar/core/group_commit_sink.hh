@@ -0,0 +1,135 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/file.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/core/timer.hh>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <exception>
+#include <optional>
+
+namespace seastar {
+
+/// \addtogroup fileio-module
+/// @{
+
+/// Configuration of a \ref group_commit_sink
+struct group_commit_sink_options {
+    /// Records are batched until this many bytes are pending; a batch
+    /// is never larger, unless a single record is
+    size_t max_batch_size = 1 << 20;
+    /// Longest time a record waits for others to join its batch. With
+    /// the default of zero, a batch is written as soon as the previous
+    /// one is durable, and holds whatever arrived in the meantime.
+    std::chrono::microseconds max_delay = std::chrono::microseconds(0);
+};
+
+/// \brief Appends records to a file durably, syncing them in batches
+///
+/// Many fibers appending small records to a log and waiting for each to
+/// become durable would otherwise issue a write and an fdatasync apiece.
+/// A group_commit_sink collects the records appended while the previous
+/// batch is being committed (or for up to
+/// \ref group_commit_sink_options::max_delay), writes them with one
+/// aligned DMA write, syncs the file once and then resolves all their
+/// futures together. At most one batch is in flight at a time, and
+/// records become durable in the order they were appended.
+///
+/// The last, partially filled block of the file is rewritten by the next
+/// batch, so the file should not be written through other handles while
+/// the sink is open. The file is padded with zeroes up to the write
+/// alignment until \ref close() truncates it to the appended length.
+///
+/// If a write or sync fails, the records of the batch and all the later
+/// ones fail with that error; the sink is then unusable.
+class group_commit_sink {
+public:
+    struct stats {
+        uint64_t records = 0;          ///< Records made durable
+        uint64_t bytes = 0;            ///< Bytes of records made durable
+        uint64_t batches = 0;          ///< Batches committed, each with a single sync
+        uint64_t bytes_written = 0;    ///< Bytes written, including rewritten tail blocks and padding
+    };
+
+private:
+    using clock_type = std::chrono::steady_clock;
+    struct pending_record {
+        temporary_buffer<char> data;
+        promise<> pr;
+        clock_type::time_point arrival;
+    };
+
+    file _file;
+    const group_commit_sink_options _opts;
+    const uint64_t _alignment;
+    // End of the durable records
+    uint64_t _pos;
+    // End of the appended records, durable or not
+    uint64_t _end;
+    // Contents of the partially written block at _pos, which is rewritten
+    // by the next batch; read from the file before the first one
+    temporary_buffer<char> _tail;
+    bool _tail_loaded;
+    std::deque<pending_record> _pending;
+    size_t _pending_bytes = 0;
+    bool _committing = false;
+    bool _closing = false;
+    std::exception_ptr _failed;
+    std::optional<promise<>> _drained;
+    timer<clock_type> _timer;
+    stats _stats;
+
+    void maybe_commit() noexcept;
+    // Commits the first \c count records of _pending, \c bytes long
+    future<> commit(size_t count, size_t bytes) noexcept;
+    future<> write_and_sync(size_t count, size_t bytes);
+
+public:
+    /// Creates a sink appending to \c f at position \c pos, normally the
+    /// file's size. The sink takes ownership of the file and closes it in
+    /// \ref close().
+    group_commit_sink(file f, uint64_t pos, group_commit_sink_options opts = {});
+    group_commit_sink(const group_commit_sink&) = delete;
+    ~group_commit_sink();
+
+    /// Appends a record.
+    ///
+    /// \return a future that resolves once the record, and all the records
+    ///         appended before it, are durable
+    future<> append(temporary_buffer<char> record) noexcept;
+
+    /// Commits the pending records, truncates the file to the appended
+    /// length and closes it. No records may be appended after this is called.
+    future<> close() noexcept;
+
+    /// Position in the file where the next record will be written
+    uint64_t position() const noexcept { return _end; }
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+/// @}
+
+}
@@ -28,6 +28,7 @@
 #include <vector>
 #include <sys/types.h>
 #include <sys/socket.h>
+#include <sys/stat.h>
 
 namespace seastar {
 extern logger io_log;
@@ -36,7 +37,7 @@ namespace internal {
 
 class io_request {
 public:
-    enum class operation : char { read, readv, write, writev, fdatasync, recv, recvmsg, send, sendmsg, accept, connect, poll_add, poll_remove, cancel };
+    enum class operation : char { read, readv, write, writev, fdatasync, fallocate, openat, statx, renameat, unlinkat, recv, recvmsg, send, sendmsg, accept, connect, poll_add, poll_remove, cancel };
 private:
     // the upper layers give us void pointers, but storing void pointers here is just
     // dangerous. The constructors seem to be happy to convert other pointers to void*,
@@ -80,6 +81,43 @@ class io_request {
         operation op;
         int fd;
     };
+    struct fallocate_op {
+        operation op;
+        int fd;
+        int mode;
+        uint64_t pos;
+        uint64_t len;
+    };
+    // The paths of the operations below must stay valid until they complete
+    struct openat_op {
+        operation op;
+        int dirfd;
+        const char* path;
+        int flags;
+        mode_t mode;
+    };
+    struct statx_op {
+        operation op;
+        int dirfd;
+        const char* path;
+        int flags;
+        unsigned mask;
+        struct ::statx* statxbuf;
+    };
+    struct renameat_op {
+        operation op;
+        int olddirfd;
+        const char* oldpath;
+        int newdirfd;
+        const char* newpath;
+        unsigned flags;
+    };
+    struct unlinkat_op {
+        operation op;
+        int dirfd;
+        const char* path;
+        int flags;
+    };
     struct accept_op {
         operation op;
         int fd;
@@ -119,6 +157,11 @@ class io_request {
         write_op _write;
         writev_op _writev;
         fdatasync_op _fdatasync;
+        fallocate_op _fallocate;
+        openat_op _openat;
+        statx_op _statx;
+        renameat_op _renameat;
+        unlinkat_op _unlinkat;
         accept_op _accept;
         connect_op _connect;
         poll_add_op _poll_add;
@@ -234,6 +277,67 @@ class io_request {
         return req;
     }
 
+    static io_request make_fallocate(int fd, int mode, uint64_t pos, uint64_t len) {
+        io_request req;
+        req._fallocate = {
+          .op = operation::fallocate,
+          .fd = fd,
+          .mode = mode,
+          .pos = pos,
+          .len = len,
+        };
+        return req;
+    }
+
+    static io_request make_openat(int dirfd, const char* path, int flags, mode_t mode) {
+        io_request req;
+        req._openat = {
+          .op = operation::openat,
+          .dirfd = dirfd,
+          .path = path,
+          .flags = flags,
+          .mode = mode,
+        };
+        return req;
+    }
+
+    static io_request make_statx(int dirfd, const char* path, int flags, unsigned mask, struct ::statx* statxbuf) {
+        io_request req;
+        req._statx = {
+          .op = operation::statx,
+          .dirfd = dirfd,
+          .path = path,
+          .flags = flags,
+          .mask = mask,
+          .statxbuf = statxbuf,
+        };
+        return req;
+    }
+
+    static io_request make_renameat(int olddirfd, const char* oldpath, int newdirfd, const char* newpath, unsigned flags) {
+        io_request req;
+        req._renameat = {
+          .op = operation::renameat,
+          .olddirfd = olddirfd,
+          .oldpath = oldpath,
+          .newdirfd = newdirfd,
+          .newpath = newpath,
+          .flags = flags,
+        };
+        return req;
+    }
+
+    static io_request make_unlinkat(int dirfd, const char* path, int flags) {
+        io_request req;
+        req._unlinkat = {
+          .op = operation::unlinkat,
+          .dirfd = dirfd,
+          .path = path,
+          .flags = flags,
+        };
+        return req;
+    }
+
     static io_request make_accept(int fd, struct sockaddr* addr, socklen_t* addrlen, int flags) {
         io_request req;
         req._accept = {
@@ -349,6 +453,21 @@ class io_request {
         if constexpr (Op == operation::fdatasync) {
             return _fdatasync;
         }
+        if constexpr (Op == operation::fallocate) {
+            return _fallocate;
+        }
+        if constexpr (Op == operation::openat) {
+            return _openat;
+        }
+        if constexpr (Op == operation::statx) {
+            return _statx;
+        }
+        if constexpr (Op == operation::renameat) {
+            return _renameat;
+        }
+        if constexpr (Op == operation::unlinkat) {
+            return _unlinkat;
+        }
         if constexpr (Op == operation::accept) {
             return _accept;
         }
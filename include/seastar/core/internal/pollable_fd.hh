@@ -21,6 +21,7 @@
 
 #pragma once
 
+#include <seastar/core/deleter.hh>
 #include <seastar/core/future.hh>
 #include <seastar/core/posix.hh>
 #include <seastar/util/bool_class.hh>
@@ -104,6 +105,11 @@ class pollable_fd_state {
     future<size_t> send_some(std::span<iovec> iovs);
     future<size_t> write_some(std::span<iovec> iovs);
     future<> send_all(std::span<iovec> iovs);
+    // Like send_all(), with \c d keeping the memory referenced by \c iovs
+    // alive. Sends larger than the configured zero-copy threshold may be
+    // done without copying, in which case \c d is only destroyed after the
+    // kernel is done with the memory, possibly after the returned future resolves.
+    future<> send_all(std::span<iovec> iovs, deleter d);
     future<> write_all(std::span<iovec> iovs);
 #else
     future<size_t> write_some(net::packet& p);
@@ -119,6 +125,10 @@ class pollable_fd_state {
     future<temporary_buffer<char>> recv_some(internal::buffer_allocator* ba);
     future<size_t> sendmsg(struct msghdr *msg);
     future<size_t> recvmsg(struct msghdr *msg);
+    // Send and receive up to n messages in one system call; resolve to how
+    // many were (at least one)
+    future<size_t> sendmmsg(struct mmsghdr* msgs, size_t n);
+    future<size_t> recvmmsg(struct mmsghdr* msgs, size_t n);
     future<size_t> sendto(socket_address addr, const void* buf, size_t len);
     future<> poll_rdhup();
     void shutdown(int how);
@@ -131,6 +141,9 @@ class pollable_fd_state {
     void maybe_no_more_recv();
     void maybe_no_more_send();
     void forget(); // called on end-of-life
+#if SEASTAR_API_LEVEL >= 9
+    future<> send_all_zerocopy(std::span<iovec> iovs, deleter d);
+#endif
 
     friend void intrusive_ptr_add_ref(pollable_fd_state* fd) {
         ++fd->_refs;
@@ -170,6 +183,9 @@ class pollable_fd {
     future<> send_all(std::span<iovec> iov) {
         return _s->send_all(iov);
     }
+    future<> send_all(std::span<iovec> iov, deleter d) {
+        return _s->send_all(iov, std::move(d));
+    }
     future<> write_all(std::span<iovec> iov) {
         return _s->write_all(iov);
     }
@@ -211,6 +227,12 @@ class pollable_fd {
     future<size_t> recvmsg(struct msghdr *msg) {
         return _s->recvmsg(msg);
     }
+    future<size_t> sendmmsg(struct mmsghdr* msgs, size_t n) {
+        return _s->sendmmsg(msgs, n);
+    }
+    future<size_t> recvmmsg(struct mmsghdr* msgs, size_t n) {
+        return _s->recvmmsg(msgs, n);
+    }
     future<size_t> sendto(socket_address addr, const void* buf, size_t len) {
         return _s->sendto(addr, buf, len);
     }
@@ -0,0 +1,129 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/cacheline.hh>
+#include <seastar/core/future.hh>
+#include <seastar/core/scheduling.hh>
+#include <seastar/core/shard_id.hh>
+#include <seastar/util/spinlock.hh>
+#include <boost/intrusive/list.hpp>
+#include <atomic>
+#include <exception>
+#include <mutex>
+#include <optional>
+
+namespace seastar::internal {
+
+// A function submitted with smp::submit_stealable(). It is allocated and
+// completed on the submitting (origin) shard, but may be computed on any
+// shard that steals it.
+class stealable_work_item : public boost::intrusive::list_base_hook<> {
+    scheduling_group _sg;
+    shard_id _origin;
+public:
+    stealable_work_item(scheduling_group sg, shard_id origin) noexcept : _sg(sg), _origin(origin) {}
+    virtual ~stealable_work_item() = default;
+    scheduling_group group() const noexcept { return _sg; }
+    shard_id origin() const noexcept { return _origin; }
+    // Runs the function; may be called on any shard.
+    virtual void compute() noexcept = 0;
+    // Resolves the future and destroys the item; called on the origin shard.
+    virtual void complete() noexcept = 0;
+};
+
+template <typename Func>
+class stealable_async_work_item final : public stealable_work_item {
+    using futurator = futurize<std::invoke_result_t<Func>>;
+    using future_type = typename futurator::type;
+    using value_type = typename future_type::value_type;
+    Func _func;
+    std::optional<value_type> _result;
+    // If !_result. May be created on the shard that stole the item; it is
+    // moved back to the origin with the item, and the allocator returns
+    // its memory to the owning shard when freed, as for smp::submit_to().
+    std::exception_ptr _ex;
+    typename futurator::promise_type _promise;
+public:
+    template <typename F>
+    stealable_async_work_item(scheduling_group sg, shard_id origin, F&& func)
+        : stealable_work_item(sg, origin), _func(std::forward<F>(func)) {}
+    virtual void compute() noexcept override {
+        auto f = futurator::invoke(_func);
+        if (f.failed()) {
+            _ex = f.get_exception();
+        } else {
+            _result = f.get();
+        }
+    }
+    virtual void complete() noexcept override {
+        if (_result) {
+            _promise.set_value(std::move(*_result));
+        } else {
+            _promise.set_exception(std::move(_ex));
+        }
+        delete this;
+    }
+    future_type get_future() noexcept { return _promise.get_future(); }
+};
+
+// Per-shard queue of stealable work. The owning shard consumes it from the
+// front, idle shards steal from the back. Items are linked intrusively so
+// neither side allocates under the lock. Aligned so that the queues of
+// neighbouring shards don't share a cache line.
+class alignas(cache_line_size) stealable_queue {
+    util::spinlock _lock;
+    boost::intrusive::list<stealable_work_item, boost::intrusive::constant_time_size<false>> _items;
+    // Lets thieves skip empty queues without touching the lock's cache line
+    std::atomic<size_t> _size = 0;
+public:
+    void push(stealable_work_item& item) noexcept {
+        std::lock_guard g(_lock);
+        _items.push_back(item);
+        _size.fetch_add(1, std::memory_order_relaxed);
+    }
+    stealable_work_item* pop_front() noexcept {
+        std::lock_guard g(_lock);
+        if (_items.empty()) {
+            return nullptr;
+        }
+        auto& item = _items.front();
+        _items.pop_front();
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return &item;
+    }
+    stealable_work_item* steal() noexcept {
+        std::lock_guard g(_lock);
+        if (_items.empty()) {
+            return nullptr;
+        }
+        auto& item = _items.back();
+        _items.pop_back();
+        _size.fetch_sub(1, std::memory_order_relaxed);
+        return &item;
+    }
+    size_t size() const noexcept {
+        return _size.load(std::memory_order_relaxed);
+    }
+};
+
+} // namespace seastar::internal
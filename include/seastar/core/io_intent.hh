@@ -24,6 +24,7 @@
 #include <seastar/core/internal/io_intent.hh>
 #include <seastar/core/io_priority_class.hh>
 #include <boost/container/small_vector.hpp>
+#include <chrono>
 
 namespace seastar {
 
@@ -37,7 +38,16 @@ namespace seastar {
 ///
 /// If no intent is provided, then the request is processed till its
 /// completion be it success or error
+///
+/// An intent may also carry a deadline. The requests attached to it are
+/// then prioritized by the \ref io_queue as the deadline nears, and the
+/// ones still queued when it passes fail with \ref timed_out_error
+/// without being submitted to the disk.
 class io_intent {
+public:
+    using clock_type = std::chrono::steady_clock;
+
+private:
     struct intents_for_queue {
         unsigned qid;
         io_priority_class_id cid;
@@ -68,16 +78,19 @@ class io_intent {
 
     boost::container::small_vector<intents_for_queue, 1> _intents;
     references _refs;
+    clock_type::time_point _deadline = clock_type::time_point::max();
     friend internal::intent_reference::intent_reference(io_intent*) noexcept;
 
 public:
     io_intent() = default;
+    /// Creates an intent whose requests should be dispatched by \c deadline
+    explicit io_intent(clock_type::time_point deadline) noexcept : _deadline(deadline) {}
     ~io_intent() = default;
 
     io_intent(const io_intent&) = delete;
     io_intent& operator=(const io_intent&) = delete;
     io_intent& operator=(io_intent&&) = delete;
-    io_intent(io_intent&& o) noexcept : _intents(std::move(o._intents)), _refs(std::move(o._refs)) {
+    io_intent(io_intent&& o) noexcept : _intents(std::move(o._intents)), _refs(std::move(o._refs)), _deadline(o._deadline) {
         for (auto&& r : _refs.list) {
             r._intent = this;
         }
@@ -91,6 +104,13 @@ class io_intent {
         _intents.clear();
     }
 
+    /// \return the deadline of the requests, \c time_point::max() if they have none
+    clock_type::time_point deadline() const noexcept { return _deadline; }
+
+    /// Sets the deadline of the requests attached to this intent from
+    /// now on; the ones already queued keep the deadline they had.
+    void set_deadline(clock_type::time_point deadline) noexcept { _deadline = deadline; }
+
     /// @private
     internal::cancellable_queue& find_or_create_cancellable_queue(unsigned qid, io_priority_class_id cid) {
         for (auto&& i : _intents) {
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <boost/container/static_vector.hpp>
+#include <atomic>
 #include <chrono>
 #include <memory>
 #include <vector>
@@ -55,6 +56,7 @@ class io_sink;
 using shard_id = unsigned;
 using stream_id = unsigned;
 
+class io_completion;
 class io_desc_read_write;
 class queued_io_request;
 class io_group;
@@ -103,6 +105,9 @@ class io_queue {
             capacity_t cap = 0;
         };
         pending _pending;
+        // Completions observed since the last io_throttler::account_latency()
+        std::chrono::duration<double> _latency_sum{0};
+        uint64_t _completions = 0;
         stream(io_throttler& t, fair_queue::config cfg)
             : fq(std::move(cfg))
             , replenish(clock_type::now())
@@ -129,6 +134,7 @@ class io_queue {
     };
     boost::container::static_vector<stream, 2> _streams;
     internal::io_sink& _sink;
+    const std::chrono::duration<double> _merge_max_latency;
 
     friend struct ::io_queue_for_tests;
     friend const io_throttler& internal::get_throttler(const io_queue& ioq, unsigned stream);
@@ -159,6 +165,8 @@ class io_queue {
 
     void update_flow_ratio() noexcept;
     void lower_stall_threshold() noexcept;
+    void calibrate_disk_rate() noexcept;
+    void dispatch_merging(stream& st, queued_io_request& head, stream::reap_result& available) noexcept;
 
     metrics::metric_groups _metric_groups;
 public:
@@ -192,6 +200,18 @@ class io_queue {
         std::chrono::milliseconds stall_threshold = std::chrono::milliseconds(100);
         std::chrono::microseconds tau = std::chrono::milliseconds(5);
         std::optional<uint32_t> physical_block_size; // Override for disks that lie about their physical block size
+        // Online disk model calibration, see io_throttler::calibrate()
+        bool auto_calibrate = false;
+        double auto_calibrate_min_ratio = 0.05;
+        // Adjacent requests are merged as long as this doesn't delay the
+        // first one by more than that. Zero disables merging.
+        std::chrono::microseconds merge_max_latency = std::chrono::microseconds(0);
+        // Requests whose deadline (see io_intent) is closer than deadline_urgency
+        // are dispatched ahead of other classes, as long as their class doesn't
+        // get more than deadline_slack worth of disk time ahead of its share.
+        // Zero slack disables this.
+        std::chrono::microseconds deadline_urgency = std::chrono::milliseconds(2);
+        std::chrono::microseconds deadline_slack = std::chrono::milliseconds(1);
     };
 
     io_queue(io_group_ptr group, internal::io_sink& sink);
@@ -203,8 +223,10 @@ class io_queue {
     future<size_t> submit_io_write(size_t len, internal::io_request req, io_intent* intent, iovec_keeper iovs = {}) noexcept;
 
     void submit_request(io_desc_read_write* desc, internal::io_request req) noexcept;
+    void submit_merged_request(io_completion* desc, size_t nr_requests, internal::io_request req) noexcept;
     void cancel_request(queued_io_request& req) noexcept;
     void complete_cancelled_request(queued_io_request& req) noexcept;
+    void expire_request(queued_io_request& req) noexcept;
     void complete_request(io_desc_read_write& desc, std::chrono::duration<double> delay) noexcept;
 
     // Dispatch requests that are pending in the I/O queue
@@ -337,6 +359,21 @@ class io_throttler {
     token_bucket_t _token_bucket;
     const capacity_t _per_tick_threshold;
 
+    /*
+     * Online calibration. The configured rates are what iotune measured,
+     * but the sustainable rate of e.g. a cloud volume drifts. Shards report
+     * completion latencies, and the group owner scales the replenish rate
+     * down multiplicatively when they exceed the latency goal and grows it
+     * back additively otherwise. The configured rate remains the cap.
+     */
+    const capacity_t _nominal_rate;
+    std::atomic<uint64_t> _latency_sum_ns = 0;
+    std::atomic<uint64_t> _completions = 0;
+    double _rate_ratio = 1.0;
+    std::chrono::duration<double> _observed_latency{0};
+    uint64_t _rate_decreases = 0;
+    uint64_t _rate_increases = 0;
+
 public:
 
     // Convert internal capacity value back into the real token
@@ -380,8 +417,18 @@ class io_throttler {
 
     capacity_t capacity_deficiency(capacity_t from) const noexcept;
 
+    // Called by any shard to report completions it observed
+    void account_latency(std::chrono::duration<double> sum, uint64_t completions) noexcept;
+    // Called periodically by the shard that owns the group
+    void calibrate(std::chrono::duration<double> goal, double min_ratio) noexcept;
+    double rate_ratio() const noexcept { return _rate_ratio; }
+    std::chrono::duration<double> observed_latency() const noexcept { return _observed_latency; }
+    uint64_t rate_decreases() const noexcept { return _rate_decreases; }
+    uint64_t rate_increases() const noexcept { return _rate_increases; }
+
+    // Uses the nominal rate, so that calibration doesn't move the latency goal
     std::chrono::duration<double> rate_limit_duration() const noexcept {
-        std::chrono::duration<double, rate_resolution> dur((double)_token_bucket.limit() / _token_bucket.rate());
+        std::chrono::duration<double, rate_resolution> dur((double)_token_bucket.limit() / _nominal_rate);
         return std::chrono::duration_cast<std::chrono::duration<double>>(dur);
     }
 
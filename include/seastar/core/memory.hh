@@ -166,7 +166,8 @@ void global_setup(unsigned nr_shards);
 
 internal::numa_layout configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        std::optional<std::string> hugetlbfs_path = {});
+        std::optional<std::string> hugetlbfs_path = {},
+        bool hugepage_spans = false);
 
 void configure_minimal();
 
@@ -249,6 +250,23 @@ extern std::pmr::polymorphic_allocator<char>* malloc_allocator;
 // Returns @true if any work was actually performed.
 bool drain_cross_cpu_freelist();
 
+// Whether large allocations queue huge pages for collapse (hugepage span
+// mode, on a kernel with MADV_COLLAPSE).
+bool hugepage_collapses_enabled();
+
+// Takes a huge page queued for collapse, or returns nullptr. MADV_COLLAPSE
+// can take milliseconds, so the reactor hands it to collapse_hugepage()
+// outside the reactor thread and reports back with hugepage_collapse_done().
+void* pop_pending_hugepage_collapse();
+
+// Collapses the huge page at hp; may be called from any thread.
+//
+// Returns 0, or the errno madvise() failed with.
+int collapse_hugepage(void* hp) noexcept;
+
+// Accounts for the collapse of a huge page taken from this shard.
+void hugepage_collapse_done(int error);
+
 
 // We don't want the memory code calling back into the rest of
 // the system, so allow the rest of the system to tell the memory
@@ -306,16 +324,20 @@ class statistics {
     uint64_t _foreign_mallocs;
     uint64_t _foreign_frees;
     uint64_t _foreign_cross_frees;
+    uint64_t _hugepage_collapses;
+    uint64_t _hugepage_collapse_failures;
 private:
     statistics(uint64_t mallocs, uint64_t frees, uint64_t cross_cpu_frees,
             uint64_t total_memory, uint64_t free_memory, uint64_t total_bytes_allocated, uint64_t reclaims,
             uint64_t large_allocs, uint64_t failed_allocs,
-            uint64_t foreign_mallocs, uint64_t foreign_frees, uint64_t foreign_cross_frees)
+            uint64_t foreign_mallocs, uint64_t foreign_frees, uint64_t foreign_cross_frees,
+            uint64_t hugepage_collapses, uint64_t hugepage_collapse_failures)
         : _mallocs(mallocs), _frees(frees), _cross_cpu_frees(cross_cpu_frees)
         , _total_memory(total_memory), _free_memory(free_memory), _total_bytes_allocated(total_bytes_allocated), _reclaims(reclaims)
         , _large_allocs(large_allocs), _failed_allocs(failed_allocs)
         , _foreign_mallocs(foreign_mallocs), _foreign_frees(foreign_frees)
-        , _foreign_cross_frees(foreign_cross_frees) {}
+        , _foreign_cross_frees(foreign_cross_frees)
+        , _hugepage_collapses(hugepage_collapses), _hugepage_collapse_failures(hugepage_collapse_failures) {}
 public:
     /// Total number of memory allocations calls since the system was started.
     uint64_t mallocs() const { return _mallocs; }
@@ -347,6 +369,12 @@ class statistics {
     uint64_t foreign_frees() const { return _foreign_frees; }
     /// Number of foreign frees on reactor threads
     uint64_t foreign_cross_frees() const { return _foreign_cross_frees; }
+    /// Number of huge pages of shard memory collapsed into transparent huge
+    /// pages (see \ref smp_options::hugepage_spans)
+    uint64_t hugepage_collapses() const { return _hugepage_collapses; }
+    /// Number of huge pages that could not be collapsed, usually because
+    /// the kernel had no free huge page at the time
+    uint64_t hugepage_collapse_failures() const { return _hugepage_collapse_failures; }
     friend statistics stats();
 };
 
@@ -359,6 +387,60 @@ struct memory_layout {
 // Supported only when seastar allocator is enabled.
 memory::memory_layout get_memory_layout();
 
+/// Occupancy of one small object size class on this shard.
+struct small_pool_stats {
+    /// Size of the objects served by this size class, in bytes.
+    size_t object_size;
+    /// Preferred size of the spans the size class carves objects from, in bytes.
+    size_t span_size;
+    /// Number of live objects.
+    uint64_t objects_in_use;
+    /// Memory held by the size class, in bytes.
+    uint64_t memory;
+    /// Part of \ref memory held by free objects, in bytes. Memory the size
+    /// class holds on to but does not use, i.e. its fragmentation.
+    uint64_t unused;
+};
+
+/// Free spans of one size (order) in the page allocator on this shard.
+struct free_span_stats {
+    /// The spans are 2^order pages long.
+    unsigned order;
+    /// Size of one span, in bytes.
+    size_t span_size;
+    /// Number of free spans of this size.
+    uint64_t free_spans;
+};
+
+/// Per size class breakdown of the allocator state, see \ref detailed_stats().
+struct detailed_statistics {
+    std::vector<small_pool_stats> small_pools;
+    /// Free-list histogram of the page allocator, indexed by order. Free
+    /// memory spread over many low orders (and absent from high orders)
+    /// means large allocations may fail even though \ref free_memory()
+    /// is high.
+    std::vector<free_span_stats> free_spans;
+};
+
+/// Capture a snapshot of the per size class allocator state of this lcore.
+///
+/// The counters are maintained as the allocator runs, so this only costs
+/// one entry per size class. Returns empty vectors with the default
+/// allocator.
+detailed_statistics detailed_stats();
+
+/// Number of small object size classes reported by \ref small_pool_stats_at().
+unsigned small_pool_count();
+
+/// Occupancy of the idx-th small object size class, ordered by object size.
+small_pool_stats small_pool_stats_at(unsigned idx);
+
+/// Number of span orders reported by \ref free_span_stats_at().
+unsigned free_span_orders();
+
+/// Free spans of the given order.
+free_span_stats free_span_stats_at(unsigned order);
+
 /// Returns the size of free memory in bytes.
 size_t free_memory();
 
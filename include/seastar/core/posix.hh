@@ -260,6 +260,22 @@ class file_desc {
         throw_system_error_on(r == -1, "send");
         return { size_t(r) };
     }
+    std::optional<size_t> recvmmsg(mmsghdr* msgs, unsigned n, int flags) {
+        auto r = ::recvmmsg(_fd, msgs, n, flags, nullptr);
+        if (r == -1 && errno == EAGAIN) {
+            return {};
+        }
+        throw_system_error_on(r == -1, "recvmmsg");
+        return { size_t(r) };
+    }
+    std::optional<size_t> sendmmsg(mmsghdr* msgs, unsigned n, int flags) {
+        auto r = ::sendmmsg(_fd, msgs, n, flags);
+        if (r == -1 && errno == EAGAIN) {
+            return {};
+        }
+        throw_system_error_on(r == -1, "sendmmsg");
+        return { size_t(r) };
+    }
     std::optional<size_t> sendto(socket_address& addr, const void* buf, size_t len, int flags) {
         auto r = ::sendto(_fd, buf, len, flags, &addr.u.sa, addr.length());
         if (r == -1 && errno == EAGAIN) {
@@ -162,6 +162,7 @@ class reactor {
     class batch_flush_pollfn;
     class smp_pollfn;
     class drain_cross_cpu_freelist_pollfn;
+    class collapse_hugepages_pollfn;
     class lowres_timer_pollfn;
     class manual_timer_pollfn;
     class epoll_pollfn;
@@ -205,7 +206,21 @@ class reactor {
         uint64_t fstream_read_bytes_blocked = 0;
         uint64_t fstream_read_aheads_discarded = 0;
         uint64_t fstream_read_ahead_discarded_bytes = 0;
+        uint64_t fstream_read_ahead_memory = 0;
+        uint64_t fstream_read_aheads_denied = 0;
         uint64_t fsyncs = 0;
+        uint64_t zerocopy_send_bytes = 0;
+        uint64_t zerocopy_send_copied_bytes = 0;
+        uint64_t uring_multishot_accepts = 0;
+        uint64_t uring_multishot_recvs = 0;
+        uint64_t uring_buf_ring_exhausted = 0;
+        uint64_t uring_buf_ring_fallback_recvs = 0;
+        uint64_t uring_multishot_recv_pauses = 0;
+        // File operations the io_uring backend can submit without the
+        // syscall thread, counted by whether they did (see --native-file-ops)
+        enum class file_op { fdatasync, fallocate, open, stat, rename, remove, count };
+        uint64_t native_file_ops[size_t(file_op::count)] = {};
+        uint64_t pool_file_ops[size_t(file_op::count)] = {};
 
     private:
         friend class file_data_source_impl;
@@ -269,6 +284,14 @@ class reactor {
     timer<manual_clock>::set_t::timer_list_t _expired_manual_timers;
     io_stats _io_stats;
     uint64_t _cxx_exceptions = 0;
+    uint64_t _stealable_tasks = 0;
+    uint64_t _stolen_tasks = 0;
+    // Decisions taken by the idle poll policy, see adaptive_idle_action()
+    struct idle_poll_stats {
+        uint64_t spins = 0;
+        uint64_t pauses = 0;
+        uint64_t sleeps = 0;
+    } _idle_poll_stats;
     uint64_t _abandoned_failed_futures = 0;
 
     struct task_queue_group;
@@ -358,6 +381,10 @@ class reactor {
     std::optional<pollable_fd> _aio_eventfd;
     static constexpr unsigned loads_size = 5;
     timer<lowres_clock> _load_timer;
+    // Collapses of the huge pages queued by large allocations, see
+    // collapse_pending_hugepages()
+    future<> _hugepage_collapses = make_ready_future<>();
+    timer<lowres_clock> _hugepage_collapse_timer;
     circular_buffer<double> _loads;
     double _load = 0;
     // Next two fields are required to enforce the monotonicity of total_steal_time()
@@ -371,6 +398,12 @@ class reactor {
     mutable sched_clock::duration _last_mono_steal{0};
     sched_clock::duration _total_idle{0};
     sched_clock::duration _total_sleep{0};
+    // Start of the current idle period. Unlike the idle_start local in
+    // do_run() it is not reset by the load timer.
+    sched_clock::time_point _idle_period_start;
+    // Moving average of the idle period length and the resulting poll window
+    sched_clock::duration _idle_period_estimate{0};
+    sched_clock::duration _idle_poll_window{0};
     sched_clock::time_point _start_time = now();
     output_stream<char>::batch_flush_list_t _flush_batching;
     std::atomic<bool> _sleeping alignas(seastar::cache_line_size){0};
@@ -382,6 +415,9 @@ class reactor {
 
 private:
     static std::chrono::nanoseconds calculate_poll_time();
+    enum class idle_action { spin, pause, sleep };
+    idle_action adaptive_idle_action(sched_clock::duration idle_for) const noexcept;
+    void update_idle_estimate(sched_clock::duration idle_period) noexcept;
     static void block_notifier(int);
     bool flush_pending_aio();
     steady_clock_type::time_point next_pending_aio() const noexcept;
@@ -391,6 +427,7 @@ class reactor {
     bool do_expire_lowres_timers() noexcept;
     bool do_check_lowres_timers() const noexcept;
     void expire_manual_timers() noexcept;
+    void collapse_pending_hugepages();
     void start_aio_eventfd_loop();
     void stop_aio_eventfd_loop();
 
@@ -435,6 +472,16 @@ class reactor {
 
     signals _signals;
     std::unique_ptr<thread_pool> _thread_pool;
+
+    // Whether a file operation is to be submitted through the I/O sink
+    // rather than the syscall thread pool; accounts for it either way.
+    bool have_native_file_ops() const noexcept;
+    bool use_native_file_op(io_stats::file_op op) noexcept;
+    // Submits a file operation request through the I/O sink. Resolves to
+    // the operation's result, or to a negated errno if it failed.
+    future<ssize_t> submit_native_file_op(internal::io_request req) noexcept;
+    // statx() through the I/O sink, filling \c st on success
+    future<ssize_t> native_stat(int dirfd, const char* path, int flags, struct stat& st) noexcept;
     friend class internal::cpu_stall_detector;
 
     friend void handle_signal(int signo, noncopyable_function<void ()>&& handler, bool once);
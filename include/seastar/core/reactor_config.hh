@@ -36,18 +36,28 @@ namespace seastar {
 struct reactor_config {
     sched_clock::duration task_quota;
     std::chrono::nanoseconds max_poll_time;
+    bool adaptive_idle_poll = false;
     bool handle_sigint = true;
     bool auto_handle_sigint_sigterm = true;
     unsigned max_networking_aio_io_control_blocks = 10000;
     bool force_io_getevents_syscall = false;
     bool kernel_page_cache = false;
     bool have_aio_fsync = false;
+    bool native_file_ops = true;
+    unsigned syscall_threads = 1;
     unsigned max_task_backlog = 1000;
     bool strict_o_direct = true;
     bool bypass_fsync = false;
     bool no_poll_aio = false;
     std::optional<bool> aio_nowait_works = false;
     bool abort_on_too_long_task_queue = false;
+    bool work_stealing = false;
+    size_t uring_registered_buffers_size = 0;
+    size_t zerocopy_send_threshold = 0;
+    bool uring_multishot = false;
+    unsigned uring_buf_ring_entries = 256;
+    size_t uring_buf_ring_buffer_size = 16384;
+    unsigned uring_multishot_recv_queue = 16;
 #ifdef SEASTAR_HAVE_URING
     std::variant<std::monostate, int, ::io_uring> asymmetric_uring;
 #endif
@@ -79,6 +89,18 @@ struct reactor_options : public program_options::option_group {
     ///
     /// Reduce for overprovisioned environments or laptops.
     program_options::value<unsigned> idle_poll_time_us;
+    /// \brief Adapt idle polling to how often work arrives.
+    ///
+    /// Each shard tracks how long its idle periods last (until network,
+    /// I/O, timer or cross-shard work arrives). While work is expected
+    /// within \ref idle_poll_time_us it polls, spinning tightly for the first
+    /// few microseconds and backing off with \p pause afterwards, for up to
+    /// twice the expected idle period. When work arrives further apart it
+    /// goes to sleep right away instead of burning the CPU. Has no effect
+    /// with \ref poll_mode.
+    ///
+    /// Default: false.
+    program_options::value<bool> adaptive_idle_poll;
     /// \brief Busy-poll for disk I/O.
     ///
     /// Reduces latency and increases throughput.
@@ -104,12 +126,42 @@ struct reactor_options : public program_options::option_group {
     ///
     /// Default: infinite (detection is OFF)
     program_options::value<unsigned> io_completion_notify_ms;
+    /// \brief Continuously calibrate the disk model against observed latency
+    ///
+    /// The io-properties rates are used as the starting point and the upper
+    /// bound. When completions take longer than the IO latency goal the
+    /// dispatch rate is lowered, and it is raised back once they're fast again.
+    ///
+    /// Default: false
+    program_options::value<bool> io_auto_calibrate;
+    /// \brief Lowest fraction of the io-properties rate calibration may go down to
+    ///
+    /// Default: 0.05
+    program_options::value<double> io_auto_calibrate_min_ratio;
+    /// \brief Merge adjacent reads or writes in the IO queue
+    ///
+    /// Contiguous requests to the same file from the same class that are
+    /// ready to be dispatched together are submitted as one, as long as the
+    /// disk model predicts the first one won't complete more than this many
+    /// microseconds later than it would alone.
+    ///
+    /// Default: 0 (merging is disabled)
+    program_options::value<unsigned> io_merge_max_latency_us;
     /// \brief Maximum number of task backlog to allow.
     ///
     /// When the number of tasks grow above this, we stop polling (e.g. I/O)
     /// until it goes back below the limit.
     /// Default: 1000.
     program_options::value<unsigned> max_task_backlog;
+    /// \brief Let idle shards run work queued on other shards.
+    ///
+    /// A shard that runs out of tasks takes work submitted with
+    /// \ref smp::submit_stealable() from the queues of busier shards,
+    /// preferring shards on its own NUMA node, before it considers
+    /// going to sleep. Other work never migrates.
+    ///
+    /// Default: false.
+    program_options::value<bool> enable_work_stealing;
     /// \brief Threshold in milliseconds over which the reactor is considered
     /// blocked if no progress is made.
     ///
@@ -179,10 +231,85 @@ struct reactor_options : public program_options::option_group {
     ///
     /// \note This option is only valid when the \p reactor_backend is set to \p asymmetric_io_uring.
     program_options::value<resource::cpuset> async_workers_cpuset;
+    /// \brief Size of the per-shard buffer pool registered with io_uring as fixed buffers (ex: 16M).
+    ///
+    /// DMA reads and writes whose buffer comes from this pool (see
+    /// \ref file::allocate_registered_buffer()) are issued as READ_FIXED/WRITE_FIXED,
+    /// sparing the kernel from pinning the user pages on every request.
+    /// \ref file::dma_read_bulk() also reads into the pool, but leaves a
+    /// quarter of it to explicit callers and uses regular memory beyond that.
+    /// The memory is taken from the shard's memory.
+    ///
+    /// \note This option is only used by the \p io_uring and \p asymmetric_io_uring
+    /// reactor backends (see \ref reactor_backend).
+    /// Default: 0 (disabled).
+    program_options::value<std::string> io_uring_registered_buffers;
+    /// \brief Minimum size of a socket write sent without copying (ex: 64k).
+    ///
+    /// Larger writes are sent directly from the application's buffers, which
+    /// are kept alive until the kernel reports it no longer references them.
+    /// This saves the copy into the kernel for large payloads, but costs an
+    /// extra completion per send, so small writes should keep copying.
+    ///
+    /// \note Only the \p io_uring and \p asymmetric_io_uring reactor backends
+    /// implement zero-copy send (Linux 6.2 or later), the others always copy.
+    /// Default: 0 (disabled).
+    program_options::value<std::string> zerocopy_send_threshold;
+    /// \brief Use multishot accept and multishot recv for sockets.
+    ///
+    /// A single submission keeps producing accepted connections or received
+    /// data until it is cancelled, and received data lands in buffers picked
+    /// by the kernel from a per-shard provided buffer ring, which are handed
+    /// to the application without a copy. Requires Linux 6.0 or later,
+    /// silently disabled otherwise.
+    ///
+    /// \note This option is only used by the \p io_uring reactor backend.
+    /// Default: false.
+    program_options::value<bool> io_uring_multishot;
+    /// \brief Number of buffers in the per-shard provided buffer ring.
+    ///
+    /// Must be a power of two. When all buffers are held by the application
+    /// multishot receives fall back to regular receives until buffers are
+    /// released.
+    ///
+    /// \note Only used when \ref io_uring_multishot is enabled.
+    /// Default: 256.
+    program_options::value<unsigned> io_uring_buf_ring_entries;
+    /// \brief Size of each buffer in the per-shard provided buffer ring.
+    ///
+    /// \note Only used when \ref io_uring_multishot is enabled.
+    /// Default: 16384.
+    program_options::value<unsigned> io_uring_buf_ring_buffer_size;
+    /// \brief Number of received buffers a connection may have waiting to be read.
+    ///
+    /// Once reached, the connection's multishot receive is cancelled, so that
+    /// it doesn't take all buffers of the ring, and re-armed when they are read.
+    ///
+    /// \note Only used when \ref io_uring_multishot is enabled.
+    /// Default: 16.
+    program_options::value<unsigned> io_uring_multishot_recv_queue;
     /// \brief Use Linux aio for fsync() calls.
     ///
     /// This reduces latency. Requires Linux 4.18 or later.
     program_options::value<bool> aio_fsync;
+    /// \brief Submit file metadata operations through io_uring.
+    ///
+    /// With the \p io_uring reactor backend, opening, stat-ing, renaming and
+    /// removing files and fallocate() are submitted as io_uring requests
+    /// instead of running in the syscall thread. Requires Linux 5.11 or later;
+    /// ignored by the other backends.
+    ///
+    /// Default: true.
+    program_options::value<bool> native_file_ops;
+    /// \brief Number of syscall threads per shard.
+    ///
+    /// Blocking system calls without a non-blocking alternative (directory
+    /// listing, statfs, the file operations io_uring can't submit, ...) are
+    /// run by the shard's syscall threads; with more than one, independent
+    /// calls proceed in parallel.
+    ///
+    /// Default: 1.
+    program_options::value<unsigned> syscall_threads;
     /// \brief Maximum number of I/O control blocks (IOCBs) to allocate per shard.
     ///
     /// This translates to the number of sockets supported per shard. Requires
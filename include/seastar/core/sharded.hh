@@ -738,10 +738,18 @@ template <typename Service>
 future<>
 sharded<Service>::invoke_on_all(smp_submit_to_options options, std::function<future<> (Service&)> func) noexcept {
   try {
-    return sharded_parallel_for_each([this, options, func = std::move(func)] (unsigned c) {
-        return smp::submit_to(c, options, [this, func] {
-            return func(*get_local_service());
+    if (_instances.size() < this_smp_shard_count()) {
+        // Started with start_single(), there are no instances to reach on
+        // the other shards
+        return sharded_parallel_for_each([this, options, func = std::move(func)] (unsigned c) {
+            return smp::submit_to(c, options, [this, func] {
+                return func(*get_local_service());
+            });
         });
+    }
+    // goes through smp::invoke_on_all() for NUMA-aware fan-out
+    return smp::invoke_on_all(options, [this, func = std::move(func)] {
+        return func(*get_local_service());
     });
   } catch (...) {
     return current_exception_as_future();
@@ -22,6 +22,7 @@
 #pragma once
 
 #include <seastar/core/future.hh>
+#include <seastar/core/do_with.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/semaphore.hh>
 #include <seastar/core/metrics_registration.hh>
@@ -29,8 +30,10 @@
 #include <seastar/core/reactor_config.hh>
 #include <seastar/core/resource.hh>
 #include <seastar/core/shard_id.hh>
+#include <seastar/core/internal/stealable_queue.hh>
 
 #include <boost/lockfree/spsc_queue.hpp>
+#include <algorithm>
 #include <deque>
 #include <optional>
 #include <thread>
@@ -173,12 +176,31 @@ struct smp_submit_to_options {
 void init_default_smp_service_group(shard_id cpu);
 
 smp_service_group_semaphore& get_smp_service_groups_semaphore(unsigned ssg_id, shard_id t) noexcept;
+// The units each of a service group's semaphores starts with
+size_t get_smp_service_groups_semaphore_capacity(unsigned ssg_id) noexcept;
 
 class smp_message_queue {
     static constexpr size_t queue_length = 128;
-    static constexpr size_t batch_size = 16;
+    static constexpr size_t min_batch_size = 1;
+    static constexpr size_t max_batch_size = queue_length / 2;
     static constexpr size_t prefetch_cnt = 2;
     struct work_item;
+    // Batch limits are the number of items to accumulate before publishing
+    // them to the other shard outside of the poller. Each publication is a
+    // write to the shared producer index that the consumer has to pull into
+    // its cache, so under load we want few, large publications; when idle, we
+    // want every item to go out immediately. The limit doubles whenever a
+    // batch fills up between two polls, and halves whenever the poller finds
+    // less than half a batch to flush, so it follows the number of items
+    // produced per poll period.
+    static void grow_batch_limit(size_t& limit) noexcept {
+        limit = std::min(limit * 2, max_batch_size);
+    }
+    static void shrink_batch_limit(size_t& limit, size_t flushed) noexcept {
+        if (flushed < limit / 2) {
+            limit = std::max(limit / 2, min_batch_size);
+        }
+    }
     struct lf_queue_remote {
         reactor* remote;
     };
@@ -198,6 +220,7 @@ class smp_message_queue {
         size_t _last_snt_batch = 0;
         size_t _last_cmpl_batch = 0;
         size_t _current_queue_length = 0;
+        size_t _request_batch_limit = min_batch_size;
     };
     // keep this between two structures with statistics
     // this makes sure that they have at least one cache line
@@ -207,6 +230,7 @@ class smp_message_queue {
     struct alignas(seastar::cache_line_size) {
         size_t _received = 0;
         size_t _last_rcv_batch = 0;
+        size_t _response_batch_limit = min_batch_size;
     };
     struct work_item : public task {
         explicit work_item(smp_service_group ssg) : task(current_scheduling_group()), ssg(ssg) {}
@@ -278,6 +302,21 @@ class smp_message_queue {
         submit_item(t, options.timeout, std::move(wi));
         return fut;
     }
+    template <typename Func>
+    std::vector<futurize_t<std::invoke_result_t<Func>>> submit_bulk(shard_id t, smp_submit_to_options options, std::vector<Func>&& funcs) noexcept {
+        memory::scoped_critical_alloc_section _;
+        std::vector<std::unique_ptr<work_item>> items;
+        std::vector<futurize_t<std::invoke_result_t<Func>>> futs;
+        items.reserve(funcs.size());
+        futs.reserve(funcs.size());
+        for (auto& func : funcs) {
+            auto wi = std::make_unique<async_work_item<Func>>(*this, options.service_group, std::move(func));
+            futs.push_back(wi->get_future());
+            items.push_back(std::move(wi));
+        }
+        submit_items(t, options.timeout, std::move(items));
+        return futs;
+    }
     void start(unsigned cpuid);
     template<size_t PrefetchCnt, typename Func>
     size_t process_queue(lf_queue& q, Func process);
@@ -287,10 +326,12 @@ class smp_message_queue {
 private:
     void work();
     void submit_item(shard_id t, smp_timeout_clock::time_point timeout, std::unique_ptr<work_item> wi);
+    void submit_items(shard_id t, smp_timeout_clock::time_point timeout, std::vector<std::unique_ptr<work_item>> items);
     void respond(work_item* wi);
     void move_pending();
     void flush_request_batch();
     void flush_response_batch();
+    void poll_response_batch();
     bool has_unflushed_responses() const;
     bool pure_poll_rx() const;
     bool pure_poll_tx() const;
@@ -327,6 +368,10 @@ class smp : public std::enable_shared_from_this<smp> {
     static inline thread_local smp* _this_smp = nullptr;
     bool _using_dpdk = false;
     std::vector<unsigned> _shard_to_numa_node_mapping;
+    // shards grouped by NUMA node, ordered by node id
+    std::vector<std::vector<unsigned>> _numa_node_shards;
+    // one per shard, see submit_stealable()
+    std::unique_ptr<internal::stealable_queue[]> _stealable_queues;
 
 private:
     void setup_prefaulter(const seastar::resource::resources& res, seastar::memory::internal::numa_layout layout);
@@ -403,6 +448,66 @@ class smp : public std::enable_shared_from_this<smp> {
     static futurize_t<std::invoke_result_t<Func>> submit_to(unsigned t, Func&& func) noexcept {
         return submit_to(t, default_smp_service_group(), std::forward<Func>(func));
     }
+    /// Runs several functions on a remote core.
+    ///
+    /// Equivalent to calling \ref submit_to() for each element of \c funcs,
+    /// except that all the functions are admitted by the service group
+    /// together and handed to core \c t in a single publication, instead of
+    /// one per function. Use it when fanning out many requests to the same
+    /// core. More functions than the service group admits at once
+    /// (\ref smp_service_group_config::max_nonlocal_requests, shared among
+    /// the other cores) are admitted and published in chunks that fit.
+    ///
+    /// \param t designates the core to run the functions on (may be a remote
+    ///          core or the local core).
+    /// \param options an \ref smp_submit_to_options that contains options for this call.
+    /// \param funcs callables to run on core \c t. They are moved from and
+    ///          destroyed on the calling core.
+    /// \return one future per function, in the order of \c funcs
+    template <typename Func>
+    static std::vector<futurize_t<std::invoke_result_t<Func>>> bulk_submit_to(unsigned t, smp_submit_to_options options, std::vector<Func> funcs) noexcept {
+        if (t == this_shard_id()) {
+            memory::scoped_critical_alloc_section _;
+            std::vector<futurize_t<std::invoke_result_t<Func>>> futs;
+            futs.reserve(funcs.size());
+            for (auto& func : funcs) {
+                futs.push_back(submit_to(t, options, std::move(func)));
+            }
+            return futs;
+        } else {
+            return _qs[t][this_shard_id()].submit_bulk(t, options, std::move(funcs));
+        }
+    }
+    /// Runs a CPU-bound function, possibly on another shard.
+    ///
+    /// The function is queued on the calling shard and runs there in
+    /// due course, like a task. When work stealing is enabled
+    /// (\ref reactor_options::enable_work_stealing), a shard that would
+    /// otherwise go idle may take it from the queue and run it instead.
+    /// Use it to spread skewed CPU-heavy work, such as compression or
+    /// checksumming of buffers, across the machine.
+    ///
+    /// \param func a callable that may run on any shard. It must not touch
+    ///          shard-local state and must not return a future. It is
+    ///          moved into the queue, invoked on the shard that runs it,
+    ///          and destroyed on the calling shard.
+    /// \return whatever \c func returns, as a future<>, resolved on the
+    ///         calling shard. The result (or exception) may be created on
+    ///         another shard, so it should be cheap to move across shards.
+    template <typename Func>
+    requires (!is_future<std::invoke_result_t<Func>>::value)
+    static futurize_t<std::invoke_result_t<Func>> submit_stealable(Func&& func) noexcept {
+        try {
+            auto item = std::make_unique<internal::stealable_async_work_item<std::decay_t<Func>>>(
+                    current_scheduling_group(), this_shard_id(), std::forward<Func>(func));
+            auto fut = item->get_future();
+            enqueue_stealable(*item);
+            item.release();
+            return fut;
+        } catch (...) {
+            return futurize<std::invoke_result_t<Func>>::current_exception_as_future();
+        }
+    }
     static bool poll_queues();
     static bool pure_poll_queues();
 
@@ -447,15 +552,75 @@ class smp : public std::enable_shared_from_this<smp> {
     ///         future<>. Each async invocation will work with a separate copy
     ///         of \c func.
     /// \returns a future that resolves when all async invocations finish.
+    ///
+    /// When shards span more than one NUMA node, the invocations are relayed
+    /// through one shard per node, see \ref invoke_on_all_hierarchical().
     template<typename Func>
      requires std::is_nothrow_move_constructible_v<Func>
     static future<> invoke_on_all(smp_submit_to_options options, Func&& func) noexcept {
         static_assert(std::is_same_v<future<>, typename futurize<std::invoke_result_t<Func>>::type>, "bad Func signature");
         static_assert(std::is_nothrow_move_constructible_v<Func>);
+        if (this_smp()._numa_node_shards.size() > 1) {
+            return invoke_on_all_hierarchical(options, std::forward<Func>(func));
+        }
         return parallel_for_each(this_smp().all_shards(), [options, &func] (unsigned id) {
             return smp::copy_and_submit_to(id, options, func);
         });
     }
+    /// Invokes func on all shards, fanning out through one shard per NUMA node.
+    ///
+    /// The calling shard messages one representative shard on every other
+    /// NUMA node, which in turn messages the shards of its own node; shards
+    /// on the caller's node are messaged directly. A broadcast thus crosses
+    /// the interconnect once per node instead of once per remote shard.
+    ///
+    /// As with the flat fan-out, all copies of \c func are made and destroyed
+    /// on the calling shard, so \c func may capture shard-local objects.
+    ///
+    /// \param options the options to forward to the \ref smp::submit_to()
+    ///         calls that invoke \c func. The relaying calls use the
+    ///         default service group instead, so that a bounded group never
+    ///         nests within itself.
+    /// \param func the function to be invoked on each shard. May return void or
+    ///         future<>. Each async invocation will work with a separate copy
+    ///         of \c func.
+    /// \returns a future that resolves when all async invocations finish.
+    template<typename Func>
+    requires std::is_nothrow_move_constructible_v<Func>
+    static future<> invoke_on_all_hierarchical(smp_submit_to_options options, Func&& func) noexcept {
+        static_assert(std::is_same_v<future<>, typename futurize<std::invoke_result_t<Func>>::type>, "bad Func signature");
+        using func_type = std::decay_t<Func>;
+        try {
+            std::vector<func_type> copies;
+            copies.reserve(this_smp()._shard_count);
+            for (unsigned id = 0; id < this_smp()._shard_count; id++) {
+                copies.emplace_back(func);
+            }
+            return do_with(std::move(copies), [options] (std::vector<func_type>& copies) {
+                return parallel_for_each(this_smp()._numa_node_shards, [&copies, options] (const std::vector<unsigned>& shards) {
+                    // Runs on the representative shard. Only invokes the
+                    // copies remotely; they stay owned by the calling shard.
+                    auto relay = [&copies, &shards, options] {
+                        return parallel_for_each(shards, [&copies, options] (unsigned id) {
+                            return smp::submit_to(id, options, [&func = copies[id]] {
+                                return futurize_invoke(func);
+                            });
+                        });
+                    };
+                    if (std::ranges::find(shards, this_shard_id()) != shards.end()) {
+                        return relay();
+                    }
+                    // spread relaying among the node's shards by caller;
+                    // the relay submits through options.service_group
+                    // itself, so it must not be admitted by it as well
+                    smp_submit_to_options relay_options(default_smp_service_group(), options.timeout);
+                    return smp::submit_to(shards[this_shard_id() % shards.size()], relay_options, std::move(relay));
+                });
+            });
+        } catch (...) {
+            return current_exception_as_future();
+        }
+    }
     /// Invokes func on all shards.
     ///
     /// \param func the function to be invoked on each shard. May return void or
@@ -517,6 +682,11 @@ class smp : public std::enable_shared_from_this<smp> {
         return *_this_smp;
     }
 private:
+    static void enqueue_stealable(internal::stealable_work_item& item);
+    static bool steal_work();
+    static void wake_idle_thief() noexcept;
+    static void complete_stolen(internal::stealable_work_item* item) noexcept;
+    friend class reactor;
     void start_all_queues();
     void pin(unsigned cpu_id);
     void allocate_reactor(unsigned id, reactor_backend_selector rbs, reactor_config cfg);
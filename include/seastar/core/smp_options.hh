@@ -55,6 +55,14 @@ struct smp_options : public program_options::option_group {
     program_options::value<std::string> hugepages;
     /// Lock all memory (prevents swapping).
     program_options::value<bool> lock_memory;
+    /// Back shard memory with transparent huge pages: each 2MiB-aligned
+    /// region is advised and, once the allocator first hands it out,
+    /// collapsed (MADV_COLLAPSE, Linux 6.1+) into a huge page the next time
+    /// the reactor is idle, keeping the dTLB footprint of large heaps
+    /// small. Ignored with \ref hugepages.
+    ///
+    /// Default: \p false.
+    program_options::value<bool> hugepage_spans;
     /// Pin threads to their cpus (disable for overprovisioning).
     ///
     /// Default: \p true.
@@ -89,6 +97,7 @@ struct smp_options : public program_options::option_group {
     /// * \ref smp_options::memory
     /// * \ref smp_options::reserve_memory
     /// * \ref smp_options::hugepages
+    /// * \ref smp_options::hugepage_spans
     /// * \ref smp_options::mbind
     /// * \ref reactor_options::heapprof
     /// * \ref reactor_options::abort_on_seastar_bad_alloc
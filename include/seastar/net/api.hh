@@ -122,6 +122,12 @@ class datagram final {
 
 using udp_datagram = datagram;
 
+/// A datagram to send as part of a batch, see datagram_channel::send()
+struct outgoing_datagram {
+    socket_address dst;
+    temporary_buffer<char> buf;
+};
+
 class datagram_channel {
 private:
     std::unique_ptr<datagram_channel_impl> _impl;
@@ -151,6 +157,19 @@ class datagram_channel {
      * \return A future that completes when the send operation is finished.
      */
     future<> send(const socket_address& dst, std::span<temporary_buffer<char>> bufs);
+    /**
+     * \brief Send a batch of datagrams, each to its own destination.
+     *
+     * Same as sending the datagrams one after the other, but the posix
+     * stack passes them to the kernel together (sendmmsg()), and lets it
+     * segment runs of datagrams of the same size to the same destination
+     * (UDP_SEGMENT). As with the other overloads, the buffers' ownership
+     * is transferred before returning the future.
+     *
+     * \param datagrams The datagrams to send, in order.
+     * \return A future that completes when all datagrams are sent.
+     */
+    future<> send(std::span<outgoing_datagram> datagrams);
     bool is_closed() const;
     /// Causes a pending receive() to complete (possibly with an exception)
     void shutdown_input();
@@ -24,6 +24,7 @@
 #include <seastar/net/net.hh>
 #include <seastar/net/virtio.hh>
 #include <seastar/net/dpdk.hh>
+#include <seastar/net/xdp.hh>
 #include <seastar/util/program-options.hh>
 
 namespace seastar {
@@ -76,6 +77,30 @@ struct native_stack_options : public program_options::option_group {
     ///
     /// Default: \p on.
     program_options::value<std::string> lro;
+    /// \brief TCP congestion control algorithm (reno, cubic or bbr).
+    ///
+    /// Connections can switch with the TCP_CONGESTION socket option.
+    ///
+    /// Default: \p reno.
+    program_options::value<std::string> tcp_congestion_control;
+    /// \brief Pace TCP data over the round-trip time instead of sending
+    /// it in bursts. BBR always paces.
+    ///
+    /// Default: \p false.
+    program_options::value<bool> tcp_pacing;
+    /// \brief Segment and checksum TCP data in software, at the device,
+    /// when the device can't.
+    ///
+    /// The stack then builds segments of up to 64KB, as with a device that
+    /// offloads segmentation.
+    ///
+    /// Default: \p true.
+    program_options::value<bool> software_gso;
+    /// \brief Merge TCP segments received in a poll, per connection,
+    /// before the stack processes them.
+    ///
+    /// Default: \p true.
+    program_options::value<bool> software_gro;
 
     /// Virtio configuration.
     virtio_options virtio_opts;
@@ -83,6 +108,8 @@ struct native_stack_options : public program_options::option_group {
     ///
     /// \note Unused when seastar is compiled without DPDK support.
     dpdk_options dpdk_opts;
+    /// AF_XDP configuration.
+    xdp_options xdp_opts;
 
     /// \cond internal
     bool _hugepages;
@@ -49,6 +49,7 @@ class interface;
 class device;
 class qp;
 class l3_protocol;
+class gro;
 
 class forward_hash {
     uint8_t data[64];
@@ -124,11 +125,22 @@ class interface {
     std::shared_ptr<device> _dev;
     ethernet_address _hw_address;
     net::hw_features _hw_features;
+    // What the device offloads itself; _hw_features is what the stack sees,
+    // including offloads done in software
+    net::hw_features _dev_features;
     std::vector<l3_protocol::packet_provider_type> _pkt_providers;
+    circular_buffer<packet> _gso_frames;
+    std::unique_ptr<gro> _gro;
+    std::unique_ptr<internal::poller> _gro_poller;
 private:
     future<> dispatch_packet(packet p);
 public:
-    explicit interface(std::shared_ptr<device> dev);
+    /// With \c gso, the stack builds TCP segments as large as if the device
+    /// could segment them and checksum them, which is done in software
+    /// where it can't. With \c gro, TCP segments received in a poll are
+    /// merged before reaching the stack.
+    explicit interface(std::shared_ptr<device> dev, bool gso = false, bool gro = false);
+    ~interface();
     ethernet_address hw_address() const noexcept { return _hw_address; }
     const net::hw_features& hw_features() const { return _hw_features; }
     future<> register_l3(eth_protocol_num proto_num,
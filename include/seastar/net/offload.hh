@@ -0,0 +1,97 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Software fallbacks for the TCP offloads of the native stack, applied at
+// the device boundary when the device lacks them: segmentation (GSO) and
+// checksumming of outgoing frames, and coalescing of received segments
+// (GRO).
+
+#pragma once
+
+#include <seastar/core/circular_buffer.hh>
+#include <seastar/net/net.hh>
+#include <seastar/net/packet.hh>
+#include <functional>
+#include <vector>
+
+namespace seastar {
+
+namespace net {
+
+/// \cond internal
+
+/// Whether an outgoing frame needs offloads \c hw doesn't have
+inline bool needs_software_offload(const offload_info& oi, const hw_features& hw) noexcept {
+    return (oi.tso_seg_size && !hw.tx_tso) || (oi.needs_csum && !hw.tx_csum_l4_offload);
+}
+
+/// Turns an Ethernet frame carrying IPv4 that was built for a device with
+/// TSO and L4 checksum offload into frames for a device with the features
+/// \c hw. A TCP frame with \c tso_seg_size set is cut into frames of that
+/// much payload, sharing the original's payload; checksums are completed
+/// in software, unless \c hw offloads them.
+void software_segment(packet frame, const hw_features& hw, circular_buffer<packet>& out);
+
+/// \brief Generic receive offload for TCP over IPv4
+///
+/// Merges TCP data segments received back to back on the same flow into
+/// one, so that the IP and TCP layers handle them once. Frames are held
+/// until a frame that can't be merged arrives on their flow, or until
+/// flush() is called, at the end of the poll that received them.
+///
+/// Checksums are verified before merging, as they can't be once merged;
+/// merged packets are marked with \c offload_info::rx_csum_verified.
+class gro {
+public:
+    /// Flows with frames held at a time
+    static constexpr unsigned max_flows = 8;
+    /// Largest merged IP datagram
+    static constexpr uint32_t max_ip_len = 65535;
+
+    struct stats {
+        uint64_t frames = 0;
+        uint64_t merged = 0;
+    };
+private:
+    struct flow;
+    hw_features _hw;
+    std::function<void (packet)> _deliver;
+    std::vector<flow> _flows;
+    stats _stats;
+private:
+    void deliver(flow& f);
+public:
+    /// Frames are handed to \c deliver, merged or not, in their order on
+    /// each flow
+    gro(const hw_features& hw, std::function<void (packet)> deliver);
+    ~gro();
+    /// Takes a received Ethernet frame
+    void receive(packet frame);
+    /// Delivers the frames held; returns whether there were any
+    bool flush();
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+/// \endcond
+
+}
+
+}
@@ -53,6 +53,8 @@ struct offload_info {
     uint8_t udp_hdr_len = 8;
     bool needs_ip_csum = false;
     bool reassembled = false;
+    // L3 and L4 checksums were verified in software on receive
+    bool rx_csum_verified = false;
     uint16_t tso_seg_size = 0;
     // HW stripped VLAN header (CPU order)
     std::optional<uint16_t> vlan_tci;
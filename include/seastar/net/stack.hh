@@ -49,6 +49,12 @@ class connected_socket_impl {
     virtual socket_address local_address() const noexcept = 0;
     virtual socket_address remote_address() const noexcept = 0;
     virtual future<> wait_input_shutdown() = 0;
+    /// Sends \c data as a single TLS record of type \c record_type on a
+    /// socket whose transmit path has been switched to kernel TLS. Used for
+    /// alerts and handshake messages, which the kernel cannot tell apart from
+    /// application data on its own. Fails with ENOTSUP when the socket has no
+    /// kernel TLS support.
+    virtual future<> send_tls_control_record(uint8_t record_type, temporary_buffer<char> data);
 };
 
 class socket_impl {
@@ -81,6 +87,8 @@ class datagram_channel_impl {
     // The ownership of temporary_buffer-s referenced by span must be transferred
     // synchronously before returning the future
     virtual future<> send(const socket_address& dst, std::span<temporary_buffer<char>> bufs) = 0;
+    // Sends the datagrams one at a time unless overridden
+    virtual future<> send(std::span<outgoing_datagram> datagrams);
     virtual void shutdown_input() = 0;
     virtual void shutdown_output() = 0;
     virtual bool is_closed() const = 0;
@@ -0,0 +1,116 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Congestion control for the native TCP stack
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+
+namespace seastar {
+
+namespace net {
+
+/// Congestion control algorithms of the native TCP stack
+enum class tcp_congestion_algorithm {
+    reno,   ///< NewReno (RFC 5681, RFC 6582), the historical behaviour
+    cubic,  ///< CUBIC (RFC 9438)
+    bbr,    ///< BBR (version 1); model-based and always paced
+};
+
+/// Parses an algorithm name, as also accepted by the TCP_CONGESTION socket
+/// option: "reno", "cubic" or "bbr". Throws std::invalid_argument otherwise.
+tcp_congestion_algorithm parse_tcp_congestion_algorithm(std::string_view name);
+/// Name of an algorithm, the inverse of \ref parse_tcp_congestion_algorithm()
+const char* tcp_congestion_algorithm_name(tcp_congestion_algorithm algo) noexcept;
+
+/// Congestion state of a connection's sender, in bytes. The tcb reads it
+/// to limit what it sends and inflates it itself during fast recovery; the
+/// congestion controller updates it on ACKs and on congestion events.
+struct tcp_congestion_window {
+    uint32_t cwnd = 0;
+    uint32_t ssthresh = 0;
+};
+
+/// \brief Congestion control algorithm of one TCP connection
+///
+/// Loss detection and recovery (fast retransmit, NewReno or SACK based
+/// recovery, RACK-TLP, retransmission timeouts) stay in the tcb, which
+/// calls into the controller to decide how the window reacts to them.
+class tcp_congestion_control {
+public:
+    /// RTT and delivery rate samples are finer than the lowres clock's tick
+    using clock_type = std::chrono::steady_clock;
+
+    /// An ACK of new data, reported once per acknowledged segment
+    struct ack_sample {
+        uint32_t acked_bytes;
+        uint16_t mss;
+        /// Bytes still unacknowledged after this ACK
+        uint32_t in_flight;
+        /// RTT of the acknowledged segment, unless it was retransmitted
+        std::optional<std::chrono::microseconds> rtt;
+        /// Bytes delivered on the connection so far, including this ACK
+        uint64_t delivered;
+        /// Bytes delivered when the acknowledged segment was sent
+        uint64_t prior_delivered;
+        /// Time it took to deliver the difference; zero if unknown
+        clock_type::duration interval;
+        /// The segment was sent while the application had no more data to
+        /// fill the window, so the delivery rate may underestimate the path's
+        bool app_limited;
+        /// The tcb is in fast recovery and manages the window itself
+        bool in_recovery;
+        clock_type::time_point now;
+    };
+
+    virtual ~tcp_congestion_control() = default;
+    virtual tcp_congestion_algorithm algorithm() const noexcept = 0;
+    /// Grows the window on an ACK of new data
+    virtual void on_ack(tcp_congestion_window& w, const ack_sample& s) = 0;
+    /// Loss detected by duplicate ACKs or by the SACK scoreboard. Sets
+    /// ssthresh; the tcb then enters fast recovery with cwnd = ssthresh +
+    /// 3 * MSS, or with cwnd = ssthresh when SACKs tell it what is still in
+    /// flight.
+    virtual void on_loss(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size, clock_type::time_point now) = 0;
+    /// Fast recovery completed by an ACK of all the data outstanding when
+    /// it started. Deflates the window per RFC 6582 by default.
+    virtual void on_recovery_exit(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size) noexcept;
+    /// Retransmission timeout. \c first is false for the backed-off
+    /// retransmissions of the same segment.
+    virtual void on_timeout(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size, bool first) = 0;
+    /// Rate to pace data at, in bytes per second, or 0 for none. By default
+    /// twice the window per RTT in slow start, and 1.2 times it afterwards.
+    virtual uint64_t pacing_rate(const tcp_congestion_window& w, std::chrono::microseconds srtt) const noexcept;
+    /// Whether the algorithm relies on pacing even when it's not enabled
+    /// for the connection
+    virtual bool needs_pacing() const noexcept { return false; }
+};
+
+std::unique_ptr<tcp_congestion_control> make_tcp_congestion_control(tcp_congestion_algorithm algo);
+
+}
+
+}
@@ -25,6 +25,8 @@
 #include <map>
 #include <functional>
 #include <deque>
+#include <array>
+#include <algorithm>
 #include <chrono>
 #include <cstring>
 #include <random>
@@ -42,6 +44,7 @@
 #include <seastar/net/ip.hh>
 #include <seastar/net/const.hh>
 #include <seastar/net/packet-util.hh>
+#include <seastar/net/tcp-congestion.hh>
 #include <seastar/util/assert.hh>
 #include <seastar/util/std-compat.hh>
 
@@ -94,10 +97,42 @@ void tcp_debug(const char* fmt, Args&&... args) {
 #endif
 }
 
+struct tcp_seq {
+    uint32_t raw;
+};
+
+inline tcp_seq ntoh(tcp_seq s) {
+    return tcp_seq { ntoh(s.raw) };
+}
+
+inline tcp_seq hton(tcp_seq s) {
+    return tcp_seq { hton(s.raw) };
+}
+
+inline
+std::ostream& operator<<(std::ostream& os, tcp_seq s) {
+    return os << s.raw;
+}
+
+inline tcp_seq make_seq(uint32_t raw) { return tcp_seq{raw}; }
+inline tcp_seq& operator+=(tcp_seq& s, int32_t n) { s.raw += n; return s; }
+inline tcp_seq& operator-=(tcp_seq& s, int32_t n) { s.raw -= n; return s; }
+inline tcp_seq operator+(tcp_seq s, int32_t n) { return s += n; }
+inline tcp_seq operator-(tcp_seq s, int32_t n) { return s -= n; }
+inline int32_t operator-(tcp_seq s, tcp_seq q) { return s.raw - q.raw; }
+inline bool operator==(tcp_seq s, tcp_seq q)  { return s.raw == q.raw; }
+inline bool operator!=(tcp_seq s, tcp_seq q) { return !(s == q); }
+inline bool operator<(tcp_seq s, tcp_seq q) { return s - q < 0; }
+inline bool operator>(tcp_seq s, tcp_seq q) { return q < s; }
+inline bool operator<=(tcp_seq s, tcp_seq q) { return !(s > q); }
+inline bool operator>=(tcp_seq s, tcp_seq q) { return !(s < q); }
+
 struct tcp_option {
-    // The kind and len field are fixed and defined in TCP protocol
-    enum class option_kind: uint8_t { mss = 2, win_scale = 3, sack = 4, timestamps = 8,  nop = 1, eol = 0 };
-    enum class option_len:  uint8_t { mss = 4, win_scale = 3, sack = 2, timestamps = 10, nop = 1, eol = 1 };
+    // The kind and len field are fixed and defined in TCP protocol; sack
+    // is SACK-permitted, while the length of sack_blocks depends on their
+    // number
+    enum class option_kind: uint8_t { mss = 2, win_scale = 3, sack = 4, sack_blocks = 5, timestamps = 8,  nop = 1, eol = 0 };
+    enum class option_len:  uint8_t { mss = 4, win_scale = 3, sack = 2, sack_blocks = 2, timestamps = 10, nop = 1, eol = 1 };
     static void write(char* p, option_kind kind, option_len len) {
         p[0] = static_cast<uint8_t>(kind);
         if (static_cast<uint8_t>(len) > 1) {
@@ -142,6 +177,36 @@ struct tcp_option {
             tcp_option::write(p, kind, len);
         }
     };
+    // A range of data received out of order, [left, right)
+    struct sack_block {
+        tcp_seq left;
+        tcp_seq right;
+    };
+    static constexpr unsigned max_sack_blocks = 4;
+    struct sack_blocks {
+        static constexpr option_kind kind = option_kind::sack_blocks;
+        static constexpr uint8_t block_len = 8;
+        static uint8_t len(unsigned nr) {
+            return uint8_t(option_len::sack_blocks) + nr * block_len;
+        }
+        // Returns the number of blocks read into \c blocks
+        static unsigned read(const char* p, sack_block* blocks) {
+            unsigned nr = std::min<unsigned>((uint8_t(p[1]) - uint8_t(option_len::sack_blocks)) / block_len, max_sack_blocks);
+            for (unsigned i = 0; i < nr; i++) {
+                blocks[i].left = tcp_seq{read_be<uint32_t>(p + 2 + i * block_len)};
+                blocks[i].right = tcp_seq{read_be<uint32_t>(p + 6 + i * block_len)};
+            }
+            return nr;
+        }
+        static void write(char* p, const sack_block* blocks, unsigned nr) {
+            p[0] = static_cast<uint8_t>(kind);
+            p[1] = len(nr);
+            for (unsigned i = 0; i < nr; i++) {
+                write_be<uint32_t>(p + 2 + i * block_len, blocks[i].left.raw);
+                write_be<uint32_t>(p + 6 + i * block_len, blocks[i].right.raw);
+            }
+        }
+    };
     struct timestamps {
         static constexpr option_kind kind = option_kind::timestamps;
         static constexpr option_len len = option_len::timestamps;
@@ -190,41 +255,17 @@ struct tcp_option {
     uint16_t _local_mss;
     uint8_t _remote_win_scale = 0;
     uint8_t _local_win_scale = 0;
+    // SACK blocks carried by the last segment parsed, and the ones to
+    // report in the next ACK we send
+    std::array<sack_block, max_sack_blocks> _remote_sack_blocks;
+    uint8_t _nr_remote_sack_blocks = 0;
+    std::array<sack_block, max_sack_blocks> _local_sack_blocks;
+    uint8_t _nr_local_sack_blocks = 0;
 };
 inline char*& operator+=(char*& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 inline const char*& operator+=(const char*& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 inline uint8_t& operator+=(uint8_t& x, tcp_option::option_len len) { x += uint8_t(len); return x; }
 
-struct tcp_seq {
-    uint32_t raw;
-};
-
-inline tcp_seq ntoh(tcp_seq s) {
-    return tcp_seq { ntoh(s.raw) };
-}
-
-inline tcp_seq hton(tcp_seq s) {
-    return tcp_seq { hton(s.raw) };
-}
-
-inline
-std::ostream& operator<<(std::ostream& os, tcp_seq s) {
-    return os << s.raw;
-}
-
-inline tcp_seq make_seq(uint32_t raw) { return tcp_seq{raw}; }
-inline tcp_seq& operator+=(tcp_seq& s, int32_t n) { s.raw += n; return s; }
-inline tcp_seq& operator-=(tcp_seq& s, int32_t n) { s.raw -= n; return s; }
-inline tcp_seq operator+(tcp_seq s, int32_t n) { return s += n; }
-inline tcp_seq operator-(tcp_seq s, int32_t n) { return s -= n; }
-inline int32_t operator-(tcp_seq s, tcp_seq q) { return s.raw - q.raw; }
-inline bool operator==(tcp_seq s, tcp_seq q)  { return s.raw == q.raw; }
-inline bool operator!=(tcp_seq s, tcp_seq q) { return !(s == q); }
-inline bool operator<(tcp_seq s, tcp_seq q) { return s - q < 0; }
-inline bool operator>(tcp_seq s, tcp_seq q) { return q < s; }
-inline bool operator<=(tcp_seq s, tcp_seq q) { return !(s > q); }
-inline bool operator>=(tcp_seq s, tcp_seq q) { return !(s < q); }
-
 struct tcp_hdr {
     static constexpr size_t len = 20;
     uint16_t src_port;
@@ -302,6 +343,9 @@ class tcp {
 
     class tcb : public enable_lw_shared_from_this<tcb> {
         using clock_type = lowres_clock;
+        // Timestamps RTT and delivery rate samples are taken from: the
+        // lowres clock would round them down to 0 on a LAN
+        using sample_clock_type = tcp_congestion_control::clock_type;
         static constexpr tcp_state CLOSED         = tcp_state::CLOSED;
         static constexpr tcp_state LISTEN         = tcp_state::LISTEN;
         static constexpr tcp_state SYN_SENT       = tcp_state::SYN_SENT;
@@ -326,7 +370,18 @@ class tcp {
             packet p;
             uint16_t data_len;
             unsigned nr_transmits;
-            clock_type::time_point tx_time;
+            sample_clock_type::time_point tx_time;
+            // Delivery state when the segment was sent, for rate sampling
+            uint64_t delivered;
+            sample_clock_type::time_point delivered_time;
+            // Order of the last transmission among all of the connection's
+            uint64_t tx_serial;
+            // Sent while the application, not the network, limited the rate
+            bool app_limited;
+            // SACK scoreboard: the peer holds the segment, or it's deemed
+            // lost and waits to be retransmitted
+            bool sacked = false;
+            bool lost = false;
         };
         struct send {
             tcp_seq unacknowledged;
@@ -351,15 +406,20 @@ class tcp {
             // wait for there is at least one byte available in the queue
             std::optional<promise<>> _send_available_promise;
             // Round-trip time variation
-            std::chrono::milliseconds rttvar;
+            std::chrono::microseconds rttvar;
             // Smoothed round-trip time
-            std::chrono::milliseconds srtt;
+            std::chrono::microseconds srtt;
             bool first_rto_sample = true;
-            clock_type::time_point syn_tx_time;
-            // Congestion window
-            uint32_t cwnd;
-            // Slow start threshold
-            uint32_t ssthresh;
+            sample_clock_type::time_point syn_tx_time;
+            // Congestion window and slow start threshold
+            tcp_congestion_window cong;
+            // Bytes acknowledged so far, and when the last of them were
+            uint64_t delivered = 0;
+            sample_clock_type::time_point delivered_time;
+            // While non-zero, the application doesn't give enough data to fill
+            // the window; segments sent until this much is delivered make
+            // delivery rate samples of the application rather than the path
+            uint64_t app_limited = 0;
             // Duplicated ACKs
             uint16_t dupacks = 0;
             unsigned syn_retransmit = 0;
@@ -369,7 +429,27 @@ class tcp {
             tcp_seq recover;
             bool window_probe = false;
             uint8_t zero_window_probing_out = 0;
+            uint64_t tx_serial = 0;
+            // Outstanding bytes the peer selectively acknowledged, and those
+            // deemed lost that were not retransmitted yet
+            uint32_t sacked_bytes = 0;
+            uint32_t lost_bytes = 0;
+            // Loss recovery driven by the SACK scoreboard (RFC 6675)
+            // rather than by duplicate ACKs
+            bool sack_recovery = false;
+            // A tail loss probe was sent and nothing acknowledged since
+            bool tlp_out = false;
         } _snd;
+        // RACK (RFC 8985): the most recently sent segment that was delivered,
+        // which segments sent before it are expected to follow
+        struct rack {
+            uint64_t tx_serial = 0;
+            sample_clock_type::duration rtt{};
+            sample_clock_type::duration min_rtt = sample_clock_type::duration::max();
+            // Highest sequence delivered, to tell reordering from loss
+            tcp_seq fack;
+            bool reordering_seen = false;
+        } _rack;
         struct receive {
             tcp_seq next;
             uint32_t window;
@@ -381,6 +461,8 @@ class tcp {
             // The total size of data stored in std::deque<packet> data
             size_t data_size = 0;
             tcp_packet_merger out_of_order;
+            // Start of the last segment received out of order
+            tcp_seq last_out_of_order;
             std::optional<promise<>> _data_received_promise;
             // The maximun memory buffer size allowed for receiving
             // Currently, it is the same as default receive window size when window scaling is enabled
@@ -398,6 +480,18 @@ class tcp {
         static constexpr uint16_t _max_nr_retransmit{5};
         timer<lowres_clock> _retransmit;
         timer<lowres_clock> _persist;
+        // RACK reordering window and tail loss probe timeouts
+        timer<lowres_clock> _rack_timer;
+        timer<lowres_clock> _tlp_timer;
+        static constexpr unsigned _dupthresh = 3;
+        // Worst case delayed ACK timeout of the peer
+        static constexpr std::chrono::milliseconds _max_ack_delay{200};
+        static constexpr std::chrono::milliseconds _tlp_min{10};
+        std::unique_ptr<tcp_congestion_control> _cc;
+        bool _pacing;
+        // Earliest time the next data segment may leave when pacing
+        steady_clock_type::time_point _pacing_next;
+        timer<> _pacing_timer;
         uint16_t _nr_full_seg_received = 0;
         struct isn_secret {
             // 512 bits secretkey for ISN generating
@@ -430,7 +524,7 @@ class tcp {
         void input_handle_listen_state(tcp_hdr* th, packet p);
         void input_handle_syn_sent_state(tcp_hdr* th, packet p);
         void input_handle_other_state(tcp_hdr* th, packet p);
-        void output_one(bool data_retransmit = false);
+        void output_one(unacked_segment* retransmit = nullptr, tcp_seq retransmit_seq = {});
         future<> wait_for_data();
         future<> wait_input_shutdown();
         void abort_reader() noexcept;
@@ -472,6 +566,18 @@ class tcp {
         tcp_state& state() {
             return _state;
         }
+        void set_congestion_control(tcp_congestion_algorithm algo) {
+            if (algo != _cc->algorithm()) {
+                // The new algorithm takes over the current window
+                _cc = make_tcp_congestion_control(algo);
+            }
+        }
+        tcp_congestion_algorithm congestion_control() const noexcept {
+            return _cc->algorithm();
+        }
+        void set_pacing(bool pacing) noexcept {
+            _pacing = pacing;
+        }
     private:
         void respond_with_reset(tcp_hdr* th);
         bool merge_out_of_order();
@@ -481,8 +587,10 @@ class tcp {
         void clear_delayed_ack() noexcept;
         packet get_transmit_packet();
         void retransmit_one() {
-            bool data_retransmit = true;
-            output_one(data_retransmit);
+            retransmit_one(_snd.data.front(), _snd.unacknowledged);
+        }
+        void retransmit_one(unacked_segment& seg, tcp_seq seq) {
+            output_one(&seg, seq);
         }
         void start_retransmit_timer() {
             auto now = clock_type::now();
@@ -509,14 +617,26 @@ class tcp {
         void persist();
         void retransmit();
         void fast_retransmit();
-        void update_rto(clock_type::time_point tx_time);
-        void update_cwnd(uint32_t acked_bytes);
+        void update_rto(sample_clock_type::time_point tx_time);
+        void update_cwnd(uint32_t acked_bytes, const unacked_segment* seg);
+        uint8_t fill_sack_blocks();
+        void sack_acked(tcp_seq seg_ack, bool new_data_acked);
+        bool update_scoreboard(sample_clock_type::time_point now);
+        void rack_delivered(const unacked_segment& seg, tcp_seq end_seq, sample_clock_type::time_point now);
+        void detect_losses(sample_clock_type::time_point now);
+        bool retransmit_lost();
+        void arm_tail_loss_probe(clock_type::time_point now);
+        void tail_loss_probe();
         void cleanup();
         uint32_t can_send() {
             if (_snd.window_probe) {
                 return 1;
             }
 
+            if (pacing_delayed()) {
+                return 0;
+            }
+
             // Can not send if send window is zero
             if (_snd.window == 0) {
                 return 0;
@@ -532,12 +652,17 @@ class tcp {
             auto x = std::min(_snd.window - window_used, _snd.unsent_len);
 
             // Can not send more than congestion window allows
-            x = std::min(_snd.cwnd, x);
+            if (sack_enabled()) {
+                // RFC 6675: the scoreboard tells what is still in the network
+                auto in_pipe = pipe();
+                return in_pipe < _snd.cong.cwnd ? std::min(_snd.cong.cwnd - in_pipe, x) : 0;
+            }
+            x = std::min(_snd.cong.cwnd, x);
             if (_snd.dupacks == 1 || _snd.dupacks == 2) {
                 // RFC5681 Step 3.1
                 // Send cwnd + 2 * smss per RFC3042
                 auto flight = flight_size();
-                auto max = _snd.cwnd + 2 * _snd.mss;
+                auto max = _snd.cong.cwnd + 2 * _snd.mss;
                 x = flight <= max ? std::min(x, max - flight) : 0;
                 _snd.limited_transfer += x;
             } else if (_snd.dupacks >= 3) {
@@ -547,6 +672,54 @@ class tcp {
             }
             return x;
         }
+        uint64_t pacing_rate() const noexcept {
+            if (!_pacing && !_cc->needs_pacing()) {
+                return 0;
+            }
+            return _cc->pacing_rate(_snd.cong, _snd.srtt);
+        }
+        // Holds data back until the pacing timer lets the next segment go
+        bool pacing_delayed() {
+            if (!pacing_rate()) {
+                return false;
+            }
+            if (steady_clock_type::now() >= _pacing_next) {
+                return false;
+            }
+            if (!_pacing_timer.armed()) {
+                _pacing_timer.arm(_pacing_next);
+            }
+            return true;
+        }
+        void paced_send(uint32_t len) {
+            if (auto rate = pacing_rate()) {
+                auto now = steady_clock_type::now();
+                _pacing_next = std::max(_pacing_next, now) + std::chrono::nanoseconds(uint64_t(len) * 1000000000 / rate);
+            }
+        }
+        bool sack_enabled() const noexcept {
+            return _option._sack_received;
+        }
+        bool in_recovery() const noexcept {
+            return _snd.dupacks >= 3 || _snd.sack_recovery;
+        }
+        // Outstanding data not known to have left the network (RFC 6675)
+        uint32_t pipe() const noexcept {
+            return uint32_t(_snd.next - _snd.unacknowledged) - _snd.sacked_bytes - _snd.lost_bytes;
+        }
+        bool can_retransmit_lost() const noexcept {
+            return _snd.lost_bytes && pipe() < _snd.cong.cwnd;
+        }
+        // Takes a segment that is acknowledged, or trimmed by a partial
+        // ACK, off the scoreboard
+        void forget_acked(const unacked_segment& seg, uint32_t bytes) noexcept {
+            if (seg.sacked) {
+                _snd.sacked_bytes -= bytes;
+            }
+            if (seg.lost) {
+                _snd.lost_bytes -= bytes;
+            }
+        }
         uint32_t flight_size() {
             uint32_t size = 0;
             std::for_each(_snd.data.begin(), _snd.data.end(), [&] (unacked_segment& seg) { size += seg.p.len(); });
@@ -578,13 +751,13 @@ class tcp {
         }
         void do_syn_sent() {
             _state = SYN_SENT;
-            _snd.syn_tx_time = clock_type::now();
+            _snd.syn_tx_time = sample_clock_type::now();
             // Send <SYN> to remote
             output();
         }
         void do_syn_received() {
             _state = SYN_RECEIVED;
-            _snd.syn_tx_time = clock_type::now();
+            _snd.syn_tx_time = sample_clock_type::now();
             // Send <SYN,ACK> to remote
             output();
         }
@@ -623,6 +796,7 @@ class tcp {
             _snd.unacknowledged = _snd.initial;
             _snd.next = _snd.initial + 1;
             _snd.recover = _snd.initial;
+            _rack.fack = _snd.next;
         }
         void do_local_fin_acked() {
             _snd.unacknowledged += 1;
@@ -664,6 +838,8 @@ class tcp {
     // queue for packets that do not belong to any tcb
     circular_buffer<ipv4_traits::l4packet> _packetq;
     semaphore _queue_space = {212992};
+    tcp_congestion_algorithm _congestion_control = tcp_congestion_algorithm::reno;
+    bool _pacing = false;
     metrics::metric_groups _metrics;
 public:
     const inet_type& inet() const {
@@ -713,6 +889,23 @@ class tcp {
         uint16_t local_port() {
             return _tcb->_local_port;
         }
+        void set_congestion_control(tcp_congestion_algorithm algo) {
+            _tcb->set_congestion_control(algo);
+        }
+        tcp_congestion_algorithm congestion_control() const noexcept {
+            return _tcb->congestion_control();
+        }
+        void set_pacing(bool pacing) noexcept {
+            _tcb->set_pacing(pacing);
+        }
+        // Smoothed RTT estimate (RFC 6298), zero before the first sample
+        std::chrono::microseconds smoothed_rtt() const noexcept {
+            return _tcb->_snd.first_rto_sample ? std::chrono::microseconds(0) : _tcb->_snd.srtt;
+        }
+        // Rate data is paced at, in bytes per second, or 0 if it isn't
+        uint64_t pacing_rate() const noexcept {
+            return _tcb->pacing_rate();
+        }
         void shutdown_connect();
         void close_read() noexcept;
         void close_write() noexcept;
@@ -763,6 +956,12 @@ class tcp {
     listener listen(uint16_t port, size_t queue_length = 100);
     connection connect(socket_address sa);
     const net::hw_features& hw_features() const { return _inet._inet.hw_features(); }
+    /// Sets the congestion control algorithm, and whether data is paced,
+    /// of the connections created from now on
+    void set_default_congestion_control(tcp_congestion_algorithm algo, bool pacing) noexcept {
+        _congestion_control = algo;
+        _pacing = pacing;
+    }
     future<> poll_tcb(ipaddr to, lw_shared_ptr<tcb> tcb);
     void add_connected_tcb(lw_shared_ptr<tcb> tcbp, uint16_t local_port) {
         auto it = _listening.find(local_port);
@@ -873,7 +1072,7 @@ void tcp<InetTraits>::received(packet p, ipaddr from, ipaddr to) {
         return;
     }
 
-    if (!hw_features().rx_csum_offload) {
+    if (!hw_features().rx_csum_offload && !p.offload_info_ref().rx_csum_verified) {
         checksummer csum;
         InetTraits::tcp_pseudo_header_checksum(csum, from, to, p.len());
         csum.sum(p);
@@ -970,7 +1169,17 @@ tcp<InetTraits>::tcb::tcb(tcp& t, connid id)
     , _foreign_port(id.foreign_port)
     , _delayed_ack([this] { _nr_full_seg_received = 0; output(); })
     , _retransmit([this] { retransmit(); })
-    , _persist([this] { persist(); }) {
+    , _persist([this] { persist(); })
+    , _rack_timer([this] {
+        detect_losses(sample_clock_type::now());
+        if (can_retransmit_lost()) {
+            output();
+        }
+    })
+    , _tlp_timer([this] { tail_loss_probe(); })
+    , _cc(make_tcp_congestion_control(t._congestion_control))
+    , _pacing(t._pacing)
+    , _pacing_timer([this] { if (can_send() > 0) { output(); } }) {
 }
 
 template <typename InetTraits>
@@ -1030,11 +1239,19 @@ uint32_t tcp<InetTraits>::tcb::data_segment_acked(tcp_seq seg_ack) {
             && (_snd.unacknowledged + _snd.data.front().p.len() <= seg_ack)) {
         auto acked_bytes = _snd.data.front().p.len();
         _snd.unacknowledged += acked_bytes;
-        // Ignore retransmitted segments when setting the RTO
-        if (_snd.data.front().nr_transmits == 0) {
-            update_rto(_snd.data.front().tx_time);
+        auto& seg = _snd.data.front();
+        // Ignore retransmitted segments when setting the RTO, and SACKed
+        // ones, whose ACK is late by design
+        if (seg.nr_transmits == 0 && !seg.sacked) {
+            update_rto(seg.tx_time);
+        }
+        if (sack_enabled()) {
+            if (!seg.sacked) {
+                rack_delivered(seg, _snd.unacknowledged, sample_clock_type::now());
+            }
+            forget_acked(seg, acked_bytes);
         }
-        update_cwnd(acked_bytes);
+        update_cwnd(acked_bytes, &seg);
         total_acked_bytes += acked_bytes;
         _snd.current_queue_space -= _snd.data.front().data_len;
         signal_send_available();
@@ -1043,12 +1260,15 @@ uint32_t tcp<InetTraits>::tcb::data_segment_acked(tcp_seq seg_ack) {
     // Partial ACK of segment
     if (_snd.unacknowledged < seg_ack) {
         auto acked_bytes = seg_ack - _snd.unacknowledged;
+        const unacked_segment* seg = nullptr;
         if (!_snd.data.empty()) {
             auto& unacked_seg = _snd.data.front();
+            forget_acked(unacked_seg, acked_bytes);
             unacked_seg.p.trim_front(acked_bytes);
+            seg = &unacked_seg;
         }
         _snd.unacknowledged = seg_ack;
-        update_cwnd(acked_bytes);
+        update_cwnd(acked_bytes, seg);
         total_acked_bytes += acked_bytes;
     }
     return total_acked_bytes;
@@ -1100,15 +1320,15 @@ void tcp<InetTraits>::tcb::init_from_options(tcp_hdr* th, uint8_t* opt_start, ui
 
     // Setup initial congestion window
     if (2190 < _snd.mss) {
-        _snd.cwnd = 2 * _snd.mss;
+        _snd.cong.cwnd = 2 * _snd.mss;
     } else if (1095 < _snd.mss && _snd.mss <= 2190) {
-        _snd.cwnd = 3 * _snd.mss;
+        _snd.cong.cwnd = 3 * _snd.mss;
     } else {
-        _snd.cwnd = 4 * _snd.mss;
+        _snd.cong.cwnd = 4 * _snd.mss;
     }
 
     // Setup initial slow start threshold
-    _snd.ssthresh = th->window << _snd.window_scale;
+    _snd.cong.ssthresh = th->window << _snd.window_scale;
 }
 
 template <typename InetTraits>
@@ -1213,6 +1433,13 @@ void tcp<InetTraits>::tcb::input_handle_syn_sent_state(tcp_hdr* th, packet p) {
 
 template <typename InetTraits>
 void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
+    if (sack_enabled() && th->data_offset * 4 > tcp_hdr::len) {
+        // Pick up the SACK blocks, if any
+        auto opt_start = reinterpret_cast<uint8_t*>(p.get_header(0, th->data_offset * 4)) + tcp_hdr::len;
+        _option.parse(opt_start, opt_start + th->data_offset * 4 - tcp_hdr::len);
+    } else {
+        _option._nr_remote_sack_blocks = 0;
+    }
     p.trim_front(th->data_offset * 4);
     bool do_output = false;
     bool do_output_data = false;
@@ -1329,7 +1556,35 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
         };
         // ESTABLISHED STATE or
         // CLOSE_WAIT STATE: Do the same processing as for the ESTABLISHED state.
-        if (in_state(ESTABLISHED | CLOSE_WAIT)){
+        if (in_state(ESTABLISHED | CLOSE_WAIT) && sack_enabled()) {
+            // Losses are detected from the SACK scoreboard and RACK rather
+            // than by counting duplicate ACKs
+            if (seg_ack > _snd.next) {
+                return output();
+            }
+            if (_snd.unacknowledged <= seg_ack) {
+                bool new_data_acked = _snd.unacknowledged < seg_ack;
+                if (new_data_acked) {
+                    data_segment_acked(seg_ack);
+                    do_output_data = true;
+                    if (_snd.data.empty()) {
+                        stop_retransmit_timer();
+                        signal_all_data_acked();
+                    } else {
+                        start_retransmit_timer();
+                    }
+                }
+                bool window_opened = _snd.window == 0 && th->window > 0;
+                if (window_opened || _snd.wl1 < seg_seq || (_snd.wl1 == seg_seq && _snd.wl2 <= seg_ack)) {
+                    update_window();
+                    do_output_data |= window_opened;
+                }
+                sack_acked(seg_ack, new_data_acked);
+                if (can_retransmit_lost()) {
+                    do_output = true;
+                }
+            }
+        } else if (in_state(ESTABLISHED | CLOSE_WAIT)){
             // When we are in zero window probing phase and packets_out = 0 we bypass "duplicated ack" check
             auto packets_out = _snd.next - _snd.unacknowledged - _snd.zero_window_probing_out;
             // If SND.UNA < SEG.ACK =< SND.NXT then, set SND.UNA <- SEG.ACK.
@@ -1362,8 +1617,7 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                     uint32_t smss = _snd.mss;
                     if (seg_ack > _snd.recover) {
                         tcp_debug("ack: full_ack\n");
-                        // Set cwnd to min (ssthresh, max(FlightSize, SMSS) + SMSS)
-                        _snd.cwnd = std::min(_snd.ssthresh, std::max(flight_size(), smss) + smss);
+                        _cc->on_recovery_exit(_snd.cong, _snd.mss, flight_size());
                         // Exit the fast recovery procedure
                         exit_fast_recovery();
                         set_retransmit_timer();
@@ -1373,11 +1627,11 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                         fast_retransmit();
                         // Deflate the congestion window by the amount of new data
                         // acknowledged by the Cumulative Acknowledgment field
-                        _snd.cwnd -= acked_bytes;
+                        _snd.cong.cwnd -= acked_bytes;
                         // If the partial ACK acknowledges at least one SMSS of new
                         // data, then add back SMSS bytes to the congestion window
                         if (acked_bytes >= smss) {
-                            _snd.cwnd += smss;
+                            _snd.cong.cwnd += smss;
                         }
                         // Send a new segment if permitted by the new value of
                         // cwnd.  Do not exit the fast recovery procedure For
@@ -1421,16 +1675,16 @@ void tcp<InetTraits>::tcb::input_handle_other_state(tcp_hdr* th, packet p) {
                     if (seg_ack - 1 > _snd.recover) {
                         _snd.recover = _snd.next - 1;
                         // RFC5681 Step 3.2
-                        _snd.ssthresh = std::max((flight_size() - _snd.limited_transfer) / 2, 2 * smss);
+                        _cc->on_loss(_snd.cong, _snd.mss, flight_size() - _snd.limited_transfer, sample_clock_type::now());
                         fast_retransmit();
                     } else {
                         // Do not enter fast retransmit and do not reset ssthresh
                     }
                     // RFC5681 Step 3.3
-                    _snd.cwnd = _snd.ssthresh + 3 * smss;
+                    _snd.cong.cwnd = _snd.cong.ssthresh + 3 * smss;
                 } else if (_snd.dupacks > 3) {
                     // RFC5681 Step 3.4
-                    _snd.cwnd += smss;
+                    _snd.cong.cwnd += smss;
                     // RFC5681 Step 3.5
                     do_output_data = true;
                 }
@@ -1589,6 +1843,8 @@ packet tcp<InetTraits>::tcb::get_transmit_packet() {
     } else {
         len = std::min(uint16_t(_tcp.hw_features().mtu - net::tcp_hdr_len_min - InetTraits::ip_hdr_len_min), _snd.mss);
     }
+    // Leave room for the SACK blocks the segment carries
+    len -= _option.get_size(false, true);
     can_send = std::min(can_send, len);
     auto p = packet();
     while (!_snd.unsent.empty() && _snd.unsent.front().size() <= can_send) {
@@ -1606,16 +1862,21 @@ packet tcp<InetTraits>::tcb::get_transmit_packet() {
 }
 
 template <typename InetTraits>
-void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
+void tcp<InetTraits>::tcb::output_one(unacked_segment* retransmit, tcp_seq retransmit_seq) {
     if (in_state(CLOSED)) {
         return;
     }
 
-    packet p = data_retransmit ? _snd.data.front().p.share() : get_transmit_packet();
-    packet clone = p.share();  // early clone to prevent share() from calling packet::unuse_internal_data() on header.
-    uint16_t len = p.len();
+    bool data_retransmit = retransmit;
     bool syn_on = syn_needs_on();
     bool ack_on = ack_needs_on();
+    // Report data received out of order, except on retransmissions, which
+    // are already as long as the MSS allows
+    bool sack_on = ack_on && !syn_on && !data_retransmit && sack_enabled() && !_rcv.out_of_order.map.empty();
+    _option._nr_local_sack_blocks = sack_on ? fill_sack_blocks() : 0;
+    packet p = data_retransmit ? retransmit->p.share() : get_transmit_packet();
+    packet clone = p.share();  // early clone to prevent share() from calling packet::unuse_internal_data() on header.
+    uint16_t len = p.len();
 
     auto options_size = _option.get_size(syn_on, ack_on);
     auto th = p.prepend_uninitialized_header(tcp_hdr::len + options_size);
@@ -1634,7 +1895,7 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
 
     tcp_seq seq;
     if (data_retransmit) {
-        seq = _snd.unacknowledged;
+        seq = retransmit_seq;
     } else {
         seq = syn_on ? _snd.initial : _snd.next;
         _snd.next += len;
@@ -1672,7 +1933,7 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
         // CSUM offload case.
         //
         if (_tcp.hw_features().tx_tso && len > _snd.mss) {
-            oi.tso_seg_size = _snd.mss;
+            oi.tso_seg_size = _snd.mss - options_size;
         } else {
             pseudo_hdr_seg_len = tcp_hdr::len + options_size + len;
         }
@@ -1697,12 +1958,30 @@ void tcp<InetTraits>::tcb::output_one(bool data_retransmit) {
 
     p.set_offload_info(oi);
 
-    if (!data_retransmit && (len || syn_on || fin_on)) {
+    if (data_retransmit) {
+        retransmit->tx_time = sample_clock_type::now();
+        retransmit->tx_serial = ++_snd.tx_serial;
+        if (retransmit->lost) {
+            retransmit->lost = false;
+            _snd.lost_bytes -= retransmit->p.len();
+        }
+    } else if (len || syn_on || fin_on) {
         auto now = clock_type::now();
         if (len) {
             unsigned nr_transmits = 0;
+            auto tx_time = sample_clock_type::now();
+            if (_snd.data.empty()) {
+                // Don't count idle time into delivery rate samples
+                _snd.delivered_time = tx_time;
+            }
+            auto in_flight = uint32_t(_snd.next - _snd.unacknowledged);
+            if (!_snd.unsent_len && !_snd.lost_bytes && in_flight < _snd.cong.cwnd) {
+                _snd.app_limited = std::max<uint64_t>(_snd.delivered + in_flight, 1);
+            }
             _snd.data.emplace_back(unacked_segment{std::move(clone),
-                                   len, nr_transmits, now});
+                                   len, nr_transmits, tx_time, _snd.delivered, _snd.delivered_time, ++_snd.tx_serial, _snd.app_limited != 0});
+            paced_send(len);
+            arm_tail_loss_probe(now);
         }
         if (!_retransmit.armed()) {
             start_retransmit_timer(now);
@@ -1916,6 +2195,7 @@ bool tcp<InetTraits>::tcb::merge_out_of_order() {
 
 template <typename InetTraits>
 void tcp<InetTraits>::tcb::insert_out_of_order(tcp_seq seg, packet p) {
+    _rcv.last_out_of_order = seg;
     _rcv.out_of_order.merge(seg, std::move(p));
 }
 
@@ -1977,19 +2257,27 @@ void tcp<InetTraits>::tcb::retransmit() {
     // If there are unacked data, retransmit the earliest segment
     auto& unacked_seg = _snd.data.front();
 
-    // According to RFC5681
-    // Update ssthresh only for the first retransmit
-    uint32_t smss = _snd.mss;
-    if (unacked_seg.nr_transmits == 0) {
-        _snd.ssthresh = std::max(flight_size() / 2, 2 * smss);
-    }
+    _cc->on_timeout(_snd.cong, _snd.mss, flight_size(), unacked_seg.nr_transmits == 0);
     // RFC6582 Step 4
     _snd.recover = _snd.next - 1;
-    // Start the slow start process
-    _snd.cwnd = smss;
     // End fast recovery
     exit_fast_recovery();
 
+    if (sack_enabled()) {
+        // RFC 8985 6.3: everything the peer doesn't hold is lost, and goes
+        // out again, in order, as the window regrows
+        for (auto& seg : _snd.data) {
+            if (!seg.sacked && !seg.lost) {
+                seg.lost = true;
+                _snd.lost_bytes += seg.p.len();
+            }
+        }
+        _snd.sack_recovery = false;
+        _snd.tlp_out = false;
+        _rack_timer.cancel();
+        _tlp_timer.cancel();
+    }
+
     if (unacked_seg.nr_transmits < _max_nr_retransmit) {
         unacked_seg.nr_transmits++;
     } else {
@@ -2013,9 +2301,236 @@ void tcp<InetTraits>::tcb::fast_retransmit() {
 }
 
 template <typename InetTraits>
-void tcp<InetTraits>::tcb::update_rto(clock_type::time_point tx_time) {
+uint8_t tcp<InetTraits>::tcb::fill_sack_blocks() {
+    auto& blocks = _option._local_sack_blocks;
+    uint8_t nr = 0;
+    // Calls fn with each range of contiguous data held out of order, until
+    // it returns false
+    auto for_each_range = [this] (auto fn) {
+        std::optional<tcp_option::sack_block> b;
+        for (auto& [seq, p] : _rcv.out_of_order.map) {
+            if (b && seq <= b->right) {
+                b->right = std::max(b->right, seq + p.len());
+                continue;
+            }
+            if (b && !fn(*b)) {
+                return;
+            }
+            b = tcp_option::sack_block{seq, seq + p.len()};
+        }
+        if (b) {
+            fn(*b);
+        }
+    };
+    // RFC 2018: the first block holds the segment that triggered the ACK,
+    // the others repeat what may have been reported in lost ACKs
+    for_each_range([&] (tcp_option::sack_block b) {
+        if (b.left <= _rcv.last_out_of_order && _rcv.last_out_of_order < b.right) {
+            blocks[nr++] = b;
+            return false;
+        }
+        return true;
+    });
+    for_each_range([&] (tcp_option::sack_block b) {
+        if (nr && b.left == blocks[0].left) {
+            return true;
+        }
+        blocks[nr++] = b;
+        return nr < blocks.size();
+    });
+    return nr;
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::sack_acked(tcp_seq seg_ack, bool new_data_acked) {
+    auto now = sample_clock_type::now();
+    bool newly_sacked = update_scoreboard(now);
+    if (_snd.sack_recovery && seg_ack > _snd.recover) {
+        // RFC 6675: recovery is over once all the data outstanding when it
+        // started is acknowledged
+        _snd.sack_recovery = false;
+        _cc->on_recovery_exit(_snd.cong, _snd.mss, pipe());
+    }
+    detect_losses(now);
+    if (new_data_acked || newly_sacked) {
+        _snd.tlp_out = false;
+        arm_tail_loss_probe(clock_type::now());
+    }
+}
+
+template <typename InetTraits>
+bool tcp<InetTraits>::tcb::update_scoreboard(sample_clock_type::time_point now) {
+    bool newly_sacked = false;
+    for (unsigned i = 0; i < _option._nr_remote_sack_blocks; i++) {
+        auto& b = _option._remote_sack_blocks[i];
+        // Blocks below the cumulative ACK report duplicates (RFC 2883), and
+        // those beyond what was sent are bogus
+        if (b.right <= _snd.unacknowledged || b.right > _snd.next || b.left >= b.right) {
+            continue;
+        }
+        // A segment only counts as SACKed once all of it is
+        auto seq = _snd.unacknowledged;
+        for (auto& seg : _snd.data) {
+            if (seq >= b.right) {
+                break;
+            }
+            auto end = seq + seg.p.len();
+            if (!seg.sacked && b.left <= seq && end <= b.right) {
+                seg.sacked = true;
+                _snd.sacked_bytes += seg.p.len();
+                if (seg.lost) {
+                    seg.lost = false;
+                    _snd.lost_bytes -= seg.p.len();
+                }
+                rack_delivered(seg, end, now);
+                newly_sacked = true;
+            }
+            seq = end;
+        }
+    }
+    _option._nr_remote_sack_blocks = 0;
+    return newly_sacked;
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::rack_delivered(const unacked_segment& seg, tcp_seq end_seq, sample_clock_type::time_point now) {
+    auto rtt = now - seg.tx_time;
+    if (seg.nr_transmits) {
+        // RFC 8985 6.2 step 2: the ACK may be for an earlier transmission,
+        // trust it only if it took about the minimum RTT
+        if (rtt < _rack.min_rtt / 2) {
+            return;
+        }
+    } else {
+        _rack.min_rtt = std::min(_rack.min_rtt, rtt);
+    }
+    if (end_seq > _rack.fack) {
+        _rack.fack = end_seq;
+    } else if (seg.nr_transmits == 0) {
+        // An original transmission delivered after later data was reordered,
+        // not lost
+        _rack.reordering_seen = true;
+    }
+    if (seg.tx_serial > _rack.tx_serial) {
+        _rack.tx_serial = seg.tx_serial;
+        _rack.rtt = rtt;
+    }
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::detect_losses(sample_clock_type::time_point now) {
+    _rack_timer.cancel();
+    // Only segments sent before some SACKed one can be found lost
+    if (!_snd.sacked_bytes) {
+        return;
+    }
+    // RFC 8985 6.2 step 4: until the path shows reordering, losses are
+    // declared as soon as recovery started or RFC 6675 would declare them
+    sample_clock_type::duration reo_wnd{};
+    if (_rack.reordering_seen || (!in_recovery() && _snd.sacked_bytes < _dupthresh * _snd.mss)) {
+        auto min_rtt = _rack.min_rtt == sample_clock_type::duration::max() ? sample_clock_type::duration(_snd.srtt) : _rack.min_rtt;
+        reo_wnd = std::min<sample_clock_type::duration>(min_rtt / 4, _snd.srtt);
+    }
+    sample_clock_type::duration timeout{};
+    uint32_t sacked_above = 0;
+    for (auto it = _snd.data.rbegin(); it != _snd.data.rend(); ++it) {
+        auto& seg = *it;
+        if (seg.sacked) {
+            sacked_above += seg.p.len();
+            continue;
+        }
+        if (seg.lost) {
+            continue;
+        }
+        bool lost = false;
+        if (!_rack.reordering_seen && seg.nr_transmits == 0 && sacked_above > (_dupthresh - 1) * _snd.mss) {
+            // RFC 6675 IsLost(), which RACK supersedes once it saw reordering
+            lost = true;
+        } else if (seg.tx_serial < _rack.tx_serial) {
+            // Sent before a segment that was delivered, and still missing
+            // after an RTT and the reordering window
+            auto deadline = seg.tx_time + _rack.rtt + reo_wnd;
+            if (deadline <= now) {
+                lost = true;
+            } else {
+                timeout = std::max(timeout, deadline - now);
+            }
+        }
+        if (lost) {
+            seg.lost = true;
+            _snd.lost_bytes += seg.p.len();
+        }
+    }
+    if (timeout.count()) {
+        _rack_timer.arm(timeout);
+    }
+    // RFC 6675 step 4: a single window reduction per loss episode, not
+    // overlapping the one after a retransmission timeout
+    if (_snd.lost_bytes && !_snd.sack_recovery && _snd.unacknowledged > _snd.recover) {
+        _snd.recover = _snd.next - 1;
+        _snd.sack_recovery = true;
+        _cc->on_loss(_snd.cong, _snd.mss, flight_size(), now);
+        _snd.cong.cwnd = _snd.cong.ssthresh;
+        _tlp_timer.cancel();
+    }
+}
+
+template <typename InetTraits>
+bool tcp<InetTraits>::tcb::retransmit_lost() {
+    if (!can_retransmit_lost()) {
+        return false;
+    }
+    // RFC 6675 NextSeg() rule 1: the first segment deemed lost
+    auto seq = _snd.unacknowledged;
+    for (auto& seg : _snd.data) {
+        if (seg.lost) {
+            seg.nr_transmits++;
+            retransmit_one(seg, seq);
+            return true;
+        }
+        seq += seg.p.len();
+    }
+    return false;
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::arm_tail_loss_probe(clock_type::time_point now) {
+    // RFC 8985 7.2: a single probe, and none while losses are being repaired
+    if (!sack_enabled() || _snd.data.empty() || in_recovery() || _snd.lost_bytes || _snd.tlp_out) {
+        _tlp_timer.cancel();
+        return;
+    }
+    std::chrono::microseconds pto = 2 * _snd.srtt;
+    if (_snd.data.size() == 1) {
+        // Leave time for the peer's delayed ACK
+        pto = std::max<std::chrono::microseconds>(pto, _snd.srtt * 3 / 2 + _max_ack_delay);
+    }
+    _tlp_timer.rearm(now + std::clamp<std::chrono::microseconds>(pto, _tlp_min, _rto));
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::tail_loss_probe() {
+    if (_snd.data.empty() || in_state(CLOSED)) {
+        return;
+    }
+    // The probe solicits an ACK whose SACK blocks reveal a lost tail to
+    // RACK, rather than waiting for the RTO. New data does it best, as it
+    // isn't a duplicate; the last segment otherwise.
+    _snd.tlp_out = true;
+    if (_snd.unsent_len && can_send() > 0) {
+        output();
+        return;
+    }
+    auto& seg = _snd.data.back();
+    seg.nr_transmits++;
+    retransmit_one(seg, _snd.next - seg.p.len());
+    output();
+}
+
+template <typename InetTraits>
+void tcp<InetTraits>::tcb::update_rto(sample_clock_type::time_point tx_time) {
     // Update RTO according to RFC6298
-    auto R = std::chrono::duration_cast<std::chrono::milliseconds>(clock_type::now() - tx_time);
+    auto R = std::chrono::duration_cast<std::chrono::microseconds>(sample_clock_type::now() - tx_time);
     if (_snd.first_rto_sample) {
         _snd.first_rto_sample = false;
         // RTTVAR <- R/2
@@ -2031,7 +2546,7 @@ void tcp<InetTraits>::tcb::update_rto(clock_type::time_point tx_time) {
         _snd.srtt = _snd.srtt * 7 / 8 +  R / 8;
     }
     // RTO <- SRTT + max(G, K * RTTVAR)
-    _rto =  _snd.srtt + std::max(_rto_clk_granularity, 4 * _snd.rttvar);
+    _rto = std::chrono::duration_cast<std::chrono::milliseconds>(_snd.srtt + std::max<std::chrono::microseconds>(_rto_clk_granularity, 4 * _snd.rttvar));
 
     // Make sure 1 sec << _rto << 60 sec
     _rto = std::max(_rto, _rto_min);
@@ -2039,16 +2554,35 @@ void tcp<InetTraits>::tcb::update_rto(clock_type::time_point tx_time) {
 }
 
 template <typename InetTraits>
-void tcp<InetTraits>::tcb::update_cwnd(uint32_t acked_bytes) {
-    uint32_t smss = _snd.mss;
-    if (_snd.cwnd < _snd.ssthresh) {
-        // In slow start phase
-        _snd.cwnd += std::min(acked_bytes, smss);
-    } else {
-        // In congestion avoidance phase
-        uint32_t round_up = 1;
-        _snd.cwnd += std::max(round_up, smss * smss / _snd.cwnd);
-    }
+void tcp<InetTraits>::tcb::update_cwnd(uint32_t acked_bytes, const unacked_segment* seg) {
+    auto now = sample_clock_type::now();
+    auto prior_delivered = _snd.delivered;
+    sample_clock_type::duration interval{};
+    std::optional<std::chrono::microseconds> rtt;
+    if (seg) {
+        prior_delivered = seg->delivered;
+        interval = now - seg->delivered_time;
+        if (seg->nr_transmits == 0 && !seg->sacked) {
+            rtt = std::chrono::duration_cast<std::chrono::microseconds>(now - seg->tx_time);
+        }
+    }
+    _snd.delivered += acked_bytes;
+    _snd.delivered_time = now;
+    if (_snd.app_limited && _snd.delivered > _snd.app_limited) {
+        _snd.app_limited = 0;
+    }
+    _cc->on_ack(_snd.cong, tcp_congestion_control::ack_sample{
+        .acked_bytes = acked_bytes,
+        .mss = _snd.mss,
+        .in_flight = uint32_t(_snd.next - _snd.unacknowledged),
+        .rtt = rtt,
+        .delivered = _snd.delivered,
+        .prior_delivered = prior_delivered,
+        .interval = interval,
+        .app_limited = seg ? seg->app_limited : _snd.app_limited != 0,
+        .in_recovery = in_recovery(),
+        .now = now,
+    });
 }
 
 template <typename InetTraits>
@@ -2059,6 +2593,9 @@ void tcp<InetTraits>::tcb::cleanup() {
     _rcv.data_size = 0;
     _rcv.data.clear();
     stop_retransmit_timer();
+    _pacing_timer.cancel();
+    _rack_timer.cancel();
+    _tlp_timer.cancel();
     clear_delayed_ack();
     remove_from_tcbs();
 }
@@ -2088,7 +2625,7 @@ tcp_seq tcp<InetTraits>::tcb::get_isn() {
 template <typename InetTraits>
 std::optional<typename InetTraits::l4packet> tcp<InetTraits>::tcb::get_packet() {
     _poll_active = false;
-    if (_packetq.empty()) {
+    if (_packetq.empty() && !retransmit_lost()) {
         output_one();
     }
 
@@ -2100,11 +2637,12 @@ std::optional<typename InetTraits::l4packet> tcp<InetTraits>::tcb::get_packet()
 
     auto p = std::move(_packetq.front());
     _packetq.pop_front();
-    if (!_packetq.empty() || (_snd.dupacks < 3 && can_send() > 0 && (_snd.window > 0))) {
+    if (!_packetq.empty() || (_snd.dupacks < 3 && can_send() > 0 && (_snd.window > 0)) || can_retransmit_lost()) {
         // If there are packets to send in the queue or tcb is allowed to send
         // more add tcp back to polling set to keep sending. In addition, dupacks >= 3
         // is an indication that an segment is lost, stop sending more in this case.
         // Finally - we can't send more until window is opened again.
+        // Segments the SACK scoreboard deems lost go out first.
         output();
     }
     return p;
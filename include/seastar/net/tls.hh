@@ -277,6 +277,15 @@ namespace tls {
          */
         void enable_tls_renegotiation();
 
+        /**
+         * Offload record encryption of outgoing data to the kernel (kTLS)
+         * once the handshake completes. Sessions for which the kernel, the
+         * socket or the negotiated cipher do not support it transparently
+         * keep encrypting in userspace. Received data is always decrypted
+         * in userspace.
+         */
+        void enable_kernel_tls();
+
     private:
         friend class session;
         friend class openssl_session;
@@ -394,6 +403,7 @@ namespace tls {
         void set_minimum_tls_version(tls_version);
         void set_maximum_tls_version(tls_version);
         void enable_tls_renegotiation();
+        void enable_kernel_tls();
 
         void apply_to(certificate_credentials&) const;
 
@@ -423,6 +433,7 @@ namespace tls {
         sstring _ciphersuites;
         bool _enable_server_precedence = false;
         bool _enable_tls_renegotiation = false;
+        bool _enable_kernel_tls = false;
         std::optional<tls_version> _min_tls_version;
         std::optional<tls_version> _max_tls_version;
     };
@@ -0,0 +1,92 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <memory>
+#include <seastar/net/net.hh>
+#include <seastar/core/sstring.hh>
+#include <seastar/util/program-options.hh>
+
+namespace seastar {
+
+namespace net {
+
+/// AF_XDP configuration.
+///
+/// The native stack runs over AF_XDP sockets when \ref xdp_interface is
+/// given: an XDP program redirects the interface's traffic to one socket
+/// per hardware queue, each owned by the shard of the same number, while
+/// the interface stays with its kernel driver.
+struct xdp_options : public program_options::option_group {
+    /// \brief Network interface to take the traffic of.
+    ///
+    /// All the traffic received on the interface's queues that seastar
+    /// serves goes to seastar, none of it to the kernel.
+    program_options::value<std::string> xdp_interface;
+    /// \brief Number of hardware queues to serve, from queue 0 on.
+    ///
+    /// With more than one queue, the interface's RSS key and indirection
+    /// table are reprogrammed, so that the NIC spreads flows over the
+    /// queues as the stack expects, and restored on exit. With a single
+    /// queue, they are left alone and flows are spread over the shards in
+    /// software.
+    ///
+    /// Default: 1.
+    program_options::value<unsigned> xdp_queues;
+    /// \brief Size of the socket rings (must be power-of-two).
+    ///
+    /// Each queue has twice as many frames of memory as the ring size.
+    ///
+    /// Default: 1024.
+    program_options::value<unsigned> xdp_ring_size;
+    /// \brief Size of a frame of packet memory, 2048 or 4096.
+    ///
+    /// Default: 4096.
+    program_options::value<unsigned> xdp_frame_size;
+    /// \brief How the sockets share packet memory with the driver (auto /
+    /// zero-copy / copy).
+    ///
+    /// \p auto uses zero-copy where the driver supports it.
+    ///
+    /// Default: \p auto.
+    program_options::value<std::string> xdp_bind_mode;
+    /// \brief Where the XDP program runs (auto / native / generic).
+    ///
+    /// \p native needs driver support, \p generic works on any interface
+    /// but only in copy mode. \p auto uses native where the driver
+    /// supports it.
+    ///
+    /// Default: \p auto.
+    program_options::value<std::string> xdp_attach_mode;
+
+    /// \cond internal
+    xdp_options(program_options::option_group* parent_group);
+    /// \endcond
+};
+
+}
+
+/// \cond internal
+std::unique_ptr<net::device> create_xdp_net_device(const net::xdp_options& opts);
+/// \endcond
+
+}
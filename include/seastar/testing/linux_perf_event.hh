@@ -49,5 +49,8 @@ class linux_perf_event {
     static linux_perf_event always_zero() { return linux_perf_event(); }
     static linux_perf_event user_instructions_retired();
     static linux_perf_event user_cpu_cycles_retired();
+    /// Data TLB load misses in user mode. Reads as zero where the PMU does
+    /// not expose the generic dTLB cache event (e.g. most virtual machines).
+    static linux_perf_event user_dtlb_load_misses();
 };
 
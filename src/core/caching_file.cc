@@ -0,0 +1,428 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <algorithm>
+#include <cstring>
+#include <limits>
+#include <vector>
+#include <boost/range/irange.hpp>
+
+#include <seastar/core/caching_file.hh>
+#include <seastar/core/layered_file.hh>
+#include <seastar/core/gate.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/util/assert.hh>
+#include <seastar/util/log.hh>
+
+namespace seastar {
+
+extern logger seastar_logger;
+
+class caching_file_impl final : public layered_file_impl {
+    block_cache& _cache;
+    const uint64_t _id;
+    // Bumped when a write starts and when it completes, so that a read
+    // racing with a write doesn't put stale data into the cache
+    uint64_t _generation = 0;
+    unsigned _writes_in_flight = 0;
+    block_cache::file_block_list _blocks;
+    gate _gate;
+
+    friend class block_cache;
+
+    uint64_t block_size() const noexcept { return _cache.block_size(); }
+
+    // Returns the [pos, pos + len) range of the file, shorter if it crosses EOF
+    future<temporary_buffer<char>> read_range(uint64_t pos, size_t len) {
+        if (len == 0) {
+            co_return temporary_buffer<char>();
+        }
+        auto bs = block_size();
+        uint64_t first = pos / bs;
+        uint64_t last = (pos + len - 1) / bs;
+        if (first == last) {
+            auto data = co_await _cache.get_block(*this, first);
+            auto off = pos - first * bs;
+            if (data.size() <= off) {
+                co_return temporary_buffer<char>();
+            }
+            data.trim_front(off);
+            data.trim(std::min(len, data.size()));
+            co_return data;
+        }
+
+        auto result = temporary_buffer<char>::aligned(_memory_dma_alignment, len);
+        uint64_t data_end = pos + len;
+        co_await parallel_for_each(boost::irange(first, last + 1), [this, bs, pos, len, &result, &data_end] (uint64_t idx) {
+            return _cache.get_block(*this, idx).then([bs, pos, len, idx, &result, &data_end] (temporary_buffer<char> data) {
+                uint64_t block_start = idx * bs;
+                if (data.size() < bs) {
+                    data_end = std::min(data_end, block_start + data.size());
+                }
+                auto from = std::max(pos, block_start);
+                auto to = std::min(pos + len, block_start + data.size());
+                if (from < to) {
+                    std::memcpy(result.get_write() + (from - pos), data.get() + (from - block_start), to - from);
+                }
+            });
+        });
+        result.trim(data_end > pos ? data_end - pos : 0);
+        co_return result;
+    }
+
+    void invalidate(uint64_t pos, uint64_t len) noexcept {
+        if (len == 0) {
+            return;
+        }
+        auto bs = block_size();
+        uint64_t first = pos / bs;
+        uint64_t last = len > std::numeric_limits<uint64_t>::max() - pos ? std::numeric_limits<uint64_t>::max() : (pos + len - 1) / bs;
+        static constexpr uint64_t max_lookups = 64;
+        if (last - first < max_lookups) {
+            for (auto idx = first; idx <= last; idx++) {
+                auto it = _cache._blocks.find(block_cache::block_key{_id, idx});
+                if (it != _cache._blocks.end()) {
+                    _cache._stats.invalidations++;
+                    _cache.erase(*it->second);
+                }
+            }
+            return;
+        }
+        for (auto it = _blocks.begin(); it != _blocks.end();) {
+            auto& b = *it++;
+            if (b.key.index >= first && b.key.index <= last) {
+                _cache._stats.invalidations++;
+                _cache.erase(b);
+            }
+        }
+    }
+
+    void drop_all() noexcept {
+        while (!_blocks.empty()) {
+            _cache.erase(_blocks.front());
+        }
+    }
+
+    template <typename Func>
+    future<size_t> do_write(uint64_t pos, size_t len, Func&& write) {
+        _generation++;
+        _writes_in_flight++;
+        invalidate(pos, len);
+        return futurize_invoke(std::forward<Func>(write)).finally([this, pos, len] {
+            invalidate(pos, len);
+            _writes_in_flight--;
+            _generation++;
+        });
+    }
+
+    template <typename Func>
+    future<> do_modify(Func&& modify) {
+        _generation++;
+        _writes_in_flight++;
+        drop_all();
+        return futurize_invoke(std::forward<Func>(modify)).finally([this] {
+            drop_all();
+            _writes_in_flight--;
+            _generation++;
+        });
+    }
+
+public:
+    caching_file_impl(file f, block_cache& cache)
+            : layered_file_impl(std::move(f))
+            , _cache(cache)
+            , _id(cache._next_file_id++)
+    {
+        if (_cache.block_size() % _disk_read_dma_alignment) {
+            throw std::invalid_argument(format("block cache block size {} is not a multiple of the disk read alignment {}",
+                    _cache.block_size(), _disk_read_dma_alignment));
+        }
+    }
+
+    ~caching_file_impl() {
+        drop_all();
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, const void* buffer, size_t len, io_intent* intent) override {
+        return do_write(pos, len, [this, pos, buffer, len, intent] {
+            return _underlying_file.dma_write(pos, reinterpret_cast<const char*>(buffer), len, intent);
+        });
+    }
+
+    virtual future<size_t> write_dma(uint64_t pos, std::vector<iovec> iov, io_intent* intent) override {
+        size_t len = 0;
+        for (auto& v : iov) {
+            len += v.iov_len;
+        }
+        return do_write(pos, len, [this, pos, iov = std::move(iov), intent] () mutable {
+            return _underlying_file.dma_write(pos, std::move(iov), intent);
+        });
+    }
+
+    // Reads of a block are shared by all the misses for it, so a single
+    // caller's intent can't cancel them
+    virtual future<size_t> read_dma(uint64_t pos, void* buffer, size_t len, io_intent*) override {
+        return with_gate(_gate, [this, pos, buffer, len] {
+            return read_range(pos, len).then([buffer] (temporary_buffer<char> data) {
+                std::memcpy(buffer, data.get(), data.size());
+                return data.size();
+            });
+        });
+    }
+
+    virtual future<size_t> read_dma(uint64_t pos, std::vector<iovec> iov, io_intent*) override {
+        size_t len = 0;
+        for (auto& v : iov) {
+            len += v.iov_len;
+        }
+        return with_gate(_gate, [this, pos, len, iov = std::move(iov)] () mutable {
+            return read_range(pos, len).then([iov = std::move(iov)] (temporary_buffer<char> data) {
+                size_t off = 0;
+                for (auto& v : iov) {
+                    if (off == data.size()) {
+                        break;
+                    }
+                    auto n = std::min(v.iov_len, data.size() - off);
+                    std::memcpy(v.iov_base, data.get() + off, n);
+                    off += n;
+                }
+                return off;
+            });
+        });
+    }
+
+    virtual future<temporary_buffer<uint8_t>> dma_read_bulk(uint64_t offset, size_t range_size, io_intent*) override {
+        return with_gate(_gate, [this, offset, range_size] {
+            return read_range(offset, range_size).then([] (temporary_buffer<char> data) {
+                return temporary_buffer<uint8_t>(reinterpret_cast<uint8_t*>(data.get_write()), data.size(), data.release());
+            });
+        });
+    }
+
+    virtual future<> flush() override {
+        return _underlying_file.flush();
+    }
+
+    virtual future<struct stat> stat() override {
+        return _underlying_file.stat();
+    }
+
+    virtual future<> truncate(uint64_t length) override {
+        return do_modify([this, length] { return _underlying_file.truncate(length); });
+    }
+
+    virtual future<> discard(uint64_t offset, uint64_t length) override {
+        return do_write(offset, length, [this, offset, length] {
+            return _underlying_file.discard(offset, length).then([] { return size_t(0); });
+        }).discard_result();
+    }
+
+    virtual future<> allocate(uint64_t position, uint64_t length) override {
+        return _underlying_file.allocate(position, length);
+    }
+
+    virtual future<uint64_t> size() override {
+        return _underlying_file.size();
+    }
+
+    virtual future<> close() override {
+        return _gate.close().then([this] {
+            drop_all();
+            return _underlying_file.close();
+        });
+    }
+
+    virtual subscription<directory_entry> list_directory(std::function<future<> (directory_entry de)> next) override {
+        return _underlying_file.list_directory(std::move(next));
+    }
+};
+
+// Rough per-block bookkeeping cost on top of the data itself
+size_t block_cache::block_memory(const block& b) noexcept {
+    return b.data.size() + sizeof(block) + 64;
+}
+
+bool block_cache::in_use(const block& b) noexcept {
+    return b.owner->refs > 1;
+}
+
+block_cache::block_cache(config cfg)
+        : _cfg(std::move(cfg))
+        , _reclaimer([this] (memory::reclaimer::request r) { return reclaim(r.bytes_to_reclaim); })
+{
+    if (!_cfg.block_size || (_cfg.block_size & (_cfg.block_size - 1))) {
+        throw std::invalid_argument(format("block cache block size {} is not a power of two", _cfg.block_size));
+    }
+
+    namespace sm = seastar::metrics;
+    auto cache_l = sm::label("cache")(_cfg.name);
+    _metrics.add_group("block_cache", {
+        sm::make_counter("hits", _stats.hits, sm::description("Number of block reads served from the cache"), {cache_l}),
+        sm::make_counter("misses", _stats.misses, sm::description("Number of block reads that went to the underlying file"), {cache_l}),
+        sm::make_counter("shared_misses", _stats.shared_misses,
+                sm::description("Number of block reads that waited for the same block being read by another miss"), {cache_l}),
+        sm::make_counter("evictions", _stats.evictions, sm::description("Number of blocks evicted to make room for new ones"), {cache_l}),
+        sm::make_counter("reclaimed", _stats.reclaimed, sm::description("Number of blocks evicted because the shard ran low on memory"), {cache_l}),
+        sm::make_counter("invalidations", _stats.invalidations, sm::description("Number of cached blocks dropped because they were written to"), {cache_l}),
+        sm::make_gauge("memory", [this] { return _memory_used; }, sm::description("Memory used by cached blocks"), {cache_l}),
+        sm::make_gauge("blocks", [this] { return _blocks.size(); }, sm::description("Number of cached blocks"), {cache_l}),
+    });
+}
+
+block_cache::~block_cache() {
+    SEASTAR_ASSERT(_pending.empty());
+    _hand = _clock.end();
+    _blocks.clear();
+}
+
+future<temporary_buffer<char>> block_cache::get_block(caching_file_impl& f, uint64_t index) {
+    block_key key{f._id, index};
+    while (true) {
+        if (auto it = _blocks.find(key); it != _blocks.end()) {
+            _stats.hits++;
+            it->second->referenced = true;
+            co_return it->second->data.share();
+        }
+        auto it = _pending.find(key);
+        if (it == _pending.end()) {
+            break;
+        }
+        // Somebody is reading it already. If it doesn't make it to the
+        // cache (evicted meanwhile or raced with a write) just try again.
+        _stats.shared_misses++;
+        co_await it->second.get_shared_future();
+    }
+
+    _stats.misses++;
+    // Concurrent misses for the block wait on this rather than read it again
+    _pending[key];
+    auto generation = f._generation;
+    auto bs = _cfg.block_size;
+    std::exception_ptr ex;
+    temporary_buffer<char> data;
+    try {
+        data = co_await f._underlying_file.dma_read_bulk<char>(index * bs, bs);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+    // The map may have been rehashed while we waited
+    auto node = _pending.extract(key);
+    if (ex) {
+        node.mapped().set_exception(ex);
+        std::rethrow_exception(ex);
+    }
+    if (generation == f._generation && !f._writes_in_flight) {
+        data = insert(f, index, std::move(data));
+    }
+    node.mapped().set_value();
+    co_return data;
+}
+
+// Returns what the reader that missed gets: a share of the cached block,
+// or data itself if it wasn't cached
+temporary_buffer<char> block_cache::insert(caching_file_impl& f, uint64_t index, temporary_buffer<char> data) {
+    block_key key{f._id, index};
+    if (_blocks.contains(key)) {
+        return data;
+    }
+    auto b = std::make_unique<block>();
+    b->key = key;
+    b->owner = new deleter::impl(deleter());
+    auto buf = data.get_write();
+    auto size = data.size();
+    b->owner->next = data.release();
+    b->data = temporary_buffer<char>(buf, size, deleter(b->owner));
+    auto mem = block_memory(*b);
+    if (mem > _cfg.capacity) {
+        return std::move(b->data);
+    }
+    while (_memory_used + mem > _cfg.capacity && !_blocks.empty()) {
+        evict_one();
+        _stats.evictions++;
+    }
+    auto& ref = *b;
+    _blocks.emplace(key, std::move(b));
+    // New blocks go right behind the hand, so they get a full turn before
+    // being considered for eviction
+    _clock.insert(_hand, ref);
+    f._blocks.push_back(ref);
+    _memory_used += mem;
+    return ref.data.share();
+}
+
+void block_cache::erase(block& b) noexcept {
+    if (_hand != _clock.end() && &*_hand == &b) {
+        ++_hand;
+    }
+    _memory_used -= block_memory(b);
+    _blocks.erase(b.key);
+}
+
+void block_cache::evict_one() noexcept {
+    SEASTAR_ASSERT(!_clock.empty());
+    while (true) {
+        if (_hand == _clock.end()) {
+            _hand = _clock.begin();
+        }
+        auto& b = *_hand;
+        if (b.referenced) {
+            b.referenced = false;
+            ++_hand;
+        } else {
+            erase(b);
+            return;
+        }
+    }
+}
+
+memory::reclaiming_result block_cache::reclaim(size_t bytes) noexcept {
+    size_t before = _memory_used;
+    // Evicting a block readers still hold frees nothing, so those are
+    // skipped. Two turns of the hand at most: the first may only clear the
+    // referenced bits.
+    for (size_t steps = 2 * _blocks.size(); steps && before - _memory_used < bytes; steps--) {
+        if (_hand == _clock.end()) {
+            _hand = _clock.begin();
+        }
+        auto& b = *_hand;
+        if (b.referenced) {
+            b.referenced = false;
+            ++_hand;
+        } else if (in_use(b)) {
+            ++_hand;
+        } else {
+            erase(b);
+            _stats.reclaimed++;
+        }
+    }
+    if (before != _memory_used) {
+        seastar_logger.debug("block cache {}: reclaimed {} bytes", _cfg.name, before - _memory_used);
+        return memory::reclaiming_result::reclaimed_something;
+    }
+    return memory::reclaiming_result::reclaimed_nothing;
+}
+
+file make_caching_file(file f, block_cache& cache) {
+    return file(make_shared<caching_file_impl>(std::move(f), cache));
+}
+
+}
@@ -88,6 +88,12 @@ void disk_config_params::parse_config(const smp_options& smp_opts, const reactor
     seastar_logger.debug("latency_goal: {}", latency_goal().count());
     _flow_ratio_backpressure_threshold = reactor_opts.io_flow_ratio_threshold.get_value();
     seastar_logger.debug("flow-ratio threshold: {}", _flow_ratio_backpressure_threshold);
+    _auto_calibrate = reactor_opts.io_auto_calibrate.get_value();
+    _auto_calibrate_min_ratio = reactor_opts.io_auto_calibrate_min_ratio.get_value();
+    _merge_max_latency = std::chrono::microseconds(reactor_opts.io_merge_max_latency_us.get_value());
+    if (_auto_calibrate_min_ratio <= 0 || _auto_calibrate_min_ratio > 1) {
+        throw std::runtime_error(fmt::format("io-auto-calibrate-min-ratio must be in (0, 1], got {}", _auto_calibrate_min_ratio));
+    }
     _stall_threshold = reactor_opts.io_completion_notify_ms.defaulted() ? std::chrono::milliseconds::max() : reactor_opts.io_completion_notify_ms.get_value() * 1ms;
 
     if (smp_opts.num_io_groups) {
@@ -202,6 +208,10 @@ struct io_queue::config disk_config_params::generate_config(const disk_params& p
     cfg.block_count_limit_min = (64 << 10) >> io_queue::block_size_shift;
     cfg.stall_threshold = stall_threshold();
     cfg.physical_block_size = p.physical_block_size;
+    // Without io-properties there's nothing to calibrate against
+    cfg.auto_calibrate = _auto_calibrate && p.read_req_rate != std::numeric_limits<uint64_t>::max();
+    cfg.auto_calibrate_min_ratio = _auto_calibrate_min_ratio;
+    cfg.merge_max_latency = _merge_max_latency;
 
     return cfg;
 }
@@ -94,12 +94,25 @@ fair_queue_ticket wrapping_difference(const fair_queue_ticket& a, const fair_que
 class fair_queue::priority_class_data final : public priority_entry {
     friend class fair_queue;
     capacity_t _pure_accumulated = 0;
+    uint64_t _deadline_dispatches = 0;
     fair_queue_entry::container_list_t _queue;
+    // Entries with a deadline, earliest first
+    fair_queue_entry::container_list_t _deadline_queue;
+    fair_queue& _fq;
+    // Position in fair_queue::_deadline_heap, or no_deadline_heap_idx
+    size_t _deadline_heap_idx = no_deadline_heap_idx;
 
     bool plug() noexcept;
+    void push_back(fair_queue_entry& ent) noexcept;
+    capacity_t pop_deadline_front() noexcept;
 
 public:
-    explicit priority_class_data(uint32_t shares, priority_class_group_data* p) noexcept : priority_entry(shares, p) {}
+    static constexpr size_t no_deadline_heap_idx = std::numeric_limits<size_t>::max();
+
+    explicit priority_class_data(uint32_t shares, priority_class_group_data* p, fair_queue& fq) noexcept
+        : priority_entry(shares, p)
+        , _fq(fq)
+    {}
     priority_class_data(const priority_class_data&) = delete;
     priority_class_data(priority_class_data&&) = delete;
 
@@ -108,14 +121,55 @@ class fair_queue::priority_class_data final : public priority_entry {
 };
 
 fair_queue_entry* fair_queue::priority_class_data::top() {
-    return (_plugged && !_queue.empty()) ? &_queue.front() : nullptr;
+    if (!_plugged) {
+        return nullptr;
+    }
+    if (!_deadline_queue.empty()) {
+        return &_deadline_queue.front();
+    }
+    return !_queue.empty() ? &_queue.front() : nullptr;
+}
+
+void fair_queue::priority_class_data::push_back(fair_queue_entry& ent) noexcept {
+    if (!ent.has_deadline()) {
+        _queue.push_back(ent);
+        return;
+    }
+    // Deadlines mostly come from timeouts and thus arrive in order
+    if (_deadline_queue.empty() || _deadline_queue.back()._deadline <= ent._deadline) {
+        _deadline_queue.push_back(ent);
+        if (&_deadline_queue.front() == &ent) {
+            _fq.update_deadline_heap(*this);
+        }
+        return;
+    }
+    auto prev = _deadline_queue.before_begin();
+    while (std::next(prev)->_deadline <= ent._deadline) {
+        ++prev;
+    }
+    _deadline_queue.insert_after(prev, ent);
+    if (&_deadline_queue.front() == &ent) {
+        _fq.update_deadline_heap(*this);
+    }
+}
+
+fair_queue_entry::capacity_t fair_queue::priority_class_data::pop_deadline_front() noexcept {
+    auto req_cap = _deadline_queue.front()._capacity;
+    _deadline_queue.pop_front();
+    _fq.update_deadline_heap(*this);
+    return req_cap;
 }
 
 std::pair<bool, fair_queue_entry::capacity_t> fair_queue::priority_class_data::pop_front() {
-    auto req_cap = _queue.front()._capacity;
+    capacity_t req_cap;
+    if (!_deadline_queue.empty()) {
+        req_cap = pop_deadline_front();
+    } else {
+        req_cap = _queue.front()._capacity;
+        _queue.pop_front();
+    }
     _pure_accumulated += req_cap;
-    _queue.pop_front();
-    return std::make_pair(_queue.empty(), req_cap);
+    return std::make_pair(_queue.empty() && _deadline_queue.empty(), req_cap);
 }
 
 bool fair_queue::class_compare::operator() (const priority_entry_ptr& lhs, const priority_entry_ptr& rhs) const noexcept {
@@ -149,6 +203,7 @@ void fair_queue::priority_class_group_data::push_from_idle(priority_entry& pc, c
     // introduce extra if's for that short corner case, use signed
     // arithmetics and make sure the _accumulated value doesn't grow
     // over signed maximum (see overflow check below)
+    pc._accumulated += std::exchange(pc._borrowed, 0);
     pc._accumulated = std::max<signed_capacity_t>(_last_accumulated - cfg.forgiving_factor / pc._shares, pc._accumulated);
     _children.assert_enough_capacity();
     _children.push(&pc);
@@ -160,7 +215,7 @@ void fair_queue::priority_class_group_data::push_from_idle(priority_entry& pc, c
 bool fair_queue::priority_class_data::plug() noexcept {
     SEASTAR_ASSERT(!_plugged);
     _plugged = true;
-    return !_queue.empty();
+    return !_queue.empty() || !_deadline_queue.empty();
 }
 
 bool fair_queue::priority_class_group_data::plug() noexcept {
@@ -208,6 +263,10 @@ unsigned fair_queue::activations(class_id cid) const noexcept {
     return _priority_classes[cid]->_activations;
 }
 
+uint64_t fair_queue::deadline_dispatches(class_id cid) const noexcept {
+    return _priority_classes[cid]->_deadline_dispatches;
+}
+
 void fair_queue::register_priority_class(class_id id, uint32_t shares, std::optional<unsigned> group) {
     if (id >= _priority_classes.size()) {
         _priority_classes.resize(id + 1);
@@ -218,7 +277,8 @@ void fair_queue::register_priority_class(class_id id, uint32_t shares, std::opti
     priority_class_group_data* pg = !group.has_value() ? &_root : _priority_groups[*group].get();
 
     pg->reserve();
-    _priority_classes[id] = std::make_unique<priority_class_data>(shares, pg);
+    _deadline_heap.reserve(_priority_classes.size());
+    _priority_classes[id] = std::make_unique<priority_class_data>(shares, pg, *this);
     pg->_nr_children++;
 }
 
@@ -258,7 +318,7 @@ void fair_queue::queue(class_id id, fair_queue_entry& ent) noexcept {
     if (pc._plugged) {
         pc.wakeup(_config);
     }
-    pc._queue.push_back(ent);
+    pc.push_back(ent);
     _queued_capacity += ent.capacity();
 }
 
@@ -268,9 +328,95 @@ void fair_queue::notify_request_cancelled(fair_queue_entry& ent) noexcept {
 }
 
 fair_queue_entry* fair_queue::top() {
+    _urgent = nullptr;
+    if (!_deadline_heap.empty() && _config.deadline_slack != 0) {
+        _urgent = find_urgent_class();
+        if (_urgent != nullptr) {
+            return &_urgent->_deadline_queue.front();
+        }
+    }
     return _root.top();
 }
 
+// Checks whether the class with the earliest deadline is urgent and can be
+// served without getting it, or any group it's in, more than deadline_slack
+// ahead of the entry its parent would serve otherwise
+fair_queue::priority_class_data* fair_queue::find_urgent_class() noexcept {
+    auto* pc = _deadline_heap.front();
+    auto& ent = pc->_deadline_queue.front();
+    auto now = clock_type::now();
+    if (ent._deadline > now + _config.deadline_urgency) {
+        return nullptr;
+    }
+    // An expired entry will be cancelled by the caller (see
+    // io_queue::poll_io_queue()) rather than dispatched, and costs nothing
+    auto cap = ent._deadline <= now ? 0 : ent._capacity;
+
+    for (priority_entry* e = pc; e != &_root; e = e->_parent) {
+        auto& siblings = e->_parent->_children;
+        if (!e->_plugged || !e->_queued || siblings.empty()) {
+            return nullptr;
+        }
+        auto cost = cap ? std::max(cap / e->_shares, (capacity_t)1) : 0;
+        if (e->_accumulated + e->_borrowed + cost > siblings.top()->_accumulated + _config.deadline_slack / e->_shares) {
+            return nullptr;
+        }
+    }
+    return pc;
+}
+
+bool fair_queue::deadline_heap_less(size_t a, size_t b) const noexcept {
+    return _deadline_heap[a]->_deadline_queue.front()._deadline < _deadline_heap[b]->_deadline_queue.front()._deadline;
+}
+
+void fair_queue::deadline_heap_swap(size_t a, size_t b) noexcept {
+    std::swap(_deadline_heap[a], _deadline_heap[b]);
+    _deadline_heap[a]->_deadline_heap_idx = a;
+    _deadline_heap[b]->_deadline_heap_idx = b;
+}
+
+// Called whenever the front of a class' deadline queue changes
+void fair_queue::update_deadline_heap(priority_class_data& pc) noexcept {
+    auto idx = pc._deadline_heap_idx;
+    if (pc._deadline_queue.empty()) {
+        if (idx == priority_class_data::no_deadline_heap_idx) {
+            return;
+        }
+        pc._deadline_heap_idx = priority_class_data::no_deadline_heap_idx;
+        auto last = _deadline_heap.size() - 1;
+        if (idx == last) {
+            _deadline_heap.pop_back();
+            return;
+        }
+        _deadline_heap[idx] = _deadline_heap[last];
+        _deadline_heap[idx]->_deadline_heap_idx = idx;
+        _deadline_heap.pop_back();
+    } else if (idx == priority_class_data::no_deadline_heap_idx) {
+        // Doesn't allocate, register_priority_class() reserved room for every class
+        idx = _deadline_heap.size();
+        _deadline_heap.push_back(&pc);
+        pc._deadline_heap_idx = idx;
+    }
+    // Sift up, then down
+    while (idx > 0 && deadline_heap_less(idx, (idx - 1) / 2)) {
+        deadline_heap_swap(idx, (idx - 1) / 2);
+        idx = (idx - 1) / 2;
+    }
+    while (true) {
+        auto smallest = idx;
+        for (auto child : {2 * idx + 1, 2 * idx + 2}) {
+            if (child < _deadline_heap.size() && deadline_heap_less(child, smallest)) {
+                smallest = child;
+            }
+        }
+        if (smallest == idx) {
+            break;
+        }
+        deadline_heap_swap(idx, smallest);
+        idx = smallest;
+    }
+}
+
 fair_queue_entry* fair_queue::priority_class_group_data::top() {
     if (!_plugged) {
         return nullptr;
@@ -283,6 +429,7 @@ fair_queue_entry* fair_queue::priority_class_group_data::top() {
             SEASTAR_ASSERT(h._queued);
             h._queued = false;
             _children.pop();
+            h._accumulated += std::exchange(h._borrowed, 0);
             continue;
         }
 
@@ -293,6 +440,20 @@ fair_queue_entry* fair_queue::priority_class_group_data::top() {
 }
 
 void fair_queue::pop_front() {
+    if (_urgent != nullptr) {
+        auto& pc = *std::exchange(_urgent, nullptr);
+        auto req_cap = pc.pop_deadline_front();
+        pc._pure_accumulated += req_cap;
+        pc._deadline_dispatches++;
+        // The class stays where it is in its parent's queue, so it can't be
+        // charged now without breaking the heap order; it (and its groups)
+        // pay when they are next taken out of their parents' queues
+        for (priority_entry* e = &pc; req_cap && e != &_root; e = e->_parent) {
+            e->_borrowed += std::max(req_cap / e->_shares, (capacity_t)1);
+        }
+        _queued_capacity -= req_cap;
+        return;
+    }
     auto [empty, req_cap] = _root.pop_front();
     _queued_capacity -= req_cap;
 }
@@ -308,8 +469,9 @@ std::pair<bool, fair_queue_entry::capacity_t> fair_queue::priority_class_group_d
     // Usually the cost of request is tens to hundreeds of thousands. However, for
     // unrestricted queue it can be as low as 2k. With large enough shares this
     // has chances to be translated into zero cost which, in turn, will make the
-    // class show no progress and monopolize the queue.
-    auto req_cost  = std::max(req_cap / h._shares, (capacity_t)1);
+    // class show no progress and monopolize the queue. Entries with no capacity
+    // (cancelled or expired) were never dispatched and cost nothing.
+    auto req_cost = (req_cap ? std::max(req_cap / h._shares, (capacity_t)1) : 0) + std::exchange(h._borrowed, 0);
     h._accumulated += req_cost;
 
     // signed overflow check to make push_priority_class_from_idle math work
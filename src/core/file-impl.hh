@@ -128,6 +128,12 @@ class posix_file_impl : public file_impl {
         return _open_flags;
     }
 
+    // Allocates a buffer suitable for DMA, preferring memory registered
+    // with the reactor backend for fixed-buffer I/O when there is some left.
+    // Internal reads pass keep_reserve so they don't drain the registered
+    // memory, see reactor_backend::allocate_registered_buffer().
+    static temporary_buffer<uint8_t> allocate_dma_buffer(size_t size, size_t alignment, bool keep_reserve);
+
     // can be moved to private once reactor::read_directory is removed
     static future<size_t> read_directory(int fd, char* buffer, size_t buffer_size);
     // can be moved to private once reactor::fdatasync is removed
@@ -73,9 +73,11 @@
 #include <seastar/util/internal/iovec_utils.hh>
 #include <seastar/core/io_queue.hh>
 #include <seastar/core/queue.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/coroutine/as_future.hh>
 #include <seastar/coroutine/exception.hh>
 #include "core/file-impl.hh"
+#include "core/reactor_backend.hh"
 #include "core/syscall_result.hh"
 #include "core/thread_pool.hh"
 
@@ -243,6 +245,8 @@ reactor::fdatasync(int fd) noexcept {
 }
 
 future<> posix_file_impl::fdatasync(bool with_aio, int fd, internal::io_sink& sink) {
+    auto& stats = reactor::io_stats::local();
+    (with_aio ? stats.native_file_ops : stats.pool_file_ops)[size_t(reactor::io_stats::file_op::fdatasync)]++;
     if (with_aio) {
         // Does not go through the I/O queue, but has to be deleted
         struct fsync_io_desc final : public io_completion {
@@ -281,6 +285,14 @@ future<> posix_file_impl::fdatasync(bool with_aio, int fd, internal::io_sink& si
 
 future<struct stat>
 posix_file_impl::stat() noexcept {
+    if (engine().use_native_file_op(reactor::io_stats::file_op::stat)) {
+        struct stat st;
+        auto ret = wrap_kernel_result(co_await engine().native_stat(_fd, "", AT_EMPTY_PATH, st), st);
+        if (ret.failed()) {
+            co_return coroutine::exception(ret.make_system_error_ptr());
+        }
+        co_return ret.extra;
+    }
     auto ret = co_await engine()._thread_pool->submit<syscall_result_extra<struct stat>>(
             internal::thread_pool_submit_reason::file_operation, [fd = _fd] {
         struct stat st;
@@ -295,6 +307,15 @@ posix_file_impl::stat() noexcept {
 
 future<struct stat>
 posix_file_impl::statat(std::string_view name, int flags) noexcept {
+    if (engine().use_native_file_op(reactor::io_stats::file_op::stat)) {
+        struct stat st;
+        auto path = sstring(name);
+        auto ret = wrap_kernel_result(co_await engine().native_stat(_fd, path.c_str(), flags, st), st);
+        if (ret.failed()) {
+            co_return coroutine::exception(ret.make_system_error_ptr());
+        }
+        co_return ret.extra;
+    }
     auto ret = co_await engine()._thread_pool->submit<syscall_result_extra<struct stat>>(
             internal::thread_pool_submit_reason::file_operation, [fd = _fd, name = sstring(name), flags] {
         struct stat st;
@@ -384,6 +405,19 @@ posix_file_impl::allocate(uint64_t position, uint64_t length) noexcept {
     if (!supported) {
         co_return;
     }
+    if (engine().use_native_file_op(reactor::io_stats::file_op::fallocate)) {
+        auto res = co_await engine().submit_native_file_op(
+                internal::io_request::make_fallocate(_fd, FALLOC_FL_ZERO_RANGE|FALLOC_FL_KEEP_SIZE, position, length));
+        if (res == -EOPNOTSUPP) {
+            supported = false;
+            co_return;
+        }
+        auto sr = wrap_kernel_result(res);
+        if (sr.failed()) {
+            co_await coroutine::return_exception_ptr(sr.make_system_error_ptr());
+        }
+        co_return;
+    }
     auto sr = co_await engine()._thread_pool->submit<syscall_result<int>>(
             internal::thread_pool_submit_reason::file_operation, [this, position, length] () mutable {
         auto ret = ::fallocate(_fd, FALLOC_FL_ZERO_RANGE|FALLOC_FL_KEEP_SIZE, position, length);
@@ -653,14 +687,27 @@ posix_file_real_impl::dup() {
     return posix_file_impl::do_dup<posix_file_real_impl>();
 }
 
+temporary_buffer<uint8_t>
+posix_file_impl::allocate_dma_buffer(size_t size, size_t alignment, bool keep_reserve) {
+    // Registered buffers are page aligned, which satisfies any alignment
+    // the kernel may ask for on O_DIRECT files.
+    if (alignment <= 4096) {
+        auto buf = engine()._backend->allocate_registered_buffer(size, keep_reserve);
+        if (buf.size()) {
+            return temporary_buffer<uint8_t>(reinterpret_cast<uint8_t*>(buf.get_write()), buf.size(), buf.release());
+        }
+    }
+    return temporary_buffer<uint8_t>::aligned(alignment, size);
+}
+
 future<temporary_buffer<uint8_t>>
 posix_file_impl::dma_read_bulk(uint64_t offset, size_t range_size, io_intent* intent) noexcept {
     auto front = offset & (_disk_read_dma_alignment - 1);
     offset -= front;
     range_size += front;
 
-    temporary_buffer<uint8_t> buf = temporary_buffer<uint8_t>::aligned(
-            _memory_dma_alignment, align_up(range_size, size_t(_disk_read_dma_alignment)));
+    temporary_buffer<uint8_t> buf = allocate_dma_buffer(
+            align_up(range_size, size_t(_disk_read_dma_alignment)), _memory_dma_alignment, true);
 
     //
     // First, try to read directly into the buffer. Most of the reads will
@@ -708,8 +755,8 @@ posix_file_impl::read_maybe_eof(uint64_t pos, size_t len, io_intent* intent) {
     // We have to allocate a new aligned buffer to make sure we don't get
     // an EINVAL error due to unaligned destination buffer.
     //
-    temporary_buffer<uint8_t> buf = temporary_buffer<uint8_t>::aligned(
-               _memory_dma_alignment, align_up(len, size_t(_disk_read_dma_alignment)));
+    temporary_buffer<uint8_t> buf = allocate_dma_buffer(
+               align_up(len, size_t(_disk_read_dma_alignment)), _memory_dma_alignment, true);
 
     // try to read a single bulk from the given position
     auto dst = buf.get_write();
@@ -1524,6 +1571,71 @@ file::dma_read_bulk_impl(uint64_t offset, size_t range_size, io_intent* intent)
   }
 }
 
+future<std::vector<temporary_buffer<uint8_t>>>
+file::dma_read_ranges_impl(std::span<const read_range> ranges, size_t max_gap, io_intent* intent) noexcept {
+    // Ranges are coalesced, in offset order, into groups read with a single
+    // dma_read_bulk() each. Everything needed from \c ranges is copied out
+    // before the first suspension point, the caller's span may not outlive it.
+    struct group {
+        uint64_t offset;
+        uint64_t end;
+    };
+    struct slice {
+        unsigned group;
+        uint64_t offset; // within the group
+        size_t size;
+    };
+    std::vector<unsigned> order;
+    order.reserve(ranges.size());
+    for (unsigned i = 0; i < ranges.size(); i++) {
+        if (ranges[i].size) {
+            order.push_back(i);
+        }
+    }
+    std::ranges::sort(order, {}, [ranges] (unsigned i) { return ranges[i].offset; });
+
+    const uint64_t align = disk_read_dma_alignment();
+    const uint64_t max_length = std::max<uint64_t>(disk_read_max_length(), align);
+    std::vector<group> groups;
+    std::vector<slice> slices(ranges.size(), slice{0, 0, 0});
+    for (auto i : order) {
+        auto& r = ranges[i];
+        auto end = r.offset + r.size;
+        if (!groups.empty()) {
+            auto& g = groups.back();
+            auto new_end = std::max(g.end, end);
+            if (align_down(r.offset, align) <= align_up(g.end, align) + max_gap
+                    && align_up(new_end, align) - align_down(g.offset, align) <= max_length) {
+                g.end = new_end;
+                slices[i] = slice{unsigned(groups.size() - 1), r.offset - g.offset, r.size};
+                continue;
+            }
+        }
+        groups.push_back(group{r.offset, end});
+        slices[i] = slice{unsigned(groups.size() - 1), 0, r.size};
+    }
+
+    std::vector<future<temporary_buffer<uint8_t>>> reads;
+    reads.reserve(groups.size());
+    for (auto& g : groups) {
+        reads.push_back(dma_read_bulk_impl(g.offset, g.end - g.offset, intent));
+    }
+    auto bufs = co_await when_all_succeed(reads.begin(), reads.end());
+
+    std::vector<temporary_buffer<uint8_t>> ret;
+    ret.reserve(slices.size());
+    for (auto& s : slices) {
+        if (!s.size || s.offset >= bufs[s.group].size()) {
+            // Empty range, or past EOF
+            ret.emplace_back();
+            continue;
+        }
+        auto& buf = bufs[s.group];
+        ret.push_back(buf.share(s.offset, std::min<uint64_t>(s.size, buf.size() - s.offset)));
+    }
+    co_return ret;
+}
+
 future<> file::discard(uint64_t offset, uint64_t length) noexcept {
   try {
     return _file_impl->discard(offset, length);
@@ -1630,6 +1742,11 @@ file::dma_read_impl(uint64_t aligned_pos, uint8_t* aligned_buffer, size_t aligne
   }
 }
 
+temporary_buffer<uint8_t>
+file::allocate_registered_buffer_impl(size_t size) {
+    return posix_file_impl::allocate_dma_buffer(size, memory_dma_alignment(), false);
+}
+
 seastar::file_handle
 file::dup() {
     return seastar::file_handle(_file_impl->dup());
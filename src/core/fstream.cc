@@ -24,6 +24,7 @@
 #include <fmt/ostream.h>
 #include <malloc.h>
 #include <string.h>
+#include <cmath>
 #include <fcntl.h>
 #include <filesystem>
 #include <ratio>
@@ -73,15 +74,35 @@ static inline T select_buffer_size(T configured_value, T maximum_value) noexcept
     }
 }
 
+// Memory budget shared by all adaptive read-ahead streams of a shard,
+// zero stands for the default
+static thread_local size_t read_ahead_budget = 0;
+
+void set_file_input_stream_read_ahead_budget(size_t bytes) noexcept {
+    read_ahead_budget = bytes;
+}
+
+static size_t get_read_ahead_budget() noexcept {
+    if (!read_ahead_budget) {
+        auto total = memory::stats().total_memory();
+        read_ahead_budget = total ? total / 32 : size_t(64) << 20;
+    }
+    return read_ahead_budget;
+}
+
 class file_data_source_impl : public data_source_impl {
     struct issued_read {
         uint64_t _pos;
         uint64_t _size;
         future<temporary_buffer<char>> _ready;
+        // Charged against the shard's read-ahead budget
+        uint64_t _reserved;
 
-        issued_read(uint64_t pos, uint64_t size, future<temporary_buffer<char>> f)
-            : _pos(pos), _size(size), _ready(std::move(f)) { }
+        issued_read(uint64_t pos, uint64_t size, future<temporary_buffer<char>> f, uint64_t reserved = 0)
+            : _pos(pos), _size(size), _ready(std::move(f)), _reserved(reserved) { }
     };
+    using clock_type = std::chrono::steady_clock;
+    static constexpr unsigned max_adaptive_read_ahead = 64;
 
     reactor::io_stats& _stats = reactor::io_stats::local();
     file _file;
@@ -97,7 +118,46 @@ class file_data_source_impl : public data_source_impl {
     bool _in_slow_start = false;
     io_intent _intent;
     using unused_ratio_target = std::ratio<25, 100>;
+    // Adaptive read-ahead: moving averages of how long a read takes and how
+    // long the consumer spends on a buffer
+    std::chrono::duration<double> _read_latency{0};
+    std::chrono::duration<double> _consume_time{0};
+    clock_type::time_point _last_get;
 private:
+    static void update_average(std::chrono::duration<double>& avg, std::chrono::duration<double> sample) noexcept {
+        avg = avg.count() > 0 ? avg * 0.75 + sample * 0.25 : sample;
+    }
+
+    // Keeps enough reads in flight that the next buffer is ready by the time
+    // the consumer is done with the current one, i.e. read latency divided
+    // by the time spent per buffer. Grows at once when the consumer has to
+    // wait and shrinks one read at a time when fewer would do.
+    void adapt_read_ahead() {
+        auto now = clock_type::now();
+        auto max_read_ahead = _options.read_ahead ? _options.read_ahead : max_adaptive_read_ahead;
+        bool starving = !_read_buffers.empty() && !_read_buffers.front()._ready.available();
+        if (starving) {
+            _current_read_ahead = std::min(_current_read_ahead + 1, max_read_ahead);
+        } else if (_last_get != clock_type::time_point()) {
+            update_average(_consume_time, now - _last_get);
+            if (_consume_time.count() > 0 && _read_latency.count() > 0) {
+                auto needed = unsigned(std::min<double>(std::ceil(_read_latency / _consume_time), max_read_ahead));
+                if (needed > _current_read_ahead) {
+                    _current_read_ahead++;
+                } else if (needed + 1 < _current_read_ahead) {
+                    _current_read_ahead--;
+                }
+            }
+        }
+        // Waiting for the read isn't consumer time, so skip the next sample
+        _last_get = starving ? clock_type::time_point() : now;
+    }
+
+    void release_budget(issued_read& r) noexcept {
+        _stats.fstream_read_ahead_memory -= r._reserved;
+        r._reserved = 0;
+    }
+
     size_t minimal_buffer_size() const {
         return std::min(std::max(_options.buffer_size / 4, size_t(8192)), _options.buffer_size);
     }
@@ -115,6 +175,9 @@ class file_data_source_impl : public data_source_impl {
         }
     }
     unsigned get_initial_read_ahead() const {
+        if (_options.adaptive_read_ahead) {
+            return 1;
+        }
         return _options.dynamic_adjustments
                ? std::min(_options.dynamic_adjustments->read_ahead, _options.read_ahead)
                : !!_options.read_ahead;
@@ -219,12 +282,15 @@ class file_data_source_impl : public data_source_impl {
         SEASTAR_ASSERT(_reads_in_progress == 0);
     }
     virtual future<temporary_buffer<char>> get() override {
-        if (!_read_buffers.empty() && !_read_buffers.front()._ready.available()) {
+        if (_options.adaptive_read_ahead) {
+            adapt_read_ahead();
+        } else if (!_read_buffers.empty() && !_read_buffers.front()._ready.available()) {
             try_increase_read_ahead();
         }
         issue_read_aheads(1);
         auto ret = std::move(_read_buffers.front());
         _read_buffers.pop_front();
+        release_budget(ret);
         update_history_consumed(ret._size);
         _stats.fstream_reads += 1;
         _stats.fstream_read_bytes += ret._size;
@@ -254,6 +320,7 @@ class file_data_source_impl : public data_source_impl {
                 break;
             } else {
                 ignore_read_future(std::move(front._ready));
+                release_budget(front);
                 n -= front._size;
                 dropped += front._size;
                 _stats.fstream_read_aheads_discarded += 1;
@@ -277,6 +344,7 @@ class file_data_source_impl : public data_source_impl {
                 _stats.fstream_read_ahead_discarded_bytes += c._size;
                 dropped += c._size;
                 ignore_read_future(std::move(c._ready));
+                release_budget(c);
             }
             update_history_unused(dropped);
             return std::move(_dropped_reads);
@@ -297,7 +365,6 @@ class file_data_source_impl : public data_source_impl {
                 _read_buffers.emplace_back(_pos, 0, make_ready_future<temporary_buffer<char>>());
                 continue;
             }
-            ++_reads_in_progress;
             // if _pos is not dma-aligned, we'll get a short read.  Account for that.
             // Also avoid reading beyond _remain.
             uint64_t align = _file.disk_read_dma_alignment();
@@ -305,11 +372,25 @@ class file_data_source_impl : public data_source_impl {
             auto end = std::min(align_up(start + _current_buffer_size, align), _pos + _remain);
             auto len = end - start;
             auto actual_size = std::min(end - _pos, _remain);
+            uint64_t reserved = 0;
+            if (_options.adaptive_read_ahead && !_read_buffers.empty()) {
+                // A read-ahead, rather than the read the consumer is waiting for
+                if (_stats.fstream_read_ahead_memory + len > get_read_ahead_budget()) {
+                    _stats.fstream_read_aheads_denied++;
+                    return;
+                }
+                reserved = len;
+                _stats.fstream_read_ahead_memory += reserved;
+            }
+            ++_reads_in_progress;
             _read_buffers.emplace_back(_pos, actual_size, futurize_invoke([&] {
                     return _file.dma_read_bulk_impl(start, len, &_intent);
             }).then_wrapped(
-                    [this, start, pos = _pos, remain = _remain] (future<temporary_buffer<uint8_t>> ret) {
+                    [this, start, pos = _pos, remain = _remain, issued = clock_type::now()] (future<temporary_buffer<uint8_t>> ret) {
                 --_reads_in_progress;
+                if (_options.adaptive_read_ahead) {
+                    update_average(_read_latency, clock_type::now() - issued);
+                }
                 if (_done && !_reads_in_progress) {
                     _done->set_value();
                 }
@@ -331,7 +412,7 @@ class file_data_source_impl : public data_source_impl {
                     }
                     return make_ready_future<temporary_buffer<char>>(temporary_buffer<char>(reinterpret_cast<char*>(tmp.get_write()), tmp.size(), tmp.release()));
                 }
-            }));
+            }), reserved);
             _remain -= end - _pos;
             _pos = end;
         };
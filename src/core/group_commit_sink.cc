@@ -0,0 +1,187 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <algorithm>
+#include <stdexcept>
+#include <system_error>
+#include <seastar/core/group_commit_sink.hh>
+#include <seastar/core/align.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/coroutine/exception.hh>
+#include <seastar/util/assert.hh>
+
+namespace seastar {
+
+group_commit_sink::group_commit_sink(file f, uint64_t pos, group_commit_sink_options opts)
+        : _file(std::move(f))
+        , _opts(opts)
+        , _alignment(_file.disk_write_dma_alignment())
+        , _pos(pos)
+        , _end(pos)
+        , _tail_loaded(pos % _alignment == 0)
+        , _timer([this] { maybe_commit(); })
+{
+}
+
+group_commit_sink::~group_commit_sink() {
+    // A batch in flight refers to the sink
+    SEASTAR_ASSERT(!_committing);
+}
+
+future<> group_commit_sink::append(temporary_buffer<char> record) noexcept {
+    if (_failed) {
+        return make_exception_future<>(_failed);
+    }
+    if (_closing) {
+        return make_exception_future<>(std::logic_error("group_commit_sink: append after close"));
+    }
+    try {
+        auto size = record.size();
+        auto& r = _pending.emplace_back(std::move(record), promise<>(), clock_type::now());
+        auto f = r.pr.get_future();
+        _pending_bytes += size;
+        _end += size;
+        maybe_commit();
+        return f;
+    } catch (...) {
+        return current_exception_as_future();
+    }
+}
+
+void group_commit_sink::maybe_commit() noexcept {
+    if (_committing || _pending.empty()) {
+        return;
+    }
+    auto deadline = _pending.front().arrival + _opts.max_delay;
+    if (!_closing && _pending_bytes < _opts.max_batch_size && clock_type::now() < deadline) {
+        if (!_timer.armed()) {
+            _timer.arm(deadline);
+        }
+        return;
+    }
+    _timer.cancel();
+
+    // The batch is a prefix of _pending; its records stay there until
+    // they are resolved, so that committing doesn't need to allocate.
+    size_t count = 0;
+    size_t bytes = 0;
+    for (auto& r : _pending) {
+        if (count && bytes + r.data.size() > _opts.max_batch_size) {
+            break;
+        }
+        count++;
+        bytes += r.data.size();
+    }
+    _committing = true;
+    (void)commit(count, bytes);
+}
+
+future<> group_commit_sink::commit(size_t count, size_t bytes) noexcept {
+    std::exception_ptr ex;
+    try {
+        co_await write_and_sync(count, bytes);
+    } catch (...) {
+        ex = std::current_exception();
+    }
+
+    if (ex) {
+        // Later records can't become durable without the failed ones
+        _failed = ex;
+        count = _pending.size();
+    } else {
+        _pos += bytes;
+        _stats.records += count;
+        _stats.bytes += bytes;
+        _stats.batches++;
+    }
+    for (size_t i = 0; i < count; i++) {
+        auto& r = _pending.front();
+        if (ex) {
+            r.pr.set_exception(ex);
+        } else {
+            r.pr.set_value();
+        }
+        _pending_bytes -= r.data.size();
+        _pending.pop_front();
+    }
+
+    _committing = false;
+    maybe_commit();
+    if (!_committing && _drained) {
+        _drained->set_value();
+    }
+}
+
+future<> group_commit_sink::write_and_sync(size_t count, size_t bytes) {
+    auto start = align_down(_pos, _alignment);
+    size_t tail = _pos - start;
+    if (!_tail_loaded) {
+        _tail = co_await _file.dma_read_exactly<char>(start, tail);
+        _tail_loaded = true;
+    }
+
+    size_t len = tail + bytes;
+    auto buf = temporary_buffer<char>::aligned(_file.memory_dma_alignment(), align_up(len, size_t(_alignment)));
+    auto p = std::copy_n(_tail.get(), tail, buf.get_write());
+    for (size_t i = 0; i < count; i++) {
+        auto& data = _pending[i].data;
+        p = std::copy(data.begin(), data.end(), p);
+    }
+    std::fill(p, buf.get_write() + buf.size(), 0);
+
+    size_t written = 0;
+    while (written < buf.size()) {
+        auto n = co_await _file.dma_write(start + written, buf.get() + written, buf.size() - written);
+        if (n == 0) {
+            throw std::system_error(EIO, std::system_category(), "group_commit_sink: short write");
+        }
+        written += n;
+    }
+    co_await _file.flush();
+
+    auto tail_len = len % _alignment;
+    _tail = temporary_buffer<char>(buf.get() + len - tail_len, tail_len);
+    _stats.bytes_written += buf.size();
+}
+
+future<> group_commit_sink::close() noexcept {
+    _closing = true;
+    maybe_commit();
+    if (_committing) {
+        _drained.emplace();
+        co_await _drained->get_future();
+    }
+
+    std::exception_ptr ex = _failed;
+    if (!ex) {
+        try {
+            co_await _file.truncate(_pos);
+        } catch (...) {
+            ex = std::current_exception();
+        }
+    }
+    co_await _file.close();
+    if (ex) {
+        co_await coroutine::return_exception_ptr(std::move(ex));
+    }
+}
+
+}
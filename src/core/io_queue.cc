@@ -21,9 +21,11 @@
 
 
 #include <array>
+#include <climits>
 #include <chrono>
 #include <cstdint>
 #include <mutex>
+#include <span>
 #include <utility>
 #include <fmt/format.h>
 #include <fmt/ostream.h>
@@ -40,8 +42,10 @@
 #include <seastar/core/when_all.hh>
 #include <seastar/core/metrics.hh>
 #include <seastar/core/internal/io_desc.hh>
+#include <seastar/core/internal/estimated_histogram.hh>
 #include <seastar/core/internal/io_sink.hh>
 #include <seastar/core/io_priority_class.hh>
+#include <seastar/core/timed_out_error.hh>
 #include <seastar/util/log.hh>
 
 namespace seastar {
@@ -57,6 +61,9 @@ struct default_io_exception_factory {
     static auto cancelled() {
         return cancelled_error();
     }
+    static auto timed_out() {
+        return timed_out_error();
+    }
 };
 
 io_throttler::io_throttler(config cfg, unsigned nr_queues)
@@ -65,6 +72,7 @@ io_throttler::io_throttler(config cfg, unsigned nr_queues)
                         tokens_capacity(cfg.min_tokens)
                        )
         , _per_tick_threshold(_token_bucket.limit() / nr_queues)
+        , _nominal_rate(_token_bucket.rate())
 {
     if (tokens_capacity(cfg.min_tokens) > _token_bucket.threshold()) {
         throw std::runtime_error("Fair-group replenisher limit is lower than threshold");
@@ -98,6 +106,45 @@ auto io_throttler::capacity_deficiency(capacity_t from) const noexcept -> capaci
     return _token_bucket.deficiency(from);
 }
 
+void io_throttler::account_latency(std::chrono::duration<double> sum, uint64_t completions) noexcept {
+    _latency_sum_ns.fetch_add(std::chrono::duration_cast<std::chrono::nanoseconds>(sum).count(), std::memory_order_relaxed);
+    _completions.fetch_add(completions, std::memory_order_relaxed);
+}
+
+void io_throttler::calibrate(std::chrono::duration<double> goal, double min_ratio) noexcept {
+    // Too few completions say nothing about the device, only grow back then
+    static constexpr uint64_t min_completions = 16;
+    static constexpr double increase_step = 0.02;
+    static constexpr double decrease_factor = 0.8;
+    // Leave some headroom so the ratio doesn't oscillate around the goal
+    static constexpr double increase_threshold = 0.75;
+
+    auto completions = _completions.exchange(0, std::memory_order_relaxed);
+    auto sum = std::chrono::nanoseconds(_latency_sum_ns.exchange(0, std::memory_order_relaxed));
+    auto ratio = _rate_ratio;
+    if (completions >= min_completions) {
+        _observed_latency = std::chrono::duration_cast<std::chrono::duration<double>>(sum) / completions;
+        if (_observed_latency > goal) {
+            ratio = std::max(ratio * decrease_factor, min_ratio);
+        } else if (_observed_latency < goal * increase_threshold) {
+            ratio = std::min(ratio + increase_step, 1.0);
+        }
+    } else {
+        ratio = std::min(ratio + increase_step, 1.0);
+    }
+
+    if (ratio < _rate_ratio) {
+        _rate_decreases++;
+    } else if (ratio > _rate_ratio) {
+        _rate_increases++;
+    } else {
+        return;
+    }
+    io_log.debug("Calibrated disk rate to {:.2f} of configured, observed latency {:.3f}ms", ratio, _observed_latency.count() * 1000);
+    _rate_ratio = ratio;
+    _token_bucket.update_rate(std::max<capacity_t>(_nominal_rate * ratio, 1));
+}
+
 struct io_group::priority_class_data {
     priority_class_group_data* parent;
 
@@ -139,7 +186,8 @@ class io_queue::priority_class_data {
             ops++;
             bytes += len;
         }
-    } _rwstat[2] = {}, _splits = {};
+    } _rwstat[2] = {}, _splits = {}, _merges = {};
+    uint64_t _expired = 0;
     util::integrated_length<unsigned short, lowres_clock> _nr_queued;
     util::integrated_length<unsigned short, lowres_clock> _nr_executing;
     std::chrono::duration<double> _queue_time;
@@ -148,6 +196,20 @@ class io_queue::priority_class_data {
     std::chrono::duration<double> _starvation_time;
     io_queue::clock_type::time_point _activated;
 
+    // Per-request latencies in microseconds, from 8us to 33s in log-linear
+    // buckets; adding a sample is a few shifts and an increment
+    using latency_histogram = metrics::internal::approximate_exponential_histogram<8, 1 << 25, 4>;
+    struct latencies {
+        latency_histogram queue;
+        latency_histogram disk;
+        latency_histogram total;
+    };
+    std::array<latencies, 2> _latencies; // indexed by stream
+
+    static uint64_t to_usec(std::chrono::duration<double> d) noexcept {
+        return std::chrono::duration_cast<std::chrono::microseconds>(d).count();
+    }
+
     class bandwidth_throttler {
         io_group::priority_class_data::token_bucket_t& _tb;
         uint64_t _replenish_head;
@@ -238,8 +300,9 @@ class io_queue::priority_class_data {
         }
     }
 
-    void on_dispatch(io_direction_and_length dnl, std::chrono::duration<double> lat) noexcept {
+    void on_dispatch(stream_id stream, io_direction_and_length dnl, std::chrono::duration<double> lat) noexcept {
         _rwstat[dnl.rw_idx()].add(dnl.length());
+        _latencies[stream].queue.add(to_usec(lat));
         _queue_time = lat;
         _total_queue_time += lat;
         _nr_queued--;
@@ -258,8 +321,15 @@ class io_queue::priority_class_data {
         _nr_queued--;
     }
 
-    void on_complete(std::chrono::duration<double> lat) noexcept {
+    void on_expire() noexcept {
+        _nr_queued--;
+        _expired++;
+    }
+
+    void on_complete(stream_id stream, std::chrono::duration<double> queue_lat, std::chrono::duration<double> lat) noexcept {
         _total_execution_time += lat;
+        _latencies[stream].disk.add(to_usec(lat));
+        _latencies[stream].total.add(to_usec(queue_lat + lat));
         _nr_executing--;
         if (_nr_executing == 0 && _nr_queued != 0) {
             _activated = io_queue::clock_type::now();
@@ -277,6 +347,10 @@ class io_queue::priority_class_data {
         _splits.add(dnl.length());
     }
 
+    void on_merge(io_direction_and_length dnl) noexcept {
+        _merges.add(dnl.length());
+    }
+
     void on_before_dispatch() noexcept {
         _nr_queued.checkpoint();
     }
@@ -288,6 +362,7 @@ class io_queue::priority_class_data {
     fair_queue::class_id fq_class() const noexcept { return _pc.id(); }
 
     std::vector<seastar::metrics::impl::metric_definition_impl> metrics();
+    std::vector<seastar::metrics::impl::metric_definition_impl> latency_metrics(stream_id stream);
     metrics::metric_groups metric_groups;
 };
 
@@ -295,6 +370,7 @@ class io_desc_read_write final : public io_completion {
     io_queue& _ioq;
     io_queue::priority_class_data& _pclass;
     io_queue::clock_type::time_point _ts;
+    std::chrono::duration<double> _queue_time{0};
     const stream_id _stream;
     const io_direction_and_length _dnl;
     const fair_queue_entry::capacity_t _fq_capacity;
@@ -327,7 +403,7 @@ class io_desc_read_write final : public io_completion {
         io_log.trace("dev {} : req {} complete", _ioq.id(), fmt::ptr(this));
         auto now = io_queue::clock_type::now();
         auto delay = std::chrono::duration_cast<std::chrono::duration<double>>(now - _ts);
-        _pclass.on_complete(delay);
+        _pclass.on_complete(_stream, _queue_time, delay);
         _ioq.complete_request(*this, delay);
         _pr.set_value(res);
         delete this;
@@ -339,10 +415,17 @@ class io_desc_read_write final : public io_completion {
         delete this;
     }
 
+    void expire() noexcept {
+        _pclass.on_expire();
+        _pr.set_exception(std::make_exception_ptr(default_io_exception_factory::timed_out()));
+        delete this;
+    }
+
     void dispatch() noexcept {
         io_log.trace("dev {} : req {} submit", _ioq.id(), fmt::ptr(this));
         auto now = io_queue::clock_type::now();
-        _pclass.on_dispatch(_dnl, std::chrono::duration_cast<std::chrono::duration<double>>(now - _ts));
+        _queue_time = std::chrono::duration_cast<std::chrono::duration<double>>(now - _ts);
+        _pclass.on_dispatch(_stream, _dnl, _queue_time);
         _ts = now;
         _dispatched_polls = engine().polls();
     }
@@ -351,9 +434,68 @@ class io_desc_read_write final : public io_completion {
         return _pr.get_future();
     }
 
+    // Submits the request again, on its own, after the merged request it
+    // was part of came short of it
+    void resubmit(internal::io_request req) noexcept {
+        io_log.trace("dev {} : req {} resubmit", _ioq.id(), fmt::ptr(this));
+        _ioq.sink().submit(this, std::move(req));
+    }
+
     fair_queue_entry::capacity_t capacity() const noexcept { return _fq_capacity; }
     stream_id stream() const noexcept { return _stream; }
     uint64_t polls() const noexcept { return _dispatched_polls; }
+    io_direction_and_length dnl() const noexcept { return _dnl; }
+    io_queue::priority_class_data& pclass() const noexcept { return _pclass; }
+};
+
+// Completes the requests that were merged into one, each with its slice
+// of the result. The preceding requests get the full length before the
+// following ones get anything, as a short read/write is only short at
+// its end. The requests the result doesn't reach are submitted again on
+// their own rather than completed with 0, which reads as EOF, as a short
+// result doesn't tell why it is short; past the end of the file, they
+// then get 0 anyway.
+class io_merged_completion final : public io_completion {
+    struct merged {
+        io_desc_read_write* desc;
+        internal::io_request req;
+    };
+    boost::container::small_vector<merged, 4> _reqs;
+    std::vector<::iovec> _iovecs;
+
+public:
+    io_merged_completion(size_t nr_descs, size_t nr_iovecs) {
+        _reqs.reserve(nr_descs);
+        _iovecs.reserve(nr_iovecs);
+    }
+
+    void add(io_desc_read_write* desc, const internal::io_request& req) noexcept {
+        _reqs.push_back(merged{desc, req});
+    }
+
+    std::vector<::iovec>& iovecs() noexcept { return _iovecs; }
+
+    virtual void complete(size_t res) noexcept override {
+        bool reached = true;
+        for (auto& [desc, req] : _reqs) {
+            if (!reached) {
+                desc->resubmit(std::move(req));
+                continue;
+            }
+            auto len = std::min(res, desc->dnl().length());
+            res -= len;
+            reached = len == desc->dnl().length();
+            desc->complete(len);
+        }
+        delete this;
+    }
+
+    virtual void set_exception(std::exception_ptr eptr) noexcept override {
+        for (auto& r : _reqs) {
+            r.desc->set_exception(eptr);
+        }
+        delete this;
+    }
 };
 
 class queued_io_request : private internal::io_request {
@@ -366,11 +508,12 @@ class queued_io_request : private internal::io_request {
     bool is_cancelled() const noexcept { return !_desc; }
 
 public:
-    queued_io_request(internal::io_request req, io_queue& q, fair_queue_entry::capacity_t cap, io_queue::priority_class_data& pc, io_direction_and_length dnl, iovec_keeper iovs)
+    queued_io_request(internal::io_request req, io_queue& q, fair_queue_entry::capacity_t cap, fair_queue_entry::deadline_type deadline,
+            io_queue::priority_class_data& pc, io_direction_and_length dnl, iovec_keeper iovs)
         : io_request(std::move(req))
         , _ioq(q)
         , _stream(_ioq.request_stream(dnl))
-        , _fq_entry(cap)
+        , _fq_entry(cap, deadline)
         , _desc(std::make_unique<io_desc_read_write>(_ioq, pc, _stream, dnl, cap, std::move(iovs)))
     {
     }
@@ -395,6 +538,87 @@ class queued_io_request : private internal::io_request {
         _desc.release()->cancel();
     }
 
+    // Fails the request that missed its deadline without dispatching it.
+    // It must have been popped from the fair queue already.
+    void expire() noexcept {
+        _intent.maybe_dequeue();
+        _ioq.expire_request(*this);
+        _desc.release()->expire();
+        delete this;
+    }
+
+    // Checks whether next starts on disk where this one ends, so that both
+    // can be submitted as one preadv/pwritev
+    bool adjacent_to(const queued_io_request& next) const noexcept {
+        if (is_cancelled() || next.is_cancelled() || &_desc->pclass() != &next._desc->pclass()) {
+            return false;
+        }
+        auto vectored = [] (operation op) { return op == operation::readv || op == operation::writev; };
+        auto plain = [] (operation op) { return op == operation::read || op == operation::write; };
+        auto op = opcode();
+        auto next_op = next.opcode();
+        if (!(vectored(op) || plain(op)) || !(vectored(next_op) || plain(next_op)) || is_read() != next.is_read()) {
+            return false;
+        }
+        // read_op and readv_op (and their write peers) share the fd and pos
+        // layout, so we don't handle them separately
+        const auto& cur = as<operation::read>();
+        const auto& nxt = next.as<operation::read>();
+        return cur.fd == nxt.fd && cur.nowait_works == nxt.nowait_works && cur.pos + _desc->dnl().length() == nxt.pos;
+    }
+
+    size_t nr_iovecs() const noexcept {
+        auto op = opcode();
+        return (op == operation::readv || op == operation::writev) ? as<operation::readv>().iov_len : 1;
+    }
+
+    // Dispatches the adjacent requests in reqs (the first one is the head) as
+    // a single vectored request. Takes ownership of all of them.
+    static void dispatch_merged(std::span<queued_io_request*> reqs) noexcept {
+        auto& head = *reqs.front();
+        size_t nr_iovecs = 0;
+        for (auto* r : reqs) {
+            nr_iovecs += r->nr_iovecs();
+        }
+
+        io_merged_completion* mc;
+        try {
+            mc = new io_merged_completion(reqs.size(), nr_iovecs);
+        } catch (...) {
+            // Merging is an optimization, fall back to dispatching one by one
+            for (auto* r : reqs) {
+                r->dispatch();
+            }
+            return;
+        }
+
+        auto& iovecs = mc->iovecs();
+        for (auto* r : reqs) {
+            auto op = r->opcode();
+            if (op == operation::readv || op == operation::writev) {
+                const auto& v = r->as<operation::readv>();
+                iovecs.insert(iovecs.end(), v.iovec, v.iovec + v.iov_len);
+            } else {
+                const auto& b = r->as<operation::read>();
+                iovecs.push_back(::iovec{b.addr, b.size});
+            }
+            r->_intent.maybe_dequeue();
+            r->_desc->dispatch();
+            if (r != &head) {
+                r->_desc->pclass().on_merge(r->_desc->dnl());
+            }
+            mc->add(r->_desc.release(), *r);
+        }
+
+        const auto& h = head.as<operation::read>();
+        auto req = head.is_read() ? io_request::make_readv(h.fd, h.pos, iovecs, h.nowait_works)
+                                  : io_request::make_writev(h.fd, h.pos, iovecs, h.nowait_works);
+        head._ioq.submit_merged_request(mc, reqs.size(), std::move(req));
+        for (auto* r : reqs) {
+            delete r;
+        }
+    }
+
     void set_intent(internal::cancellable_queue& cq) noexcept {
         _intent.enqueue(cq);
     }
@@ -402,6 +626,8 @@ class queued_io_request : private internal::io_request {
     future<size_t> get_future() noexcept { return _desc->get_future(); }
     fair_queue_entry& queue_entry() noexcept { return _fq_entry; }
     stream_id stream() const noexcept { return _stream; }
+    bool cancelled() const noexcept { return is_cancelled(); }
+    io_direction_and_length dnl() const noexcept { return _desc->dnl(); }
 
     static queued_io_request& from_fq_entry(fair_queue_entry& ent) noexcept {
         return *boost::intrusive::get_parent_from_member(&ent, &queued_io_request::_fq_entry);
@@ -569,6 +795,16 @@ sstring io_request::opname() const {
     switch (opcode()) {
     case io_request::operation::fdatasync:
         return "fdatasync";
+    case io_request::operation::fallocate:
+        return "fallocate";
+    case io_request::operation::openat:
+        return "openat";
+    case io_request::operation::statx:
+        return "statx";
+    case io_request::operation::renameat:
+        return "renameat";
+    case io_request::operation::unlinkat:
+        return "unlinkat";
     case io_request::operation::write:
         return "write";
     case io_request::operation::writev:
@@ -624,11 +860,33 @@ void io_queue::lower_stall_threshold() noexcept {
     _stall_threshold = std::max(_stall_threshold_min, new_threshold);
 }
 
+void io_queue::calibrate_disk_rate() noexcept {
+    for (auto& s : _streams) {
+        if (s._completions) {
+            s.out.account_latency(s._latency_sum, s._completions);
+            s._latency_sum = std::chrono::duration<double>(0);
+            s._completions = 0;
+        }
+    }
+    if (_group->_allocated_on == this_shard_id()) {
+        auto goal = _group->io_latency_goal();
+        for (auto& fg : _group->_fgs) {
+            fg.calibrate(goal, get_config().auto_calibrate_min_ratio);
+        }
+    }
+}
+
 void
 io_queue::complete_request(io_desc_read_write& desc, std::chrono::duration<double> delay) noexcept {
     _requests_executing--;
     _requests_completed++;
 
+    if (delay.count() > 0) {
+        auto& s = _streams[desc.stream()];
+        s._latency_sum += delay;
+        s._completions++;
+    }
+
     if (delay > _stall_threshold) {
         _stall_threshold *= 2;
         io_log.warn("Request took {:.3f}ms ({} polls) to execute, queued {} executing {}",
@@ -641,6 +899,8 @@ fair_queue::config io_queue::make_fair_queue_config(const config& iocfg, sstring
     fair_queue::config cfg;
     cfg.label = label;
     cfg.forgiving_factor = io_throttler::fixed_point_factor * io_throttler::token_bucket_t::rate_cast(iocfg.tau).count();
+    cfg.deadline_urgency = iocfg.deadline_urgency;
+    cfg.deadline_slack = io_throttler::fixed_point_factor * io_throttler::token_bucket_t::rate_cast(iocfg.deadline_slack).count();
     return cfg;
 }
 
@@ -649,9 +909,13 @@ io_queue::io_queue(io_group_ptr group, internal::io_sink& sink)
     , _group(std::move(group))
     , _id(_group->_config.id)
     , _sink(sink)
+    , _merge_max_latency(get_config().merge_max_latency)
     , _averaging_decay_timer([this] {
         update_flow_ratio();
         lower_stall_threshold();
+        if (get_config().auto_calibrate) {
+            calibrate_disk_rate();
+        }
     })
     , _stall_threshold_min(std::max(get_config().stall_threshold, 1ms))
     , _stall_threshold(_stall_threshold_min)
@@ -677,6 +941,35 @@ io_queue::io_queue(io_group_ptr group, internal::io_sink& sink)
                 sm::description("Ratio of dispatch rate to completion rate. Is expected to be 1.0+ growing larger on reactor stalls or (!) disk problems"),
                 { owner_l, mnt_l, group_l }),
     });
+
+    if (cfg.auto_calibrate && _group->_allocated_on == this_shard_id()) {
+        std::vector<sm::metric_definition> calibration;
+        for (unsigned i = 0; i < _streams.size(); i++) {
+            auto& fg = _group->_fgs[i];
+            auto stream_l = sm::label("stream")(_streams[i].fq.label());
+            calibration.emplace_back(sm::make_gauge("disk_rate_ratio", [&fg] { return fg.rate_ratio(); },
+                    sm::description("Fraction of the configured io-properties rate the disk is currently estimated to sustain"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+            calibration.emplace_back(sm::make_gauge("disk_estimated_read_bandwidth", [&fg, &cfg] {
+                        return fg.rate_ratio() * (cfg.blocks_count_rate << block_size_shift) / read_request_base_count;
+                    }, sm::description("Estimated sustainable read bandwidth (bytes/s) of the IO group"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+            calibration.emplace_back(sm::make_gauge("disk_estimated_read_iops", [&fg, &cfg] {
+                        return fg.rate_ratio() * cfg.req_count_rate / read_request_base_count;
+                    }, sm::description("Estimated sustainable read IOPS of the IO group"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+            calibration.emplace_back(sm::make_gauge("disk_observed_latency", [&fg] { return fg.observed_latency().count(); },
+                    sm::description("Average completion latency (s) seen during the last calibration period"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+            calibration.emplace_back(sm::make_counter("disk_rate_decreases", [&fg] { return fg.rate_decreases(); },
+                    sm::description("Number of times calibration lowered the disk rate because latency exceeded the goal"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+            calibration.emplace_back(sm::make_counter("disk_rate_increases", [&fg] { return fg.rate_increases(); },
+                    sm::description("Number of times calibration raised the disk rate back towards the configured one"),
+                    { owner_l, mnt_l, group_l, stream_l }));
+        }
+        _metric_groups.add_group("io_queue", std::move(calibration));
+    }
 }
 
 io_throttler::config io_group::configure_throttler(const io_queue::config& qcfg) noexcept {
@@ -802,6 +1095,12 @@ std::vector<seastar::metrics::impl::metric_definition_impl> io_queue::priority_c
                     sm::description("Total number of requests split")),
             sm::make_counter("total_split_bytes", _splits.bytes,
                     sm::description("Total number of bytes split")),
+            sm::make_counter("total_merged_ops", _merges.ops,
+                    sm::description("Total number of requests merged into a preceding adjacent request")),
+            sm::make_counter("total_merged_bytes", _merges.bytes,
+                    sm::description("Total number of bytes merged into a preceding adjacent request")),
+            sm::make_counter("total_expired_ops", _expired,
+                    sm::description("Total number of requests failed without being dispatched because their deadline had passed")),
             sm::make_counter("total_delay_sec", [this] {
                     return _total_queue_time.count();
                 }, sm::description("Total time spent in the queue")),
@@ -837,6 +1136,19 @@ std::vector<seastar::metrics::impl::metric_definition_impl> io_queue::priority_c
     });
 }
 
+std::vector<seastar::metrics::impl::metric_definition_impl> io_queue::priority_class_data::latency_metrics(stream_id stream) {
+    namespace sm = seastar::metrics;
+    auto& l = _latencies[stream];
+    return std::vector<sm::impl::metric_definition_impl>({
+            sm::make_histogram("queue_latency", [&l] { return l.queue.to_metrics_histogram(); },
+                    sm::description("Histogram of the time requests spent in the queue, in microseconds")).set_skip_when_empty(),
+            sm::make_histogram("disk_latency", [&l] { return l.disk.to_metrics_histogram(); },
+                    sm::description("Histogram of the time requests spent in disk, in microseconds")).set_skip_when_empty(),
+            sm::make_histogram("total_latency", [&l] { return l.total.to_metrics_histogram(); },
+                    sm::description("Histogram of the time from queueing requests until their completion, in microseconds")).set_skip_when_empty(),
+    });
+}
+
 void io_queue::register_stats(sstring name, priority_class_data& pc) {
     namespace sm = seastar::metrics;
     seastar::metrics::metric_groups new_metrics;
@@ -852,9 +1164,15 @@ void io_queue::register_stats(sstring name, priority_class_data& pc) {
         metrics.emplace_back(std::move(m));
     }
 
-    for (auto&& s : _streams) {
+    for (stream_id i = 0; i < _streams.size(); i++) {
+        auto& s = _streams[i];
+        auto stream_l = sm::label("stream")(s.fq.label());
         for (auto&& m : s.metrics(pc)) {
-            m(owner_l)(mnt_l)(class_l)(group_l)(sm::label("stream")(s.fq.label()));
+            m(owner_l)(mnt_l)(class_l)(group_l)(stream_l);
+            metrics.emplace_back(std::move(m));
+        }
+        for (auto&& m : pc.latency_metrics(i)) {
+            m(owner_l)(mnt_l)(class_l)(group_l)(stream_l);
             metrics.emplace_back(std::move(m));
         }
     }
@@ -1009,7 +1327,8 @@ future<size_t> io_queue::queue_one_request(internal::priority_class pc, io_direc
         // that we create the shared pointer in the same shard it will be used at later.
         auto& pclass = find_or_create_class(pc);
         auto cap = request_capacity(dnl);
-        auto queued_req = std::make_unique<queued_io_request>(std::move(req), *this, cap, pclass, std::move(dnl), std::move(iovs));
+        auto deadline = intent != nullptr ? intent->deadline() : fair_queue_entry::deadline_type::max();
+        auto queued_req = std::make_unique<queued_io_request>(std::move(req), *this, cap, deadline, pclass, std::move(dnl), std::move(iovs));
         auto fut = queued_req->get_future();
         if (intent != nullptr) {
             auto& cq = intent->find_or_create_cancellable_queue(_id, pc.id());
@@ -1136,6 +1455,18 @@ void io_queue::poll_io_queue() {
                 break;
             }
 
+            // Requests that missed their deadline fail without consuming
+            // capacity, nor charging their class
+            if (ent->has_deadline() && ent->deadline() <= clock_type::now()) {
+                auto& req = queued_io_request::from_fq_entry(*ent);
+                if (!req.cancelled()) {
+                    st.fq.notify_request_cancelled(*ent);
+                    st.fq.pop_front();
+                    req.expire();
+                    continue;
+                }
+            }
+
             auto result = st.grab_capacity(ent->capacity(), available);
             if (result == stream::grab_result::stop) {
                 break;
@@ -1145,7 +1476,12 @@ void io_queue::poll_io_queue() {
             }
 
             st.fq.pop_front();
-            queued_io_request::from_fq_entry(*ent).dispatch();
+            auto& req = queued_io_request::from_fq_entry(*ent);
+            if (_merge_max_latency.count() > 0) {
+                dispatch_merging(st, req, available);
+            } else {
+                req.dispatch();
+            }
         }
 
         SEASTAR_ASSERT(available.ready_tokens == 0);
@@ -1172,6 +1508,69 @@ void io_queue::submit_request(io_desc_read_write* desc, internal::io_request req
     _sink.submit(desc, std::move(req));
 }
 
+void io_queue::submit_merged_request(io_completion* desc, size_t nr_requests, internal::io_request req) noexcept {
+    _queued_requests -= nr_requests;
+    _requests_executing += nr_requests;
+    _requests_dispatched += nr_requests;
+    _sink.submit(desc, std::move(req));
+}
+
+// Picks up the requests following the just popped head in the fair queue
+// as long as they continue it on disk and can be dispatched right away.
+// Since the head completes only when the whole merged request does, its
+// latency grows by the time the device needs for what's appended. That's
+// estimated from the disk model and kept under the configured bound.
+void io_queue::dispatch_merging(stream& st, queued_io_request& head, stream::reap_result& available) noexcept {
+    static constexpr size_t max_merged = 64;
+    std::array<queued_io_request*, max_merged> batch;
+    size_t nr = 0;
+    batch[nr++] = &head;
+
+    if (head.cancelled()) {
+        head.dispatch();
+        return;
+    }
+
+    auto dnl = head.dnl();
+    size_t length = dnl.length();
+    size_t nr_iovecs = head.nr_iovecs();
+    const size_t max_length = _group->max_request_length(dnl.rw_idx());
+    fair_queue_entry::capacity_t added = 0;
+    const auto now = clock_type::now();
+
+    while (nr < max_merged) {
+        auto* ent = st.fq.top();
+        if (ent == nullptr || ent->capacity() > available.ready_tokens) {
+            break;
+        }
+        // Left for poll_io_queue() to expire
+        if (ent->has_deadline() && ent->deadline() <= now) {
+            break;
+        }
+        auto& next = queued_io_request::from_fq_entry(*ent);
+        if (!batch[nr - 1]->adjacent_to(next)) {
+            break;
+        }
+        auto next_length = next.dnl().length();
+        if (length + next_length > max_length || nr_iovecs + next.nr_iovecs() > IOV_MAX ||
+                st.out.capacity_duration(added + ent->capacity()) > _merge_max_latency) {
+            break;
+        }
+        available.ready_tokens -= ent->capacity();
+        added += ent->capacity();
+        length += next_length;
+        nr_iovecs += next.nr_iovecs();
+        st.fq.pop_front();
+        batch[nr++] = &next;
+    }
+
+    if (nr == 1) {
+        head.dispatch();
+    } else {
+        queued_io_request::dispatch_merged(std::span(batch.data(), nr));
+    }
+}
+
 void io_queue::cancel_request(queued_io_request& req) noexcept {
     _queued_requests--;
     _streams[req.stream()].fq.notify_request_cancelled(req.queue_entry());
@@ -1180,6 +1579,10 @@ void io_queue::cancel_request(queued_io_request& req) noexcept {
 void io_queue::complete_cancelled_request(queued_io_request& req) noexcept {
 }
 
+void io_queue::expire_request(queued_io_request& req) noexcept {
+    _queued_requests--;
+}
+
 io_queue::clock_type::time_point io_queue::next_pending_aio() const noexcept {
     clock_type::time_point next = clock_type::time_point::max();
 
@@ -1376,6 +1779,9 @@ std::vector<seastar::metrics::impl::metric_definition_impl> io_queue::stream::me
             sm::make_counter("activations",
                     [this, c] { return fq.activations(c); },
                     sm::description("The number of times the class was woken up from idle")),
+            sm::make_counter("deadline_dispatches",
+                    [this, c] { return fq.deadline_dispatches(c); },
+                    sm::description("The number of requests of this class dispatched ahead of other classes because their deadline was near")),
     });
 }
 
@@ -101,6 +101,10 @@
 #include <sys/syscall.h>
 #include <linux/mempolicy.h>
 
+#ifndef MADV_COLLAPSE
+#define MADV_COLLAPSE 25
+#endif
+
 #endif // !defined(SEASTAR_DEFAULT_ALLOCATOR)
 
 #include <seastar/core/cacheline.hh>
@@ -238,7 +242,7 @@ std::atomic<bool> use_transparent_hugepages = true;
 namespace alloc_stats {
 
 enum class types { allocs, frees, cross_cpu_frees, total_bytes_allocated, reclaims, large_allocs, failed_allocs,
-    foreign_mallocs, foreign_frees, foreign_cross_frees, enum_size };
+    foreign_mallocs, foreign_frees, foreign_cross_frees, hugepage_collapses, hugepage_collapse_failures, enum_size };
 
 using stats_array = std::array<uint64_t, static_cast<std::size_t>(types::enum_size)>;
 using stats_atomic_array = std::array<std::atomic_uint64_t, static_cast<std::size_t>(types::enum_size)>;
@@ -312,6 +316,8 @@ class page_list_link {
     uint32_t _next;
     friend class page_list;
     friend seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar::internal::log_buf::inserter_iterator);
+    friend small_pool_stats small_pool_stats_at(unsigned);
+    friend free_span_stats free_span_stats_at(unsigned);
 };
 
 constexpr size_t mem_base_alloc = size_t(1) << bits_for_cpu_id_and_memory;
@@ -413,6 +419,8 @@ class page_list {
         _front = ary[_front].link._next;
     }
     friend seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar::internal::log_buf::inserter_iterator);
+    friend small_pool_stats small_pool_stats_at(unsigned);
+    friend free_span_stats free_span_stats_at(unsigned);
 };
 
 class small_pool {
@@ -424,6 +432,9 @@ class small_pool {
     unsigned _object_size;
     span_sizes _span_sizes;
     unsigned _free_count = 0;
+    // Objects on the freelists of the spans in _span_list, kept up to date
+    // so that statistics don't have to walk the spans.
+    unsigned _span_free_count = 0;
     unsigned _min_free;
     unsigned _max_free;
     unsigned _pages_in_use = 0;
@@ -459,6 +470,8 @@ class small_pool {
     [[gnu::noinline]] void* add_more_objects();
     void trim_free_list();
     friend seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar::internal::log_buf::inserter_iterator);
+    friend small_pool_stats small_pool_stats_at(unsigned);
+    friend free_span_stats free_span_stats_at(unsigned);
 };
 
 // index 0b0001'1100 -> size (1 << 4) + 0b11 << (4 - 2)
@@ -579,6 +592,7 @@ struct cpu_pages {
     std::vector<reclaimer*> reclaimers;
     static constexpr unsigned nr_span_lists = 32;
     page_list free_spans[nr_span_lists];  // contains aligned spans with span_size == 2^idx
+    uint32_t nr_free_spans[nr_span_lists] = {}; // length of each free_spans list
     alignas(seastar::cache_line_size) std::atomic<cross_cpu_free_item*> xcpu_freelist;
     static std::atomic<unsigned> cpu_id_gen;
     static cpu_pages* all_cpus[max_cpus];
@@ -592,6 +606,15 @@ struct cpu_pages {
     allocation_site_ptr alloc_site_list_head = nullptr; // For easy traversal of asu.alloc_sites from scylla-gdb.py
     sampler heap_prof_sampler;
     small_pool_array<true> sampled_small_pools;
+    // In hugepage span mode, one bit per huge page of shard memory, set once
+    // the huge page has been queued for collapse.
+    uint64_t* hugepage_collapsed = nullptr;
+    // Huge pages handed out by large allocations but not yet collapsed.
+    // MADV_COLLAPSE can take milliseconds, so the reactor takes them from
+    // here and collapses them in the syscall thread pool.
+    static constexpr unsigned max_pending_hugepage_collapses = 64;
+    std::array<uint32_t, max_pending_hugepage_collapses> pending_hugepage_collapses;
+    unsigned nr_pending_hugepage_collapses = 0;
 
     char* mem() { return memory; }
 
@@ -636,6 +659,10 @@ struct cpu_pages {
     void resize(size_t new_size, allocate_system_memory_fn alloc_sys_mem);
     void do_resize(size_t new_size, allocate_system_memory_fn alloc_sys_mem);
     void replace_memory_backing(allocate_system_memory_fn alloc_sys_mem);
+    void init_hugepage_spans();
+    void collapse_hugepages(pageidx start, unsigned nr_pages);
+    void* pop_pending_hugepage_collapse();
+    void hugepage_collapse_done(int error);
     void check_large_allocation(size_t size);
     void warn_large_allocation(size_t size);
     allocation_site_ptr add_alloc_site(size_t allocated_size);
@@ -737,6 +764,7 @@ void cpu_pages::free_span_no_merge(uint32_t span_start, uint32_t nr_pages) {
     span->span_size = span_end->span_size = nr_pages;
     auto idx = index_of(nr_pages);
     link(free_spans[idx], span);
+    ++nr_free_spans[idx];
 }
 
 bool cpu_pages::grow_span(uint32_t& span_start, uint32_t& nr_pages, unsigned idx) {
@@ -749,6 +777,7 @@ bool cpu_pages::grow_span(uint32_t& span_start, uint32_t& nr_pages, unsigned idx
     auto buddy = span_start + delta;
     if (pages[buddy].free && pages[buddy].span_size == nr_pages) {
         unlink(free_spans[idx], &pages[span_start ^ nr_pages]);
+        --nr_free_spans[idx];
         nr_free_pages -= nr_pages; // free_span_no_merge() will restore
         span_start &= ~nr_pages;
         nr_pages *= 2;
@@ -795,6 +824,7 @@ cpu_pages::find_and_unlink_span(unsigned n_pages) {
     auto& list = free_spans[idx];
     page* span = &list.front(pages);
     unlink(list, span);
+    --nr_free_spans[idx];
     return span;
 }
 
@@ -846,6 +876,9 @@ cpu_pages::allocate_large_and_trim(unsigned n_pages, bool should_sample) {
     span->free = span_end->free = false;
     span->span_size = span_end->span_size = span_size;
     span->pool = nullptr;
+    if (hugepage_collapsed) [[unlikely]] {
+        collapse_hugepages(span_idx, span_size);
+    }
 #ifdef SEASTAR_HEAPPROF
     if (should_sample) {
         auto alloc_site = add_alloc_site(span->span_size * page_size);
@@ -1336,6 +1369,61 @@ void cpu_pages::do_resize(size_t new_size, allocate_system_memory_fn alloc_sys_m
     free_span_unaligned(old_nr_pages, new_pages - old_nr_pages);
 }
 
+void cpu_pages::init_hugepage_spans() {
+    constexpr size_t pages_per_huge_page = huge_page_size / page_size;
+    auto nr_huge_pages = align_up<size_t>(nr_pages, pages_per_huge_page) / pages_per_huge_page;
+    auto bitmap_size = align_up<size_t>(nr_huge_pages, 64) / 64 * sizeof(uint64_t);
+    auto bitmap = reinterpret_cast<uint64_t*>(allocate_large(align_up(bitmap_size, page_size) / page_size, false));
+    if (!bitmap) {
+        return;
+    }
+    std::memset(bitmap, 0, bitmap_size);
+    hugepage_collapsed = bitmap;
+}
+
+void cpu_pages::collapse_hugepages(pageidx start, unsigned n_pages) {
+    constexpr size_t pages_per_huge_page = huge_page_size / page_size;
+    auto first = start / pages_per_huge_page;
+    auto last = (start + n_pages - 1) / pages_per_huge_page;
+    for (auto hp = first; hp <= last; ++hp) {
+        if (nr_pending_hugepage_collapses == max_pending_hugepage_collapses) {
+            // Leave the rest unmarked; a later allocation will queue them.
+            return;
+        }
+        auto& word = hugepage_collapsed[hp / 64];
+        auto bit = uint64_t(1) << (hp % 64);
+        if (word & bit) {
+            continue;
+        }
+        word |= bit;
+        pending_hugepage_collapses[nr_pending_hugepage_collapses++] = hp;
+    }
+}
+
+void* cpu_pages::pop_pending_hugepage_collapse() {
+    if (!nr_pending_hugepage_collapses) {
+        return nullptr;
+    }
+    auto hp = pending_hugepage_collapses[--nr_pending_hugepage_collapses];
+    return mem() + size_t(hp) * huge_page_size;
+}
+
+void cpu_pages::hugepage_collapse_done(int error) {
+    if (!error) {
+        alloc_stats::increment_local(alloc_stats::types::hugepage_collapses);
+    } else if (error == EINVAL) {
+        // Kernel predates MADV_COLLAPSE (5.x). Stop trying; the bitmap
+        // stays allocated, which is a few pages at most.
+        hugepage_collapsed = nullptr;
+        nr_pending_hugepage_collapses = 0;
+    } else {
+        // Typically EAGAIN/ENOMEM: no free huge page right now. The
+        // range keeps its MADV_HUGEPAGE advice, so khugepaged may still
+        // pick it up later.
+        alloc_stats::increment_local(alloc_stats::types::hugepage_collapse_failures);
+    }
+}
+
 void cpu_pages::resize(size_t new_size, allocate_system_memory_fn alloc_memory) {
     new_size = align_down(new_size, huge_page_size);
     while (nr_pages * page_size < new_size) {
@@ -1487,6 +1575,7 @@ small_pool::add_more_objects() {
             obj->next = _free;
             _free = obj;
             ++_free_count;
+            --_span_free_count;
             ++span.nr_small_alloc;
         }
     }
@@ -1536,7 +1625,9 @@ small_pool::trim_free_list() {
         }
         obj->next = span->freelist;
         span->freelist = obj;
+        ++_span_free_count;
         if (--span->nr_small_alloc == 0) {
+            _span_free_count -= span->span_size * page_size / _object_size;
             _pages_in_use -= span->span_size;
             _span_list.erase(get_cpu_mem().pages, *span);
             get_cpu_mem().free_span(span - get_cpu_mem().pages, span->span_size);
@@ -1887,14 +1978,17 @@ internal::global_setup(unsigned nr_shards) {
 internal::numa_layout
 configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        optional<std::string> hugetlbfs_path) {
+        optional<std::string> hugetlbfs_path,
+        bool hugepage_spans) {
     // we need to make sure cpu_mem is initialize since configure calls cpu_mem.resize
     // and we might reach configure without ever allocating, hence without ever calling
     // cpu_pages::initialize.
     // The correct solution is to add a condition inside cpu_mem.resize, but since all
     // other paths to cpu_pages::resize are already verifying initialize was called, we
     // verify that here.
-    use_transparent_hugepages.store(transparent_hugepages, std::memory_order_relaxed);
+    // hugetlbfs memory is made of huge pages already
+    hugepage_spans = hugepage_spans && !hugetlbfs_path;
+    use_transparent_hugepages.store(transparent_hugepages || hugepage_spans, std::memory_order_relaxed);
     init_cpu_mem();
     // init_cpu_mem() could have been called very early, see call site in allocate().
     // In that case we don't know about the transparent_hugepages parameter and conservatively
@@ -1942,6 +2036,10 @@ configure(std::vector<resource::memory> m, bool mbind,
         }
         pos += x.bytes;
     }
+    // After mbind(), so that collapsed huge pages land on the right node.
+    if (hugepage_spans) {
+        get_cpu_mem().init_hugepage_spans();
+    }
     return ret_layout;
 }
 
@@ -1949,7 +2047,8 @@ statistics stats() {
     return statistics{alloc_stats::get(alloc_stats::types::allocs), alloc_stats::get(alloc_stats::types::frees), alloc_stats::get(alloc_stats::types::cross_cpu_frees),
         cpu_mem.nr_pages * page_size, cpu_mem.nr_free_pages * page_size, alloc_stats::get(alloc_stats::types::total_bytes_allocated), alloc_stats::get(alloc_stats::types::reclaims), alloc_stats::get(alloc_stats::types::large_allocs),
         alloc_stats::get(alloc_stats::types::failed_allocs), alloc_stats::get(alloc_stats::types::foreign_mallocs), alloc_stats::get(alloc_stats::types::foreign_frees),
-        alloc_stats::get(alloc_stats::types::foreign_cross_frees)};
+        alloc_stats::get(alloc_stats::types::foreign_cross_frees), alloc_stats::get(alloc_stats::types::hugepage_collapses),
+        alloc_stats::get(alloc_stats::types::hugepage_collapse_failures)};
 }
 
 size_t free_memory() {
@@ -1960,10 +2059,86 @@ bool drain_cross_cpu_freelist() {
     return get_cpu_mem().drain_cross_cpu_freelist();
 }
 
+bool hugepage_collapses_enabled() {
+    return get_cpu_mem().hugepage_collapsed != nullptr;
+}
+
+void* pop_pending_hugepage_collapse() {
+    return get_cpu_mem().pop_pending_hugepage_collapse();
+}
+
+int collapse_hugepage(void* hp) noexcept {
+    if (::madvise(hp, huge_page_size, MADV_COLLAPSE) == 0) {
+        return 0;
+    }
+    return errno;
+}
+
+void hugepage_collapse_done(int error) {
+    get_cpu_mem().hugepage_collapse_done(error);
+}
+
 memory_layout get_memory_layout() {
     return get_cpu_mem().memory_layout();
 }
 
+// Pools too small to fit a free_object are never used, so they are not reported.
+static constexpr unsigned first_reported_small_pool = [] {
+    unsigned i = 0;
+    while (small_pool::idx_to_size(i) < sizeof(free_object)) {
+        ++i;
+    }
+    return i;
+}();
+
+unsigned small_pool_count() {
+    return get_cpu_mem().small_pools.nr_small_pools - first_reported_small_pool;
+}
+
+small_pool_stats small_pool_stats_at(unsigned idx) {
+    auto& sp = get_cpu_mem().small_pools[first_reported_small_pool + idx];
+    // For the small pools, there are two types of free objects:
+    // Pool freelist objects are poitned to by sp._free and their count is sp._free_count
+    // Span freelist objects are those removed from the pool freelist when that list
+    // becomes too large: they are instead attached to the spans allocated to this
+    // pool, and counted by sp._span_free_count.
+    const auto free_objs = uint64_t(sp._free_count) + sp._span_free_count; // pool + span free objects
+    const uint64_t memory = uint64_t(sp._pages_in_use) * page_size;
+    return small_pool_stats{
+        .object_size = sp.object_size(),
+        .span_size = size_t(sp._span_sizes.preferred) * page_size,
+        .objects_in_use = memory / sp.object_size() - free_objs,
+        .memory = memory,
+        .unused = free_objs * sp.object_size(),
+    };
+}
+
+unsigned free_span_orders() {
+    return cpu_pages::nr_span_lists;
+}
+
+free_span_stats free_span_stats_at(unsigned order) {
+    return free_span_stats{
+        .order = order,
+        .span_size = (size_t(1) << order) * page_size,
+        .free_spans = get_cpu_mem().nr_free_spans[order],
+    };
+}
+
+detailed_statistics detailed_stats() {
+    detailed_statistics ret;
+    auto nr_pools = small_pool_count();
+    ret.small_pools.reserve(nr_pools);
+    for (unsigned i = 0; i < nr_pools; ++i) {
+        ret.small_pools.push_back(small_pool_stats_at(i));
+    }
+    ret.free_spans.reserve(free_span_orders());
+    for (unsigned i = 0; i < free_span_orders(); ++i) {
+        ret.free_spans.push_back(free_span_stats_at(i));
+    }
+    return ret;
+}
+
 size_t min_free_memory() {
     return get_cpu_mem().min_free_pages * page_size;
 }
@@ -2088,39 +2263,16 @@ seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar
 
     it = fmt::format_to(it, "Small pools:\n");
     it = fmt::format_to(it, "objsz spansz usedobj memory unused wst%\n");
-    for (unsigned i = 0; i < get_cpu_mem().small_pools.nr_small_pools; i++) {
-        auto& sp = get_cpu_mem().small_pools[i];
-        // We don't use pools too small to fit a free_object, so skip these, they
-        // are always empty.
-        if (sp.object_size() < sizeof(free_object)) {
-            continue;
-        }
-
-        // For the small pools, there are two types of free objects:
-        // Pool freelist objects are poitned to by sp._free and their count is sp._free_count
-        // Span freelist objects are those removed from the pool freelist when that list
-        // becomes too large: they are instead attached to the spans allocated to this
-        // pool. To count this second category, we iterate over the spans below.
-        uint32_t span_freelist_objs = 0;
-        auto front = sp._span_list._front;
-        while (front) {
-            auto& span = get_cpu_mem().pages[front];
-            auto capacity_in_objects = span.span_size * page_size / sp.object_size();
-            span_freelist_objs += capacity_in_objects - span.nr_small_alloc;
-            front = span.link._next;
-        }
-        const auto free_objs = sp._free_count + span_freelist_objs; // pool + span free objects
-        const auto use_count = sp._pages_in_use * page_size / sp.object_size() - free_objs;
-        auto memory = sp._pages_in_use * page_size;
-        const auto unused = free_objs * sp.object_size();
-        const auto wasted_percent = memory ? unused * 100 / memory : 0;
+    for (unsigned i = 0; i < small_pool_count(); i++) {
+        const auto sp = small_pool_stats_at(i);
+        const auto wasted_percent = sp.memory ? sp.unused * 100 / sp.memory : 0;
         it = fmt::format_to(it,
                 "{:>5}  {:>5}   {:>5}  {:>5}  {:>5} {:>4}\n",
-                sp.object_size(),
-                to_hr_size(sp._span_sizes.preferred * page_size),
-                to_hr_number(use_count),
-                to_hr_size(memory),
-                to_hr_size(unused),
+                sp.object_size,
+                to_hr_size(sp.span_size),
+                to_hr_number(sp.objects_in_use),
+                to_hr_size(sp.memory),
+                to_hr_size(sp.unused),
                 unsigned(wasted_percent));
     }
     it = fmt::format_to(it, "\nPage spans:\n");
@@ -2139,15 +2291,8 @@ seastar::internal::log_buf::inserter_iterator do_dump_memory_diagnostics(seastar
         i += span_size;
     }
 
-    for (unsigned i = 0; i< get_cpu_mem().nr_span_lists; i++) {
-        auto& span_list = get_cpu_mem().free_spans[i];
-        auto front = span_list._front;
-        uint32_t free_pages = 0;
-        while (front) {
-            auto& span = get_cpu_mem().pages[front];
-            free_pages += span.span_size;
-            front = span.link._next;
-        }
+    for (unsigned i = 0; i < free_span_orders(); i++) {
+        const auto free_pages = free_span_stats_at(i).free_spans << i;
         const auto total_spans = span_size_histogram[i];
         const auto total_pages = total_spans * (1 << i);
         it = fmt::format_to(it,
@@ -2711,7 +2856,8 @@ void set_reclaim_hook(std::function<void (std::function<void ()>)> hook) {
 internal::numa_layout
 configure(std::vector<resource::memory> m, bool mbind,
         bool transparent_hugepages,
-        std::optional<std::string> hugepages_path) {
+        std::optional<std::string> hugepages_path,
+        bool hugepage_spans) {
     return {};
 }
 
@@ -2719,7 +2865,7 @@ void configure_minimal()
 {}
 
 statistics stats() {
-    return statistics{0, 0, 0, 1 << 30, 1 << 30, 0, 0, 0, 0, 0, 0, 0};
+    return statistics{0, 0, 0, 1 << 30, 1 << 30, 0, 0, 0, 0, 0, 0, 0, 0, 0};
 }
 
 size_t free_memory() {
@@ -2730,10 +2876,45 @@ bool drain_cross_cpu_freelist() {
     return false;
 }
 
+bool hugepage_collapses_enabled() {
+    return false;
+}
+
+void* pop_pending_hugepage_collapse() {
+    return nullptr;
+}
+
+int collapse_hugepage(void*) noexcept {
+    return EINVAL;
+}
+
+void hugepage_collapse_done(int) {
+}
+
 memory_layout get_memory_layout() {
     throw std::runtime_error("get_memory_layout() not supported");
 }
 
+detailed_statistics detailed_stats() {
+    return {};
+}
+
+unsigned small_pool_count() {
+    return 0;
+}
+
+small_pool_stats small_pool_stats_at(unsigned idx) {
+    throw std::out_of_range("small_pool_stats_at() not supported");
+}
+
+unsigned free_span_orders() {
+    return 0;
+}
+
+free_span_stats free_span_stats_at(unsigned order) {
+    throw std::out_of_range("free_span_stats_at() not supported");
+}
+
 size_t min_free_memory() {
     return 0;
 }
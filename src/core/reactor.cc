@@ -31,6 +31,7 @@
 #include <exception>
 #include <filesystem>
 #include <fstream>
+#include <map>
 #include <ranges>
 #include <regex>
 #include <seastar/util/log-level.hh>
@@ -48,6 +49,7 @@
 #include <sys/statvfs.h>
 #include <sys/time.h>
 #include <sys/resource.h>
+#include <sys/sysmacros.h>
 #include <sys/socket.h>
 #include <sys/inotify.h>
 #include <sys/wait.h>
@@ -482,6 +484,21 @@ future<> pollable_fd_state::send_all(std::span<iovec> iovs) {
     });
 }
 
+future<> pollable_fd_state::send_all(std::span<iovec> iovs, deleter d) {
+    auto threshold = engine()._cfg.zerocopy_send_threshold;
+    if (!threshold || internal::iovec_len(iovs) < threshold) {
+        return send_all(iovs).finally([d = std::move(d)] {});
+    }
+    return send_all_zerocopy(iovs, std::move(d));
+}
+
+future<> pollable_fd_state::send_all_zerocopy(std::span<iovec> iovs, deleter d) {
+    return engine()._backend->sendmsg_zerocopy(*this, iovs, internal::iovec_len(iovs), d.share()).then([this, iovs, d = std::move(d)] (size_t size) mutable {
+        auto niovs = internal::iovec_trim_front(iovs, size);
+        return niovs.empty() ? make_ready_future<>() : send_all_zerocopy(niovs, std::move(d));
+    });
+}
+
 future<> pollable_fd_state::write_all(std::span<iovec> iovs) {
     return write_some(iovs).then([this, iovs] (size_t size) {
         auto niovs = internal::iovec_trim_front(iovs, size);
@@ -549,13 +566,43 @@ future<size_t> pollable_fd_state::recvmsg(struct msghdr *msg) {
         // all messages without resorting to epoll. However this adds extra
         // recvmsg() call when we hit the empty queue condition, so it may
         // hurt request-response workload in which the queue is empty when we
-        // initially enter recvmsg(). If that turns out to be a problem, we can
-        // improve speculation by using recvmmsg().
+        // initially enter recvmsg(). recvmmsg() below speculates better.
         speculate_epoll(EPOLLIN);
         return make_ready_future<size_t>(*r);
     });
 }
 
+future<size_t> pollable_fd_state::recvmmsg(struct mmsghdr* msgs, size_t n) {
+    maybe_no_more_recv();
+    return engine().readable(*this).then([this, msgs, n] {
+        auto r = fd.recvmmsg(msgs, n, 0);
+        if (!r) {
+            return recvmmsg(msgs, n);
+        }
+        // Unlike with recvmsg(), we know whether the queue was drained: only
+        // a full batch suggests that more messages are waiting.
+        if (*r == n) {
+            speculate_epoll(EPOLLIN);
+        }
+        return make_ready_future<size_t>(*r);
+    });
+}
+
+future<size_t> pollable_fd_state::sendmmsg(struct mmsghdr* msgs, size_t n) {
+    maybe_no_more_send();
+    return engine().writeable(*this).then([this, msgs, n] {
+        auto r = fd.sendmmsg(msgs, n, 0);
+        if (!r) {
+            return sendmmsg(msgs, n);
+        }
+        // See the comment about speculation in sendmsg().
+        if (*r == n) {
+            speculate_epoll(EPOLLOUT);
+        }
+        return make_ready_future<size_t>(*r);
+    });
+}
+
 future<size_t> pollable_fd_state::sendmsg(struct msghdr* msg) {
     maybe_no_more_send();
     return engine().writeable(*this).then([this, msg] () mutable {
@@ -1128,7 +1175,7 @@ reactor::reactor(std::shared_ptr<seastar::smp> smp, alien::instance& alien, unsi
     , _id(id)
     , _cpu_stall_detector(internal::make_cpu_stall_detector())
     , _cpu_sched(nullptr, 0)
-    , _thread_pool(std::make_unique<thread_pool>(seastar::format("syscall-{}", id), _notify_eventfd)) {
+    , _thread_pool(std::make_unique<thread_pool>(seastar::format("syscall-{}", id), _notify_eventfd, _cfg.syscall_threads)) {
     /*
      * The _backend assignment is here, not on the initialization list as
      * the chosen backend constructor may want to handle signals and thus
@@ -1884,10 +1931,150 @@ size_t sanitize_iovecs(std::vector<iovec>& iov, size_t disk_alignment) noexcept
 
 }
 
+bool reactor::have_native_file_ops() const noexcept {
+    return _cfg.native_file_ops && _backend->have_native_file_ops();
+}
+
+bool reactor::use_native_file_op(io_stats::file_op op) noexcept {
+    bool native = have_native_file_ops();
+    (native ? _io_stats.native_file_ops : _io_stats.pool_file_ops)[size_t(op)]++;
+    return native;
+}
+
+future<ssize_t>
+reactor::submit_native_file_op(internal::io_request req) noexcept {
+    // Does not go through the I/O queue. Errors are returned rather than
+    // thrown, so that callers report them just like those of the syscalls
+    // made in the thread pool.
+    struct file_op_desc final : public io_completion {
+        promise<ssize_t> _pr;
+    public:
+        virtual void complete(size_t res) noexcept override {
+            _pr.set_value(ssize_t(res));
+            delete this;
+        }
+
+        virtual void set_exception(std::exception_ptr eptr) noexcept override {
+            try {
+                std::rethrow_exception(std::move(eptr));
+            } catch (const std::system_error& e) {
+                _pr.set_value(-ssize_t(e.code().value()));
+            } catch (...) {
+                _pr.set_exception(std::current_exception());
+            }
+            delete this;
+        }
+
+        future<ssize_t> get_future() {
+            return _pr.get_future();
+        }
+    };
+
+    try {
+        auto desc = new file_op_desc;
+        auto fut = desc->get_future();
+        _io_sink.submit(desc, std::move(req));
+        return fut;
+    } catch (...) {
+        return current_exception_as_future<ssize_t>();
+    }
+}
+
+static struct stat statx_to_stat(const struct ::statx& stx) noexcept {
+    struct stat st = {};
+    st.st_dev = makedev(stx.stx_dev_major, stx.stx_dev_minor);
+    st.st_ino = stx.stx_ino;
+    st.st_mode = stx.stx_mode;
+    st.st_nlink = stx.stx_nlink;
+    st.st_uid = stx.stx_uid;
+    st.st_gid = stx.stx_gid;
+    st.st_rdev = makedev(stx.stx_rdev_major, stx.stx_rdev_minor);
+    st.st_size = stx.stx_size;
+    st.st_blksize = stx.stx_blksize;
+    st.st_blocks = stx.stx_blocks;
+    st.st_atim = timespec{stx.stx_atime.tv_sec, stx.stx_atime.tv_nsec};
+    st.st_mtim = timespec{stx.stx_mtime.tv_sec, stx.stx_mtime.tv_nsec};
+    st.st_ctim = timespec{stx.stx_ctime.tv_sec, stx.stx_ctime.tv_nsec};
+    return st;
+}
+
+future<ssize_t>
+reactor::native_stat(int dirfd, const char* path, int flags, struct stat& st) noexcept {
+    struct ::statx stx;
+    auto res = co_await submit_native_file_op(internal::io_request::make_statx(dirfd, path, flags, STATX_BASIC_STATS, &stx));
+    if (res >= 0) {
+        st = statx_to_stat(stx);
+    }
+    co_return res;
+}
+
+static void set_extent_size_hint(int fd, uint64_t hint) noexcept {
+    fsxattr attr = {};
+    int r = ::ioctl(fd, XFS_IOC_FSGETXATTR, &attr);
+    // xfs delayed allocation is disabled when extent size hints are present.
+    // This causes tons of xfs log fsyncs. Given that extent size hints are
+    // unneeded when delayed allocation is available (which is the case
+    // when not using O_DIRECT), disable them.
+    //
+    // Ignore error; may be !xfs, and just a hint anyway
+    if (r != -1) {
+        attr.fsx_xflags |= XFS_XFLAG_EXTSIZE;
+        attr.fsx_extsize = std::min(hint, file_open_options::max_extent_allocation_size_hint);
+
+        attr.fsx_extsize = align_up<uint32_t>(attr.fsx_extsize, file_open_options::min_extent_size_hint_alignment);
+
+        // Ignore error; may be !xfs, and just a hint anyway
+        ::ioctl(fd, XFS_IOC_FSSETXATTR, &attr);
+    }
+}
+
 future<file>
 reactor::open_file_dma(std::string_view nameref, open_flags flags, file_open_options options) noexcept {
     auto open_flags = static_cast<int>(flags);
     sstring name(nameref);
+    // When the filesystem doesn't support O_DIRECT the open is retried in the
+    // thread pool, which can't be done if the native open created the file
+    // exclusively.
+    // Counted once it's known where the open was done
+    if (!(open_flags & O_EXCL) && have_native_file_ops()) {
+        auto native_flags = open_flags | O_CLOEXEC;
+        auto native_options = options;
+        if (_cfg.bypass_fsync) {
+            native_options.durable = false;
+        }
+        if (!native_options.durable) {
+            native_flags &= ~O_DSYNC;
+        }
+        int o_direct_flag = _cfg.kernel_page_cache ? 0 : O_DIRECT;
+        auto mode = static_cast<mode_t>(options.create_permissions);
+        auto fd = co_await submit_native_file_op(internal::io_request::make_openat(AT_FDCWD, name.c_str(), native_flags | o_direct_flag, mode));
+        if (fd != -EINVAL || !o_direct_flag) {
+            _io_stats.native_file_ops[size_t(io_stats::file_op::open)]++;
+        }
+        if (fd >= 0) {
+            auto close_fd = defer([fd] () noexcept { ::close(fd); });
+            struct stat st;
+            auto sr = wrap_kernel_result(co_await native_stat(fd, "", AT_EMPTY_PATH, st), st);
+            if (sr.failed()) {
+                co_return coroutine::exception(sr.make_fs_exception_ptr("open failed", fs::path(name)));
+            }
+            // Extent size hints only matter to files that are written to.
+            // Setting one only updates the in-memory inode, so it's done
+            // here rather than handed to the thread pool.
+            if (native_options.extent_allocation_size_hint && !_cfg.kernel_page_cache && (native_flags & O_ACCMODE) != O_RDONLY) {
+                set_extent_size_hint(fd, native_options.extent_allocation_size_hint);
+            }
+            close_fd.cancel();
+            shared_ptr<file_impl> impl = co_await make_file_impl(fd, native_options, native_flags, sr.extra);
+            co_return file(std::move(impl));
+        }
+        if (fd != -EINVAL || !o_direct_flag) {
+            co_return coroutine::exception(wrap_kernel_result(fd).make_fs_exception_ptr("open failed", fs::path(name)));
+        }
+        // O_DIRECT may not be supported by the filesystem, which the thread
+        // pool path can detect and forgive
+    }
+    _io_stats.pool_file_ops[size_t(io_stats::file_op::open)]++;
     syscall_result_extra<struct stat> sr = co_await _thread_pool->submit<syscall_result_extra<struct stat>>(
             internal::thread_pool_submit_reason::file_operation, [this, name, &open_flags, &options, strict_o_direct = _cfg.strict_o_direct, bypass_fsync = _cfg.bypass_fsync] () mutable {
         // We want O_DIRECT, except in three cases:
@@ -1929,24 +2116,7 @@ reactor::open_file_dma(std::string_view nameref, open_flags flags, file_open_opt
             }
         }
         if (fd != -1 && options.extent_allocation_size_hint && !_cfg.kernel_page_cache) {
-            fsxattr attr = {};
-            int r = ::ioctl(fd, XFS_IOC_FSGETXATTR, &attr);
-            // xfs delayed allocation is disabled when extent size hints are present.
-            // This causes tons of xfs log fsyncs. Given that extent size hints are
-            // unneeded when delayed allocation is available (which is the case
-            // when not using O_DIRECT), disable them.
-            //
-            // Ignore error; may be !xfs, and just a hint anyway
-            if (r != -1) {
-                attr.fsx_xflags |= XFS_XFLAG_EXTSIZE;
-                attr.fsx_extsize = std::min(options.extent_allocation_size_hint,
-                                    file_open_options::max_extent_allocation_size_hint);
-
-                attr.fsx_extsize = align_up<uint32_t>(attr.fsx_extsize, file_open_options::min_extent_size_hint_alignment);
-
-                // Ignore error; may be !xfs, and just a hint anyway
-                ::ioctl(fd, XFS_IOC_FSSETXATTR, &attr);
-            }
+            set_extent_size_hint(fd, options.extent_allocation_size_hint);
         }
         r = ::fstat(fd, &st);
         if (r == -1) {
@@ -1965,10 +2135,20 @@ reactor::open_file_dma(std::string_view nameref, open_flags flags, file_open_opt
 future<>
 reactor::remove_file(std::string_view pathname_view) noexcept {
     auto pathname = sstring(pathname_view);
-    syscall_result<int> sr = co_await _thread_pool->submit<syscall_result<int>>(
-            internal::thread_pool_submit_reason::file_operation, [pathname] {
-        return wrap_syscall<int>(::remove(pathname.c_str()));
-    });
+    syscall_result<int> sr(0, 0);
+    if (use_native_file_op(io_stats::file_op::remove)) {
+        // Like remove(3): unlink, or rmdir if it's a directory
+        auto res = co_await submit_native_file_op(internal::io_request::make_unlinkat(AT_FDCWD, pathname.c_str(), 0));
+        if (res == -EISDIR) {
+            res = co_await submit_native_file_op(internal::io_request::make_unlinkat(AT_FDCWD, pathname.c_str(), AT_REMOVEDIR));
+        }
+        sr = wrap_kernel_result(res);
+    } else {
+        sr = co_await _thread_pool->submit<syscall_result<int>>(
+                internal::thread_pool_submit_reason::file_operation, [pathname] {
+            return wrap_syscall<int>(::remove(pathname.c_str()));
+        });
+    }
     if (sr.failed()) {
         co_await coroutine::return_exception_ptr(
           sr.make_fs_exception_ptr("remove failed", fs::path(pathname)));
@@ -1980,11 +2160,17 @@ reactor::rename_file(std::string_view old_pathname_view, std::string_view new_pa
     auto old_pathname = sstring(old_pathname_view);
     auto new_pathname = sstring(new_pathname_view);
     auto raw_flags = std::underlying_type_t<rename_flags>(flags);
-    syscall_result<int> sr = co_await _thread_pool->submit<syscall_result<int>>(
-            internal::thread_pool_submit_reason::file_operation, [old_pathname, new_pathname, raw_flags] {
-        return wrap_syscall<int>(static_cast<int>(
-                ::syscall(SYS_renameat2, AT_FDCWD, old_pathname.c_str(), AT_FDCWD, new_pathname.c_str(), raw_flags)));
-    });
+    syscall_result<int> sr(0, 0);
+    if (use_native_file_op(io_stats::file_op::rename)) {
+        sr = wrap_kernel_result(co_await submit_native_file_op(
+                internal::io_request::make_renameat(AT_FDCWD, old_pathname.c_str(), AT_FDCWD, new_pathname.c_str(), raw_flags)));
+    } else {
+        sr = co_await _thread_pool->submit<syscall_result<int>>(
+                internal::thread_pool_submit_reason::file_operation, [old_pathname, new_pathname, raw_flags] {
+            return wrap_syscall<int>(static_cast<int>(
+                    ::syscall(SYS_renameat2, AT_FDCWD, old_pathname.c_str(), AT_FDCWD, new_pathname.c_str(), raw_flags)));
+        });
+    }
     if (sr.failed()) {
         co_await coroutine::return_exception_ptr(
           sr.make_fs_exception_ptr("rename failed", fs::path(old_pathname), fs::path(new_pathname)));
@@ -2048,13 +2234,20 @@ directory_entry_type stat_to_entry_type(mode_t type) {
 future<std::optional<directory_entry_type>>
 reactor::file_type(std::string_view name_view, follow_symlink follow) noexcept {
     auto name = sstring(name_view);
-    syscall_result_extra<struct stat> sr = co_await _thread_pool->submit<syscall_result_extra<struct stat>>(
-            internal::thread_pool_submit_reason::file_operation, [name, follow] {
+    syscall_result_extra<struct stat> sr(0, 0, {});
+    if (use_native_file_op(io_stats::file_op::stat)) {
         struct stat st;
-        auto stat_syscall = follow ? stat : lstat;
-        auto ret = stat_syscall(name.c_str(), &st);
-        return wrap_syscall(ret, st);
-    });
+        auto res = co_await native_stat(AT_FDCWD, name.c_str(), follow ? 0 : AT_SYMLINK_NOFOLLOW, st);
+        sr = wrap_kernel_result(res, st);
+    } else {
+        sr = co_await _thread_pool->submit<syscall_result_extra<struct stat>>(
+                internal::thread_pool_submit_reason::file_operation, [name, follow] {
+            struct stat st;
+            auto stat_syscall = follow ? stat : lstat;
+            auto ret = stat_syscall(name.c_str(), &st);
+            return wrap_syscall(ret, st);
+        });
+    }
     if (sr.failed()) {
         if (sr.error != ENOENT && sr.error != ENOTDIR) {
             co_return coroutine::exception(sr.make_fs_exception_ptr("stat failed", fs::path(name)));
@@ -2334,13 +2527,20 @@ static stat_data make_stat_data(const struct stat& st) {
 future<stat_data>
 reactor::file_stat(std::string_view pathname_view, follow_symlink follow) noexcept {
     auto pathname = sstring(pathname_view);
-    syscall_result_extra<struct stat> sr = co_await _thread_pool->submit<syscall_result_extra<struct stat>>(
-            internal::thread_pool_submit_reason::file_operation, [&] {
+    syscall_result_extra<struct stat> sr(0, 0, {});
+    if (use_native_file_op(io_stats::file_op::stat)) {
         struct stat st;
-        auto stat_syscall = follow ? stat : lstat;
-        auto ret = stat_syscall(pathname.c_str(), &st);
-        return wrap_syscall(ret, st);
-    });
+        auto res = co_await native_stat(AT_FDCWD, pathname.c_str(), follow ? 0 : AT_SYMLINK_NOFOLLOW, st);
+        sr = wrap_kernel_result(res, st);
+    } else {
+        sr = co_await _thread_pool->submit<syscall_result_extra<struct stat>>(
+                internal::thread_pool_submit_reason::file_operation, [&] {
+            struct stat st;
+            auto stat_syscall = follow ? stat : lstat;
+            auto ret = stat_syscall(pathname.c_str(), &st);
+            return wrap_syscall(ret, st);
+        });
+    }
     if (sr.failed()) {
         co_return coroutine::exception(sr.make_fs_exception_ptr("stat failed", fs::path(pathname)));
     }
@@ -2642,6 +2842,12 @@ void reactor::register_metrics() {
         return sm::make_counter("io_threaded_fallbacks", std::bind(&thread_pool::count, _thread_pool.get(), r),
                 sm::description("Total number of io-threaded-fallbacks operations"), { reason_label(reason_str), });
     };
+    auto io_fallback_latency = [this](const sstring& reason_str, internal::thread_pool_submit_reason r) {
+        static auto reason_label = sm::label("reason");
+        return sm::make_histogram("io_threaded_fallbacks_latency", [this, r] { return _thread_pool->latency(r).to_metrics_histogram(); },
+                sm::description("Latency in microseconds of io-threaded-fallbacks operations, from submission until the reactor collects the result"),
+                { reason_label(reason_str), }).set_skip_when_empty();
+    };
 
     _metric_groups.add_group("reactor", {
             sm::make_gauge("tasks_pending", std::bind(&reactor::pending_task_count, this), sm::description("Number of pending tasks in the queue")),
@@ -2674,14 +2880,51 @@ void reactor::register_metrics() {
             // total_operations value:DERIVE:0:U
             sm::make_counter("fsyncs", _io_stats.fsyncs, sm::description("Total number of fsync operations")),
             sm::make_counter("aio_retries", _io_stats.aio_retries, sm::description("Total number of IOCB-s re-submitted via thread-pool")),
+            sm::make_total_bytes("zerocopy_send_bytes", _io_stats.zerocopy_send_bytes, sm::description("Total bytes sent from user memory without copying (see --zerocopy-send-threshold)")),
+            sm::make_total_bytes("zerocopy_send_copied_bytes", _io_stats.zerocopy_send_copied_bytes,
+                    sm::description("Total bytes eligible for zero-copy send that were copied nevertheless, by the kernel or because the reactor backend lacks support")),
+            sm::make_counter("uring_multishot_accepts", _io_stats.uring_multishot_accepts, sm::description("Total number of connections accepted by io_uring multishot accept")),
+            sm::make_counter("uring_multishot_recvs", _io_stats.uring_multishot_recvs, sm::description("Total number of buffers received by io_uring multishot recv")),
+            sm::make_counter("uring_buf_ring_exhausted", _io_stats.uring_buf_ring_exhausted,
+                    sm::description("Total number of io_uring multishot receives terminated because the provided buffer ring ran out of buffers")),
+            sm::make_counter("uring_buf_ring_fallback_recvs", _io_stats.uring_buf_ring_fallback_recvs,
+                    sm::description("Total number of regular receives issued because all provided buffer ring buffers were held by the application")),
+            sm::make_counter("uring_multishot_recv_pauses", _io_stats.uring_multishot_recv_pauses,
+                    sm::description("Total number of io_uring multishot receives cancelled because too many received buffers were waiting to be read (see --io-uring-multishot-recv-queue)")),
             // total_operations value:DERIVE:0:U
             io_fallback_counter("aio_fallback", internal::thread_pool_submit_reason::aio_fallback),
             // total_operations value:DERIVE:0:U
             io_fallback_counter("file_operation", internal::thread_pool_submit_reason::file_operation),
             // total_operations value:DERIVE:0:U
             io_fallback_counter("process_operation", internal::thread_pool_submit_reason::process_operation),
+            // total_operations value:DERIVE:0:U
+            io_fallback_counter("memory_operation", internal::thread_pool_submit_reason::memory_operation),
+            io_fallback_latency("aio_fallback", internal::thread_pool_submit_reason::aio_fallback),
+            io_fallback_latency("file_operation", internal::thread_pool_submit_reason::file_operation),
+            io_fallback_latency("process_operation", internal::thread_pool_submit_reason::process_operation),
+            io_fallback_latency("memory_operation", internal::thread_pool_submit_reason::memory_operation),
+            sm::make_gauge("syscall_threads", [this] { return _thread_pool->threads(); }, sm::description("Number of threads running blocking system calls for the shard")),
     });
 
+    std::vector<sm::metric_definition> file_op_metrics;
+    static auto op_label = sm::label("op");
+    static auto path_label = sm::label("path");
+    for (auto [op_str, op] : std::initializer_list<std::pair<const char*, io_stats::file_op>>{
+            {"fdatasync", io_stats::file_op::fdatasync},
+            {"fallocate", io_stats::file_op::fallocate},
+            {"open", io_stats::file_op::open},
+            {"stat", io_stats::file_op::stat},
+            {"rename", io_stats::file_op::rename},
+            {"remove", io_stats::file_op::remove},
+            }) {
+        auto desc = sm::description("Total number of file operations, by whether the reactor backend submitted them to the kernel or they ran in the syscall thread");
+        file_op_metrics.emplace_back(sm::make_counter("file_operations", _io_stats.native_file_ops[size_t(op)], desc,
+                { op_label(op_str), path_label("native") }));
+        file_op_metrics.emplace_back(sm::make_counter("file_operations", _io_stats.pool_file_ops[size_t(op)], desc,
+                { op_label(op_str), path_label("thread_pool") }));
+    }
+    _metric_groups.add_group("reactor", file_op_metrics);
+
     _metric_groups.add_group("memory", {
             sm::make_counter("malloc_operations", [] { return memory::stats().mallocs(); },
                     sm::description("Total number of malloc operations")),
@@ -2693,17 +2936,53 @@ void reactor::register_metrics() {
             sm::make_current_bytes("allocated_memory", [] { return memory::stats().allocated_memory(); }, sm::description("Allocated memory size in bytes")),
             sm::make_counter("reclaims_operations", [] { return memory::stats().reclaims(); }, sm::description("Total reclaims operations")),
             sm::make_counter("malloc_failed", [] { return memory::stats().failed_allocations(); }, sm::description("Total count of failed memory allocations")),
-            sm::make_counter("oversized_allocs", [] { return memory::stats().large_allocations(); }, sm::description("Total count of oversized memory allocations"))
+            sm::make_counter("oversized_allocs", [] { return memory::stats().large_allocations(); }, sm::description("Total count of oversized memory allocations")),
+            sm::make_counter("hugepage_collapses", [] { return memory::stats().hugepage_collapses(); },
+                    sm::description("Total count of shard memory huge pages collapsed into transparent huge pages")).set_skip_when_empty(),
+            sm::make_counter("hugepage_collapse_failures", [] { return memory::stats().hugepage_collapse_failures(); },
+                    sm::description("Total count of shard memory huge pages that could not be collapsed into transparent huge pages")).set_skip_when_empty(),
     });
 
+    std::vector<sm::metric_definition> allocator_metrics;
+    static auto object_size_label = sm::label("object_size");
+    for (unsigned i = 0; i < memory::small_pool_count(); ++i) {
+        auto size_l = object_size_label(memory::small_pool_stats_at(i).object_size);
+        allocator_metrics.emplace_back(sm::make_gauge("small_pool_objects", [i] { return memory::small_pool_stats_at(i).objects_in_use; },
+                sm::description("Number of live objects in a small object size class"), {size_l}).set_skip_when_empty());
+        allocator_metrics.emplace_back(sm::make_current_bytes("small_pool_memory", [i] { return memory::small_pool_stats_at(i).memory; },
+                sm::description("Memory held by a small object size class in bytes"), {size_l}).set_skip_when_empty());
+        allocator_metrics.emplace_back(sm::make_current_bytes("small_pool_unused_memory", [i] { return memory::small_pool_stats_at(i).unused; },
+                sm::description("Memory held by a small object size class but not used by live objects, in bytes"), {size_l}).set_skip_when_empty());
+    }
+    static auto order_label = sm::label("order");
+    for (unsigned i = 0; i < memory::free_span_orders(); ++i) {
+        allocator_metrics.emplace_back(sm::make_gauge("free_spans", [i] { return memory::free_span_stats_at(i).free_spans; },
+                sm::description("Number of free spans of 2^order pages in the page allocator"), {order_label(i)}).set_skip_when_empty());
+    }
+    _metric_groups.add_group("memory", allocator_metrics);
+
     _metric_groups.add_group("reactor", {
             sm::make_counter("logging_failures", [] { return logging_failures; }, sm::description("Total number of logging failures")),
             // total_operations value:DERIVE:0:U
             sm::make_counter("cpp_exceptions", _cxx_exceptions, sm::description("Total number of C++ exceptions")),
             sm::make_counter("internal_errors", internal::internal_errors, sm::description("Total number of internal errors (subset of cpp_exceptions) that usually indicate malfunction in the code")),
             sm::make_counter("abandoned_failed_futures", _abandoned_failed_futures, sm::description("Total number of abandoned failed futures, futures destroyed while still containing an exception")),
+            sm::make_counter("stealable_tasks", _stealable_tasks, sm::description("Total number of tasks submitted with smp::submit_stealable() on this shard")).set_skip_when_empty(),
+            sm::make_counter("stolen_tasks", _stolen_tasks, sm::description("Total number of stealable tasks this shard took from other shards while idle")).set_skip_when_empty(),
     });
 
+    if (_cfg.adaptive_idle_poll) {
+        _metric_groups.add_group("reactor", {
+            sm::make_counter("idle_spin_polls", _idle_poll_stats.spins, sm::description("Number of idle polls that spun without pausing the CPU")),
+            sm::make_counter("idle_pause_polls", _idle_poll_stats.pauses, sm::description("Number of idle polls that paused the CPU before polling again")),
+            sm::make_counter("idle_sleeps", _idle_poll_stats.sleeps, sm::description("Number of times the reactor went to sleep waiting for work")),
+            sm::make_gauge("idle_period_estimate_us", [this] { return std::chrono::duration<double, std::micro>(_idle_period_estimate).count(); },
+                    sm::description("Moving average of the time between going idle and work arriving, as learned by --adaptive-idle-poll")),
+            sm::make_gauge("idle_poll_window_us", [this] { return std::chrono::duration<double, std::micro>(_idle_poll_window).count(); },
+                    sm::description("How long the reactor polls when idle before going to sleep")),
+        });
+    }
+
     _metric_groups.add_group("reactor", {
         sm::make_counter("fstream_reads", _io_stats.fstream_reads,
                 sm::description(
@@ -2729,6 +3008,12 @@ void reactor::register_metrics() {
                 sm::description(
                         "Counts the number of buffered bytes that were read ahead of time and were discarded because they were not needed, wasting disk bandwidth."
                         " Indicates over-eager read ahead configuration.")),
+        sm::make_gauge("fstream_read_ahead_memory", _io_stats.fstream_read_ahead_memory,
+                sm::description("Bytes held by in-flight adaptive read-aheads of disk file streams, counted against the shard's read-ahead budget")),
+        sm::make_counter("fstream_read_aheads_denied", _io_stats.fstream_read_aheads_denied,
+                sm::description(
+                        "Counts the read-aheads adaptive disk file streams wanted to issue but didn't because the shard's read-ahead budget was exhausted."
+                        " Indicates too many concurrent streams or too small a budget.")),
     });
 }
 
@@ -2996,6 +3281,48 @@ class reactor::drain_cross_cpu_freelist_pollfn final : public simple_pollfn<true
     }
 };
 
+// Starts collapsing the queued huge pages each time the reactor is about
+// to sleep; the syscall thread wakes it up when done. Busy shards, which
+// don't sleep, are driven by _hugepage_collapse_timer instead.
+class reactor::collapse_hugepages_pollfn final : public reactor::pollfn {
+    reactor& _r;
+public:
+    explicit collapse_hugepages_pollfn(reactor& r) : _r(r) {}
+    virtual bool poll() final override {
+        return false;
+    }
+    virtual bool pure_poll() final override {
+        return false;
+    }
+    virtual bool try_enter_interrupt_mode() final override {
+        _r.collapse_pending_hugepages();
+        return true;
+    }
+    virtual void exit_interrupt_mode() final override {
+    }
+};
+
+// MADV_COLLAPSE can take milliseconds, so the huge pages queued by large
+// allocations are collapsed one at a time in the syscall thread pool
+void reactor::collapse_pending_hugepages() {
+    if (!_hugepage_collapses.available()) {
+        return;
+    }
+    _hugepage_collapses = repeat([this] {
+        auto hp = _stopping ? nullptr : memory::pop_pending_hugepage_collapse();
+        if (!hp) {
+            return make_ready_future<stop_iteration>(stop_iteration::yes);
+        }
+        return _thread_pool->submit<int>(internal::thread_pool_submit_reason::memory_operation, [hp] {
+            return memory::collapse_hugepage(hp);
+        }).then_wrapped([] (future<int> f) {
+            // Failing to submit counts as a failed collapse
+            memory::hugepage_collapse_done(f.failed() ? (f.ignore_ready_future(), EAGAIN) : f.get());
+            return stop_iteration::no;
+        });
+    });
+}
+
 class reactor::lowres_timer_pollfn final : public reactor::pollfn {
     reactor& _r;
     // A highres timer is implemented as a waking  signal; so
@@ -3405,6 +3732,17 @@ int reactor::do_run() {
     poller syscall_poller(std::make_unique<syscall_pollfn>(*this));
 
     poller drain_cross_cpu_freelist(std::make_unique<drain_cross_cpu_freelist_pollfn>());
+    poller collapse_hugepages(std::make_unique<collapse_hugepages_pollfn>(*this));
+    if (memory::hugepage_collapses_enabled()) {
+        _hugepage_collapse_timer.set_callback([this] {
+            collapse_pending_hugepages();
+        });
+        _hugepage_collapse_timer.arm_periodic(100ms);
+        do_at_exit([this] {
+            _hugepage_collapse_timer.cancel();
+            return std::exchange(_hugepage_collapses, make_ready_future<>());
+        });
+    }
 
     poller expire_lowres_timers(std::make_unique<lowres_timer_pollfn>(*this));
     poller sig_poller(std::make_unique<signal_pollfn>(*this));
@@ -3436,6 +3774,8 @@ int reactor::do_run() {
     SEASTAR_ASSERT(r == 0);
 
     bool idle = false;
+    // Until something is learned, poll for the full budget like the static policy
+    _idle_poll_window = std::chrono::duration_cast<sched_clock::duration>(_cfg.max_poll_time);
 
     auto check_for_work = [this] () {
         return poll_once() || have_more_tasks();
@@ -3457,11 +3797,17 @@ int reactor::do_run() {
                 _total_idle += idle_end - idle_start;
                 idle_start = idle_end;
                 idle = false;
+                if (_cfg.adaptive_idle_poll) {
+                    update_idle_estimate(idle_end - _idle_period_start);
+                }
             }
+        } else if (_cfg.work_stealing && smp::steal_work()) {
+            // Picked up work from a busier shard; run it before considering idling.
         } else {
             idle_end = now();
             if (!idle) {
                 idle_start = idle_end;
+                _idle_period_start = idle_end;
                 idle = true;
             }
             bool go_to_sleep = true;
@@ -3475,9 +3821,19 @@ int reactor::do_run() {
                 report_exception("Exception while running idle cpu handler", std::current_exception());
             }
             if (go_to_sleep) {
-                internal::cpu_relax();
-                if (idle_end - idle_start > _cfg.max_poll_time) {
+                auto action = _cfg.adaptive_idle_poll ? adaptive_idle_action(idle_end - _idle_period_start)
+                        : idle_end - idle_start > _cfg.max_poll_time ? idle_action::sleep : idle_action::pause;
+                if (action == idle_action::spin) {
+                    _idle_poll_stats.spins++;
+                } else {
+                    internal::cpu_relax();
+                    if (action == idle_action::pause) {
+                        _idle_poll_stats.pauses++;
+                    }
+                }
+                if (action == idle_action::sleep) {
                     if (pollers_enter_interrupt_mode()) {
+                        _idle_poll_stats.sleeps++;
                         // Turn off the task quota timer to avoid spurious wakeups
                         struct itimerspec zero_itimerspec = {};
                         _task_quota_timer.timerfd_settime(0, zero_itimerspec);
@@ -3490,6 +3846,9 @@ int reactor::do_run() {
                         // We may have slept for a while, so freshen idle_end
                         idle_end = now();
                         _task_quota_timer.timerfd_settime(0, task_quote_itimerspec);
+                    } else {
+                        // A poller has work pending, so this was just another pause
+                        _idle_poll_stats.pauses++;
                     }
                 }
             } else {
@@ -3692,14 +4051,16 @@ void syscall_work_queue::submit_item(std::unique_ptr<syscall_work_queue::work_it
     });
 }
 
-unsigned syscall_work_queue::complete() {
+unsigned syscall_work_queue::complete(internal::submit_metrics& metrics) {
     std::array<work_item*, queue_length> tmp_buf;
     auto end = tmp_buf.data();
     auto nr = _completed.consume_all([&] (work_item* wi) {
         *end++ = wi;
     });
+    auto now = std::chrono::steady_clock::now();
     for (auto p = tmp_buf.data(); p != end; ++p) {
         auto wi = *p;
+        metrics.record_latency(wi->_reason, now - wi->_submitted);
         wi->complete();
         delete wi;
     }
@@ -3762,19 +4123,69 @@ void smp_message_queue::submit_item(shard_id t, smp_timeout_clock::time_point ti
     // no exceptions from this point
     item.release();
     units_fut.get().release();
-    if (_tx.a.pending_fifo.size() >= batch_size) {
+    if (_tx.a.pending_fifo.size() >= _request_batch_limit) {
+        grow_batch_limit(_request_batch_limit);
         move_pending();
     }
   });
 }
 
+void smp_message_queue::submit_items(shard_id t, smp_timeout_clock::time_point timeout, std::vector<std::unique_ptr<smp_message_queue::work_item>> items) {
+  if (items.empty()) {
+      return;
+  }
+  // matching signal() in process_completions()
+  auto ssg_id = internal::smp_service_group_id(items.front()->ssg);
+  auto& sem = get_smp_service_groups_semaphore(ssg_id, t);
+  // The semaphore could never grant more units than it has; admit such
+  // batches in chunks that fit, which the semaphore keeps in order
+  auto capacity = get_smp_service_groups_semaphore_capacity(ssg_id);
+  if (items.size() > capacity) {
+      for (size_t i = 0; i < items.size(); i += capacity) {
+          auto end = std::min(items.size(), i + capacity);
+          submit_items(t, timeout, std::vector<std::unique_ptr<work_item>>(
+                  std::make_move_iterator(items.begin() + i), std::make_move_iterator(items.begin() + end)));
+      }
+      return;
+  }
+  auto nr = items.size();
+  // Futures indirectly forwarded to `items`.
+  (void)get_units(sem, nr, timeout).then_wrapped([this, nr, items = std::move(items)] (future<smp_service_group_semaphore_units> units_fut) mutable {
+    if (units_fut.failed()) {
+        auto ex = units_fut.get_exception();
+        for (auto& item : items) {
+            item->fail_with(ex);
+        }
+        _compl += nr;
+        _last_cmpl_batch += nr;
+        return;
+    }
+    for (auto& item : items) {
+        _tx.a.pending_fifo.push_back(item.get());
+        item.release();
+    }
+    // no exceptions from this point
+    units_fut.get().release();
+    // Publish the whole set at once rather than waiting for the poller.
+    move_pending();
+  });
+}
+
 void smp_message_queue::respond(work_item* item) {
     _completed_fifo.push_back(item);
-    if (_completed_fifo.size() >= batch_size || engine().stopped()) {
+    if (engine().stopped()) {
+        flush_response_batch();
+    } else if (_completed_fifo.size() >= _response_batch_limit) {
+        grow_batch_limit(_response_batch_limit);
         flush_response_batch();
     }
 }
 
+void smp_message_queue::poll_response_batch() {
+    shrink_batch_limit(_response_batch_limit, _completed_fifo.size());
+    flush_response_batch();
+}
+
 void smp_message_queue::flush_response_batch() {
     if (!_completed_fifo.empty()) {
         auto begin = _completed_fifo.cbegin();
@@ -3856,6 +4267,7 @@ size_t smp_message_queue::process_completions(shard_id t) {
 }
 
 void smp_message_queue::flush_request_batch() {
+    shrink_batch_limit(_request_batch_limit, _tx.a.pending_fifo.size());
     if (!_tx.a.pending_fifo.empty()) {
         move_pending();
     }
@@ -3882,6 +4294,8 @@ void smp_message_queue::start(unsigned cpuid) {
             sm::make_queue_length("receive_batch_queue_length", _last_rcv_batch, sm::description("Current receive batch queue length"), {sm::shard_label(instance)})(sm::metric_disabled),
             sm::make_queue_length("complete_batch_queue_length", _last_cmpl_batch, sm::description("Current complete batch queue length"), {sm::shard_label(instance)})(sm::metric_disabled),
             sm::make_queue_length("send_queue_length", _current_queue_length, sm::description("Current send queue length"), {sm::shard_label(instance)})(sm::metric_disabled),
+            sm::make_gauge("send_batch_limit", _request_batch_limit,
+                    sm::description("Current number of requests accumulated before they are sent outside of polling"), {sm::shard_label(instance)})(sm::metric_disabled),
             // total_operations value:DERIVE:0:U
             sm::make_counter("total_received_messages", _received, sm::description("Total number of received messages"), {sm::shard_label(instance)})(sm::metric_disabled),
             // total_operations value:DERIVE:0:U
@@ -4041,13 +4455,19 @@ reactor_options::reactor_options(program_options::option_group* parent_group)
     , poll_mode(*this, "poll-mode", "poll continuously (100% cpu use)")
     , idle_poll_time_us(*this, "idle-poll-time-us", reactor::calculate_poll_time() / 1us,
                 "idle polling time in microseconds (reduce for overprovisioned environments or laptops)")
+    , adaptive_idle_poll(*this, "adaptive-idle-poll", false,
+                "choose between spinning, pausing and sleeping when idle based on how often work arrives, polling for at most --idle-poll-time-us")
     , poll_aio(*this, "poll-aio", true,
                 "busy-poll for disk I/O (reduces latency and increases throughput)")
     , task_quota_ms(*this, "task-quota-ms", 0.5, "Max time (ms) between polls")
     , io_latency_goal_ms(*this, "io-latency-goal-ms", {}, "Max time (ms) io operations must take (1.5 * task-quota-ms if not set)")
     , io_flow_ratio_threshold(*this, "io-flow-rate-threshold", 1.1, "Dispatch rate to completion rate threshold")
     , io_completion_notify_ms(*this, "io-completion-notify-ms", {}, "Threshold in milliseconds over which IO request completion is reported to logs")
+    , io_auto_calibrate(*this, "io-auto-calibrate", false, "Adjust the disk rates at runtime based on observed completion latency, using io-properties as the upper bound")
+    , io_auto_calibrate_min_ratio(*this, "io-auto-calibrate-min-ratio", 0.05, "Lowest fraction of the io-properties rates --io-auto-calibrate may lower the disk rates to")
+    , io_merge_max_latency_us(*this, "io-merge-max-latency-us", 0, "Merge adjacent IO requests as long as the first one is delayed by no more than this (0 disables merging)")
     , max_task_backlog(*this, "max-task-backlog", 1000, "Maximum number of task backlog to allow; above this we ignore I/O")
+    , enable_work_stealing(*this, "enable-work-stealing", false, "Let idle shards run work submitted with smp::submit_stealable() on other shards")
     , blocked_reactor_notify_ms(*this, "blocked-reactor-notify-ms", 25, "threshold in miliseconds over which the reactor is considered blocked if no progress is made")
     , blocked_reactor_reports_per_minute(*this, "blocked-reactor-reports-per-minute", 5, "Maximum number of backtraces reported by stall detector per minute")
     , blocked_reactor_report_format_oneline(*this, "blocked-reactor-report-format-oneline", true, "Print a simplified backtrace on a single line")
@@ -4075,8 +4495,28 @@ reactor_options::reactor_options(program_options::option_group* parent_group)
                 "CPUs to use (in cpuset(7) format) for backend's async workers."
                 " Only applicable to, and required by, the asymmetric_io_uring reactor backend (see --reactor-backend)."
                 " Note that if the --cpuset is not set, using --async-workers-cpuset will restrict the CPUs available to the SMP shards.")
+    , io_uring_registered_buffers(*this, "io-uring-registered-buffers", {},
+                "Size of the per-shard buffer pool registered with io_uring as fixed buffers (ex: 16M). DMA reads and writes"
+                " into buffers from this pool skip per-request page pinning. Only used by the io_uring reactor backends (see --reactor-backend)")
+    , zerocopy_send_threshold(*this, "zerocopy-send-threshold", {},
+                "Send socket writes of at least this many bytes (ex: 64k) without copying them into the kernel; 0 disables zero-copy send."
+                " Only the io_uring reactor backends implement it (requires Linux 6.2 or later), others copy as usual")
+    , io_uring_multishot(*this, "io-uring-multishot", false,
+                "Use multishot accept and multishot recv with a kernel-provided buffer ring for sockets. Requires Linux 6.0 or later."
+                " Only used by the io_uring reactor backend (see --reactor-backend)")
+    , io_uring_buf_ring_entries(*this, "io-uring-buf-ring-entries", 256,
+                "Number of buffers (a power of two) in the per-shard provided buffer ring used by --io-uring-multishot")
+    , io_uring_buf_ring_buffer_size(*this, "io-uring-buf-ring-buffer-size", 16384,
+                "Size of each buffer in the per-shard provided buffer ring used by --io-uring-multishot")
+    , io_uring_multishot_recv_queue(*this, "io-uring-multishot-recv-queue", 16,
+                "Number of received buffers a connection may have waiting to be read before its multishot receive is paused (see --io-uring-multishot)")
     , aio_fsync(*this, "aio-fsync", kernel_supports_aio_fsync(),
                 "Use Linux aio for fsync() calls. This reduces latency; requires Linux 4.18 or later.")
+    , native_file_ops(*this, "native-file-ops", true,
+                "Submit file metadata operations (open, stat, rename, remove, fallocate) through io_uring instead of the syscall thread."
+                " Requires Linux 5.11 or later; ignored by the other reactor backends.")
+    , syscall_threads(*this, "syscall-threads", 1,
+                "Number of threads per shard running blocking system calls (such as directory listing) that have no non-blocking alternative")
     , max_networking_io_control_blocks(*this, "max-networking-io-control-blocks", 10000,
                 "Maximum number of I/O control blocks (IOCBs) to allocate per shard. This translates to the number of sockets supported per shard."
                 " Requires tuning /proc/sys/fs/aio-max-nr. Only valid for the linux-aio reactor backend (see --reactor-backend).")
@@ -4100,6 +4540,7 @@ smp_options::smp_options(program_options::option_group* parent_group)
     , reserve_memory(*this, "reserve-memory", {}, "memory reserved to OS (if --memory not specified)")
     , hugepages(*this, "hugepages", {}, "path to accessible hugetlbfs mount (typically /dev/hugepages/something)")
     , lock_memory(*this, "lock-memory", {}, "lock all memory (prevents swapping)")
+    , hugepage_spans(*this, "hugepage-spans", false, "collapse shard memory into transparent huge pages as the allocator hands it out (Linux 6.1+)")
     , thread_affinity(*this, "thread-affinity", true, "pin threads to their cpus (disable for overprovisioning)")
 #ifdef SEASTAR_HAVE_HWLOC
     , num_io_groups(*this, "num-io-groups", {}, "Number of IO groups. Each IO group will be responsible for a fraction of the IO requests. Defaults to the number of NUMA nodes")
@@ -4200,6 +4641,8 @@ void smp::cleanup() noexcept {
     smp::_threads = std::vector<posix_thread>();
     _thread_loops.clear();
     _shard_to_numa_node_mapping = decltype(_shard_to_numa_node_mapping)();
+    _numa_node_shards = decltype(_numa_node_shards)();
+    _stealable_queues.reset();
     reactor_holder.reset();
     local_engine = nullptr;
 }
@@ -4538,6 +4981,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     if (smp_opts.hugepages) {
         hugepages_path = smp_opts.hugepages.get_value();
     }
+    auto hugepage_spans = smp_opts.hugepage_spans.get_value();
     auto mlock = false;
     if (smp_opts.lock_memory) {
         mlock = smp_opts.lock_memory.get_value();
@@ -4584,7 +5028,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     }
     std::optional<memory::internal::numa_layout> layout;
     if (smp_opts.memory_allocator == memory_allocator::seastar) {
-        layout = memory::configure(allocations[0].mem, mbind, use_transparent_hugepages, hugepages_path);
+        layout = memory::configure(allocations[0].mem, mbind, use_transparent_hugepages, hugepages_path, hugepage_spans);
     } else {
         // #2148 - if running seastar allocator but options that contradict this, we still need to
         // init memory at least minimally, otherwise a bunch of stuff breaks.
@@ -4598,6 +5042,14 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     for (unsigned i = 0; i < _shard_count; i++) {
         _shard_to_numa_node_mapping.push_back(allocations[i].mem.size() > 0 ? allocations[i].mem[0].nodeid : 0);
     }
+    _stealable_queues = std::make_unique<internal::stealable_queue[]>(_shard_count);
+    std::map<unsigned, std::vector<unsigned>> shards_by_node;
+    for (unsigned i = 0; i < _shard_count; i++) {
+        shards_by_node[_shard_to_numa_node_mapping[i]].push_back(i);
+    }
+    for (auto& [node, shards] : shards_by_node) {
+        _numa_node_shards.push_back(std::move(shards));
+    }
 
     if (reactor_opts.abort_on_seastar_bad_alloc) {
         memory::set_abort_on_allocation_failure(true);
@@ -4625,18 +5077,28 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
                 return reactor_opts.idle_poll_time_us.get_value() * 1us;
             }
         }(),
+        .adaptive_idle_poll = reactor_opts.adaptive_idle_poll.get_value() && !reactor_opts.poll_mode,
         .handle_sigint = !reactor_opts.no_handle_interrupt,
         .auto_handle_sigint_sigterm = reactor_opts._auto_handle_sigint_sigterm,
         .max_networking_aio_io_control_blocks = max_networking_aio_io_control_blocks,
         .force_io_getevents_syscall = reactor_opts.force_aio_syscalls.get_value(),
         .kernel_page_cache = reactor_opts.kernel_page_cache.get_value(),
         .have_aio_fsync = reactor_opts.aio_fsync.get_value(),
+        .native_file_ops = reactor_opts.native_file_ops.get_value(),
+        .syscall_threads = std::max(reactor_opts.syscall_threads.get_value(), 1u),
         .max_task_backlog = reactor_opts.max_task_backlog.get_value(),
         .strict_o_direct = !reactor_opts.relaxed_dma,
         .bypass_fsync = reactor_opts.unsafe_bypass_fsync.get_value(),
         .no_poll_aio = !reactor_opts.poll_aio.get_value() || (reactor_opts.poll_aio.defaulted() && reactor_opts.overprovisioned),
         .aio_nowait_works = reactor_opts.linux_aio_nowait.defaulted() ? std::optional<bool>(std::nullopt) : std::optional<bool>(reactor_opts.linux_aio_nowait.get_value()), // Mixed in with filesystem-provided values later
         .abort_on_too_long_task_queue = reactor_opts.abort_on_too_long_task_queue.get_value(),
+        .work_stealing = reactor_opts.enable_work_stealing.get_value(),
+        .uring_registered_buffers_size = reactor_opts.io_uring_registered_buffers ? parse_memory_size(reactor_opts.io_uring_registered_buffers.get_value()) : 0,
+        .zerocopy_send_threshold = reactor_opts.zerocopy_send_threshold ? parse_memory_size(reactor_opts.zerocopy_send_threshold.get_value()) : 0,
+        .uring_multishot = reactor_opts.io_uring_multishot.get_value(),
+        .uring_buf_ring_entries = reactor_opts.io_uring_buf_ring_entries.get_value(),
+        .uring_buf_ring_buffer_size = reactor_opts.io_uring_buf_ring_buffer_size.get_value(),
+        .uring_multishot_recv_queue = std::max(reactor_opts.io_uring_multishot_recv_queue.get_value(), 1u),
     };
 
     // Disable hot polling if sched wakeup granularity is too high
@@ -4766,7 +5228,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     smp::_this_smp = this;
     for (i = 1; i < _shard_count; i++) {
         auto allocation = allocations[i];
-        create_thread([this, smp_tmain, inited, &reactors_registered, &smp_queues_constructed, &smp_opts, &reactor_opts, &reactors, hugepages_path, i, allocation, assign_io_queues, alloc_io_queues, thread_affinity, heapprof_sampling_rate, mbind, backend_selector, reactor_cfg, &mtx, &layout, use_transparent_hugepages, allocate_qs_owner, allocate_smp_queues, backend_configurator, &backend_configuration_initialized] {
+        create_thread([this, smp_tmain, inited, &reactors_registered, &smp_queues_constructed, &smp_opts, &reactor_opts, &reactors, hugepages_path, i, allocation, assign_io_queues, alloc_io_queues, thread_affinity, heapprof_sampling_rate, mbind, backend_selector, reactor_cfg, &mtx, &layout, use_transparent_hugepages, hugepage_spans, allocate_qs_owner, allocate_smp_queues, backend_configurator, &backend_configuration_initialized] {
           try {
             // initialize thread_locals that are equal across all reacto threads of this smp instance
             smp::_tmain = smp_tmain;
@@ -4777,7 +5239,7 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
                 smp::pin(allocation.cpu_id);
             }
             if (smp_opts.memory_allocator == memory_allocator::seastar) {
-                auto another_layout = memory::configure(allocation.mem, mbind, use_transparent_hugepages, hugepages_path);
+                auto another_layout = memory::configure(allocation.mem, mbind, use_transparent_hugepages, hugepages_path, hugepage_spans);
                 auto guard = std::lock_guard(mtx);
                 *layout = memory::internal::merge(std::move(*layout), std::move(another_layout));
             } else {
@@ -4863,12 +5325,129 @@ void smp::configure(const smp_options& smp_opts, const reactor_options& reactor_
     }
 }
 
+// Number of queued stealable items at which an idle shard is woken to help
+static constexpr size_t stealable_wakeup_threshold = 2;
+
+void smp::enqueue_stealable(internal::stealable_work_item& item) {
+    // One task per item, which runs whichever item is at the front of the
+    // queue by then, if it wasn't stolen yet.
+    auto t = make_task(item.group(), [] {
+        auto item = this_smp()._stealable_queues[this_shard_id()].pop_front();
+        if (item) {
+            item->compute();
+            item->complete();
+        }
+    });
+    auto& q = this_smp()._stealable_queues[this_shard_id()];
+    q.push(item);
+    engine()._stealable_tasks++;
+    schedule(t);
+    // A sleeping shard doesn't look for work to steal, so once more work
+    // is queued than the next task will take, wake one up to share it.
+    if (engine()._cfg.work_stealing && q.size() >= stealable_wakeup_threshold) {
+        wake_idle_thief();
+    }
+}
+
+// Wakes one sleeping shard, preferably on our NUMA node, so that it tries
+// to steal. A shard that is just going to sleep may miss the wakeup; the
+// work then runs here, as it would without stealing.
+void smp::wake_idle_thief() noexcept {
+    auto& smp = this_smp();
+    auto local_node = smp._shard_to_numa_node_mapping[this_shard_id()];
+    auto wake_one = [] (std::span<const unsigned> shards) {
+        auto start = this_shard_id() % shards.size();
+        for (size_t i = 0; i < shards.size(); i++) {
+            auto peer = shards[(start + i) % shards.size()];
+            if (peer == this_shard_id()) {
+                continue;
+            }
+            auto& r = *_qs[peer][this_shard_id()]._pending.remote;
+            if (r._sleeping.load(std::memory_order_relaxed)) {
+                // see smp_message_queue::lf_queue::maybe_wakeup()
+                std::atomic_signal_fence(std::memory_order_seq_cst);
+                r.wakeup();
+                return true;
+            }
+        }
+        return false;
+    };
+    for (auto& shards : smp._numa_node_shards) {
+        if (smp._shard_to_numa_node_mapping[shards.front()] == local_node && wake_one(shards)) {
+            return;
+        }
+    }
+    for (auto& shards : smp._numa_node_shards) {
+        if (smp._shard_to_numa_node_mapping[shards.front()] != local_node && wake_one(shards)) {
+            return;
+        }
+    }
+}
+
+bool smp::steal_work() {
+    auto& smp = this_smp();
+    auto steal_from = [&smp] (std::span<const unsigned> shards) -> internal::stealable_work_item* {
+        // start after ourselves so that thieves spread over victims
+        auto start = this_shard_id() % shards.size();
+        for (size_t i = 0; i < shards.size(); i++) {
+            auto victim = shards[(start + i) % shards.size()];
+            if (victim != this_shard_id() && smp._stealable_queues[victim].size()) {
+                if (auto item = smp._stealable_queues[victim].steal()) {
+                    return item;
+                }
+            }
+        }
+        return nullptr;
+    };
+    auto local_node = smp._shard_to_numa_node_mapping[this_shard_id()];
+    internal::stealable_work_item* item = nullptr;
+    // Prefer victims on our NUMA node: the function and its data are then
+    // transferred over the local interconnect only.
+    for (auto& shards : smp._numa_node_shards) {
+        if (smp._shard_to_numa_node_mapping[shards.front()] == local_node && (item = steal_from(shards))) {
+            break;
+        }
+    }
+    for (auto& shards : smp._numa_node_shards) {
+        if (item) {
+            break;
+        }
+        if (smp._shard_to_numa_node_mapping[shards.front()] != local_node) {
+            item = steal_from(shards);
+        }
+    }
+    if (!item) {
+        return false;
+    }
+    engine()._stolen_tasks++;
+    schedule(make_task(item->group(), [item] {
+        item->compute();
+        complete_stolen(item);
+    }));
+    return true;
+}
+
+void smp::complete_stolen(internal::stealable_work_item* item) noexcept {
+    // Completion, like allocation, happens on the origin shard.
+    (void)smp::submit_to(item->origin(), [item] {
+        item->complete();
+    }).handle_exception([item] (std::exception_ptr ex) {
+        // Only fails if the message can't be allocated. Dropping the item
+        // would leave its future unresolved forever, so retry once memory
+        // had a chance to be freed.
+        seastar_logger.warn("Failed to return stolen work to shard {}, retrying: {}", item->origin(), ex);
+        (void)sleep(1ms).then([item] {
+            complete_stolen(item);
+        });
+    });
+}
+
 bool smp::poll_queues() {
     size_t got = 0;
     for (unsigned i = 0; i < this_smp_shard_count(); i++) {
         if (this_shard_id() != i) {
             auto& rxq = _qs[this_shard_id()][i];
-            rxq.flush_response_batch();
+            rxq.poll_response_batch();
             got += rxq.has_unflushed_responses();
             got += rxq.process_incoming();
             auto& txq = _qs[i][this_shard_id()];
@@ -4883,7 +5462,7 @@ bool smp::pure_poll_queues() {
     for (unsigned i = 0; i < this_smp_shard_count(); i++) {
         if (this_shard_id() != i) {
             auto& rxq = _qs[this_shard_id()][i];
-            rxq.flush_response_batch();
+            rxq.poll_response_batch();
             auto& txq = _qs[i][this_shard_id()];
             txq.flush_request_batch();
             if (rxq.pure_poll_rx() || txq.pure_poll_tx() || rxq.has_unflushed_responses()) {
@@ -5012,6 +5591,41 @@ reactor::calculate_poll_time() {
     return virtualized() ? 2000us : 200us;
 }
 
+// Spinning without pause gives the lowest wakeup latency but starves a
+// sibling hyperthread, so only do it for the first few microseconds.
+static constexpr auto idle_spin_limit = std::chrono::microseconds(10);
+// Rough cost of going to sleep and being woken up again. Polling for less
+// than that is never worth it.
+static constexpr auto idle_min_poll_window = std::chrono::microseconds(50);
+
+reactor::idle_action
+reactor::adaptive_idle_action(sched_clock::duration idle_for) const noexcept {
+    if (idle_for < std::min<sched_clock::duration>(_idle_period_estimate, idle_spin_limit)) {
+        return idle_action::spin;
+    }
+    if (idle_for < _idle_poll_window) {
+        return idle_action::pause;
+    }
+    return idle_action::sleep;
+}
+
+void
+reactor::update_idle_estimate(sched_clock::duration idle_period) noexcept {
+    // Work arriving after the poll budget is exhausted is only known to
+    // arrive "late"; clamp so that a single long sleep doesn't keep the
+    // estimate high for too long after the load picks up again.
+    auto max_poll = std::chrono::duration_cast<sched_clock::duration>(_cfg.max_poll_time);
+    idle_period = std::min(idle_period, 2 * max_poll);
+    _idle_period_estimate = (_idle_period_estimate * 7 + idle_period) / 8;
+    // Ski rental: keep polling for twice the expected wait when work is
+    // expected within the poll budget, otherwise sleep right away.
+    if (_idle_period_estimate <= max_poll) {
+        _idle_poll_window = std::min<sched_clock::duration>(std::max<sched_clock::duration>(2 * _idle_period_estimate, idle_min_poll_window), max_poll);
+    } else {
+        _idle_poll_window = sched_clock::duration(0);
+    }
+}
+
 future<>
 yield() noexcept {
     memory::scoped_critical_alloc_section _;
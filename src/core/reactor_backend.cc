@@ -53,6 +53,9 @@
 #include "core/thread_pool.hh"
 #include "core/syscall_result.hh"
 #include <seastar/core/internal/buffer_allocator.hh>
+#include <seastar/core/aligned_buffer.hh>
+#include <seastar/core/align.hh>
+#include <seastar/core/bitops.hh>
 #include <seastar/util/internal/iovec_utils.hh>
 #include <seastar/core/internal/uname.hh>
 #include <seastar/core/print.hh>
@@ -788,6 +791,14 @@ reactor_backend_aio::sendmsg(pollable_fd_state& fd, std::span<iovec> iovs, size_
     return _r.do_sendmsg(fd, iovs, len);
 }
 
+future<size_t>
+reactor_backend_aio::sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) {
+    return _r.do_sendmsg(fd, iovs, len).then([this, d = std::move(d)] (size_t sent) {
+        _r._io_stats.zerocopy_send_copied_bytes += sent;
+        return sent;
+    });
+}
+
 future<size_t>
 reactor_backend_aio::writev(pollable_fd_state& fd, std::span<iovec> iovs) {
     return _r.do_writev(fd, iovs);
@@ -828,6 +839,11 @@ reactor_backend_aio::make_pollable_fd_state(file_desc fd, pollable_fd::speculati
     return pollable_fd_state_ptr(new aio_pollable_fd_state(std::move(fd), std::move(speculate)));
 }
 
+temporary_buffer<char>
+reactor_backend_aio::allocate_registered_buffer(size_t, bool) noexcept {
+    return {};
+}
+
 reactor_backend_epoll::reactor_backend_epoll(reactor& r)
         : reactor_backend(uses_blocking_io::no, supports_aio_fdatasync::yes)
         , _r(r)
@@ -1191,6 +1207,14 @@ reactor_backend_epoll::sendmsg(pollable_fd_state& fd, std::span<iovec> iovs, siz
     return _r.do_sendmsg(fd, iovs, len);
 }
 
+future<size_t>
+reactor_backend_epoll::sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) {
+    return _r.do_sendmsg(fd, iovs, len).then([this, d = std::move(d)] (size_t sent) {
+        _r._io_stats.zerocopy_send_copied_bytes += sent;
+        return sent;
+    });
+}
+
 future<size_t>
 reactor_backend_epoll::writev(pollable_fd_state& fd, std::span<iovec> iovs) {
     return _r.do_writev(fd, iovs);
@@ -1217,6 +1241,11 @@ reactor_backend_epoll::make_pollable_fd_state(file_desc fd, pollable_fd::specula
     return pollable_fd_state_ptr(new epoll_pollable_fd_state(std::move(fd), std::move(speculate)));
 }
 
+temporary_buffer<char>
+reactor_backend_epoll::allocate_registered_buffer(size_t, bool) noexcept {
+    return {};
+}
+
 void reactor_backend_epoll::reset_preemption_monitor() {
     _r._preemption_monitor.head.store(0, std::memory_order_relaxed);
 }
@@ -1281,6 +1310,30 @@ try_create_uring(unsigned queue_len, bool throw_on_error) {
     return ring;
 }
 
+// The file operations submitted natively when the kernel supports them,
+// otherwise they go to the syscall thread pool
+static
+bool
+probe_native_file_ops(::io_uring& ring) {
+    auto probe = ::io_uring_get_probe_ring(&ring);
+    if (!probe) {
+        return false;
+    }
+    auto free_probe = defer([&] () noexcept { ::io_uring_free_probe(probe); });
+    for (auto op : {
+            IORING_OP_FALLOCATE, // linux 5.6
+            IORING_OP_OPENAT,
+            IORING_OP_STATX,
+            IORING_OP_RENAMEAT,  // linux 5.11
+            IORING_OP_UNLINKAT,
+            }) {
+        if (!io_uring_opcode_supported(probe, op)) {
+            return false;
+        }
+    }
+    return true;
+}
+
 static
 bool
 have_md_devices() {
@@ -1345,19 +1398,257 @@ detect_asymmetric_io_uring() {
     return bool(attached_ring_opt);
 }
 
+namespace uring {
+
+// A per-ring pool of DMA buffers carved out of a single memory region that is
+// registered with the kernel as fixed buffer 0. Reads and writes targeting
+// this region are submitted as READ_FIXED/WRITE_FIXED and skip the per-request
+// page pinning. Chunks are power-of-two sized and managed as buddies: a freed
+// chunk merges with its free buddy, so memory split for small buffers can
+// serve large ones again. Free chunks are kept on per-order intrusive lists,
+// so returning a buffer never allocates.
+class registered_buffer_pool : public enable_lw_shared_from_this<registered_buffer_pool> {
+public:
+    static constexpr unsigned min_order = 12; // 4k
+    static constexpr unsigned max_order = 17; // 128k
+    // Buffers taken on behalf of internal readers (see allocate()) leave
+    // this fraction of the pool to explicit allocate_registered_buffer()
+    // callers, and fall back to regular memory beyond it.
+    static constexpr unsigned reserve_fraction = 4;
+private:
+    struct free_chunk {
+        free_chunk* prev;
+        free_chunk* next;
+    };
+    static constexpr uint8_t not_free = 0xff;
+    std::unique_ptr<char[], free_deleter> _region;
+    size_t _size;
+    size_t _free_bytes;
+    std::array<free_chunk*, max_order - min_order + 1> _free = {};
+    // Per 2^min_order unit: the order of the free chunk starting there, or
+    // not_free
+    std::vector<uint8_t> _free_order;
+public:
+    registered_buffer_pool(std::unique_ptr<char[], free_deleter> region, size_t size)
+        : _region(std::move(region)), _size(size), _free_bytes(size), _free_order(size >> min_order, not_free) {
+        for (size_t off = 0; off < _size; off += size_t(1) << max_order) {
+            push(off, max_order);
+        }
+    }
+    // Returns a null pointer if the region can't be allocated or registered.
+    static lw_shared_ptr<registered_buffer_pool> create(::io_uring& ring, size_t size) {
+        size = align_down<size_t>(size, size_t(1) << max_order);
+        if (!size) {
+            return nullptr;
+        }
+        auto region = allocate_aligned_buffer<char>(size, size_t(1) << min_order);
+        ::iovec iov{region.get(), size};
+        auto r = ::io_uring_register_buffers(&ring, &iov, 1);
+        if (r < 0) {
+            seastar_logger.warn("Failed to register {} bytes of fixed buffers with io_uring: {}, falling back to regular buffers",
+                    size, std::error_code(-r, std::system_category()).message());
+            return nullptr;
+        }
+        return make_lw_shared<registered_buffer_pool>(std::move(region), size);
+    }
+    bool contains(const void* addr, size_t len) const noexcept {
+        auto p = reinterpret_cast<const char*>(addr);
+        return p >= _region.get() && p + len <= _region.get() + _size;
+    }
+    // With keep_reserve, fails once the allocation would leave less than
+    // 1/reserve_fraction of the pool free, so that a burst of internal reads
+    // can't drain it.
+    temporary_buffer<char> allocate(size_t size, bool keep_reserve) noexcept {
+        if (size > (size_t(1) << max_order)) {
+            return {};
+        }
+        auto order = std::max<unsigned>(min_order, log2ceil(std::max<size_t>(size, 1)));
+        auto chunk_size = size_t(1) << order;
+        if (keep_reserve && _free_bytes < chunk_size + _size / reserve_fraction) {
+            return {};
+        }
+        auto o = order;
+        while (o <= max_order && !_free[o - min_order]) {
+            ++o;
+        }
+        if (o > max_order) {
+            return {};
+        }
+        auto off = pop(o);
+        // Split down to the requested order, freeing the upper halves
+        while (o > order) {
+            --o;
+            push(off + (size_t(1) << o), o);
+        }
+        _free_bytes -= chunk_size;
+        auto chunk = _region.get() + off;
+        try {
+            return temporary_buffer<char>(chunk, size, make_deleter([self = shared_from_this(), off, order] {
+                self->release(off, order);
+            }));
+        } catch (const std::bad_alloc&) {
+            // No memory for the deleter; give the chunk back
+            release(off, order);
+            return {};
+        }
+    }
+private:
+    void push(size_t off, unsigned order) noexcept {
+        auto& head = _free[order - min_order];
+        auto c = new (_region.get() + off) free_chunk{nullptr, head};
+        if (head) {
+            head->prev = c;
+        }
+        head = c;
+        _free_order[off >> min_order] = order;
+    }
+    void unlink(size_t off, unsigned order) noexcept {
+        auto c = reinterpret_cast<free_chunk*>(_region.get() + off);
+        if (c->prev) {
+            c->prev->next = c->next;
+        } else {
+            _free[order - min_order] = c->next;
+        }
+        if (c->next) {
+            c->next->prev = c->prev;
+        }
+        _free_order[off >> min_order] = not_free;
+    }
+    size_t pop(unsigned order) noexcept {
+        auto off = reinterpret_cast<char*>(_free[order - min_order]) - _region.get();
+        unlink(off, order);
+        return off;
+    }
+    void release(size_t off, unsigned order) noexcept {
+        _free_bytes += size_t(1) << order;
+        while (order < max_order) {
+            auto buddy = off ^ (size_t(1) << order);
+            if (_free_order[buddy >> min_order] != order) {
+                break;
+            }
+            unlink(buddy, order);
+            off = std::min(off, buddy);
+            ++order;
+        }
+        push(off, order);
+    }
+};
+
+// A per-shard ring of receive buffers provided to the kernel (IORING_REGISTER_PBUF_RING).
+// Multishot receives pick a buffer from the ring for every completion; the buffer
+// is handed to the application as a temporary_buffer and goes back to the ring
+// once the application releases it.
+class provided_buffer_ring : public enable_lw_shared_from_this<provided_buffer_ring> {
+public:
+    static constexpr int group_id = 0;
+private:
+    ::io_uring* _ring;
+    ::io_uring_buf_ring* _br;
+    unsigned _entries;
+    size_t _buffer_size;
+    std::unique_ptr<char[], free_deleter> _region;
+    unsigned _available;
+public:
+    provided_buffer_ring(::io_uring& ring, ::io_uring_buf_ring* br, unsigned entries, size_t buffer_size, std::unique_ptr<char[], free_deleter> region) noexcept
+        : _ring(&ring), _br(br), _entries(entries), _buffer_size(buffer_size), _region(std::move(region)), _available(entries) {
+        for (unsigned bid = 0; bid < _entries; ++bid) {
+            ::io_uring_buf_ring_add(_br, buffer(bid), _buffer_size, bid, ::io_uring_buf_ring_mask(_entries), bid);
+        }
+        ::io_uring_buf_ring_advance(_br, _entries);
+    }
+    // Returns a null pointer if the kernel does not support provided buffer rings.
+    static lw_shared_ptr<provided_buffer_ring> create(::io_uring& ring, unsigned entries, size_t buffer_size) {
+        if (!entries || (entries & (entries - 1)) || entries > 32768) {
+            throw std::invalid_argument(fmt::format("io_uring buffer ring entries must be a power of two not larger than 32768, got {}", entries));
+        }
+        int ret = 0;
+        auto br = ::io_uring_setup_buf_ring(&ring, entries, group_id, 0, &ret);
+        if (!br) {
+            seastar_logger.warn("Failed to set up io_uring provided buffer ring: {}, multishot receive disabled",
+                    std::error_code(-ret, std::system_category()).message());
+            return nullptr;
+        }
+        auto region = allocate_aligned_buffer<char>(size_t(entries) * buffer_size, 4096);
+        return make_lw_shared<provided_buffer_ring>(ring, br, entries, buffer_size, std::move(region));
+    }
+    unsigned available() const noexcept {
+        return _available;
+    }
+    size_t buffer_size() const noexcept {
+        return _buffer_size;
+    }
+    // Wraps buffer \c bid, just filled by the kernel with \c len bytes.
+    temporary_buffer<char> take(unsigned bid, size_t len) {
+        --_available;
+        auto recycle = defer([this, bid] () noexcept { give_back(bid); });
+        auto buf = temporary_buffer<char>(buffer(bid), len, make_deleter([self = shared_from_this(), bid] {
+            self->give_back(bid);
+        }));
+        recycle.cancel();
+        return buf;
+    }
+    // Returns a buffer released by the application to the kernel.
+    void give_back(unsigned bid) noexcept {
+        recycle(bid);
+        ++_available;
+    }
+    // Returns a buffer the kernel filled but that was never take()n, so
+    // was never counted out of the available ones.
+    void recycle(unsigned bid) noexcept {
+        if (_ring) {
+            ::io_uring_buf_ring_add(_br, buffer(bid), _buffer_size, bid, ::io_uring_buf_ring_mask(_entries), 0);
+            ::io_uring_buf_ring_advance(_br, 1);
+        }
+    }
+    // Called before the ring goes away, buffers still held by the application
+    // are then simply dropped when released.
+    void detach() noexcept {
+        if (auto ring = std::exchange(_ring, nullptr)) {
+            ::io_uring_free_buf_ring(ring, _br, _entries, group_id);
+        }
+    }
+private:
+    char* buffer(unsigned bid) const noexcept {
+        return _region.get() + size_t(bid) * _buffer_size;
+    }
+};
+
+// Completion of a request that posts several CQEs (multishot accept and recv).
+// These need the CQE flags for IORING_CQE_F_MORE and the provided buffer id, so
+// they are told apart from kernel_completion by tagging the low bit of user_data.
+class multishot_completion {
+public:
+    static constexpr uintptr_t tag = 1;
+    virtual ~multishot_completion() = default;
+    virtual void complete_with(int32_t res, uint32_t flags) noexcept = 0;
+    void* user_data() noexcept {
+        return reinterpret_cast<void*>(reinterpret_cast<uintptr_t>(this) | tag);
+    }
+};
+
+}
+
 static
 void
-prepare_sqe(io_uring_sqe* sqe, const internal::io_request& req, io_completion* completion) {
+prepare_sqe(io_uring_sqe* sqe, const internal::io_request& req, io_completion* completion, const uring::registered_buffer_pool* fixed_buffers = nullptr) {
     using o = internal::io_request::operation;
     switch (req.opcode()) {
         case o::read: {
             const auto& op = req.as<io_request::operation::read>();
-            ::io_uring_prep_read(sqe, op.fd, op.addr, op.size, op.pos);
+            if (fixed_buffers && fixed_buffers->contains(op.addr, op.size)) {
+                ::io_uring_prep_read_fixed(sqe, op.fd, op.addr, op.size, op.pos, 0);
+            } else {
+                ::io_uring_prep_read(sqe, op.fd, op.addr, op.size, op.pos);
+            }
             break;
         }
         case o::write: {
             const auto& op = req.as<io_request::operation::write>();
-            ::io_uring_prep_write(sqe, op.fd, op.addr, op.size, op.pos);
+            if (fixed_buffers && fixed_buffers->contains(op.addr, op.size)) {
+                ::io_uring_prep_write_fixed(sqe, op.fd, op.addr, op.size, op.pos, 0);
+            } else {
+                ::io_uring_prep_write(sqe, op.fd, op.addr, op.size, op.pos);
+            }
             break;
         }
         case o::readv: {
@@ -1375,6 +1666,31 @@ prepare_sqe(io_uring_sqe* sqe, const internal::io_request& req, io_completion* c
             ::io_uring_prep_fsync(sqe, op.fd, IORING_FSYNC_DATASYNC);
             break;
         }
+        case o::fallocate: {
+            const auto& op = req.as<io_request::operation::fallocate>();
+            ::io_uring_prep_fallocate(sqe, op.fd, op.mode, op.pos, op.len);
+            break;
+        }
+        case o::openat: {
+            const auto& op = req.as<io_request::operation::openat>();
+            ::io_uring_prep_openat(sqe, op.dirfd, op.path, op.flags, op.mode);
+            break;
+        }
+        case o::statx: {
+            const auto& op = req.as<io_request::operation::statx>();
+            ::io_uring_prep_statx(sqe, op.dirfd, op.path, op.flags, op.mask, op.statxbuf);
+            break;
+        }
+        case o::renameat: {
+            const auto& op = req.as<io_request::operation::renameat>();
+            ::io_uring_prep_renameat(sqe, op.olddirfd, op.oldpath, op.newdirfd, op.newpath, op.flags);
+            break;
+        }
+        case o::unlinkat: {
+            const auto& op = req.as<io_request::operation::unlinkat>();
+            ::io_uring_prep_unlinkat(sqe, op.dirfd, op.path, op.flags);
+            break;
+        }
         case o::recv: {
             const auto& op = req.as<io_request::operation::recv>();
             ::io_uring_prep_recv(sqe, op.fd, op.addr, op.size, op.flags);
@@ -1425,14 +1741,24 @@ class reactor_backend_uring_base : public reactor_backend {
 private:
     bool _did_work_while_getting_sqe = false;
     bool _has_pending_submissions = false;
+    lw_shared_ptr<uring::registered_buffer_pool> _fixed_buffers;
     file_desc _hrtimer_timerfd;
     preempt_io_context _preempt_io_context;
 
+protected:
+    class multishot_accept_state;
+    class multishot_recv_state;
+private:
     class uring_pollable_fd_state : public pollable_fd_state {
         pollable_fd_state_completion _completion_pollin;
         pollable_fd_state_completion _completion_pollout;
         pollable_fd_state_completion _completion_pollrdhup;
     public:
+        // Created on first use when multishot mode is enabled, they outlive
+        // this object if a multishot request is still armed when it's forgotten.
+        multishot_accept_state* accept_state = nullptr;
+        multishot_recv_state* recv_state = nullptr;
+
         explicit uring_pollable_fd_state(file_desc desc, speculation speculate)
                 : pollable_fd_state(std::move(desc), std::move(speculate)) {
         }
@@ -1639,6 +1965,325 @@ class reactor_backend_uring_base : public reactor_backend {
         }
     };
 
+    // Results of a multishot request are queued here until consumed. The state
+    // belongs to a uring_pollable_fd_state, but is only destroyed after the
+    // final CQE of an armed request has been posted.
+    template <typename T>
+    class multishot_state : public uring::multishot_completion {
+    protected:
+        reactor_backend_uring_base& _be;
+        int _fd;
+        circular_buffer<future<T>> _ready;
+        std::optional<promise<T>> _waiter;
+        bool _armed = false;
+        bool _orphaned = false;
+    public:
+        multishot_state(reactor_backend_uring_base& be, int fd) noexcept : _be(be), _fd(fd) {}
+        future<T> get() {
+            if (!_ready.empty()) {
+                auto f = std::move(_ready.front());
+                _ready.pop_front();
+                return f;
+            }
+            if (!_armed) {
+                if (auto f = try_arm()) {
+                    return std::move(*f);
+                }
+            }
+            return _waiter.emplace().get_future();
+        }
+        void orphan() noexcept {
+            _orphaned = true;
+            for (auto& f : _ready) {
+                f.ignore_ready_future();
+            }
+            _ready.clear();
+            if (_waiter) {
+                _waiter->set_exception(std::make_exception_ptr(std::system_error(EBADF, std::system_category())));
+                _waiter.reset();
+            }
+            if (!_armed) {
+                delete this;
+                return;
+            }
+            // Deleted by the final CQE, or with the backend if it never comes
+            _be._orphaned_multishots.insert(this);
+            cancel();
+        }
+        virtual void complete_with(int32_t res, uint32_t flags) noexcept override {
+            if (!(flags & IORING_CQE_F_MORE)) {
+                _armed = false;
+            }
+            if (_orphaned) {
+                discard(res, flags);
+                if (!_armed) {
+                    _be._orphaned_multishots.erase(this);
+                    delete this;
+                }
+                return;
+            }
+            handle(res, flags);
+        }
+    protected:
+        // Arms the multishot request, or returns a result obtained some other
+        // way when the request cannot be armed right now.
+        virtual std::optional<future<T>> try_arm() = 0;
+        virtual void handle(int32_t res, uint32_t flags) noexcept = 0;
+        virtual void discard(int32_t res, uint32_t flags) noexcept = 0;
+
+        // Asks the kernel to end the armed request; its final CQE follows
+        void cancel() noexcept {
+            auto sqe = _be.get_sqe();
+            ::io_uring_prep_cancel(sqe, user_data(), 0);
+            ::io_uring_sqe_set_data(sqe, ignore_completion().user_data());
+            _be._has_pending_submissions = true;
+        }
+        ::io_uring_sqe* arm_sqe() {
+            auto sqe = _be.get_sqe();
+            ::io_uring_sqe_set_data(sqe, user_data());
+            _be._has_pending_submissions = true;
+            _armed = true;
+            return sqe;
+        }
+        void deliver(future<T> f) noexcept {
+            if (_waiter) {
+                f.forward_to(std::move(*_waiter));
+                _waiter.reset();
+            } else {
+                _ready.push_back(std::move(f));
+            }
+        }
+        void deliver_error(int32_t res) noexcept {
+            deliver(make_exception_future<T>(std::system_error(-res, std::system_category())));
+        }
+    private:
+        static uring::multishot_completion& ignore_completion() noexcept {
+            struct ignore final : uring::multishot_completion {
+                virtual void complete_with(int32_t, uint32_t) noexcept override {}
+            };
+            static thread_local ignore c;
+            return c;
+        }
+    };
+
+    class multishot_accept_state final : public multishot_state<std::tuple<pollable_fd, socket_address>> {
+        pollable_fd_state& _listenfd;
+    public:
+        multishot_accept_state(reactor_backend_uring_base& be, pollable_fd_state& listenfd) noexcept
+            : multishot_state(be, listenfd.fd.get()), _listenfd(listenfd) {}
+    protected:
+        virtual std::optional<future<std::tuple<pollable_fd, socket_address>>> try_arm() override {
+            ::io_uring_prep_multishot_accept(arm_sqe(), _fd, nullptr, nullptr, SOCK_NONBLOCK | SOCK_CLOEXEC);
+            return std::nullopt;
+        }
+        virtual void handle(int32_t res, uint32_t flags) noexcept override {
+            if (res == -EINVAL) {
+                try {
+                    // The chances are that we are shutting down the connection.
+                    _listenfd.maybe_no_more_recv();
+                } catch (...) {
+                    deliver(current_exception_as_future<std::tuple<pollable_fd, socket_address>>());
+                    return;
+                }
+            }
+            if (res < 0) {
+                deliver_error(res);
+                return;
+            }
+            ++_be._r._io_stats.uring_multishot_accepts;
+            // The kernel writes the peer address of every accepted connection to the
+            // same place, so it can't be used here; ask for it instead.
+            auto fd = file_desc::from_fd(res);
+            socket_address sa;
+            if (::getpeername(res, &sa.as_posix_sockaddr(), &sa.addr_length) < 0) {
+                // Closes the connection, the peer may well have reset it already
+                deliver_error(-errno);
+                return;
+            }
+            pollable_fd pfd(std::move(fd), pollable_fd::speculation(EPOLLOUT));
+            deliver(make_ready_future<std::tuple<pollable_fd, socket_address>>(std::move(pfd), std::move(sa)));
+        }
+        virtual void discard(int32_t res, uint32_t flags) noexcept override {
+            if (res >= 0) {
+                ::close(res);
+            }
+        }
+    };
+
+    class multishot_recv_state final : public multishot_state<temporary_buffer<char>> {
+        lw_shared_ptr<uring::provided_buffer_ring> _buffers;
+        // Set while the request is being cancelled because too many buffers
+        // wait in _ready; get() re-arms it once they are all consumed.
+        bool _paused = false;
+
+        class fallback_recv_completion final : public read_completion_base {
+        public:
+            using read_completion_base::read_completion_base;
+        };
+    public:
+        multishot_recv_state(reactor_backend_uring_base& be, int fd, lw_shared_ptr<uring::provided_buffer_ring> buffers) noexcept
+            : multishot_state(be, fd), _buffers(std::move(buffers)) {}
+    protected:
+        virtual std::optional<future<temporary_buffer<char>>> try_arm() override {
+            if (!_buffers->available()) {
+                // All buffers are held by the application, a multishot receive
+                // would terminate with ENOBUFS right away.
+                ++_be._r._io_stats.uring_buf_ring_fallback_recvs;
+                auto desc = std::make_unique<fallback_recv_completion>(temporary_buffer<char>(_buffers->buffer_size()));
+                auto req = internal::io_request::make_recv(_fd, desc->get_write(), desc->get_size(), 0);
+                auto fut = desc->get_future();
+                _be._r._io_sink.submit(desc.release(), std::move(req));
+                return fut;
+            }
+            auto sqe = arm_sqe();
+            ::io_uring_prep_recv_multishot(sqe, _fd, nullptr, 0, 0);
+            sqe->flags |= IOSQE_BUFFER_SELECT;
+            sqe->buf_group = uring::provided_buffer_ring::group_id;
+            return std::nullopt;
+        }
+        virtual void handle(int32_t res, uint32_t flags) noexcept override {
+            if (!_armed && std::exchange(_paused, false) && res == -ECANCELED) {
+                rearm_for_waiter();
+                return;
+            }
+            if (res == -ENOBUFS) {
+                ++_be._r._io_stats.uring_buf_ring_exhausted;
+                rearm_for_waiter();
+                return;
+            }
+            if (res < 0) {
+                deliver_error(res);
+                return;
+            }
+            if (!(flags & IORING_CQE_F_BUFFER)) {
+                // End of stream
+                deliver(make_ready_future<temporary_buffer<char>>());
+                return;
+            }
+            ++_be._r._io_stats.uring_multishot_recvs;
+            try {
+                deliver(make_ready_future<temporary_buffer<char>>(_buffers->take(flags >> IORING_CQE_BUFFER_SHIFT, res)));
+            } catch (...) {
+                deliver(current_exception_as_future<temporary_buffer<char>>());
+            }
+            if (_armed && !_paused && _ready.size() >= _be._r._cfg.uring_multishot_recv_queue) {
+                pause();
+            }
+        }
+        virtual void discard(int32_t res, uint32_t flags) noexcept override {
+            if (flags & IORING_CQE_F_BUFFER) {
+                _buffers->recycle(flags >> IORING_CQE_BUFFER_SHIFT);
+            }
+        }
+    private:
+        // A slow reader would otherwise let its connection take all buffers
+        // of the ring, shared by the whole shard. Buffers already in flight
+        // still arrive before the final -ECANCELED.
+        void pause() noexcept {
+            ++_be._r._io_stats.uring_multishot_recv_pauses;
+            _paused = true;
+            cancel();
+        }
+        // Called when the request is over while a reader is waiting for it
+        void rearm_for_waiter() noexcept {
+            if (!_waiter) {
+                return;
+            }
+            try {
+                if (auto f = try_arm()) {
+                    f->forward_to(std::move(*_waiter));
+                    _waiter.reset();
+                }
+            } catch (...) {
+                deliver(current_exception_as_future<temporary_buffer<char>>());
+            }
+        }
+    };
+
+    // Zero-copy sendmsg. The first CQE carries the result of the send, and,
+    // if the kernel took references to the user memory, a second one flagged
+    // IORING_CQE_F_NOTIF tells when it dropped them.
+    class sendmsg_zc_completion final : public uring::multishot_completion {
+        reactor& _r;
+        pollable_fd_state& _fd;
+        promise<size_t> _result;
+        ::msghdr _mh = {};
+        size_t _to_write;
+        size_t _sent = 0;
+        deleter _d;
+    public:
+        sendmsg_zc_completion(reactor& r, pollable_fd_state& fd, std::span<iovec> iovs, size_t to_write, deleter d)
+            : _r(r), _fd(fd), _to_write(to_write), _d(std::move(d)) {
+            _mh.msg_iov = iovs.data();
+            _mh.msg_iovlen = std::min<size_t>(iovs.size(), IOV_MAX);
+        }
+        ::msghdr* msghdr() noexcept {
+            return &_mh;
+        }
+        future<size_t> get_future() {
+            return _result.get_future();
+        }
+        virtual void complete_with(int32_t res, uint32_t flags) noexcept override {
+            if (flags & IORING_CQE_F_NOTIF) {
+                if (res & IORING_NOTIF_USAGE_ZC_COPIED) {
+                    _r._io_stats.zerocopy_send_copied_bytes += _sent;
+                } else {
+                    _r._io_stats.zerocopy_send_bytes += _sent;
+                }
+                delete this;
+                return;
+            }
+            if (res < 0) {
+                _result.set_exception(std::system_error(-res, std::system_category()));
+            } else {
+                _sent = res;
+                if (_sent == _to_write) {
+                    _fd.speculate_epoll(EPOLLOUT);
+                }
+                _result.set_value(_sent);
+            }
+            if (!(flags & IORING_CQE_F_MORE)) {
+                delete this;
+            }
+        }
+    };
+
+    lw_shared_ptr<uring::provided_buffer_ring> _recv_buffers;
+    // States of closed fds whose multishot requests are being cancelled
+    std::set<uring::multishot_completion*> _orphaned_multishots;
+    bool _multishot = false;
+    // IORING_SEND_ZC_REPORT_USAGE, used to tell copied sends apart, appeared in 6.2.
+    const bool _zerocopy_send = internal::kernel_uname().whitelisted({"6.2"});
+
+    // Switches accept() and recv_some() to multishot requests, if the kernel supports them.
+    void enable_multishot() {
+        if (!_r._cfg.uring_multishot) {
+            return;
+        }
+        if (!internal::kernel_uname().whitelisted({"6.0"})) {
+            seastar_logger.warn("io_uring multishot receive requires Linux 6.0 or later, multishot mode disabled");
+            return;
+        }
+        _recv_buffers = uring::provided_buffer_ring::create(_uring, _r._cfg.uring_buf_ring_entries, _r._cfg.uring_buf_ring_buffer_size);
+        _multishot = bool(_recv_buffers);
+    }
+
+    future<std::tuple<pollable_fd, socket_address>> multishot_accept(pollable_fd_state& listenfd) {
+        auto& ufd = static_cast<uring_pollable_fd_state&>(listenfd);
+        if (!ufd.accept_state) {
+            ufd.accept_state = new multishot_accept_state(*this, listenfd);
+        }
+        return ufd.accept_state->get();
+    }
+
+    future<temporary_buffer<char>> multishot_recv(pollable_fd_state& fd) {
+        auto& ufd = static_cast<uring_pollable_fd_state&>(fd);
+        if (!ufd.recv_state) {
+            ufd.recv_state = new multishot_recv_state(*this, fd.fd.get(), _recv_buffers);
+        }
+        return ufd.recv_state->get();
+    }
+
     bool do_flush_submission_ring() {
         if (_has_pending_submissions) {
             _has_pending_submissions = false;
@@ -1672,7 +2317,7 @@ class reactor_backend_uring_base : public reactor_backend {
     }
 
     void submit_io_request(const internal::io_request& req, io_completion* completion) {
-        prepare_sqe(get_sqe(), req, completion);
+        prepare_sqe(get_sqe(), req, completion, _fixed_buffers.get());
         _has_pending_submissions = true;
     }
 
@@ -1690,6 +2335,11 @@ class reactor_backend_uring_base : public reactor_backend {
     void do_process_ready_kernel_completions(::io_uring_cqe** buf, size_t nr) {
         for (auto p = buf; p != buf + nr; ++p) {
             auto cqe = *p;
+            if (cqe->user_data & uring::multishot_completion::tag) {
+                auto completion = reinterpret_cast<uring::multishot_completion*>(cqe->user_data & ~uring::multishot_completion::tag);
+                completion->complete_with(cqe->res, cqe->flags);
+                continue;
+            }
             auto completion = reinterpret_cast<kernel_completion*>(cqe->user_data);
             completion->complete_with(cqe->res);
         }
@@ -1721,7 +2371,8 @@ class reactor_backend_uring_base : public reactor_backend {
     }
 public:
     explicit reactor_backend_uring_base(reactor& r, ::io_uring uring)
-            : reactor_backend(uses_blocking_io::yes, supports_aio_fdatasync::yes)
+            : reactor_backend(uses_blocking_io::yes, supports_aio_fdatasync::yes,
+                    supports_native_file_ops(probe_native_file_ops(uring)))
             , _r(r)
             , _uring(uring)
             , _hrtimer_timerfd(make_timerfd())
@@ -1732,8 +2383,17 @@ class reactor_backend_uring_base : public reactor_backend {
         // expired when it really hasn't, we don't want to block in read(tfd, ...).
         auto tfd = _r._task_quota_timer.get();
         ::fcntl(tfd, F_SETFL, ::fcntl(tfd, F_GETFL) | O_NONBLOCK);
+        if (_r._cfg.uring_registered_buffers_size) {
+            _fixed_buffers = uring::registered_buffer_pool::create(_uring, _r._cfg.uring_registered_buffers_size);
+        }
     }
     ~reactor_backend_uring_base() override {
+        for (auto* state : std::exchange(_orphaned_multishots, {})) {
+            delete state;
+        }
+        if (_recv_buffers) {
+            _recv_buffers->detach();
+        }
         ::io_uring_queue_exit(&_uring);
     }
     virtual bool reap_kernel_completions() override {
@@ -1790,6 +2450,12 @@ class reactor_backend_uring_base : public reactor_backend {
     }
     virtual void forget(pollable_fd_state& fd) noexcept override {
         auto* pfd = static_cast<uring_pollable_fd_state*>(&fd);
+        if (pfd->accept_state) {
+            pfd->accept_state->orphan();
+        }
+        if (pfd->recv_state) {
+            pfd->recv_state->orphan();
+        }
         delete pfd;
     }
 
@@ -1817,12 +2483,32 @@ class reactor_backend_uring_base : public reactor_backend {
     virtual pollable_fd_state_ptr make_pollable_fd_state(file_desc fd, pollable_fd::speculation speculate) override {
         return pollable_fd_state_ptr(new uring_pollable_fd_state(std::move(fd), std::move(speculate)));
     }
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) override {
+        if (!_zerocopy_send) {
+            return sendmsg(fd, iovs, len).then([this, d = std::move(d)] (size_t sent) {
+                _r._io_stats.zerocopy_send_copied_bytes += sent;
+                return sent;
+            });
+        }
+        auto desc = new sendmsg_zc_completion(_r, fd, iovs, len, std::move(d));
+        auto fut = desc->get_future();
+        auto sqe = get_sqe();
+        ::io_uring_prep_sendmsg_zc(sqe, fd.fd.get(), desc->msghdr(), MSG_NOSIGNAL);
+        sqe->ioprio |= IORING_SEND_ZC_REPORT_USAGE;
+        ::io_uring_sqe_set_data(sqe, desc->user_data());
+        _has_pending_submissions = true;
+        return fut;
+    }
+    virtual temporary_buffer<char> allocate_registered_buffer(size_t size, bool keep_reserve) noexcept override {
+        return _fixed_buffers ? _fixed_buffers->allocate(size, keep_reserve) : temporary_buffer<char>();
+    }
 };
 
 class reactor_backend_uring final : public reactor_backend_uring_base {
 public:
     explicit reactor_backend_uring(reactor& r)
         : reactor_backend_uring_base(r, try_create_uring(uring::QUEUE_LEN, true).value()) {
+        enable_multishot();
     }
 
     virtual std::string_view get_backend_name() const override {
@@ -1830,6 +2516,9 @@ class reactor_backend_uring final : public reactor_backend_uring_base {
     }
 
     virtual future<std::tuple<pollable_fd, socket_address>> accept(pollable_fd_state& listenfd) override {
+        if (_multishot) {
+            return multishot_accept(listenfd);
+        }
         if (listenfd.take_speculation(POLLIN)) {
             try {
                 listenfd.maybe_no_more_recv();
@@ -2023,6 +2712,12 @@ class reactor_backend_uring final : public reactor_backend_uring_base {
 #endif
 
     virtual future<temporary_buffer<char>> recv_some(pollable_fd_state& fd, internal::buffer_allocator* ba) override {
+        if (_multishot) {
+            // Data lands in buffers picked from the provided buffer ring, so
+            // the allocator is not used. Don't try a speculative recv either,
+            // it could overtake data already queued by the armed request.
+            return multishot_recv(fd);
+        }
         if (fd.take_speculation(POLLIN)) {
             auto buffer = ba->allocate_buffer();
             try {
@@ -197,10 +197,12 @@ class reactor_backend {
 protected:
     using uses_blocking_io = bool_class<struct uses_blocking_io_tag>;
     using supports_aio_fdatasync = bool_class<struct supports_aio_fdatasync_tag>;
+    using supports_native_file_ops = bool_class<struct supports_native_file_ops_tag>;
 
 private:
     const uses_blocking_io _blocking_io;
     const supports_aio_fdatasync _aio_fdatasync;
+    const supports_native_file_ops _native_file_ops;
 
 public:
     virtual ~reactor_backend() {};
@@ -234,6 +236,9 @@ class reactor_backend {
     virtual future<size_t> recvmsg(pollable_fd_state& fd, const std::vector<iovec>& iov) = 0;
     virtual future<temporary_buffer<char>> read_some(pollable_fd_state& fd, internal::buffer_allocator* ba) = 0;
     virtual future<size_t> sendmsg(pollable_fd_state& fd, std::span<iovec> iovs, size_t len) = 0;
+    // Like sendmsg(), but the kernel may send straight from the memory behind
+    // \c iovs, which \c d keeps alive until the kernel is done with it.
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) = 0;
     virtual future<size_t> writev(pollable_fd_state& fd, std::span<iovec> iovs) = 0;
 #if SEASTAR_API_LEVEL < 9
     virtual future<size_t> send(pollable_fd_state& fd, const void* buffer, size_t len) = 0;
@@ -246,6 +251,11 @@ class reactor_backend {
     bool have_aio_fdatasync() const noexcept {
         return bool(_aio_fdatasync);
     }
+    // Whether fallocate, openat, statx, renameat and unlinkat requests can be
+    // submitted through the io_sink, instead of running in the syscall thread
+    bool have_native_file_ops() const noexcept {
+        return bool(_native_file_ops);
+    }
     virtual void signal_received(int signo, siginfo_t* siginfo, void* ignore) = 0;
     virtual void start_tick() = 0;
     virtual void stop_tick() = 0;
@@ -256,10 +266,19 @@ class reactor_backend {
 
     virtual pollable_fd_state_ptr make_pollable_fd_state(file_desc fd, pollable_fd::speculation speculate) = 0;
 
+    // Allocates a DMA buffer from memory registered with the kernel for
+    // fixed-buffer I/O. Backends without such memory return an empty buffer,
+    // and the caller is expected to fall back to a regular allocation.
+    // Internal users pass keep_reserve, so that they fall back before the
+    // pool runs out for explicit file::allocate_registered_buffer() callers.
+    virtual temporary_buffer<char> allocate_registered_buffer(size_t size, bool keep_reserve) noexcept = 0;
+
 protected:
-    reactor_backend(uses_blocking_io blocking_io, supports_aio_fdatasync aio_fdatasync)
+    reactor_backend(uses_blocking_io blocking_io, supports_aio_fdatasync aio_fdatasync,
+                    supports_native_file_ops native_file_ops = supports_native_file_ops::no)
         : _blocking_io(blocking_io)
         , _aio_fdatasync(aio_fdatasync)
+        , _native_file_ops(native_file_ops)
     {}
 };
 
@@ -314,6 +333,7 @@ class reactor_backend_epoll : public reactor_backend {
     virtual future<size_t> recvmsg(pollable_fd_state& fd, const std::vector<iovec>& iov) override;
     virtual future<temporary_buffer<char>> read_some(pollable_fd_state& fd, internal::buffer_allocator* ba) override;
     virtual future<size_t> sendmsg(pollable_fd_state& fd, std::span<iovec> iovs, size_t len) override;
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) override;
     virtual future<size_t> writev(pollable_fd_state& fd, std::span<iovec> iovs) override;
 #if SEASTAR_API_LEVEL < 9
     virtual future<size_t> send(pollable_fd_state& fd, const void* buffer, size_t len) override;
@@ -330,6 +350,7 @@ class reactor_backend_epoll : public reactor_backend {
 
     virtual pollable_fd_state_ptr
     make_pollable_fd_state(file_desc fd, pollable_fd::speculation speculate) override;
+    virtual temporary_buffer<char> allocate_registered_buffer(size_t size, bool keep_reserve) noexcept override;
 };
 
 class reactor_backend_aio : public reactor_backend {
@@ -366,6 +387,7 @@ class reactor_backend_aio : public reactor_backend {
     virtual future<size_t> recvmsg(pollable_fd_state& fd, const std::vector<iovec>& iov) override;
     virtual future<temporary_buffer<char>> read_some(pollable_fd_state& fd, internal::buffer_allocator* ba) override;
     virtual future<size_t> sendmsg(pollable_fd_state& fd, std::span<iovec> iovs, size_t len) override;
+    virtual future<size_t> sendmsg_zerocopy(pollable_fd_state& fd, std::span<iovec> iovs, size_t len, deleter d) override;
     virtual future<size_t> writev(pollable_fd_state& fd, std::span<iovec> iovs) override;
 #if SEASTAR_API_LEVEL < 9
     virtual future<size_t> send(pollable_fd_state& fd, const void* buffer, size_t len) override;
@@ -382,6 +404,7 @@ class reactor_backend_aio : public reactor_backend {
 
     virtual pollable_fd_state_ptr
     make_pollable_fd_state(file_desc fd, pollable_fd::speculation speculate) override;
+    virtual temporary_buffer<char> allocate_registered_buffer(size_t size, bool keep_reserve) noexcept override;
 };
 
 class reactor_backend_uring;
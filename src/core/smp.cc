@@ -55,6 +55,7 @@ void smp_message_queue::work_item::process() {
 
 struct smp_service_group_impl {
     std::vector<smp_service_group_semaphore> clients;   // one client per server shard
+    size_t capacity = 0;                                // units of each client
 #ifdef SEASTAR_DEBUG
     unsigned version = 0;
 #endif
@@ -95,6 +96,7 @@ future<smp_service_group> create_smp_service_group(smp_service_group_config ssgc
                 for (unsigned i = 0; i != this_smp_shard_count(); ++i) {
                     smp_service_groups[id].clients.emplace_back(per_client, make_service_group_semaphore_exception_factory(id, i, cpu, ssgc.group_name));
                 }
+                smp_service_groups[id].capacity = per_client;
               });
             }).handle_exception([id] (std::exception_ptr e) {
                 // rollback
@@ -152,12 +154,17 @@ void init_default_smp_service_group(shard_id cpu) {
     for (unsigned i = 0; i != this_smp_shard_count(); ++i) {
         ssg0.clients.emplace_back(smp_service_group_semaphore::max_counter(), make_service_group_semaphore_exception_factory(0, i, cpu, {"default"}));
     }
+    ssg0.capacity = smp_service_group_semaphore::max_counter();
 }
 
 smp_service_group_semaphore& get_smp_service_groups_semaphore(unsigned ssg_id, shard_id t) noexcept {
     return smp_service_groups[ssg_id].clients[t];
 }
 
+size_t get_smp_service_groups_semaphore_capacity(unsigned ssg_id) noexcept {
+    return smp_service_groups[ssg_id].capacity;
+}
+
 smp::smp(alien::instance& alien)
         : _alien(alien) {
 }
@@ -85,4 +85,18 @@ wrap_syscall(int result, const Extra& extra) {
     return syscall_result_extra<Extra>{result, errno, extra};
 }
 
+// Like wrap_syscall(), for operations completed by the kernel
+// asynchronously, which report errors as a negated errno
+inline
+syscall_result<int>
+wrap_kernel_result(ssize_t res) {
+    return res < 0 ? syscall_result<int>{-1, int(-res)} : syscall_result<int>{int(res), 0};
+}
+
+template <typename Extra>
+syscall_result_extra<Extra>
+wrap_kernel_result(ssize_t res, const Extra& extra) {
+    return res < 0 ? syscall_result_extra<Extra>{-1, int(-res), extra} : syscall_result_extra<Extra>{int(res), 0, extra};
+}
+
 }
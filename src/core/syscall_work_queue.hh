@@ -27,9 +27,16 @@
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/noncopyable_function.hh>
 #include <boost/lockfree/spsc_queue.hpp>
+#include <chrono>
+#include <mutex>
 
 namespace seastar {
 
+namespace internal {
+enum class thread_pool_submit_reason : size_t;
+class submit_metrics;
+}
+
 class syscall_work_queue {
     static constexpr size_t queue_length = 128;
     struct work_item;
@@ -37,9 +44,17 @@ class syscall_work_queue {
                             boost::lockfree::capacity<queue_length>>;
     lf_queue _pending;
     lf_queue _completed;
+    // The queues have a single producer and a single consumer on the
+    // reactor side; the syscall threads take these locks to pop from
+    // _pending and to push to _completed.
+    std::mutex _pending_lock;
+    std::mutex _completed_lock;
     writeable_eventfd _start_eventfd;
     semaphore _queue_has_room = { queue_length };
     struct work_item {
+        internal::thread_pool_submit_reason _reason;
+        std::chrono::steady_clock::time_point _submitted;
+        explicit work_item(internal::thread_pool_submit_reason reason) : _reason(reason), _submitted(std::chrono::steady_clock::now()) {}
         virtual ~work_item() {}
         virtual void process() = 0;
         virtual void complete() = 0;
@@ -50,7 +65,7 @@ class syscall_work_queue {
         noncopyable_function<T ()> _func;
         promise<T> _promise;
         std::optional<T> _result;
-        work_item_returning(noncopyable_function<T ()> func) : _func(std::move(func)) {}
+        work_item_returning(internal::thread_pool_submit_reason reason, noncopyable_function<T ()> func) : work_item(reason), _func(std::move(func)) {}
         virtual void process() override { _result = this->_func(); }
         virtual void complete() override { _promise.set_value(std::move(*_result)); }
         virtual void set_exception(std::exception_ptr eptr) override { _promise.set_exception(eptr); };
@@ -59,9 +74,9 @@ class syscall_work_queue {
 public:
     syscall_work_queue();
     template <typename T>
-    future<T> submit(noncopyable_function<T ()> func) noexcept {
+    future<T> submit(internal::thread_pool_submit_reason reason, noncopyable_function<T ()> func) noexcept {
       try {
-        auto wi = std::make_unique<work_item_returning<T>>(std::move(func));
+        auto wi = std::make_unique<work_item_returning<T>>(reason, std::move(func));
         auto fut = wi->get_future();
         submit_item(std::move(wi));
         return fut;
@@ -76,8 +91,8 @@ class syscall_work_queue {
     // that from the reactor's point of view, a request is not considered handled until it is
     // removed from the _completed queue.
     //
-    // Returns the number of requests handled.
-    unsigned complete();
+    // Returns the number of requests handled, and records their latencies in \c metrics.
+    unsigned complete(internal::submit_metrics& metrics);
     void submit_item(std::unique_ptr<syscall_work_queue::work_item> wi);
 
     friend class thread_pool;
@@ -23,16 +23,21 @@
 
 #include <atomic>
 #include <cstdint>
-#include <array>
 #include <pthread.h>
 #include <signal.h>
 
 #include "core/thread_pool.hh"
+#include <seastar/core/format.hh>
 #include <seastar/util/assert.hh>
 
 namespace seastar {
 
-thread_pool::thread_pool(sstring name, file_desc& notify) : _notify_eventfd(notify), _worker_thread([this, name] { work(name); }) {
+thread_pool::thread_pool(sstring name, file_desc& notify, unsigned nr_threads) : _notify_eventfd(notify), _nr_threads(nr_threads) {
+    _worker_threads.reserve(nr_threads);
+    for (unsigned i = 0; i < nr_threads; i++) {
+        auto thread_name = nr_threads == 1 ? name : seastar::format("{}.{}", name, i);
+        _worker_threads.emplace_back([this, thread_name] { work(thread_name); });
+    }
 }
 
 void thread_pool::work(sstring name) {
@@ -41,22 +46,38 @@ void thread_pool::work(sstring name) {
     sigfillset(&mask);
     auto r = ::pthread_sigmask(SIG_BLOCK, &mask, NULL);
     throw_pthread_error(r);
-    std::array<syscall_work_queue::work_item*, syscall_work_queue::queue_length> tmp_buf;
+    bool shared = _nr_threads > 1;
     while (true) {
         uint64_t count;
         auto r = ::read(inter_thread_wq._start_eventfd.get_read_fd(), &count, sizeof(count));
         SEASTAR_ASSERT(r == sizeof(count));
         if (_stopped.load(std::memory_order_relaxed)) {
+            // Pass the wakeup on to the next thread
+            inter_thread_wq._start_eventfd.signal(1);
             break;
         }
-        auto end = tmp_buf.data();
-        inter_thread_wq._pending.consume_all([&] (syscall_work_queue::work_item* wi) {
-            *end++ = wi;
-        });
-        for (auto p = tmp_buf.data(); p != end; ++p) {
-            auto wi = *p;
+        // The read consumed the wakeups of all the items queued so far, so
+        // take them one at a time and hand the rest over to another thread,
+        // which will pick the next one while this one is busy with its call.
+        while (true) {
+            syscall_work_queue::work_item* wi = nullptr;
+            bool more = false;
+            {
+                std::lock_guard<std::mutex> lock(inter_thread_wq._pending_lock);
+                inter_thread_wq._pending.pop(wi);
+                more = shared && inter_thread_wq._pending.read_available();
+            }
+            if (!wi) {
+                break;
+            }
+            if (more) {
+                inter_thread_wq._start_eventfd.signal(1);
+            }
             wi->process();
-            inter_thread_wq._completed.push(wi);
+            {
+                std::lock_guard<std::mutex> lock(inter_thread_wq._completed_lock);
+                inter_thread_wq._completed.push(wi);
+            }
 
             // Prevent the following load of _main_thread_idle to be hoisted before the writes to _completed above.
             std::atomic_thread_fence(std::memory_order_seq_cst);
@@ -72,7 +93,9 @@ void thread_pool::work(sstring name) {
 thread_pool::~thread_pool() {
     _stopped.store(true, std::memory_order_relaxed);
     inter_thread_wq._start_eventfd.signal(1);
-    _worker_thread.join();
+    for (auto& t : _worker_threads) {
+        t.join();
+    }
 }
 
 }
@@ -22,6 +22,8 @@
 #pragma once
 
 #include "syscall_work_queue.hh"
+#include <seastar/core/internal/estimated_histogram.hh>
+#include <vector>
 
 namespace seastar {
 
@@ -36,19 +38,37 @@ enum class thread_pool_submit_reason : size_t {
     file_operation,
     // Used for process operations that don't have non-blocking alternatives.
     process_operation,
+    // Used for memory management calls too slow for the reactor thread.
+    memory_operation,
 };
 
 class submit_metrics {
-    uint64_t _counters[static_cast<size_t>(thread_pool_submit_reason::process_operation) + 1]{};
+public:
+    // Time from submission until the reactor collects the result, in
+    // microseconds, from 4us to 33s.
+    using latency_histogram = metrics::internal::approximate_exponential_histogram<4, 33554432, 4>;
+
+private:
+    static constexpr size_t nr_reasons = static_cast<size_t>(thread_pool_submit_reason::memory_operation) + 1;
+    uint64_t _counters[nr_reasons]{};
+    latency_histogram _latencies[nr_reasons];
 
 public:
     void record_reason(thread_pool_submit_reason reason) {
         ++_counters[static_cast<size_t>(reason)];
     }
 
+    void record_latency(thread_pool_submit_reason reason, std::chrono::steady_clock::duration latency) {
+        _latencies[static_cast<size_t>(reason)].add(std::chrono::duration_cast<std::chrono::microseconds>(latency).count());
+    }
+
     uint64_t count_for(thread_pool_submit_reason reason) const {
         return _counters[static_cast<size_t>(reason)];
     }
+
+    const latency_histogram& latency_for(thread_pool_submit_reason reason) const {
+        return _latencies[static_cast<size_t>(reason)];
+    }
 };
 } // namespace internal
 
@@ -56,20 +76,24 @@ class thread_pool {
     file_desc& _notify_eventfd;
     internal::submit_metrics metrics;
     syscall_work_queue inter_thread_wq;
-    posix_thread _worker_thread;
     std::atomic<bool> _stopped = { false };
     std::atomic<bool> _main_thread_idle = { false };
+    const unsigned _nr_threads;
+    std::vector<posix_thread> _worker_threads;
 public:
-    explicit thread_pool(sstring thread_name, file_desc& notify);
+    // Starts \c nr_threads syscall threads, which share the work queue
+    explicit thread_pool(sstring thread_name, file_desc& notify, unsigned nr_threads = 1);
     ~thread_pool();
     template <typename T, typename Func>
     future<T> submit(internal::thread_pool_submit_reason reason, Func func) noexcept {
         metrics.record_reason(reason);
-        return inter_thread_wq.submit<T>(std::move(func));
+        return inter_thread_wq.submit<T>(reason, std::move(func));
     }
     uint64_t count(internal::thread_pool_submit_reason r) const { return metrics.count_for(r); }
+    const internal::submit_metrics::latency_histogram& latency(internal::thread_pool_submit_reason r) const { return metrics.latency_for(r); }
+    unsigned threads() const noexcept { return _nr_threads; }
 
-    unsigned complete() { return inter_thread_wq.complete(); }
+    unsigned complete() { return inter_thread_wq.complete(metrics); }
     // Before we enter interrupt mode, we must make sure that the syscall thread will properly
     // generate signals to wake us up. This means we need to make sure that all modifications to
     // the pending and completed fields in the inter_thread_wq are visible to all threads.
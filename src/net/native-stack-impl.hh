@@ -21,8 +21,12 @@
 
 #pragma once
 
+#include <cstring>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
 #include <seastar/net/stack.hh>
 #include <seastar/net/inet_address.hh>
+#include <seastar/net/tcp-congestion.hh>
 #include <seastar/util/assert.hh>
 #include <seastar/util/log.hh>
 
@@ -292,11 +296,21 @@ keepalive_params native_connected_socket_impl<Protocol>::get_keepalive_parameter
 
 template<typename Protocol>
 void native_connected_socket_impl<Protocol>::set_sockopt(int level, int optname, const void* data, size_t len) {
+    if (level == IPPROTO_TCP && optname == TCP_CONGESTION) {
+        auto name = static_cast<const char*>(data);
+        _conn->set_congestion_control(net::parse_tcp_congestion_algorithm(std::string_view(name, strnlen(name, len))));
+        return;
+    }
     throw std::runtime_error("Setting custom socket options is not supported for native stack");
 }
 
 template<typename Protocol>
 int native_connected_socket_impl<Protocol>::get_sockopt(int level, int optname, void* data, size_t len) const {
+    if (level == IPPROTO_TCP && optname == TCP_CONGESTION) {
+        auto name = net::tcp_congestion_algorithm_name(_conn->congestion_control());
+        strncpy(static_cast<char*>(data), name, len);
+        return 0;
+    }
     throw std::runtime_error("Getting custom socket options is not supported for native stack");
 }
 
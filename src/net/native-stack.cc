@@ -44,6 +44,7 @@
 #include <seastar/net/udp.hh>
 #include <seastar/net/virtio.hh>
 #include <seastar/net/dpdk.hh>
+#include <seastar/net/xdp.hh>
 #include <seastar/net/proxy.hh>
 #include <seastar/net/dhcp.hh>
 #include <seastar/net/config.hh>
@@ -74,6 +75,9 @@ void create_native_net_device(const native_stack_options& opts) {
     std::unique_ptr<device> dev;
 
     if ( deprecated_config_used) {
+        if (opts.xdp_opts.xdp_interface) {
+            dev = create_xdp_net_device(opts.xdp_opts);
+        } else
 #ifdef SEASTAR_HAVE_DPDK
         if ( opts.dpdk_pmd) {
              dev = create_dpdk_net_device(opts.dpdk_opts.dpdk_port_index.get_value(), this_smp_shard_count(),
@@ -216,9 +220,12 @@ net::datagram_channel native_network_stack::make_bound_datagram_channel(const so
 }
 
 native_network_stack::native_network_stack(const native_stack_options& opts, std::shared_ptr<device> dev)
-    : _netif(std::move(dev))
+    : _netif(std::move(dev), opts.software_gso.get_value(), opts.software_gro.get_value())
     , _inet(&_netif) {
     _inet.get_udp().set_queue_size(opts.udpv4_queue_size.get_value());
+    _inet.get_tcp().set_default_congestion_control(
+            parse_tcp_congestion_algorithm(opts.tcp_congestion_control.get_value()),
+            opts.tcp_pacing.get_value());
     _dhcp = opts.host_ipv4_addr.defaulted()
             && opts.gw_ipv4_addr.defaulted()
             && opts.netmask_ipv4_addr.defaulted() && opts.dhcp.get_value();
@@ -359,8 +366,21 @@ native_stack_options::native_stack_options()
     , lro(*this, "lro",
                 "on",
                 "Enable LRO")
+    , tcp_congestion_control(*this, "tcp-congestion-control",
+                "reno",
+                "TCP congestion control algorithm (reno, cubic, bbr)")
+    , tcp_pacing(*this, "tcp-pacing",
+                false,
+                "Pace TCP data over the round-trip time (always on with bbr)")
+    , software_gso(*this, "software-gso",
+                true,
+                "Segment and checksum TCP data in software when the device can't")
+    , software_gro(*this, "software-gro",
+                true,
+                "Merge received TCP segments in software")
     , virtio_opts(this)
     , dpdk_opts(this)
+    , xdp_opts(this)
 {
 }
 
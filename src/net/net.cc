@@ -27,6 +27,7 @@
 #include <utility>
 
 #include <seastar/net/net.hh>
+#include <seastar/net/offload.hh>
 #include <seastar/net/toeplitz.hh>
 #include <seastar/core/internal/poll.hh>
 #include <seastar/core/reactor.hh>
@@ -255,16 +256,42 @@ future<> l3_protocol::receive(
     return _netif->register_l3(_proto_num, std::move(rx_fn), std::move(forward));
 };
 
-interface::interface(std::shared_ptr<device> dev)
+interface::interface(std::shared_ptr<device> dev, bool gso, bool gro)
     : _dev(dev)
     , _hw_address(_dev->hw_address())
-    , _hw_features(_dev->hw_features()) {
+    , _hw_features(_dev->hw_features())
+    , _dev_features(_hw_features) {
+    if (gso && !_dev_features.tx_tso) {
+        _hw_features.tx_tso = true;
+        _hw_features.tx_csum_l4_offload = true;
+        _hw_features.max_packet_len = ip_packet_len_max - eth_hdr_len;
+    }
+    if (gro) {
+        _gro = std::make_unique<net::gro>(_dev_features, [this] (packet p) {
+            (void)dispatch_packet(std::move(p));
+        });
+    }
     // FIXME: ignored future
     (void)_dev->receive([this] (packet p) {
+        if (_gro) {
+            _gro->receive(std::move(p));
+            return make_ready_future<>();
+        }
         return dispatch_packet(std::move(p));
     });
+    if (_gro) {
+        // Runs after the device's receive pollers, ending each batch
+        _gro_poller = std::make_unique<internal::poller>(reactor::poller::simple([this] {
+            return _gro->flush();
+        }));
+    }
     dev->local_queue().register_packet_provider([this, idx = 0u] () mutable {
             std::optional<packet> p;
+            if (!_gso_frames.empty()) {
+                p = std::move(_gso_frames.front());
+                _gso_frames.pop_front();
+                return p;
+            }
             for (size_t i = 0; i < _pkt_providers.size(); i++) {
                 auto l3p = _pkt_providers[idx++]();
                 if (idx == _pkt_providers.size())
@@ -276,6 +303,12 @@ interface::interface(std::shared_ptr<device> dev)
                     eh->src_mac = _hw_address;
                     eh->eth_proto = uint16_t(l3pv.proto_num);
                     *eh = hton(*eh);
+                    if (needs_software_offload(l3pv.p.get_offload_info(), _dev_features)) {
+                        software_segment(std::move(l3pv.p), _dev_features, _gso_frames);
+                        p = std::move(_gso_frames.front());
+                        _gso_frames.pop_front();
+                        return p;
+                    }
                     p = std::move(l3pv.p);
                     return p;
                 }
@@ -284,6 +317,8 @@ interface::interface(std::shared_ptr<device> dev)
         });
 }
 
+interface::~interface() = default;
+
 future<>
 interface::register_l3(eth_protocol_num proto_num,
         std::function<future<> (packet p, ethernet_address from)> next,
@@ -0,0 +1,306 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <algorithm>
+#include <cstring>
+
+#include <seastar/net/offload.hh>
+#include <seastar/net/const.hh>
+#include <seastar/net/ethernet.hh>
+#include <seastar/net/ip.hh>
+#include <seastar/net/ip_checksum.hh>
+#include <seastar/net/tcp.hh>
+
+namespace seastar {
+
+namespace net {
+
+// Sums the packet from \c offset on
+static void sum_from(checksummer& csum, const packet& p, size_t offset) {
+    for (auto& f : p.fragments()) {
+        if (offset >= f.size) {
+            offset -= f.size;
+            continue;
+        }
+        csum.sum(f.base + offset, f.size - offset);
+        offset = 0;
+    }
+}
+
+// With checksum offload, the stack leaves the L4 checksum field holding
+// the sum of the pseudo header; summing the L4 header and payload over it
+// gives the checksum
+static void complete_l4_checksum(packet& frame, const offload_info& oi) {
+    size_t l4_offset = eth_hdr_len + oi.ip_hdr_len;
+    size_t csum_offset = l4_offset + (oi.protocol == ip_protocol_num::tcp ? 16 : 6);
+    checksummer csum;
+    sum_from(csum, frame, l4_offset);
+    uint16_t checksum = csum.get();
+    if (oi.protocol == ip_protocol_num::udp && checksum == 0) {
+        // Zero means no checksum for UDP
+        checksum = 0xffff;
+    }
+    std::copy_n(reinterpret_cast<const char*>(&checksum), 2, frame.get_header(csum_offset, 2));
+}
+
+void software_segment(packet frame, const hw_features& hw, circular_buffer<packet>& out) {
+    auto oi = frame.get_offload_info();
+    if (!oi.tso_seg_size || hw.tx_tso) {
+        if (oi.needs_csum && !hw.tx_csum_l4_offload) {
+            complete_l4_checksum(frame, oi);
+            oi.needs_csum = false;
+            frame.set_offload_info(oi);
+        }
+        out.push_back(std::move(frame));
+        return;
+    }
+
+    // Segments get a copy of the headers each, fixed up, and share the
+    // payload of the original frame
+    size_t l4_offset = eth_hdr_len + oi.ip_hdr_len;
+    size_t hdr_len = l4_offset + oi.tcp_hdr_len;
+    char hdrs[eth_hdr_len + 60 + 60];
+    std::copy_n(frame.get_header(0, hdr_len), hdr_len, hdrs);
+    auto iph = ntoh(*reinterpret_cast<ip_hdr*>(hdrs + eth_hdr_len));
+    auto th = tcp_hdr::read(hdrs + l4_offset);
+    uint32_t payload = frame.len() - hdr_len;
+    uint16_t seg_size = oi.tso_seg_size;
+
+    auto seg_oi = oi;
+    seg_oi.tso_seg_size = 0;
+    seg_oi.needs_csum = hw.tx_csum_l4_offload;
+    uint16_t id = iph.id;
+    for (uint32_t offset = 0; offset < payload; offset += seg_size) {
+        uint16_t len = std::min<uint32_t>(seg_size, payload - offset);
+        bool last = offset + len == payload;
+        auto seg = frame.share(hdr_len + offset, len);
+        auto h = seg.prepend_uninitialized_header(hdr_len);
+        std::copy_n(hdrs, hdr_len, h);
+
+        auto ip = iph;
+        ip.len = oi.ip_hdr_len + oi.tcp_hdr_len + len;
+        ip.id = id++;
+        ip.csum = 0;
+        auto seg_iph = reinterpret_cast<ip_hdr*>(h + eth_hdr_len);
+        *seg_iph = hton(ip);
+        if (!oi.needs_ip_csum) {
+            checksummer csum;
+            csum.sum(h + eth_hdr_len, oi.ip_hdr_len);
+            seg_iph->csum = csum.get();
+        }
+
+        auto t = th;
+        t.seq = th.seq + int32_t(offset);
+        // FIN and PSH belong to the end of the data
+        t.f_fin = th.f_fin && last;
+        t.f_psh = th.f_psh && last;
+        t.checksum = 0;
+        t.write(h + l4_offset);
+        checksummer csum;
+        ipv4_traits::tcp_pseudo_header_checksum(csum, iph.src_ip, iph.dst_ip, oi.tcp_hdr_len + len);
+        uint16_t checksum;
+        if (hw.tx_csum_l4_offload) {
+            checksum = ~csum.get();
+        } else {
+            sum_from(csum, seg, l4_offset);
+            checksum = csum.get();
+        }
+        tcp_hdr::write_nbo_checksum(h + l4_offset, checksum);
+
+        seg.set_offload_info(seg_oi);
+        out.push_back(std::move(seg));
+    }
+}
+
+struct gro::flow {
+    ipv4_address src_ip;
+    ipv4_address dst_ip;
+    uint16_t src_port;
+    uint16_t dst_port;
+    // The first segment's headers become those of the merged one
+    packet p;
+    uint16_t hdr_len;
+    uint16_t seg_size;
+    uint32_t ip_len;
+    tcp_seq next_seq;
+    tcp_seq ack;
+    unsigned segs;
+    bool verified;
+
+    bool matches(const ip_hdr& ip, const tcp_hdr& th) const noexcept {
+        return src_ip == ip.src_ip && dst_ip == ip.dst_ip && src_port == th.src_port && dst_port == th.dst_port;
+    }
+};
+
+gro::gro(const hw_features& hw, std::function<void (packet)> deliver)
+    : _hw(hw)
+    , _deliver(std::move(deliver))
+{
+    _flows.reserve(max_flows);
+}
+
+gro::~gro() = default;
+
+void gro::deliver(flow& f) {
+    if (f.segs > 1) {
+        auto iph = f.p.get_header<ip_hdr>(eth_hdr_len);
+        iph->len = hton(uint16_t(f.ip_len));
+        iph->csum = 0;
+        checksummer csum;
+        csum.sum(reinterpret_cast<char*>(iph), sizeof(*iph));
+        iph->csum = csum.get();
+    }
+    if (f.verified) {
+        f.p.offload_info_ref().rx_csum_verified = true;
+    }
+    _deliver(std::move(f.p));
+}
+
+void gro::receive(packet frame) {
+    _stats.frames++;
+    auto eh = frame.get_header<eth_hdr>(0);
+    auto iph = frame.get_header<ip_hdr>(eth_hdr_len);
+    if (!eh || ntoh(eh->eth_proto) != uint16_t(eth_protocol_num::ipv4)
+            || !iph || iph->ver != 4 || iph->ip_proto != uint8_t(ip_protocol_num::tcp)) {
+        _deliver(std::move(frame));
+        return;
+    }
+    auto ip = ntoh(*iph);
+    size_t l4_offset = eth_hdr_len + ip.ihl * 4;
+    auto thp = frame.get_header(l4_offset, tcp_hdr::len);
+    if (ip.ihl < 5 || ip.len < ip.ihl * 4 + tcp_hdr::len || frame.len() < eth_hdr_len + size_t(ip.len) || !thp) {
+        _deliver(std::move(frame));
+        return;
+    }
+    auto th = tcp_hdr::read(thp);
+    size_t hdr_len = l4_offset + th.data_offset * 4;
+    if (hdr_len > eth_hdr_len + size_t(ip.len)) {
+        _deliver(std::move(frame));
+        return;
+    }
+    uint32_t payload = eth_hdr_len + ip.len - hdr_len;
+    auto fit = std::find_if(_flows.begin(), _flows.end(), [&] (const flow& f) { return f.matches(ip, th); });
+
+    // Only plain in-order data segments are merged; anything else on the
+    // flow is delivered after what is held
+    auto flush_and_deliver = [&] {
+        if (fit != _flows.end()) {
+            deliver(*fit);
+            _flows.erase(fit);
+        }
+        _deliver(std::move(frame));
+    };
+    if (ip.ihl != 5 || ip.mf() || ip.offset() || th.data_offset * 4 < tcp_hdr::len || !payload
+            || !th.f_ack || th.f_syn || th.f_rst || th.f_fin || th.f_urg || th.rsvd2) {
+        return flush_and_deliver();
+    }
+    // Drop the Ethernet padding
+    frame.trim_back(frame.len() - eth_hdr_len - ip.len);
+    if (!frame.get_header(0, hdr_len)) {
+        return flush_and_deliver();
+    }
+
+    bool verified = _hw.rx_csum_offload || frame.offload_info_ref().rx_csum_verified;
+    if (!verified) {
+        checksummer csum;
+        csum.sum(reinterpret_cast<char*>(frame.get_header<ip_hdr>(eth_hdr_len)), sizeof(ip_hdr));
+        if (csum.get() != 0) {
+            return flush_and_deliver();
+        }
+        checksummer l4csum;
+        ipv4_traits::tcp_pseudo_header_checksum(l4csum, ip.src_ip, ip.dst_ip, ip.len - ip.ihl * 4);
+        sum_from(l4csum, frame, l4_offset);
+        if (l4csum.get() != 0) {
+            // Let the stack drop it
+            return flush_and_deliver();
+        }
+        verified = true;
+    }
+
+    if (fit != _flows.end()) {
+        auto& f = *fit;
+        auto hdrs = frame.get_header(0, hdr_len);
+        auto f_hdrs = f.p.get_header(0, f.hdr_len);
+        if (th.seq == f.next_seq && th.ack == f.ack && hdr_len == f.hdr_len && payload <= f.seg_size
+                && f.ip_len + payload <= max_ip_len
+                && std::equal(hdrs + l4_offset + tcp_hdr::len, hdrs + hdr_len, f_hdrs + l4_offset + tcp_hdr::len)) {
+            // Take the latest window, and PSH
+            std::copy_n(hdrs + l4_offset + 14, 2, f_hdrs + l4_offset + 14);
+            f_hdrs[l4_offset + 13] |= hdrs[l4_offset + 13] & 0x08;
+            frame.trim_front(hdr_len);
+            f.p.append(std::move(frame));
+            f.ip_len += payload;
+            f.next_seq += payload;
+            f.segs++;
+            f.verified &= verified;
+            _stats.merged++;
+            // A short segment ends a burst, and PSH a message
+            if (th.f_psh || payload < f.seg_size) {
+                deliver(f);
+                _flows.erase(fit);
+            }
+            return;
+        }
+        deliver(f);
+        _flows.erase(fit);
+    }
+
+    if (th.f_psh) {
+        if (verified) {
+            frame.offload_info_ref().rx_csum_verified = true;
+        }
+        _deliver(std::move(frame));
+        return;
+    }
+    if (_flows.size() == max_flows) {
+        deliver(_flows.front());
+        _flows.erase(_flows.begin());
+    }
+    _flows.push_back(flow{
+        .src_ip = ip.src_ip,
+        .dst_ip = ip.dst_ip,
+        .src_port = th.src_port,
+        .dst_port = th.dst_port,
+        .p = std::move(frame),
+        .hdr_len = uint16_t(hdr_len),
+        .seg_size = uint16_t(payload),
+        .ip_len = ip.len,
+        .next_seq = th.seq + int32_t(payload),
+        .ack = th.ack,
+        .segs = 1,
+        .verified = verified,
+    });
+}
+
+bool gro::flush() {
+    if (_flows.empty()) {
+        return false;
+    }
+    for (auto& f : _flows) {
+        deliver(f);
+    }
+    _flows.clear();
+    return true;
+}
+
+}
+
+}
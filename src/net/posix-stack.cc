@@ -29,11 +29,13 @@
 
 #include <unistd.h>
 #include <linux/if.h>
+#include <linux/tls.h>
 #include <linux/netlink.h>
 #include <linux/rtnetlink.h>
 #include <arpa/inet.h>
 #include <net/route.h>
 #include <netinet/tcp.h>
+#include <netinet/udp.h>
 #include <netinet/sctp.h>
 #include <sys/socket.h>
 #include <seastar/util/assert.hh>
@@ -322,6 +324,26 @@ class posix_connected_socket_impl : public connected_socket_impl {
     future<> wait_input_shutdown() override {
         return _fd.poll_rdhup();
     }
+    future<> send_tls_control_record(uint8_t record_type, temporary_buffer<char> data) override {
+        std::array<char, CMSG_SPACE(sizeof(uint8_t))> control{};
+        iovec iov = { const_cast<char*>(data.get()), data.size() };
+        msghdr msg = {};
+        msg.msg_iov = &iov;
+        msg.msg_iovlen = 1;
+        msg.msg_control = control.data();
+        msg.msg_controllen = control.size();
+        auto cmsg = CMSG_FIRSTHDR(&msg);
+        cmsg->cmsg_level = SOL_TLS;
+        cmsg->cmsg_type = TLS_SET_RECORD_TYPE;
+        cmsg->cmsg_len = CMSG_LEN(sizeof(uint8_t));
+        *CMSG_DATA(cmsg) = record_type;
+        // The kernel turns a single sendmsg() carrying the record type into
+        // one record, so a short write here cannot be resumed.
+        auto n = co_await _fd.sendmsg(&msg);
+        if (n != data.size()) {
+            throw std::system_error(EIO, std::system_category(), "short write of TLS control record");
+        }
+    }
 
     friend class posix_server_socket_impl;
     friend class posix_ap_server_socket_impl;
@@ -876,7 +898,7 @@ future<> posix_data_sink_impl::put(std::span<temporary_buffer<char>> bufs) {
     auto [ total, del ] = _vecs.populate(bufs);
     auto sg_id = internal::scheduling_group_index(current_scheduling_group());
     bytes_sent[sg_id] += total;
-    return _fd.send_all(_vecs.v).finally([del = std::move(del)] {} );
+    return _fd.send_all(_vecs.v, std::move(del));
 }
 #else
 future<>
@@ -956,48 +978,109 @@ posix_ap_network_stack::listen(socket_address sa, listen_options opt) {
         server_socket(std::make_unique<posix_ap_server_socket_impl>(protocol, sa, _allocator));
 }
 
-struct cmsg_with_pktinfo {
-    struct cmsghdrcmh;
-    union {
-        struct in_pktinfo pktinfo;
-        struct in6_pktinfo pkt6info;
-    };
+class posix_datagram : public datagram_impl {
+private:
+    socket_address _src;
+    socket_address _dst;
+    temporary_buffer<char> _buf;
+public:
+    posix_datagram(const socket_address& src, const socket_address& dst, temporary_buffer<char> b) : _src(src), _dst(dst), _buf(std::move(b)) {}
+    virtual socket_address get_src() override { return _src; }
+    virtual socket_address get_dst() override { return _dst; }
+    virtual uint16_t get_dst_port() override {
+        if (_dst.family() != AF_INET && _dst.family() != AF_INET6) {
+            throw std::runtime_error(format("get_dst_port() called on non-IP address: {}", _dst));
+        }
+        return _dst.port();
+    }
+    virtual std::span<temporary_buffer<char>> get_buffers() override { return std::span(&_buf, 1); }
 };
 
 class posix_datagram_channel : public datagram_channel_impl {
 private:
     static constexpr int MAX_DATAGRAM_SIZE = 65507;
-    struct recv_ctx {
-        struct msghdr _hdr;
-        struct iovec _iov;
-        socket_address _src_addr;
-        char* _buffer;
-        cmsg_with_pktinfo _cmsg;
+    // The kernel's limit on segments per UDP_SEGMENT send
+    static constexpr unsigned max_gso_segments = 64;
+    // Datagrams are received in batches with recvmmsg(), each into a slot of
+    // a ring of buffers. A slot's buffer is reused by the next batch unless
+    // datagrams handed out of it are still alive. With UDP_GRO, the kernel
+    // may coalesce datagrams of the same size from the same sender into one
+    // slot; they are split again before being handed out.
+    struct recv_ring {
+        static constexpr unsigned batch = 16;
+        struct slot_buffer {
+            std::unique_ptr<char[]> data{new char[MAX_DATAGRAM_SIZE]};
+        };
+        struct slot {
+            struct iovec iov;
+            socket_address src_addr;
+            lw_shared_ptr<slot_buffer> buf;
+            alignas(cmsghdr) char control[CMSG_SPACE(sizeof(in6_pktinfo)) + CMSG_SPACE(sizeof(int))];
+        };
+        const bool _use_cmsg;
+        std::vector<slot> _slots;
+        std::vector<struct mmsghdr> _msgs;
+        circular_buffer<datagram> _ready;
 
-        recv_ctx(bool use_pktinfo) {
-            memset(&_hdr, 0, sizeof(_hdr));
-            _hdr.msg_iov = &_iov;
-            _hdr.msg_iovlen = 1;
-            _hdr.msg_name = &_src_addr.u.sa;
-            _hdr.msg_namelen = sizeof(_src_addr.u.sas);
-
-            if (use_pktinfo) {
-                memset(&_cmsg, 0, sizeof(_cmsg));
-                _hdr.msg_control = &_cmsg;
-                _hdr.msg_controllen = sizeof(_cmsg);
-            } else {
-                _hdr.msg_control = nullptr;
-                _hdr.msg_controllen = 0;
-            }
-        }
+        recv_ring(bool use_cmsg) : _use_cmsg(use_cmsg) {}
 
-        recv_ctx(const recv_ctx&) = delete;
-        recv_ctx(recv_ctx&&) = delete;
+        recv_ring(const recv_ring&) = delete;
+        recv_ring(recv_ring&&) = delete;
 
         void prepare() {
-            _buffer = new char[MAX_DATAGRAM_SIZE];
-            _iov.iov_base = _buffer;
-            _iov.iov_len = MAX_DATAGRAM_SIZE;
+            if (_slots.empty()) {
+                _slots.resize(batch);
+                _msgs.resize(batch);
+            }
+            for (unsigned i = 0; i < batch; i++) {
+                auto& s = _slots[i];
+                if (!s.buf || s.buf.use_count() > 1) {
+                    s.buf = make_lw_shared<slot_buffer>();
+                }
+                s.iov.iov_base = s.buf->data.get();
+                s.iov.iov_len = MAX_DATAGRAM_SIZE;
+                auto& hdr = _msgs[i].msg_hdr;
+                memset(&hdr, 0, sizeof(hdr));
+                hdr.msg_iov = &s.iov;
+                hdr.msg_iovlen = 1;
+                hdr.msg_name = &s.src_addr.u.sa;
+                hdr.msg_namelen = sizeof(s.src_addr.u.sas);
+                if (_use_cmsg) {
+                    hdr.msg_control = s.control;
+                    hdr.msg_controllen = sizeof(s.control);
+                }
+                _msgs[i].msg_len = 0;
+            }
+        }
+
+        // Queues the datagrams received into slot i; returns their size
+        size_t unpack(unsigned i, const socket_address& local) {
+            auto& s = _slots[i];
+            auto& hdr = _msgs[i].msg_hdr;
+            size_t size = _msgs[i].msg_len;
+            std::optional<socket_address> dst;
+            size_t seg_size = size;
+            for (auto* cmsg = CMSG_FIRSTHDR(&hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&hdr, cmsg)) {
+                if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
+                    dst = ipv4_addr(copy_reinterpret_cast<in_pktinfo>(CMSG_DATA(cmsg)).ipi_addr, local.port());
+                } else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
+                    dst = ipv6_addr(copy_reinterpret_cast<in6_pktinfo>(CMSG_DATA(cmsg)).ipi6_addr, local.port());
+                } else if (cmsg->cmsg_level == SOL_UDP && cmsg->cmsg_type == UDP_GRO) {
+                    seg_size = copy_reinterpret_cast<int>(CMSG_DATA(cmsg));
+                }
+            }
+            if (!seg_size) {
+                seg_size = size;
+            }
+            auto data = s.buf->data.get();
+            size_t offset = 0;
+            do {
+                auto len = std::min(seg_size, size - offset);
+                _ready.push_back(datagram(std::make_unique<posix_datagram>(s.src_addr, dst ? *dst : local,
+                        temporary_buffer<char>(data + offset, len, make_deleter([buf = s.buf] {})))));
+                offset += len;
+            } while (offset < size);
+            return size;
         }
     };
     struct send_ctx {
@@ -1034,6 +1117,9 @@ class posix_datagram_channel : public datagram_channel_impl {
 
         if (is_inet(family)) {
             fd.setsockopt(SOL_IP, IP_PKTINFO, true);
+            // Best effort, kernels before 5.0 don't coalesce
+            int one = 1;
+            ::setsockopt(fd.get(), SOL_UDP, UDP_GRO, &one, sizeof(one));
             if (engine().posix_reuseport_available()) {
                 fd.setsockopt(SOL_SOCKET, SO_REUSEPORT, 1);
             }
@@ -1042,17 +1128,21 @@ class posix_datagram_channel : public datagram_channel_impl {
         return fd;
     }
 
+    struct send_batch;
+
     pollable_fd _fd;
     socket_address _address;
-    recv_ctx _recv;
+    recv_ring _recv;
     send_ctx _send;
+    // Cleared when the device can't do UDP_SEGMENT
+    bool _gso;
     bool _closed;
 public:
     /// Creates a channel that is not bound to any socket address. The channel
     /// can be used to communicate with adressess that belong to the \param
     /// family.
     posix_datagram_channel(sa_family_t family)
-        : _recv(is_inet(family)), _closed(false) {
+        : _recv(is_inet(family)), _gso(is_inet(family)), _closed(false) {
         auto fd = create_socket(family);
 
         _address = fd.get_address();
@@ -1062,7 +1152,7 @@ class posix_datagram_channel : public datagram_channel_impl {
     /// Creates a channel that is bound to the specified local address. It can be used to
     /// communicate with addresses that belong to the family of \param local.
     posix_datagram_channel(socket_address local)
-        : _recv(is_inet(local.family())), _closed(false) {
+        : _recv(is_inet(local.family())), _gso(is_inet(local.family())), _closed(false) {
         auto fd = create_socket(local.family());
         fd.bind(local.u.sa, local.addr_length);
 
@@ -1074,6 +1164,7 @@ class posix_datagram_channel : public datagram_channel_impl {
     virtual future<datagram> receive() override;
     virtual future<> send(const socket_address& dst, const char *msg) override;
     virtual future<> send(const socket_address& dst, std::span<temporary_buffer<char>> bufs) override;
+    virtual future<> send(std::span<outgoing_datagram> datagrams) override;
     virtual void shutdown_input() override {
         _fd.shutdown(SHUT_RD, pollable_fd::shutdown_kernel_only::no);
     }
@@ -1109,6 +1200,111 @@ future<> posix_datagram_channel::send(const socket_address& dst, std::span<tempo
             .then([len, del = std::move(del) ] (size_t size) { SEASTAR_ASSERT(size == len); });
 }
 
+// The messages for one sendmmsg(): a message per datagram, or per run of
+// datagrams for UDP_SEGMENT to split
+struct posix_datagram_channel::send_batch {
+    struct gso_control {
+        alignas(cmsghdr) char buf[CMSG_SPACE(sizeof(uint16_t))];
+    };
+    std::vector<outgoing_datagram> datagrams;
+    std::vector<struct mmsghdr> msgs;
+    // Index in datagrams of the first datagram of each message
+    std::vector<size_t> first;
+    std::vector<iovec> iovs;
+    std::vector<gso_control> controls;
+
+    explicit send_batch(std::span<outgoing_datagram> d)
+        : datagrams(std::make_move_iterator(d.begin()), std::make_move_iterator(d.end())) {
+        for (auto& d : datagrams) {
+            resolve_outgoing_address(d.dst);
+        }
+    }
+
+    // (Re)builds the messages for the datagrams from \c from on
+    void build(size_t from, bool gso) {
+        first.clear();
+        for (size_t i = from; i < datagrams.size();) {
+            first.push_back(i);
+            auto seg_size = datagrams[i].buf.size();
+            size_t total = seg_size;
+            size_t j = i + 1;
+            // A run of equal-sized datagrams to the same destination, the
+            // last of which may be shorter
+            while (gso && seg_size && j < datagrams.size() && j - i < max_gso_segments
+                    && datagrams[j].dst == datagrams[i].dst
+                    && datagrams[j].buf.size() && datagrams[j].buf.size() <= seg_size
+                    && total + datagrams[j].buf.size() <= MAX_DATAGRAM_SIZE) {
+                total += datagrams[j].buf.size();
+                if (datagrams[j++].buf.size() < seg_size) {
+                    break;
+                }
+            }
+            i = j;
+        }
+        msgs.assign(first.size(), mmsghdr{});
+        iovs.resize(datagrams.size() - from);
+        controls.resize(first.size());
+        for (size_t m = 0; m < first.size(); m++) {
+            auto begin = first[m];
+            auto end = m + 1 < first.size() ? first[m + 1] : datagrams.size();
+            for (auto i = begin; i < end; i++) {
+                iovs[i - from] = iovec{datagrams[i].buf.get_write(), datagrams[i].buf.size()};
+            }
+            auto& hdr = msgs[m].msg_hdr;
+            auto& dst = datagrams[begin].dst;
+            hdr.msg_name = &dst.u.sa;
+            hdr.msg_namelen = dst.addr_length;
+            hdr.msg_iov = &iovs[begin - from];
+            hdr.msg_iovlen = end - begin;
+            if (end - begin > 1) {
+                hdr.msg_control = controls[m].buf;
+                hdr.msg_controllen = sizeof(controls[m].buf);
+                auto cmsg = CMSG_FIRSTHDR(&hdr);
+                cmsg->cmsg_level = SOL_UDP;
+                cmsg->cmsg_type = UDP_SEGMENT;
+                cmsg->cmsg_len = CMSG_LEN(sizeof(uint16_t));
+                uint16_t seg_size = datagrams[begin].buf.size();
+                std::memcpy(CMSG_DATA(cmsg), &seg_size, sizeof(seg_size));
+            }
+        }
+    }
+
+    bool segmented(size_t m) const noexcept {
+        return msgs[m].msg_hdr.msg_control;
+    }
+};
+
+future<> posix_datagram_channel::send(std::span<outgoing_datagram> datagrams) {
+    send_batch batch(datagrams);
+    size_t len = 0;
+    for (auto& d : batch.datagrams) {
+        len += d.buf.size();
+    }
+    auto sg_id = internal::scheduling_group_index(current_scheduling_group());
+    bytes_sent[sg_id] += len;
+    batch.build(0, _gso);
+    size_t sent = 0;
+    while (sent < batch.msgs.size()) {
+        try {
+            sent += co_await _fd.sendmmsg(batch.msgs.data() + sent, batch.msgs.size() - sent);
+            continue;
+        } catch (const std::system_error& e) {
+            // Devices without checksum offload (EIO), or segments larger
+            // than the path MTU (EINVAL), make the kernel refuse
+            // segmentation; send the rest datagram by datagram. Only the
+            // former lasts, the latter depends on the datagrams.
+            if (!batch.segmented(sent) || (e.code().value() != EIO && e.code().value() != EINVAL)) {
+                throw;
+            }
+            if (e.code().value() == EIO) {
+                _gso = false;
+            }
+        }
+        batch.build(batch.first[sent], false);
+        sent = 0;
+    }
+}
+
 datagram_channel
 posix_network_stack::make_unbound_datagram_channel(sa_family_t family) {
     return datagram_channel(std::make_unique<posix_datagram_channel>(family));
@@ -1133,45 +1329,31 @@ posix_network_stack::supports_ipv6() const {
     return has_ipv6;
 }
 
-class posix_datagram : public datagram_impl {
-private:
-    socket_address _src;
-    socket_address _dst;
-    temporary_buffer<char> _buf;
-public:
-    posix_datagram(const socket_address& src, const socket_address& dst, temporary_buffer<char> b) : _src(src), _dst(dst), _buf(std::move(b)) {}
-    virtual socket_address get_src() override { return _src; }
-    virtual socket_address get_dst() override { return _dst; }
-    virtual uint16_t get_dst_port() override {
-        if (_dst.family() != AF_INET && _dst.family() != AF_INET6) {
-            throw std::runtime_error(format("get_dst_port() called on non-IP address: {}", _dst));
-        }
-        return _dst.port();
-    }
-    virtual std::span<temporary_buffer<char>> get_buffers() override { return std::span(&_buf, 1); }
-};
-
 future<datagram>
 posix_datagram_channel::receive() {
+    if (!_recv._ready.empty()) {
+        auto d = std::move(_recv._ready.front());
+        _recv._ready.pop_front();
+        return make_ready_future<datagram>(std::move(d));
+    }
     _recv.prepare();
-    return _fd.recvmsg(&_recv._hdr).then([this] (size_t size) {
-        std::optional<socket_address> dst;
-        for (auto* cmsg = CMSG_FIRSTHDR(&_recv._hdr); cmsg != nullptr; cmsg = CMSG_NXTHDR(&_recv._hdr, cmsg)) {
-            if (cmsg->cmsg_level == IPPROTO_IP && cmsg->cmsg_type == IP_PKTINFO) {
-                dst = ipv4_addr(copy_reinterpret_cast<in_pktinfo>(CMSG_DATA(cmsg)).ipi_addr, _address.port());
-                break;
-            } else if (cmsg->cmsg_level == IPPROTO_IPV6 && cmsg->cmsg_type == IPV6_PKTINFO) {
-                dst = ipv6_addr(copy_reinterpret_cast<in6_pktinfo>(CMSG_DATA(cmsg)).ipi6_addr, _address.port());
+    return _fd.recvmmsg(_recv._msgs.data(), _recv._msgs.size()).then([this] (size_t n) {
+        // Like recvmsg() on a shut down socket, yield an empty datagram
+        n = std::max<size_t>(n, 1);
+        size_t size = 0;
+        for (unsigned i = 0; i < n; i++) {
+            // Once shut down, the remaining messages all come back empty
+            // and without a sender, unlike empty datagrams
+            if (i && !_recv._msgs[i].msg_len && !_recv._msgs[i].msg_hdr.msg_namelen) {
                 break;
             }
+            size += _recv.unpack(i, _address);
         }
         auto sg_id = internal::scheduling_group_index(current_scheduling_group());
         bytes_received[sg_id] += size;
-        return make_ready_future<datagram>(datagram(std::make_unique<posix_datagram>(
-            _recv._src_addr, dst ? *dst : _address, temporary_buffer<char>(_recv._buffer, size, make_deleter([buf = _recv._buffer] { delete[] buf; })))));
-    }).handle_exception([p = _recv._buffer](auto ep) {
-        delete[] p;
-        return make_exception_future<datagram>(std::move(ep));
+        auto d = std::move(_recv._ready.front());
+        _recv._ready.pop_front();
+        return make_ready_future<datagram>(std::move(d));
     });
 }
 
@@ -25,6 +25,8 @@
 #include <utility>
 #include <vector>
 
+#include <seastar/core/do_with.hh>
+#include <seastar/core/loop.hh>
 #include <seastar/core/metrics_api.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/net/stack.hh>
@@ -78,6 +80,19 @@ future<> net::datagram_channel::send(const socket_address& dst, std::span<tempor
     return _impl->send(dst, bufs);
 }
 
+future<> net::datagram_channel::send(std::span<outgoing_datagram> datagrams) {
+    return _impl->send(datagrams);
+}
+
+future<> net::datagram_channel_impl::send(std::span<outgoing_datagram> datagrams) {
+    std::vector<outgoing_datagram> owned(std::make_move_iterator(datagrams.begin()), std::make_move_iterator(datagrams.end()));
+    return do_with(std::move(owned), [this] (std::vector<outgoing_datagram>& owned) {
+        return do_for_each(owned, [this] (outgoing_datagram& d) {
+            return send(d.dst, std::span(&d.buf, 1));
+        });
+    });
+}
+
 bool net::datagram_channel::is_closed() const {
     return _impl->is_closed();
 }
@@ -172,6 +187,11 @@ net::connected_socket_impl::source(connected_socket_input_stream_config csisc) {
     return source();
 }
 
+future<>
+net::connected_socket_impl::send_tls_control_record(uint8_t, temporary_buffer<char>) {
+    return make_exception_future<>(std::system_error(ENOTSUP, std::system_category()));
+}
+
 socket::~socket()
 {}
 
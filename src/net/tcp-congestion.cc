@@ -0,0 +1,448 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <algorithm>
+#include <array>
+#include <cmath>
+#include <stdexcept>
+#include <fmt/format.h>
+#include <seastar/net/tcp-congestion.hh>
+
+namespace seastar {
+
+namespace net {
+
+using namespace std::chrono_literals;
+
+tcp_congestion_algorithm parse_tcp_congestion_algorithm(std::string_view name) {
+    if (name == "reno") {
+        return tcp_congestion_algorithm::reno;
+    }
+    if (name == "cubic") {
+        return tcp_congestion_algorithm::cubic;
+    }
+    if (name == "bbr") {
+        return tcp_congestion_algorithm::bbr;
+    }
+    throw std::invalid_argument(fmt::format("unknown TCP congestion control algorithm: {}", name));
+}
+
+const char* tcp_congestion_algorithm_name(tcp_congestion_algorithm algo) noexcept {
+    switch (algo) {
+    case tcp_congestion_algorithm::reno: return "reno";
+    case tcp_congestion_algorithm::cubic: return "cubic";
+    case tcp_congestion_algorithm::bbr: return "bbr";
+    }
+    return "unknown";
+}
+
+void tcp_congestion_control::on_recovery_exit(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size) noexcept {
+    uint32_t smss = mss;
+    // Set cwnd to min (ssthresh, max(FlightSize, SMSS) + SMSS)
+    w.cwnd = std::min(w.ssthresh, std::max(flight_size, smss) + smss);
+}
+
+uint64_t tcp_congestion_control::pacing_rate(const tcp_congestion_window& w, std::chrono::microseconds srtt) const noexcept {
+    if (srtt.count() <= 0) {
+        return 0;
+    }
+    double gain = w.cwnd < w.ssthresh ? 2.0 : 1.2;
+    return uint64_t(gain * w.cwnd * 1e6 / srtt.count());
+}
+
+namespace {
+
+class reno_congestion_control final : public tcp_congestion_control {
+public:
+    tcp_congestion_algorithm algorithm() const noexcept override {
+        return tcp_congestion_algorithm::reno;
+    }
+
+    void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        uint32_t smss = s.mss;
+        if (w.cwnd < w.ssthresh) {
+            // In slow start phase
+            w.cwnd += std::min(s.acked_bytes, smss);
+        } else {
+            // In congestion avoidance phase
+            uint32_t round_up = 1;
+            w.cwnd += std::max(round_up, smss * smss / w.cwnd);
+        }
+    }
+
+    void on_loss(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size, clock_type::time_point) override {
+        // RFC5681 Step 3.2
+        w.ssthresh = std::max(flight_size / 2, 2 * uint32_t(mss));
+    }
+
+    void on_timeout(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size, bool first) override {
+        // According to RFC5681, update ssthresh only for the first retransmit
+        if (first) {
+            w.ssthresh = std::max(flight_size / 2, 2 * uint32_t(mss));
+        }
+        // Start the slow start process
+        w.cwnd = mss;
+    }
+};
+
+// RFC 9438. Windows are kept in segments and time in seconds, as in the
+// RFC's formulas, and converted to bytes when the window is updated.
+class cubic_congestion_control final : public tcp_congestion_control {
+    static constexpr double C = 0.4;
+    static constexpr double beta = 0.7;
+    static constexpr double alpha = 3 * (1 - beta) / (1 + beta);
+
+    // Window before the last reduction
+    double _w_max = 0;
+    // Time the window takes to grow back to _origin
+    double _k = 0;
+    double _origin = 0;
+    // Estimate of what Reno would have reached in this epoch
+    double _w_est = 0;
+    // Growth not yet added to the window, in bytes
+    double _pending = 0;
+    std::chrono::microseconds _rtt = 0us;
+    std::optional<clock_type::time_point> _epoch_start;
+
+    void reduce(tcp_congestion_window& w, uint16_t mss) {
+        double cwnd = double(w.cwnd) / mss;
+        // Fast convergence: release bandwidth for new flows when the
+        // window keeps shrinking
+        _w_max = cwnd < _w_max ? cwnd * (1 + beta) / 2 : cwnd;
+        w.ssthresh = std::max(uint32_t(w.cwnd * beta), 2 * uint32_t(mss));
+        _epoch_start.reset();
+        _pending = 0;
+    }
+
+public:
+    tcp_congestion_algorithm algorithm() const noexcept override {
+        return tcp_congestion_algorithm::cubic;
+    }
+
+    void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        if (s.rtt) {
+            _rtt = *s.rtt;
+        }
+        if (s.in_recovery) {
+            return;
+        }
+        if (w.cwnd < w.ssthresh) {
+            w.cwnd += std::min(s.acked_bytes, uint32_t(s.mss));
+            return;
+        }
+
+        double cwnd = double(w.cwnd) / s.mss;
+        if (!_epoch_start) {
+            _epoch_start = s.now;
+            if (cwnd < _w_max) {
+                _k = std::cbrt((_w_max - cwnd) / C);
+                _origin = _w_max;
+            } else {
+                _k = 0;
+                _origin = cwnd;
+            }
+            _w_est = cwnd;
+        }
+
+        // Aim at where the curve will be one RTT from now
+        double t = std::chrono::duration<double>(s.now - *_epoch_start + _rtt).count();
+        double target = _origin + C * std::pow(t - _k, 3);
+        target = std::clamp(target, cwnd, 1.5 * cwnd);
+
+        double acked = double(s.acked_bytes) / s.mss;
+        _w_est += (_w_est < _w_max ? alpha : 1.0) * acked / cwnd;
+        if (_w_est > target) {
+            // Reno-friendly region: grow at least as fast as Reno would
+            _pending += (_w_est - cwnd) * s.mss;
+        } else {
+            _pending += (target - cwnd) / cwnd * acked * s.mss;
+        }
+        auto inc = uint32_t(_pending);
+        w.cwnd += inc;
+        _pending -= inc;
+    }
+
+    void on_loss(tcp_congestion_window& w, uint16_t mss, uint32_t, clock_type::time_point) override {
+        reduce(w, mss);
+    }
+
+    void on_timeout(tcp_congestion_window& w, uint16_t mss, uint32_t, bool first) override {
+        if (first) {
+            reduce(w, mss);
+        }
+        w.cwnd = mss;
+    }
+};
+
+// BBR version 1: the window and pacing rate follow a model of the path,
+// the bottleneck bandwidth (windowed max of delivery rate samples) and
+// the round-trip propagation time (windowed min of RTT samples), rather
+// than reacting to losses.
+class bbr_congestion_control final : public tcp_congestion_control {
+    enum class mode { startup, drain, probe_bw, probe_rtt };
+
+    static constexpr double high_gain = 2.885;  // 2/ln(2)
+    static constexpr double drain_gain = 1 / high_gain;
+    static constexpr double cwnd_gain = 2;
+    static constexpr std::array<double, 8> pacing_gain_cycle = { 1.25, 0.75, 1, 1, 1, 1, 1, 1 };
+    static constexpr unsigned bw_window_rounds = 10;
+    static constexpr auto min_rtt_window = 10s;
+    static constexpr auto probe_rtt_duration = 200ms;
+    static constexpr unsigned min_cwnd_segments = 4;
+    static constexpr double full_bw_growth = 1.25;
+    static constexpr unsigned full_bw_rounds = 3;
+
+    mode _mode = mode::startup;
+    double _pacing_gain = high_gain;
+    double _cwnd_gain = high_gain;
+
+    // Max delivery rate, in bytes per second, of each of the last rounds
+    // that had a sample, and which round that was
+    std::array<double, bw_window_rounds> _bw_samples = {};
+    std::array<uint64_t, bw_window_rounds> _bw_sample_rounds = {};
+    uint64_t _round = 0;
+    uint64_t _next_round_delivered = 0;
+    bool _round_start = false;
+
+    std::optional<std::chrono::microseconds> _min_rtt;
+    clock_type::time_point _min_rtt_stamp;
+
+    double _full_bw = 0;
+    unsigned _full_bw_count = 0;
+    bool _filled_pipe = false;
+
+    unsigned _cycle_index = 0;
+    clock_type::time_point _cycle_stamp;
+
+    std::optional<clock_type::time_point> _probe_rtt_done;
+    // Window to restore after recovery or PROBE_RTT
+    uint32_t _prior_cwnd = 0;
+
+    double btl_bw() const noexcept {
+        return *std::max_element(_bw_samples.begin(), _bw_samples.end());
+    }
+
+    double bdp() const noexcept {
+        return _min_rtt ? btl_bw() * _min_rtt->count() / 1e6 : 0;
+    }
+
+    uint32_t target_cwnd(uint16_t mss, double gain) const noexcept {
+        auto min_cwnd = min_cwnd_segments * uint32_t(mss);
+        if (!_min_rtt || btl_bw() == 0) {
+            return min_cwnd;
+        }
+        // Three segments of allowance for delayed and stretched ACKs
+        return std::max(uint32_t(gain * bdp()) + 3 * uint32_t(mss), min_cwnd);
+    }
+
+    void update_round(const ack_sample& s) {
+        _round_start = false;
+        if (s.prior_delivered >= _next_round_delivered) {
+            _next_round_delivered = s.delivered;
+            _round++;
+            _round_start = true;
+        }
+    }
+
+    void update_bw(const ack_sample& s) {
+        if (s.interval <= clock_type::duration::zero() || s.delivered <= s.prior_delivered) {
+            return;
+        }
+        double rate = (s.delivered - s.prior_delivered) / std::chrono::duration<double>(s.interval).count();
+        // An application-limited sample only tells the path is at least
+        // this fast, so it may raise the estimate but never lower it
+        if (s.app_limited && rate < btl_bw()) {
+            return;
+        }
+        // Samples only age out as newer ones come in, so that rounds
+        // without any don't forget the path's bandwidth
+        for (unsigned i = 0; i < bw_window_rounds; i++) {
+            if (_round - _bw_sample_rounds[i] >= bw_window_rounds) {
+                _bw_samples[i] = 0;
+            }
+        }
+        auto slot = _round % bw_window_rounds;
+        if (_bw_sample_rounds[slot] != _round) {
+            _bw_samples[slot] = 0;
+            _bw_sample_rounds[slot] = _round;
+        }
+        _bw_samples[slot] = std::max(_bw_samples[slot], rate);
+    }
+
+    void check_full_pipe(const ack_sample& s) {
+        if (_filled_pipe || !_round_start || s.app_limited) {
+            return;
+        }
+        auto bw = btl_bw();
+        if (bw >= _full_bw * full_bw_growth) {
+            _full_bw = bw;
+            _full_bw_count = 0;
+            return;
+        }
+        if (++_full_bw_count >= full_bw_rounds) {
+            _filled_pipe = true;
+        }
+    }
+
+    void enter_probe_bw(clock_type::time_point now) {
+        _mode = mode::probe_bw;
+        _cwnd_gain = cwnd_gain;
+        // Start past the probing and draining phases, as Linux does for
+        // all but an unlucky few
+        _cycle_index = 2;
+        _pacing_gain = pacing_gain_cycle[_cycle_index];
+        _cycle_stamp = now;
+    }
+
+    void update_cycle(const ack_sample& s) {
+        if (_mode != mode::probe_bw || !_min_rtt) {
+            return;
+        }
+        bool full_length = s.now - _cycle_stamp > *_min_rtt;
+        bool advance = full_length;
+        if (_pacing_gain < 1) {
+            // Done draining the queue built while probing
+            advance = full_length || s.in_flight <= bdp();
+        }
+        if (advance) {
+            _cycle_index = (_cycle_index + 1) % pacing_gain_cycle.size();
+            _pacing_gain = pacing_gain_cycle[_cycle_index];
+            _cycle_stamp = s.now;
+        }
+    }
+
+    void update_mode(tcp_congestion_window& w, const ack_sample& s) {
+        if (_mode == mode::startup && _filled_pipe) {
+            _mode = mode::drain;
+            _pacing_gain = drain_gain;
+            _cwnd_gain = high_gain;
+        }
+        if (_mode == mode::drain && s.in_flight <= target_cwnd(s.mss, 1)) {
+            enter_probe_bw(s.now);
+        }
+
+        bool min_rtt_expired = _min_rtt && s.now > _min_rtt_stamp + min_rtt_window;
+        if (s.rtt && (!_min_rtt || *s.rtt <= *_min_rtt || min_rtt_expired)) {
+            _min_rtt = *s.rtt;
+            _min_rtt_stamp = s.now;
+        }
+        if (min_rtt_expired && _mode != mode::probe_rtt) {
+            // Drain the queue to measure the propagation delay again
+            _mode = mode::probe_rtt;
+            _pacing_gain = 1;
+            _cwnd_gain = 1;
+            _prior_cwnd = std::max(_prior_cwnd, w.cwnd);
+            _probe_rtt_done = s.now + probe_rtt_duration;
+        }
+        if (_mode == mode::probe_rtt && s.now >= *_probe_rtt_done) {
+            _min_rtt_stamp = s.now;
+            _probe_rtt_done.reset();
+            w.cwnd = std::max(w.cwnd, _prior_cwnd);
+            _prior_cwnd = 0;
+            if (_filled_pipe) {
+                enter_probe_bw(s.now);
+            } else {
+                _mode = mode::startup;
+                _pacing_gain = high_gain;
+                _cwnd_gain = high_gain;
+            }
+        }
+    }
+
+public:
+    tcp_congestion_algorithm algorithm() const noexcept override {
+        return tcp_congestion_algorithm::bbr;
+    }
+
+    void on_ack(tcp_congestion_window& w, const ack_sample& s) override {
+        update_round(s);
+        update_bw(s);
+        check_full_pipe(s);
+        update_cycle(s);
+        update_mode(w, s);
+
+        if (s.in_recovery) {
+            // The tcb conserves packets during recovery
+            return;
+        }
+        auto min_cwnd = min_cwnd_segments * uint32_t(s.mss);
+        if (_mode == mode::probe_rtt) {
+            w.cwnd = std::min(w.cwnd, min_cwnd);
+            return;
+        }
+        auto target = target_cwnd(s.mss, _cwnd_gain);
+        if (_filled_pipe) {
+            w.cwnd = std::min(w.cwnd + s.acked_bytes, target);
+        } else if (w.cwnd < target || btl_bw() == 0) {
+            w.cwnd += s.acked_bytes;
+        }
+        w.cwnd = std::max(w.cwnd, min_cwnd);
+    }
+
+    void on_loss(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size, clock_type::time_point) override {
+        _prior_cwnd = std::max(_prior_cwnd, w.cwnd);
+        // Packet conservation: the tcb adds 3 segments for the ones that
+        // left the network and triggered the duplicate ACKs
+        auto three = 3 * uint32_t(mss);
+        w.ssthresh = std::max(flight_size > three ? flight_size - three : 0, 2 * uint32_t(mss));
+    }
+
+    void on_recovery_exit(tcp_congestion_window& w, uint16_t mss, uint32_t flight_size) noexcept override {
+        w.cwnd = std::max({_prior_cwnd, target_cwnd(mss, _cwnd_gain), flight_size + mss});
+        _prior_cwnd = 0;
+    }
+
+    void on_timeout(tcp_congestion_window& w, uint16_t mss, uint32_t, bool) override {
+        // The window regrows by the delivered data, up to the model's
+        w.cwnd = mss;
+    }
+
+    uint64_t pacing_rate(const tcp_congestion_window& w, std::chrono::microseconds srtt) const noexcept override {
+        auto bw = btl_bw();
+        if (bw == 0) {
+            // No delivery rate sample yet; pace the initial window over an RTT
+            return srtt.count() > 0 ? uint64_t(high_gain * w.cwnd * 1e6 / srtt.count()) : 0;
+        }
+        return uint64_t(_pacing_gain * bw);
+    }
+
+    bool needs_pacing() const noexcept override {
+        return true;
+    }
+};
+
+}
+
+std::unique_ptr<tcp_congestion_control> make_tcp_congestion_control(tcp_congestion_algorithm algo) {
+    switch (algo) {
+    case tcp_congestion_algorithm::reno:
+        return std::make_unique<reno_congestion_control>();
+    case tcp_congestion_algorithm::cubic:
+        return std::make_unique<cubic_congestion_control>();
+    case tcp_congestion_algorithm::bbr:
+        return std::make_unique<bbr_congestion_control>();
+    }
+    throw std::invalid_argument("unknown TCP congestion control algorithm");
+}
+
+}
+
+}
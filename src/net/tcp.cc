@@ -34,6 +34,7 @@ namespace net {
 void tcp_option::parse(uint8_t* beg1, uint8_t* end1) {
     const char* beg = reinterpret_cast<const char*>(beg1);
     const char* end = reinterpret_cast<const char*>(end1);
+    _nr_remote_sack_blocks = 0;
     while (beg < end) {
         auto kind = option_kind(*beg);
         if (kind != option_kind::nop && kind != option_kind::eol) {
@@ -60,6 +61,13 @@ void tcp_option::parse(uint8_t* beg1, uint8_t* end1) {
             _sack_received = true;
             beg += option_len::sack;
             break;
+        case option_kind::sack_blocks:
+            if (uint8_t(beg[1]) < sack_blocks::len(1)) {
+                return;
+            }
+            _nr_remote_sack_blocks = sack_blocks::read(beg, _remote_sack_blocks.data());
+            beg += uint8_t(beg[1]);
+            break;
         case option_kind::nop:
             beg += option_len::nop;
             break;
@@ -100,6 +108,16 @@ uint8_t tcp_option::fill(void* h, const tcp_hdr* th, uint8_t options_size) {
             off += win_scale.len;
             size += win_scale.len;
         }
+        if (_sack_received || !ack_on) {
+            auto sack = tcp_option::sack();
+            sack.write(off);
+            off += sack.len;
+            size += sack.len;
+        }
+    } else if (_nr_local_sack_blocks) {
+        sack_blocks::write(off, _local_sack_blocks.data(), _nr_local_sack_blocks);
+        off += sack_blocks::len(_nr_local_sack_blocks);
+        size += sack_blocks::len(_nr_local_sack_blocks);
     }
     if (size > 0) {
         // Insert NOP option
@@ -128,6 +146,11 @@ uint8_t tcp_option::get_size(bool syn_on, bool ack_on) {
         if (_win_scale_received || !ack_on) {
             size += option_len::win_scale;
         }
+        if (_sack_received || !ack_on) {
+            size += option_len::sack;
+        }
+    } else if (_nr_local_sack_blocks) {
+        size += sack_blocks::len(_nr_local_sack_blocks);
     }
     if (size > 0) {
         size += option_len::eol;
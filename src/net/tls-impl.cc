@@ -21,14 +21,17 @@
 
 #include <chrono>
 #include <filesystem>
+#include <netinet/tcp.h>
 #include <sys/stat.h>
 
 #include <boost/range/adaptor/map.hpp>
 #include <boost/range/algorithm/copy.hpp>
 
+#include <seastar/core/byteorder.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/fsnotify.hh>
 #include <seastar/core/loop.hh>
+#include <seastar/core/metrics.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/thread.hh>
 #include <seastar/core/timer.hh>
@@ -207,6 +210,10 @@ void tls::credentials_builder::set_maximum_tls_version(tls_version v) {
     _max_tls_version = v;
 }
 
+void tls::credentials_builder::enable_kernel_tls() {
+    _enable_kernel_tls = true;
+}
+
 void tls::credentials_builder::enable_tls_renegotiation() {
     _enable_tls_renegotiation = true;
 }
@@ -284,6 +291,10 @@ void tls::certificate_credentials::enable_tls_renegotiation() {
     _impl->enable_tls_renegotiation();
 }
 
+void tls::certificate_credentials::enable_kernel_tls() {
+    _impl->_enable_kernel_tls = true;
+}
+
 tls::server_credentials::server_credentials()
 {}
 
@@ -390,6 +401,9 @@ void tls::credentials_builder::apply_to(certificate_credentials& creds) const {
     if (_enable_tls_renegotiation) {
         creds.enable_tls_renegotiation();
     }
+    if (_enable_kernel_tls) {
+        creds.enable_kernel_tls();
+    }
 
     creds._impl->set_client_auth(_client_auth);
     // Note: this causes server session key rotation on cert reload
@@ -701,6 +715,123 @@ future<shared_ptr<tls::server_credentials>> tls::credentials_builder::build_relo
     }, tolerance);
 }
 
+namespace {
+
+struct ktls_stats {
+    uint64_t tx_offloaded = 0;
+    uint64_t tx_fallback = 0;
+    metrics::metric_groups metrics;
+
+    ktls_stats() {
+        namespace sm = seastar::metrics;
+        metrics.add_group("tls", {
+            sm::make_counter("ktls_tx_sessions", tx_offloaded,
+                    sm::description("Number of TLS sessions whose record encryption was offloaded to the kernel")),
+            sm::make_counter("ktls_tx_fallbacks", tx_fallback,
+                    sm::description("Number of TLS sessions that requested kernel TLS but kept encrypting in userspace")),
+        });
+    }
+};
+
+// Created on first use, so that shards which never request kernel TLS do
+// not export the metrics.
+ktls_stats& get_ktls_stats() {
+    static thread_local ktls_stats stats;
+    return stats;
+}
+
+template <typename Info>
+bool fill_crypto_info(Info& info, std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint64_t seq) noexcept {
+    if (key.size() != sizeof(info.key) || nonce.size() != sizeof(info.salt) + sizeof(info.iv)) {
+        return false;
+    }
+    std::copy(key.begin(), key.end(), info.key);
+    std::copy_n(nonce.begin(), sizeof(info.salt), info.salt);
+    std::copy_n(nonce.begin() + sizeof(info.salt), sizeof(info.iv), info.iv);
+    write_be<uint64_t>(reinterpret_cast<char*>(info.rec_seq), seq);
+    return true;
+}
+
+template <>
+bool fill_crypto_info(::tls12_crypto_info_chacha20_poly1305& info, std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint64_t seq) noexcept {
+    if (key.size() != sizeof(info.key) || nonce.size() != sizeof(info.iv)) {
+        return false;
+    }
+    std::copy(key.begin(), key.end(), info.key);
+    std::copy(nonce.begin(), nonce.end(), info.iv);
+    write_be<uint64_t>(reinterpret_cast<char*>(info.rec_seq), seq);
+    return true;
+}
+
+}
+
+size_t tls::ktls::crypto_info_size(const ::tls_crypto_info& info) noexcept {
+    if (info.version != TLS_1_2_VERSION && info.version != TLS_1_3_VERSION) {
+        return 0;
+    }
+    switch (info.cipher_type) {
+    case TLS_CIPHER_AES_GCM_128:
+        return sizeof(::tls12_crypto_info_aes_gcm_128);
+    case TLS_CIPHER_AES_GCM_256:
+        return sizeof(::tls12_crypto_info_aes_gcm_256);
+    case TLS_CIPHER_AES_CCM_128:
+        return sizeof(::tls12_crypto_info_aes_ccm_128);
+    case TLS_CIPHER_CHACHA20_POLY1305:
+        return sizeof(::tls12_crypto_info_chacha20_poly1305);
+    default:
+        return 0;
+    }
+}
+
+std::optional<tls::ktls::crypto_info> tls::ktls::make_crypto_info(uint16_t version, uint16_t cipher_type,
+        std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint64_t seq) noexcept {
+    crypto_info ci = {};
+    ci.info.version = version;
+    ci.info.cipher_type = cipher_type;
+    bool ok = false;
+    switch (cipher_type) {
+    case TLS_CIPHER_AES_GCM_128:
+        ok = fill_crypto_info(ci.aes_gcm_128, key, nonce, seq);
+        break;
+    case TLS_CIPHER_AES_GCM_256:
+        ok = fill_crypto_info(ci.aes_gcm_256, key, nonce, seq);
+        break;
+    case TLS_CIPHER_AES_CCM_128:
+        ok = fill_crypto_info(ci.aes_ccm_128, key, nonce, seq);
+        break;
+    case TLS_CIPHER_CHACHA20_POLY1305:
+        ok = fill_crypto_info(ci.chacha20_poly1305, key, nonce, seq);
+        break;
+    default:
+        break;
+    }
+    if (!ok || crypto_info_size(ci.info) == 0) {
+        return std::nullopt;
+    }
+    return ci;
+}
+
+void tls::ktls::attach(net::connected_socket_impl& sock) {
+    static constexpr char ulp[] = "tls";
+    sock.set_sockopt(SOL_TCP, TCP_ULP, ulp, sizeof(ulp));
+}
+
+void tls::ktls::install_tx(net::connected_socket_impl& sock, const ::tls_crypto_info& info) {
+    auto size = crypto_info_size(info);
+    if (size == 0) {
+        throw std::system_error(EINVAL, std::system_category(), "cipher not supported by kernel TLS");
+    }
+    sock.set_sockopt(SOL_TLS, TLS_TX, &info, size);
+}
+
+void tls::ktls::note_tx_offloaded() noexcept {
+    ++get_ktls_stats().tx_offloaded;
+}
+
+void tls::ktls::note_tx_fallback() noexcept {
+    ++get_ktls_stats().tx_fallback;
+}
+
 const std::error_category& tls::error_category() {
     return internal::crypto::provider().get_tls_backend().error_category();
 }
@@ -22,10 +22,13 @@
 
 #include <any>
 #include <memory>
+#include <optional>
 #include <span>
 #include <string_view>
 #include <unordered_set>
 
+#include <linux/tls.h>
+
 #include <boost/range/iterator_range.hpp>
 
 #include <seastar/core/future.hh>
@@ -162,8 +165,52 @@ class credentials_impl {
 
     // Flag for lazy system trust loading.
     bool _load_system_trust = false;
+    // Offload record encryption to the kernel once handshake is done.
+    bool _enable_kernel_tls = false;
 };
 
+/// Kernel TLS (kTLS) transmit offload, shared by both backends.
+///
+/// Once the handshake is done, the transmit keys are handed to the kernel
+/// and the session writes plaintext to the socket from then on. Only the
+/// transmit direction is offloaded; received records are still decrypted
+/// in userspace.
+namespace ktls {
+
+/// TLS record content type of alerts, e.g. close_notify.
+constexpr uint8_t record_type_alert = 21;
+
+/// Any of the kernel's per-cipher crypto info layouts.
+union crypto_info {
+    ::tls_crypto_info info;
+    ::tls12_crypto_info_aes_gcm_128 aes_gcm_128;
+    ::tls12_crypto_info_aes_gcm_256 aes_gcm_256;
+    ::tls12_crypto_info_aes_ccm_128 aes_ccm_128;
+    ::tls12_crypto_info_chacha20_poly1305 chacha20_poly1305;
+};
+
+/// Size of the kernel structure for the cipher in \c info, or 0 if the
+/// cipher cannot be offloaded.
+size_t crypto_info_size(const ::tls_crypto_info& info) noexcept;
+
+/// Builds crypto info from raw key material. \c nonce is the full
+/// per-record nonce base, i.e. the salt followed by the IV. Returns
+/// std::nullopt if the cipher or the material sizes cannot be offloaded.
+std::optional<crypto_info> make_crypto_info(uint16_t version, uint16_t cipher_type,
+        std::span<const uint8_t> key, std::span<const uint8_t> nonce, uint64_t seq) noexcept;
+
+/// Attaches the kernel "tls" upper layer protocol to the socket. Throws if
+/// the socket or the kernel does not support it.
+void attach(net::connected_socket_impl& sock);
+
+/// Hands the transmit keys in \c info to the kernel. Throws on failure.
+void install_tx(net::connected_socket_impl& sock, const ::tls_crypto_info& info);
+
+void note_tx_offloaded() noexcept;
+void note_tx_fallback() noexcept;
+
+} // namespace ktls
+
 /// Abstract interface for a TLS session.
 ///
 /// This is the primary abstraction that TLS backends (GnuTLS, OpenSSL)
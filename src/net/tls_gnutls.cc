@@ -45,6 +45,7 @@
 #include <fmt/core.h>
 #include <fmt/ostream.h>
 
+#include <seastar/core/byteorder.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/reactor.hh>
 #include <seastar/core/seastar.hh>
@@ -648,7 +649,9 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
             }
             _connected = true;
             // make sure we reset output_pending
-            return wait_for_output();
+            return wait_for_output().then([this] {
+                maybe_enable_ktls_tx();
+            });
         } catch (...) {
             return make_exception_future<>(std::current_exception());
         }
@@ -683,9 +686,89 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
         if (_type == type::CLIENT) {
             throw std::system_error(GNUTLS_E_INVALID_REQUEST, local_error_category(), "re-handshake only applicable for server socket");
         }
+        if (_ktls_tx) {
+            throw std::system_error(ENOTSUP, std::system_category(), "re-handshake not supported with kernel TLS offload");
+        }
         return do_handshake_sync(&session::do_force_rehandshake);
     }
 
+    // Write-side key material in the form the kernel wants it, if the
+    // negotiated protocol and cipher can be offloaded.
+    std::optional<tls::ktls::crypto_info> ktls_tx_crypto_info() {
+        uint16_t version;
+        switch (gnutls_protocol_get_version(*this)) {
+        case GNUTLS_TLS1_2:
+            version = TLS_1_2_VERSION;
+            break;
+        case GNUTLS_TLS1_3:
+            version = TLS_1_3_VERSION;
+            break;
+        default:
+            return std::nullopt;
+        }
+        uint16_t cipher_type;
+        switch (gnutls_cipher_get(*this)) {
+        case GNUTLS_CIPHER_AES_128_GCM:
+            cipher_type = TLS_CIPHER_AES_GCM_128;
+            break;
+        case GNUTLS_CIPHER_AES_256_GCM:
+            cipher_type = TLS_CIPHER_AES_GCM_256;
+            break;
+        case GNUTLS_CIPHER_AES_128_CCM:
+            cipher_type = TLS_CIPHER_AES_CCM_128;
+            break;
+        case GNUTLS_CIPHER_CHACHA20_POLY1305:
+            cipher_type = TLS_CIPHER_CHACHA20_POLY1305;
+            break;
+        default:
+            return std::nullopt;
+        }
+        gnutls_datum_t mac_key, iv, cipher_key;
+        unsigned char seq_number[8];
+        if (gnutls_record_get_state(*this, 0, &mac_key, &iv, &cipher_key, seq_number) < 0) {
+            return std::nullopt;
+        }
+        auto seq = read_be<uint64_t>(reinterpret_cast<const char*>(seq_number));
+        std::array<uint8_t, 12> nonce;
+        if (iv.size == nonce.size()) {
+            std::copy_n(iv.data, iv.size, nonce.begin());
+        } else if (iv.size == 4 && version == TLS_1_2_VERSION) {
+            // TLS 1.2 AEAD: only the implicit part of the nonce is kept by
+            // gnutls; the explicit part is sent with each record, and the
+            // sequence number is as good a start as any.
+            std::copy_n(iv.data, iv.size, nonce.begin());
+            std::copy_n(seq_number, sizeof(seq_number), nonce.begin() + iv.size);
+        } else {
+            return std::nullopt;
+        }
+        return tls::ktls::make_crypto_info(version, cipher_type,
+                std::span<const uint8_t>(cipher_key.data, cipher_key.size), nonce, seq);
+    }
+
+    // Switches the transmit direction over to kernel TLS, if requested.
+    // Must be called with no output pending, since anything written to
+    // the socket afterwards is encrypted by the kernel.
+    void maybe_enable_ktls_tx() {
+        if (!_creds->_enable_kernel_tls || _ktls_tx) {
+            return;
+        }
+        auto info = ktls_tx_crypto_info();
+        if (!info) {
+            tls::ktls::note_tx_fallback();
+            return;
+        }
+        try {
+            tls::ktls::attach(*_sock);
+            tls::ktls::install_tx(*_sock, info->info);
+        } catch (...) {
+            // an attached but unconfigured ULP passes data through as is
+            tls::ktls::note_tx_fallback();
+            return;
+        }
+        _ktls_tx = true;
+        tls::ktls::note_tx_offloaded();
+    }
+
     future<> handshake() {
         // maybe load system certificates before handshake, in case we
         // have not done so yet...
@@ -937,6 +1020,19 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
             });
         }
 
+        if (_ktls_tx) {
+            // The kernel splits plaintext into records itself.
+            std::vector<temporary_buffer<char>> p;
+            p.reserve(bufs.size());
+            p.insert(p.end(), std::make_move_iterator(bufs.begin()), std::make_move_iterator(bufs.end()));
+            return with_semaphore(_out_sem, 1, [this, p = std::move(p)] () mutable {
+                return _out.put(std::move(p)).handle_exception([this](auto ep) {
+                    _error = ep;
+                    return make_exception_future(ep);
+                });
+            });
+        }
+
         if (bufs.size() == 1) {
             return do_put(std::move(bufs.front()));
         }
@@ -982,6 +1078,15 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
         return n;
     }
     ssize_t vec_push(const giovec_t * iov, int iovcnt) {
+        if (_ktls_tx) {
+            // The kernel owns the write keys and sequence number now, so a
+            // record encrypted here would be garbage to the peer (e.g. a
+            // TLS 1.3 key update response).
+            gnutls_transport_set_errno(*this, EIO);
+            _output_pending = make_exception_future<>(std::system_error(ENOTSUP, std::system_category(),
+                    "cannot send gnutls generated records with kernel TLS offload"));
+            return -1;
+        }
         if (!_output_pending.available()) {
             gnutls_transport_set_errno(*this, EAGAIN);
             return -1;
@@ -1045,6 +1150,15 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
         if (_error || !_connected) {
             return make_ready_future();
         }
+        if (_ktls_tx) {
+            temporary_buffer<char> alert(2);
+            alert.get_write()[0] = GNUTLS_AL_WARNING;
+            alert.get_write()[1] = GNUTLS_A_CLOSE_NOTIFY;
+            return _sock->send_tls_control_record(tls::ktls::record_type_alert, std::move(alert)).handle_exception([this](auto ep) {
+                _error = ep;
+                return make_exception_future(ep);
+            });
+        }
         auto res = gnutls_bye(*this, GNUTLS_SHUT_WR);
         if (res < 0) {
             switch (res) {
@@ -1355,6 +1469,8 @@ class session : public enable_shared_from_this<session>, public tls::session_imp
     bool _eof = false;
     bool _shutdown = false;
     bool _connected = false;
+    // transmit records are encrypted by the kernel
+    bool _ktls_tx = false;
     std::exception_ptr _error;
 
     future<> _output_pending;
@@ -1117,6 +1117,9 @@ class openssl_session : public enable_shared_from_this<openssl_session>, public
                             || _creds->get_client_auth() != client_auth::NONE) {
                             verify();
                         }
+                        if (_creds->_enable_kernel_tls && !_ktls_tx) {
+                            tls::ktls::note_tx_fallback();
+                        }
                         return wait_for_output();
                     }
                 } catch(...) {
@@ -1406,6 +1409,9 @@ class openssl_session : public enable_shared_from_this<openssl_session>, public
         if (_type == session_type::CLIENT) {
             throw std::runtime_error("re-handshake only applicable for server socket");
         }
+        if (_ktls_tx) {
+            throw std::system_error(ENOTSUP, std::system_category(), "key update not supported with kernel TLS offload");
+        }
         // TLS 1.3 does not support renegotiation. Use key update instead,
         // which rotates the session keys. This is the OpenSSL equivalent
         // of GnuTLS's gnutls_rehandshake for TLS 1.3.
@@ -1417,6 +1423,30 @@ class openssl_session : public enable_shared_from_this<openssl_session>, public
         });
     }
 
+    // Called by OpenSSL through the write BIO once the transmit keys of the
+    // established session are known. OpenSSL writes plaintext to the BIO
+    // from then on, so the key install is queued behind the handshake
+    // output still in flight, and failing it fails the session.
+    bool set_ktls_tx(const ::tls_crypto_info& info) {
+        if (_ktls_tx || tls::ktls::crypto_info_size(info) == 0) {
+            return false;
+        }
+        try {
+            tls::ktls::attach(*_sock);
+        } catch (...) {
+            tls_log.debug("{} kernel TLS not available: {}", *this, std::current_exception());
+            return false;
+        }
+        tls::ktls::crypto_info ci = {};
+        std::memcpy(&ci, &info, tls::ktls::crypto_info_size(info));
+        _output_pending = std::move(_output_pending).then([this, ci] {
+            tls::ktls::install_tx(*_sock, ci.info);
+            tls::ktls::note_tx_offloaded();
+        });
+        _ktls_tx = true;
+        return true;
+    }
+
     // This function is called to kick off the handshake.  It will obtain
     // locks on the _in_sem and _out_sem semaphores and start the handshake.
     future<> handshake() {
@@ -1849,6 +1879,12 @@ class openssl_session : public enable_shared_from_this<openssl_session>, public
 #ifdef SSL_OP_NO_RX_CERTIFICATE_COMPRESSION
         SSL_CTX_set_options(ssl_ctx.get(), SSL_OP_NO_RX_CERTIFICATE_COMPRESSION);
 #endif
+#if defined(SSL_OP_ENABLE_KTLS) && !defined(OPENSSL_NO_KTLS)
+        // OpenSSL hands the keys to our BIO, see set_ktls_tx()
+        if (_creds->_enable_kernel_tls) {
+            SSL_CTX_set_options(ssl_ctx.get(), SSL_OP_ENABLE_KTLS);
+        }
+#endif
 
         const auto& ck_pair = _creds->get_certkey_pair();
         if (type == session_type::SERVER) {
@@ -2060,6 +2096,10 @@ class openssl_session : public enable_shared_from_this<openssl_session>, public
     session_type _type;
     bool _eof = false;
     bool _shutdown = false;
+    // transmit records are encrypted by the kernel
+    bool _ktls_tx = false;
+    // record type of the next BIO write, if it is not application data
+    std::optional<uint8_t> _ktls_record_type;
 
     friend int bio_write_ex(BIO* b, const char * data, size_t dlen, size_t * written);
     friend int bio_read_ex(BIO* b, char * data, size_t dlen, size_t *readbytes);
@@ -2133,6 +2173,14 @@ tls::openssl_session* unwrap_bio_ptr(BIO * b) {
     return unwrap_bio_ptr(BIO_get_data(b));
 }
 
+#ifndef OPENSSL_NO_KTLS
+// Controls OpenSSL only sends to its own socket BIO, and so does not
+// export; see include/internal/bio.h in the OpenSSL tree.
+constexpr int BIO_CTRL_SET_KTLS = 72;
+constexpr int BIO_CTRL_SET_KTLS_TX_SEND_CTRL_MSG = 74;
+constexpr int BIO_CTRL_CLEAR_KTLS_TX_CTRL_MSG = 75;
+#endif
+
 /// The 'ioctl' for BIO
 long bio_ctrl(BIO * b, int ctrl, long num, void * data) {
     if (BIO_get_init(b) <= 0 && ctrl != BIO_C_SET_POINTER) {
@@ -2165,6 +2213,21 @@ long bio_ctrl(BIO * b, int ctrl, long num, void * data) {
         return static_cast<long>(session->_input.size());
     case BIO_CTRL_WPENDING:
         return session->_output_pending.available() ? 0 : 1;
+#ifndef OPENSSL_NO_KTLS
+    case BIO_CTRL_SET_KTLS:
+        // only the transmit direction (num != 0) is offloaded
+        return num && session->set_ktls_tx(*static_cast<const ::tls_crypto_info*>(data)) ? 1 : 0;
+    case BIO_CTRL_GET_KTLS_SEND:
+        return session->_ktls_tx ? 1 : 0;
+    case BIO_CTRL_GET_KTLS_RECV:
+        return 0;
+    case BIO_CTRL_SET_KTLS_TX_SEND_CTRL_MSG:
+        session->_ktls_record_type = static_cast<uint8_t>(num);
+        return 0;
+    case BIO_CTRL_CLEAR_KTLS_TX_CTRL_MSG:
+        session->_ktls_record_type.reset();
+        return 0;
+#endif
     default:
         return 0;
     }
@@ -2203,7 +2266,16 @@ int bio_write_ex(BIO* b, const char * data, size_t dlen, size_t * written) {
             auto buf = temporary_buffer<char>(dlen);
             std::memcpy(buf.get_write(), data, dlen);
             n = buf.size();
-            session->_output_pending = session->_out.put(std::move(buf));
+            if (session->_ktls_record_type) {
+                // alerts and post-handshake messages must be marked as such
+                // for the kernel to frame them
+                // libssl never sends BIO_CTRL_CLEAR_KTLS_TX_CTRL_MSG, OpenSSL's
+                // socket BIO clears the flag on write; do the same
+                session->_output_pending = session->_sock->send_tls_control_record(*session->_ktls_record_type, std::move(buf));
+                session->_ktls_record_type.reset();
+            } else {
+                session->_output_pending = session->_out.put(std::move(buf));
+            }
             tls_log.trace("{} bio_write_ex: Appended {} bytes to output pending", *session, n);
         }
 
@@ -99,6 +99,8 @@ class native_channel : public datagram_channel_impl {
         return _state->_queue.pop_eventually();
     }
 
+    using datagram_channel_impl::send;
+
     virtual future<> send(const socket_address& dst, const char* msg) override {
         temporary_buffer<char> buf(const_cast<char *>(msg), strlen(msg), deleter());
         return send(dst, std::span(&buf, 1));
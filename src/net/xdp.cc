@@ -0,0 +1,673 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Network device over AF_XDP sockets. An XDP program attached to the
+// interface redirects each received frame to the socket bound to its
+// hardware queue, with one socket per queue, owned by the shard of the
+// same number. Frames live in packet memory (UMEM) the socket shares with
+// the kernel, which in zero-copy mode is also where the driver DMAs them.
+
+#include <algorithm>
+#include <atomic>
+#include <bit>
+#include <cstddef>
+#include <cstring>
+#include <iterator>
+#include <memory>
+#include <optional>
+#include <stdexcept>
+#include <vector>
+#include <net/if.h>
+#include <sys/ioctl.h>
+#include <sys/mman.h>
+#include <sys/socket.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#include <linux/bpf.h>
+#include <linux/ethtool.h>
+#include <linux/if_link.h>
+#include <linux/if_xdp.h>
+#include <linux/sockios.h>
+
+#include <seastar/net/xdp.hh>
+#include <seastar/core/posix.hh>
+#include <seastar/core/internal/poll.hh>
+#include <seastar/core/metrics.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/net/native-stack.hh>
+#include <seastar/util/assert.hh>
+#include <seastar/util/log.hh>
+
+namespace seastar {
+
+using namespace net;
+
+namespace xdp {
+
+static logger xdp_log("xdp");
+
+static uint64_t to_u64(const void* p) {
+    return reinterpret_cast<uintptr_t>(p);
+}
+
+static int bpf(int cmd, bpf_attr& attr, const char* what) {
+    int r = ::syscall(__NR_bpf, cmd, &attr, sizeof(attr));
+    throw_system_error_on(r < 0, what);
+    return r;
+}
+
+// Map from a receive queue to the socket serving it
+static file_desc create_socket_map(uint16_t nr_queues) {
+    bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.map_type = BPF_MAP_TYPE_XSKMAP;
+    attr.key_size = sizeof(uint32_t);
+    attr.value_size = sizeof(uint32_t);
+    attr.max_entries = nr_queues;
+    return file_desc::from_fd(bpf(BPF_MAP_CREATE, attr, "bpf(BPF_MAP_CREATE)"));
+}
+
+// The program run on each received frame; it hands the frame to the
+// socket of its queue, or to the kernel if the queue has none:
+//
+//     r2 = ctx->rx_queue_index
+//     r1 = map
+//     r3 = XDP_PASS
+//     return bpf_redirect_map(r1, r2, r3)
+static file_desc load_redirect_program(const file_desc& map) {
+    bpf_insn insns[] = {
+        { .code = BPF_LDX | BPF_W | BPF_MEM, .dst_reg = BPF_REG_2, .src_reg = BPF_REG_1,
+          .off = int16_t(offsetof(xdp_md, rx_queue_index)), .imm = 0 },
+        { .code = BPF_LD | BPF_DW | BPF_IMM, .dst_reg = BPF_REG_1, .src_reg = BPF_PSEUDO_MAP_FD, .off = 0, .imm = map.get() },
+        { .code = 0, .dst_reg = 0, .src_reg = 0, .off = 0, .imm = 0 },
+        { .code = BPF_ALU64 | BPF_MOV | BPF_K, .dst_reg = BPF_REG_3, .src_reg = 0, .off = 0, .imm = XDP_PASS },
+        { .code = BPF_JMP | BPF_CALL, .dst_reg = 0, .src_reg = 0, .off = 0, .imm = BPF_FUNC_redirect_map },
+        { .code = BPF_JMP | BPF_EXIT, .dst_reg = 0, .src_reg = 0, .off = 0, .imm = 0 },
+    };
+    static const char license[] = "GPL";
+    bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.prog_type = BPF_PROG_TYPE_XDP;
+    attr.expected_attach_type = BPF_XDP;
+    attr.insns = to_u64(insns);
+    attr.insn_cnt = std::size(insns);
+    attr.license = to_u64(license);
+    return file_desc::from_fd(bpf(BPF_PROG_LOAD, attr, "bpf(BPF_PROG_LOAD)"));
+}
+
+// Attaches the program for as long as the returned link is open
+static file_desc attach_program(const file_desc& prog, unsigned ifindex, uint32_t flags) {
+    bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.link_create.prog_fd = prog.get();
+    attr.link_create.target_ifindex = ifindex;
+    attr.link_create.attach_type = BPF_XDP;
+    attr.link_create.flags = flags;
+    return file_desc::from_fd(bpf(BPF_LINK_CREATE, attr, "bpf(BPF_LINK_CREATE)"));
+}
+
+static ifreq interface_request(const sstring& ifname) {
+    if (ifname.size() + 1 > IFNAMSIZ) {
+        throw std::runtime_error(format("interface name {} is too long", ifname));
+    }
+    ifreq ifr = {};
+    std::strcpy(ifr.ifr_name, ifname.c_str());
+    return ifr;
+}
+
+static bool ethtool(file_desc& s, const sstring& ifname, void* cmd) {
+    auto ifr = interface_request(ifname);
+    ifr.ifr_data = reinterpret_cast<char*>(cmd);
+    return ::ioctl(s.get(), SIOCETHTOOL, &ifr) == 0;
+}
+
+static uint32_t parse_bind_mode(const std::string& mode) {
+    if (mode == "auto") {
+        return 0;
+    } else if (mode == "zero-copy") {
+        return XDP_ZEROCOPY;
+    } else if (mode == "copy") {
+        return XDP_COPY;
+    }
+    throw std::runtime_error(format("invalid AF_XDP bind mode {}", mode));
+}
+
+static uint32_t parse_attach_mode(const std::string& mode) {
+    if (mode == "auto") {
+        return 0;
+    } else if (mode == "native") {
+        return XDP_FLAGS_DRV_MODE;
+    } else if (mode == "generic") {
+        return XDP_FLAGS_SKB_MODE;
+    }
+    throw std::runtime_error(format("invalid XDP attach mode {}", mode));
+}
+
+class device : public net::device {
+    sstring _ifname;
+    unsigned _ifindex;
+    uint16_t _num_queues;
+    ethernet_address _hw_address;
+    net::hw_features _hw_features;
+    rss_key_type _rss_key = default_rsskey_40bytes;
+    std::vector<uint8_t> _redir_table;
+    // The interface's RSS configuration before configure_rss() changed it,
+    // as an ETHTOOL_SRSSH command, and its hash fields per flow type
+    std::vector<uint32_t> _saved_rss;
+    std::vector<std::pair<uint32_t, uint64_t>> _saved_hash_fields;
+    file_desc _socket_map;
+    file_desc _prog;
+    file_desc _link;
+private:
+    void configure_rss(file_desc& s);
+    void restore_rss() noexcept;
+public:
+    explicit device(const net::xdp_options& opts);
+    ~device();
+    ethernet_address hw_address() override {
+        return _hw_address;
+    }
+    net::hw_features hw_features() override {
+        return _hw_features;
+    }
+    rss_key_type rss_key() const override {
+        return _rss_key;
+    }
+    uint16_t hw_queues_count() override {
+        return _num_queues;
+    }
+    unsigned hash2qid(uint32_t hash) override {
+        return _redir_table[hash & (_redir_table.size() - 1)];
+    }
+    unsigned ifindex() const noexcept {
+        return _ifindex;
+    }
+    std::unique_ptr<net::qp> init_local_queue(const program_options::option_group& opts, uint16_t qid) override;
+    // Has the XDP program redirect the queue's frames to the socket
+    void register_socket(uint16_t qid, const file_desc& fd);
+};
+
+device::device(const net::xdp_options& opts)
+    : _ifname(opts.xdp_interface.get_value())
+    , _ifindex(if_nametoindex(_ifname.c_str()))
+    , _num_queues(std::min(opts.xdp_queues.get_value(), this_smp_shard_count()))
+    , _socket_map(create_socket_map(_num_queues))
+    , _prog(load_redirect_program(_socket_map))
+    , _link(attach_program(_prog, _ifindex, parse_attach_mode(opts.xdp_attach_mode.get_value())))
+{
+    if (_num_queues < opts.xdp_queues.get_value()) {
+        xdp_log.warn("{}: serving {} queues, one per shard", _ifname, _num_queues);
+    }
+    auto s = file_desc::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC);
+    auto ifr = interface_request(_ifname);
+    s.ioctl(SIOCGIFHWADDR, ifr);
+    _hw_address = ethernet_address(reinterpret_cast<const uint8_t*>(ifr.ifr_hwaddr.sa_data));
+    s.ioctl(SIOCGIFMTU, ifr);
+
+    // Frames are received after XDP_PACKET_HEADROOM bytes of the frame,
+    // and sent from its start. There are no offloads: the stack computes
+    // checksums and segments itself.
+    auto frame_mtu = opts.xdp_frame_size.get_value() - XDP_PACKET_HEADROOM - net::eth_hdr_len;
+    _hw_features.mtu = std::min<unsigned>(ifr.ifr_mtu, frame_mtu);
+
+    configure_rss(s);
+    xdp_log.info("{}: serving {} queue(s) over AF_XDP", _ifname, _num_queues);
+}
+
+device::~device() {
+    restore_rss();
+}
+
+// The indirection table then the key follow an ethtool_rxfh command
+static std::vector<uint32_t> make_rxfh(uint32_t cmd, uint32_t indir_size, uint32_t key_size) {
+    std::vector<uint32_t> buf((sizeof(ethtool_rxfh) + indir_size * sizeof(uint32_t) + key_size) / sizeof(uint32_t) + 1);
+    auto rxfh = reinterpret_cast<ethtool_rxfh*>(buf.data());
+    rxfh->cmd = cmd;
+    rxfh->indir_size = indir_size;
+    rxfh->key_size = key_size;
+    return buf;
+}
+
+// Sets the NIC's RSS up to spread flows over the queues like hash2qid()
+// does: toeplitz hashing of the IP addresses and ports with our key,
+// and the same indirection table. The interface's configuration is
+// restored when the device goes away. A single queue gets all the
+// traffic the program redirects whatever the RSS configuration, so it's
+// left alone then.
+void device::configure_rss(file_desc& s) {
+    if (_num_queues == 1) {
+        _redir_table.assign(1, 0);
+        return;
+    }
+    auto fail = [this] (const char* what) {
+        throw std::runtime_error(format("{}: cannot {}: {}; run with --xdp-queues=1 to spread flows in software",
+                _ifname, what, strerror(errno)));
+    };
+
+    ethtool_rxfh get = {};
+    get.cmd = ETHTOOL_GRSSH;
+    if (!ethtool(s, _ifname, &get)) {
+        return fail("read the RSS configuration");
+    }
+    if (!std::has_single_bit(get.indir_size)) {
+        errno = EOPNOTSUPP;
+        return fail("use the RSS indirection table");
+    }
+    if (get.key_size == default_rsskey_52bytes.size()) {
+        _rss_key = default_rsskey_52bytes;
+    } else if (get.key_size != default_rsskey_40bytes.size()) {
+        errno = EOPNOTSUPP;
+        return fail("use the RSS key");
+    }
+
+    auto saved = make_rxfh(ETHTOOL_GRSSH, get.indir_size, get.key_size);
+    if (!ethtool(s, _ifname, saved.data())) {
+        return fail("read the RSS configuration");
+    }
+    for (auto flow_type : { TCP_V4_FLOW, UDP_V4_FLOW }) {
+        ethtool_rxnfc nfc = {};
+        nfc.cmd = ETHTOOL_GRXFH;
+        nfc.flow_type = flow_type;
+        if (ethtool(s, _ifname, &nfc)) {
+            _saved_hash_fields.emplace_back(flow_type, nfc.data);
+        }
+    }
+
+    auto buf = make_rxfh(ETHTOOL_SRSSH, get.indir_size, _rss_key.size());
+    auto set = reinterpret_cast<ethtool_rxfh*>(buf.data());
+    // ETH_RSS_HASH_TOP, which is not part of the uapi headers
+    set->hfunc = 1 << 0;
+    _redir_table.resize(get.indir_size);
+    for (uint32_t i = 0; i < get.indir_size; i++) {
+        _redir_table[i] = i % _num_queues;
+        set->rss_config[i] = _redir_table[i];
+    }
+    std::copy(_rss_key.begin(), _rss_key.end(), reinterpret_cast<uint8_t*>(set->rss_config + get.indir_size));
+    if (!ethtool(s, _ifname, set)) {
+        return fail("set the RSS configuration");
+    }
+    reinterpret_cast<ethtool_rxfh*>(saved.data())->cmd = ETHTOOL_SRSSH;
+    _saved_rss = std::move(saved);
+    _rss_table_bits = std::countr_zero(get.indir_size);
+
+    // Some NICs hash UDP on addresses only by default
+    for (auto flow_type : { TCP_V4_FLOW, UDP_V4_FLOW }) {
+        ethtool_rxnfc nfc = {};
+        nfc.cmd = ETHTOOL_SRXFH;
+        nfc.flow_type = flow_type;
+        nfc.data = RXH_IP_SRC | RXH_IP_DST | RXH_L4_B_0_1 | RXH_L4_B_2_3;
+        if (!ethtool(s, _ifname, &nfc)) {
+            xdp_log.warn("{}: cannot hash flow type {} on ports: {}", _ifname, flow_type, strerror(errno));
+        }
+    }
+}
+
+void device::restore_rss() noexcept {
+    if (_saved_rss.empty()) {
+        return;
+    }
+    try {
+        auto s = file_desc::socket(AF_INET, SOCK_DGRAM | SOCK_CLOEXEC);
+        if (!ethtool(s, _ifname, _saved_rss.data())) {
+            xdp_log.warn("{}: cannot restore the RSS configuration: {}", _ifname, strerror(errno));
+        }
+        for (auto [flow_type, fields] : _saved_hash_fields) {
+            ethtool_rxnfc nfc = {};
+            nfc.cmd = ETHTOOL_SRXFH;
+            nfc.flow_type = flow_type;
+            nfc.data = fields;
+            if (!ethtool(s, _ifname, &nfc)) {
+                xdp_log.warn("{}: cannot restore the hash fields of flow type {}: {}", _ifname, flow_type, strerror(errno));
+            }
+        }
+    } catch (...) {
+        xdp_log.warn("{}: cannot restore the RSS configuration: {}", _ifname, std::current_exception());
+    }
+}
+
+void device::register_socket(uint16_t qid, const file_desc& fd) {
+    uint32_t key = qid;
+    uint32_t value = fd.get();
+    bpf_attr attr;
+    std::memset(&attr, 0, sizeof(attr));
+    attr.map_fd = _socket_map.get();
+    attr.key = to_u64(&key);
+    attr.value = to_u64(&value);
+    attr.flags = BPF_ANY;
+    bpf(BPF_MAP_UPDATE_ELEM, attr, "bpf(BPF_MAP_UPDATE_ELEM)");
+}
+
+// One of the four rings of a socket, mapped from the kernel. Its
+// producer and consumer indexes run freely and are taken modulo the
+// size, a power of two; each side of the ring only writes its own.
+template <typename T>
+class ring {
+    mmap_area _area;
+    uint32_t* _producer;
+    uint32_t* _consumer;
+    uint32_t* _flags;
+    T* _descs;
+    uint32_t _mask;
+
+    static uint32_t load(uint32_t* p, std::memory_order mo) noexcept {
+        return std::atomic_ref<uint32_t>(*p).load(mo);
+    }
+    static void store(uint32_t* p, uint32_t v) noexcept {
+        std::atomic_ref<uint32_t>(*p).store(v, std::memory_order_release);
+    }
+public:
+    ring(file_desc& fd, const xdp_ring_offset& off, uint32_t size, uint64_t pgoff)
+        : _area(fd.map(off.desc + size * sizeof(T), PROT_READ | PROT_WRITE, MAP_SHARED | MAP_POPULATE, pgoff))
+        , _producer(reinterpret_cast<uint32_t*>(_area.get() + off.producer))
+        , _consumer(reinterpret_cast<uint32_t*>(_area.get() + off.consumer))
+        , _flags(reinterpret_cast<uint32_t*>(_area.get() + off.flags))
+        , _descs(reinterpret_cast<T*>(_area.get() + off.desc))
+        , _mask(size - 1)
+    {}
+
+    // Producer side
+    uint32_t free_slots() const noexcept {
+        return _mask + 1 - (load(_producer, std::memory_order_relaxed) - load(_consumer, std::memory_order_acquire));
+    }
+    uint32_t in_flight() const noexcept {
+        return _mask + 1 - free_slots();
+    }
+    T& slot(uint32_t i) noexcept {
+        return _descs[(load(_producer, std::memory_order_relaxed) + i) & _mask];
+    }
+    void produce(uint32_t n) noexcept {
+        store(_producer, load(_producer, std::memory_order_relaxed) + n);
+    }
+
+    // Consumer side
+    uint32_t available() const noexcept {
+        return load(_producer, std::memory_order_acquire) - load(_consumer, std::memory_order_relaxed);
+    }
+    const T& entry(uint32_t i) const noexcept {
+        return _descs[(load(_consumer, std::memory_order_relaxed) + i) & _mask];
+    }
+    void consume(uint32_t n) noexcept {
+        store(_consumer, load(_consumer, std::memory_order_relaxed) + n);
+    }
+
+    bool needs_wakeup() const noexcept {
+        return load(_flags, std::memory_order_relaxed) & XDP_RING_NEED_WAKEUP;
+    }
+};
+
+// Packet memory of a queue. Frames go to the kernel through the fill and
+// transmit rings and come back through the receive and completion rings;
+// received frames then stay with the stack as packet fragments until
+// these are freed, which may be after the queue is gone.
+struct umem {
+    mmap_area area;
+    std::vector<uint64_t> free_frames;
+
+    char* at(uint64_t addr) noexcept {
+        return area.get() + addr;
+    }
+};
+
+class qp : public net::qp {
+    static constexpr uint32_t rx_batch = 64;
+
+    device* _dev;
+    uint16_t _qid;
+    uint32_t _frame_size;
+    uint32_t _ring_size;
+    lw_shared_ptr<umem> _umem;
+    file_desc _fd;
+    xdp_mmap_offsets _offsets;
+    ring<uint64_t> _fill;
+    ring<uint64_t> _completion;
+    ring<xdp_desc> _rx;
+    ring<xdp_desc> _tx;
+    std::optional<reactor::poller> _rx_poller;
+    // Packets the stack sent larger than a frame
+    uint64_t _tx_oversize_drops = 0;
+private:
+    xdp_mmap_offsets setup_socket();
+    void bind(uint32_t flags);
+    void refill();
+    bool reap_completions();
+    void kick_tx();
+    bool poll();
+public:
+    qp(device* dev, uint16_t qid, const net::xdp_options& opts);
+    future<> send(packet p) override {
+        abort();
+    }
+    uint32_t send(circular_buffer<packet>& pb) override;
+    void rx_start() override;
+};
+
+qp::qp(device* dev, uint16_t qid, const net::xdp_options& opts)
+    : net::qp(true, "network", qid)
+    , _dev(dev)
+    , _qid(qid)
+    , _frame_size(opts.xdp_frame_size.get_value())
+    , _ring_size(opts.xdp_ring_size.get_value())
+    , _umem(make_lw_shared<umem>())
+    , _fd(file_desc::socket(AF_XDP, SOCK_RAW | SOCK_CLOEXEC))
+    , _offsets(setup_socket())
+    , _fill(_fd, _offsets.fr, _ring_size, XDP_UMEM_PGOFF_FILL_RING)
+    , _completion(_fd, _offsets.cr, _ring_size, XDP_UMEM_PGOFF_COMPLETION_RING)
+    , _rx(_fd, _offsets.rx, _ring_size, XDP_PGOFF_RX_RING)
+    , _tx(_fd, _offsets.tx, _ring_size, XDP_PGOFF_TX_RING)
+{
+    // Give the kernel frames to receive into before it can redirect any
+    refill();
+    bind(parse_bind_mode(opts.xdp_bind_mode.get_value()));
+    _dev->register_socket(_qid, _fd);
+
+    namespace sm = seastar::metrics;
+    _metrics.add_group(_stats_plugin_name, {
+        sm::make_counter(_queue_name + "_tx_oversize_drops", _tx_oversize_drops,
+                        sm::description("Counts packets dropped by this queue for not fitting in an AF_XDP frame. "
+                                        "A non-zero value indicates an MTU larger than --xdp-frame-size allows.")),
+    });
+}
+
+// Registers packet memory for as many frames as the fill and transmit
+// rings together hold, and sizes the rings
+xdp_mmap_offsets qp::setup_socket() {
+    if (!std::has_single_bit(_ring_size)) {
+        throw std::runtime_error(format("AF_XDP ring size {} is not a power of two", _ring_size));
+    }
+    if (_frame_size != 2048 && _frame_size != 4096) {
+        throw std::runtime_error(format("AF_XDP frame size {} is neither 2048 nor 4096", _frame_size));
+    }
+    auto nr_frames = 2 * _ring_size;
+    _umem->area = mmap_anonymous(nullptr, size_t(nr_frames) * _frame_size, PROT_READ | PROT_WRITE,
+            MAP_PRIVATE | MAP_ANONYMOUS | MAP_POPULATE);
+    _umem->free_frames.reserve(nr_frames);
+    for (uint32_t i = nr_frames; i > 0; i--) {
+        _umem->free_frames.push_back(uint64_t(i - 1) * _frame_size);
+    }
+
+    xdp_umem_reg reg = {};
+    reg.addr = to_u64(_umem->area.get());
+    reg.len = uint64_t(nr_frames) * _frame_size;
+    reg.chunk_size = _frame_size;
+    reg.headroom = 0;
+    _fd.setsockopt(SOL_XDP, XDP_UMEM_REG, reg);
+    _fd.setsockopt(SOL_XDP, XDP_UMEM_FILL_RING, _ring_size);
+    _fd.setsockopt(SOL_XDP, XDP_UMEM_COMPLETION_RING, _ring_size);
+    _fd.setsockopt(SOL_XDP, XDP_RX_RING, _ring_size);
+    _fd.setsockopt(SOL_XDP, XDP_TX_RING, _ring_size);
+    return _fd.getsockopt<xdp_mmap_offsets>(SOL_XDP, XDP_MMAP_OFFSETS);
+}
+
+void qp::bind(uint32_t flags) {
+    sockaddr_xdp sxdp = {};
+    sxdp.sxdp_family = AF_XDP;
+    sxdp.sxdp_ifindex = _dev->ifindex();
+    sxdp.sxdp_queue_id = _qid;
+    sxdp.sxdp_flags = flags | XDP_USE_NEED_WAKEUP;
+    _fd.bind(reinterpret_cast<sockaddr&>(sxdp), sizeof(sxdp));
+    auto opts = _fd.getsockopt<::xdp_options>(SOL_XDP, XDP_OPTIONS);
+    xdp_log.info("queue {}: bound in {} mode", _qid, (opts.flags & XDP_OPTIONS_ZEROCOPY) ? "zero-copy" : "copy");
+}
+
+void qp::refill() {
+    auto& free_frames = _umem->free_frames;
+    auto n = std::min<uint32_t>(_fill.free_slots(), free_frames.size());
+    for (uint32_t i = 0; i < n; i++) {
+        _fill.slot(i) = free_frames.back();
+        free_frames.pop_back();
+    }
+    _fill.produce(n);
+    if (_fill.needs_wakeup()) {
+        ::recvfrom(_fd.get(), nullptr, 0, MSG_DONTWAIT, nullptr, nullptr);
+    }
+}
+
+bool qp::reap_completions() {
+    auto n = _completion.available();
+    for (uint32_t i = 0; i < n; i++) {
+        _umem->free_frames.push_back(_completion.entry(i));
+    }
+    _completion.consume(n);
+    return n;
+}
+
+void qp::kick_tx() {
+    // Failures are transient (the ring is being drained or the link is
+    // down); whatever remains is sent on the next kick
+    ::sendto(_fd.get(), nullptr, 0, MSG_DONTWAIT, nullptr, 0);
+}
+
+bool qp::poll() {
+    bool work = reap_completions();
+    // In copy mode the kernel sends a batch per kick
+    if (_tx.in_flight() && _tx.needs_wakeup()) {
+        kick_tx();
+    }
+
+    auto n = std::min(_rx.available(), rx_batch);
+    uint64_t bytes = 0;
+    for (uint32_t i = 0; i < n; i++) {
+        auto& d = _rx.entry(i);
+        auto frame = d.addr & ~uint64_t(_frame_size - 1);
+        fragment frag{_umem->at(d.addr), d.len};
+        bytes += d.len;
+        // Frames the stack holds on to (e.g. out of order TCP data) can't
+        // be received into; copy rather than run out of them
+        if (_umem->free_frames.size() < _ring_size / 2) {
+            packet p(frag);
+            _umem->free_frames.push_back(frame);
+            _stats.rx.good.update_copy_stats(1, d.len);
+            _dev->l2receive(std::move(p));
+        } else {
+            _dev->l2receive(packet(frag, make_deleter([u = _umem, frame] {
+                u->free_frames.push_back(frame);
+            })));
+        }
+    }
+    _rx.consume(n);
+    if (n) {
+        _stats.rx.good.update_pkts_bunch(n);
+        _stats.rx.good.update_frags_stats(n, bytes);
+    }
+    refill();
+    return work || n;
+}
+
+uint32_t qp::send(circular_buffer<packet>& pb) {
+    reap_completions();
+    auto& free_frames = _umem->free_frames;
+    auto slots = _tx.free_slots();
+    uint32_t queued = 0;
+    uint64_t bytes = 0, nr_frags = 0;
+    while (!pb.empty() && queued < slots && !free_frames.empty()) {
+        auto p = std::move(pb.front());
+        pb.pop_front();
+        // The stack doesn't build packets beyond the MTU
+        if (p.len() > _frame_size) {
+            ++_tx_oversize_drops;
+            continue;
+        }
+        auto frame = free_frames.back();
+        free_frames.pop_back();
+        auto dst = _umem->at(frame);
+        for (auto& f : p.fragments()) {
+            dst = std::copy_n(f.base, f.size, dst);
+        }
+        _tx.slot(queued++) = xdp_desc{ .addr = frame, .len = uint32_t(p.len()), .options = 0 };
+        bytes += p.len();
+        nr_frags += p.nr_frags();
+    }
+    if (queued) {
+        _tx.produce(queued);
+        if (_tx.needs_wakeup()) {
+            kick_tx();
+        }
+        _stats.tx.good.update_frags_stats(nr_frags, bytes);
+        _stats.tx.good.update_copy_stats(nr_frags, bytes);
+    }
+    return queued;
+}
+
+void qp::rx_start() {
+    _rx_poller = reactor::poller::simple([this] { return poll(); });
+}
+
+std::unique_ptr<net::qp> device::init_local_queue(const program_options::option_group& opts, uint16_t qid) {
+    auto net_opts = dynamic_cast<const net::native_stack_options*>(&opts);
+    SEASTAR_ASSERT(net_opts);
+    return std::make_unique<qp>(this, qid, net_opts->xdp_opts);
+}
+
+}
+
+net::xdp_options::xdp_options(program_options::option_group* parent_group)
+    : program_options::option_group(parent_group, "AF_XDP net options")
+    , xdp_interface(*this, "xdp-interface",
+                {},
+                "Network interface to run the native stack on over AF_XDP")
+    , xdp_queues(*this, "xdp-queues",
+                1,
+                "Number of hardware queues to serve, from queue 0 on")
+    , xdp_ring_size(*this, "xdp-ring-size",
+                1024,
+                "AF_XDP ring size (must be power-of-two)")
+    , xdp_frame_size(*this, "xdp-frame-size",
+                4096,
+                "AF_XDP frame size (2048 or 4096)")
+    , xdp_bind_mode(*this, "xdp-bind-mode",
+                "auto",
+                "How AF_XDP sockets share packet memory with the driver (auto / zero-copy / copy)")
+    , xdp_attach_mode(*this, "xdp-attach-mode",
+                "auto",
+                "Where the XDP program runs (auto / native / generic)")
+{
+}
+
+std::unique_ptr<net::device> create_xdp_net_device(const net::xdp_options& opts) {
+    if (!if_nametoindex(opts.xdp_interface.get_value().c_str())) {
+        throw std::runtime_error(format("no network interface {}", opts.xdp_interface.get_value()));
+    }
+    return std::make_unique<xdp::device>(opts);
+}
+
+}
@@ -22,6 +22,10 @@
 #include <seastar/testing/perf_tests.hh>
 
 #include <seastar/core/memory.hh>
+#include <seastar/testing/linux_perf_event.hh>
+#include <fmt/core.h>
+#include <algorithm>
+#include <random>
 #include <sys/mman.h>
 
 struct alloc_bench {
@@ -153,6 +157,56 @@ PERF_TEST_F(alloc_bench, single_alloc_and_free_small_many_cross_page_alloc_more)
     }
 }
 
+// Random reads over a working set of small objects much larger than the
+// dTLB reach with 4KiB pages. Run with and without --hugepage-spans to see
+// the effect of backing the heap with transparent huge pages; the dTLB miss
+// rate is printed at the end (it reads as zero where the PMU event is not
+// available).
+struct tlb_bench {
+    static constexpr size_t object_size = 128;
+    static constexpr size_t working_set = size_t(64) << 20;
+    static constexpr size_t nr_objects = working_set / object_size;
+    static constexpr size_t accesses_per_run = 100'000;
+
+    std::vector<uint64_t*> _objects;
+    size_t _next = 0;
+    uint64_t _accesses = 0;
+    linux_perf_event _dtlb_load_misses = linux_perf_event::user_dtlb_load_misses();
+
+    tlb_bench() {
+        _objects.reserve(nr_objects);
+        for (size_t i = 0; i < nr_objects; ++i) {
+            auto p = static_cast<uint64_t*>(std::malloc(object_size));
+            *p = i;
+            _objects.push_back(p);
+        }
+        std::shuffle(_objects.begin(), _objects.end(), std::mt19937_64(nr_objects));
+    }
+
+    ~tlb_bench() {
+        auto misses = _dtlb_load_misses.read();
+        fmt::print("tlb_bench: {:.4f} dTLB load misses per access ({} accesses), {} huge pages collapsed, {} collapse failures\n",
+                _accesses ? double(misses) / _accesses : 0.0, _accesses,
+                seastar::memory::stats().hugepage_collapses(), seastar::memory::stats().hugepage_collapse_failures());
+        for (auto p : _objects) {
+            std::free(p);
+        }
+    }
+};
+
+PERF_TEST_F(tlb_bench, random_read) {
+    uint64_t sum = 0;
+    _dtlb_load_misses.enable();
+    for (size_t i = 0; i < accesses_per_run; ++i) {
+        sum += *_objects[_next];
+        _next = _next + 1 == nr_objects ? 0 : _next + 1;
+    }
+    _dtlb_load_misses.disable();
+    perf_tests::do_not_optimize(sum);
+    _accesses += accesses_per_run;
+    return accesses_per_run;
+}
+
 template <typename DistType>
 static size_t dist_bench() {
     std::random_device rd_device;
@@ -0,0 +1,89 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Skewed random 4k reads of a file opened with O_DIRECT: most reads go to a
+// small hot set, as index lookups do. Compares reading the file directly
+// with reading it through a block_cache large enough for the hot set.
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/caching_file.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/loop.hh>
+#include <random>
+#include <ranges>
+
+using namespace seastar;
+
+struct skewed_reads {
+    static constexpr size_t block_size = 4096;
+    static constexpr size_t file_size = 16 << 20;
+    static constexpr size_t blocks = file_size / block_size;
+    static constexpr size_t hot_blocks = blocks / 10;
+    static constexpr size_t reads = 256;
+    static constexpr size_t concurrency = 16;
+
+    sstring _path = "caching_file_perf.tmp";
+    block_cache _cache{{ .capacity = 4 << 20, .block_size = block_size, .name = "perf" }};
+    file _file;
+    file _cached;
+    std::mt19937 _rng{reads};
+
+    skewed_reads() {
+        _file = open_file_dma(_path, open_flags::rw | open_flags::create | open_flags::truncate).get();
+        // Unlinked right away; the data lives until the last handle is gone
+        remove_file(_path).get();
+        auto buf = temporary_buffer<char>::aligned(_file.memory_dma_alignment(), 1 << 20);
+        std::fill_n(buf.get_write(), buf.size(), 'x');
+        for (size_t pos = 0; pos < file_size; pos += buf.size()) {
+            _file.dma_write(pos, buf.get(), buf.size()).get();
+        }
+        _file.flush().get();
+        _cached = make_caching_file(_file, _cache);
+    }
+
+    uint64_t next_offset() {
+        // 80% of the reads go to the first 10% of the file
+        auto hot = std::uniform_int_distribution<unsigned>(0, 9)(_rng) < 8;
+        auto limit = hot ? hot_blocks : blocks;
+        return std::uniform_int_distribution<uint64_t>(0, limit - 1)(_rng) * block_size;
+    }
+
+    future<size_t> read_blocks(file f) {
+        co_await parallel_for_each(std::views::iota(size_t(0), concurrency), [this, &f] (size_t) -> future<> {
+            for (size_t i = 0; i < reads / concurrency; i++) {
+                auto buf = co_await f.dma_read_bulk<char>(next_offset(), block_size);
+                perf_tests::do_not_optimize(buf);
+            }
+        });
+        co_return reads;
+    }
+};
+
+PERF_TEST_F(skewed_reads, uncached)
+{
+    return read_blocks(_file);
+}
+
+PERF_TEST_F(skewed_reads, cached)
+{
+    return read_blocks(_cached);
+}
@@ -130,3 +130,77 @@ PERF_TEST_F(perf_fair_queue, contended_shared)
 {
     return test(false);
 }
+
+// A bulk class and an interactive one whose requests may carry deadlines,
+// all queued up front and then dispatched
+struct perf_fair_queue_deadlines {
+    static constexpr unsigned nr_requests = 1000;
+    static constexpr fair_queue::class_id bulk = 0;
+    static constexpr fair_queue::class_id interactive = 1;
+
+    seastar::fair_queue fq;
+    seastar::fair_queue fq_slack;
+    std::vector<std::unique_ptr<seastar::fair_queue_entry>> entries;
+
+    static seastar::fair_queue::config make_config(uint64_t slack) {
+        seastar::fair_queue::config cfg;
+        cfg.deadline_urgency = std::chrono::seconds(1);
+        cfg.deadline_slack = slack;
+        return cfg;
+    }
+
+    perf_fair_queue_deadlines()
+        : fq(make_config(0))
+        , fq_slack(make_config(1 << 20))
+    {
+        for (auto* q : {&fq, &fq_slack}) {
+            q->register_priority_class(bulk, 100);
+            q->register_priority_class(interactive, 100);
+        }
+        entries.reserve(nr_requests);
+    }
+
+    ~perf_fair_queue_deadlines() {
+        for (auto* q : {&fq, &fq_slack}) {
+            q->unregister_priority_class(bulk);
+            q->unregister_priority_class(interactive);
+        }
+    }
+
+    // Every tenth request is interactive
+    size_t test(seastar::fair_queue& q, bool deadlines) {
+        entries.clear();
+        auto now = std::chrono::steady_clock::now();
+        for (unsigned i = 0; i < nr_requests; i++) {
+            auto deadline = fair_queue_entry::deadline_type::max();
+            if (i % 10 == 0 && deadlines) {
+                deadline = now + std::chrono::microseconds(i);
+            }
+            entries.push_back(std::make_unique<fair_queue_entry>(fair_queue_entry::capacity_t(1000), deadline));
+        }
+
+        perf_tests::start_measuring_time();
+        for (unsigned i = 0; i < nr_requests; i++) {
+            q.queue(i % 10 == 0 ? interactive : bulk, *entries[i]);
+        }
+        while (auto* ent = q.top()) {
+            perf_tests::do_not_optimize(ent);
+            q.pop_front();
+        }
+        perf_tests::stop_measuring_time();
+        return nr_requests;
+    }
+};
+
+PERF_TEST_F(perf_fair_queue_deadlines, no_deadlines)
+{
+    return test(fq, false);
+}
+PERF_TEST_F(perf_fair_queue_deadlines, deadlines_within_class)
+{
+    return test(fq, true);
+}
+PERF_TEST_F(perf_fair_queue_deadlines, deadlines_across_classes)
+{
+    return test(fq_slack, true);
+}
@@ -25,12 +25,55 @@
 #include <seastar/core/app-template.hh>
 #include <seastar/core/do_with.hh>
 #include <seastar/core/loop.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sleep.hh>
 #include <fmt/printf.h>
 #include <string>
 
 using namespace seastar;
 using namespace std::chrono_literals;
 
+// Streams the file back, spending consume_time on every buffer to model a
+// consumer that parses what it reads
+static future<> read_back(sstring name, size_t buffer_size, unsigned read_ahead, bool adaptive, std::chrono::microseconds consume_time) {
+    return open_file_dma(name, open_flags::ro).then([=] (file f) {
+        file_input_stream_options fiso;
+        fiso.buffer_size = buffer_size;
+        fiso.read_ahead = read_ahead;
+        fiso.adaptive_read_ahead = adaptive;
+        auto& stats = engine().get_io_stats();
+        auto blocked_before = stats.fstream_reads_blocked;
+        auto denied_before = stats.fstream_read_aheads_denied;
+        return do_with(make_file_input_stream(std::move(f), fiso), uint64_t(0), [=] (input_stream<char>& is, uint64_t& total) {
+            auto start = std::chrono::steady_clock::now();
+            return repeat([=, &is, &total] {
+                return is.read().then([=, &total] (temporary_buffer<char> buf) {
+                    if (buf.empty()) {
+                        return make_ready_future<stop_iteration>(stop_iteration::yes);
+                    }
+                    total += buf.size();
+                    if (consume_time.count() == 0) {
+                        return make_ready_future<stop_iteration>(stop_iteration::no);
+                    }
+                    // Burn the CPU rather than sleep, sleeping would let reads complete in the meantime for free
+                    auto until = std::chrono::steady_clock::now() + consume_time;
+                    while (std::chrono::steady_clock::now() < until) { }
+                    return make_ready_future<stop_iteration>(stop_iteration::no);
+                });
+            }).then([=, &is, &total] {
+                auto end = std::chrono::steady_clock::now();
+                using fseconds = std::chrono::duration<float, std::ratio<1, 1>>;
+                auto secs = std::chrono::duration_cast<fseconds>(end - start).count();
+                auto& stats = engine().get_io_stats();
+                fmt::print("{:10} {:10} {:10} {:12} {:10} {:10}\n", "bufsize", "readahead", "adaptive", "MB/s", "blocked", "denied");
+                fmt::print("{:10d} {:10d} {:10} {:12.1f} {:10d} {:10d}\n", buffer_size, read_ahead, adaptive, total / secs / (1 << 20),
+                        stats.fstream_reads_blocked - blocked_before, stats.fstream_read_aheads_denied - denied_before);
+                return is.close();
+            });
+        });
+    });
+}
+
 int main(int ac, char** av) {
     app_template at;
     namespace bpo = boost::program_options;
@@ -39,12 +82,20 @@ int main(int ac, char** av) {
             ("buffer-size", bpo::value<size_t>()->default_value(4096), "Write buffer size")
             ("total-ops", bpo::value<unsigned>()->default_value(100000), "Total write operations to issue")
             ("sloppy-size", bpo::value<bool>()->default_value(false), "Enable the sloppy-size optimization")
+            ("read", bpo::value<bool>()->default_value(false), "Stream the written file back and report read throughput")
+            ("read-ahead", bpo::value<unsigned>()->default_value(0), "Read-ahead for the read phase (upper bound with --adaptive-read-ahead, 0 means unbounded there)")
+            ("adaptive-read-ahead", bpo::value<bool>()->default_value(false), "Scale read-ahead to the consumption rate in the read phase")
+            ("consume-us", bpo::value<unsigned>()->default_value(0), "CPU time the reader spends on every buffer")
             ;
     return at.run(ac, av, [&at] {
         auto concurrency = at.configuration()["concurrency"].as<unsigned>();
         auto buffer_size = at.configuration()["buffer-size"].as<size_t>();
         auto total_ops = at.configuration()["total-ops"].as<unsigned>();
         auto sloppy_size = at.configuration()["sloppy-size"].as<bool>();
+        auto read = at.configuration()["read"].as<bool>();
+        auto read_ahead = at.configuration()["read-ahead"].as<unsigned>();
+        auto adaptive = at.configuration()["adaptive-read-ahead"].as<bool>();
+        auto consume_time = std::chrono::microseconds(at.configuration()["consume-us"].as<unsigned>());
         file_open_options foo;
         foo.sloppy_size = sloppy_size;
         return open_file_dma(
@@ -78,6 +129,11 @@ int main(int ac, char** av) {
                     });
                 });
             });
+        }).then([=] {
+            if (!read) {
+                return make_ready_future<>();
+            }
+            return read_back("testfile.tmp", buffer_size, read_ahead, adaptive, consume_time);
         });
     });
 }
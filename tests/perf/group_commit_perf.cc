@@ -0,0 +1,93 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Many writers appending small records to a log and waiting for each to be
+// durable. Compares each writer writing its record and flushing the file
+// on its own with all of them going through a group_commit_sink. Each run
+// reports the number of records made durable.
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/group_commit_sink.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/seastar.hh>
+#include <memory>
+#include <ranges>
+
+using namespace seastar;
+
+struct log_writers {
+    static constexpr size_t writers = 64;
+    static constexpr size_t records_per_writer = 8;
+    static constexpr size_t record_size = 256;
+
+    sstring _path = "group_commit_perf.tmp";
+    file _file;
+    uint64_t _pos = 0;
+    std::unique_ptr<group_commit_sink> _sink;
+
+    log_writers() {
+        _file = open_file_dma(_path, open_flags::rw | open_flags::create | open_flags::truncate).get();
+        // Unlinked right away; the data lives until the last handle is gone
+        remove_file(_path).get();
+        _sink = std::make_unique<group_commit_sink>(_file, 0);
+    }
+
+    ~log_writers() {
+        _sink->close().get();
+    }
+
+    // A record takes a whole block, since each is written separately
+    future<> write_and_flush() {
+        auto align = _file.disk_write_dma_alignment();
+        auto pos = std::exchange(_pos, _pos + align);
+        auto buf = temporary_buffer<char>::aligned(_file.memory_dma_alignment(), align);
+        std::fill_n(buf.get_write(), record_size, 'r');
+        co_await _file.dma_write(pos, buf.get(), buf.size());
+        co_await _file.flush();
+    }
+
+    future<> append() {
+        temporary_buffer<char> buf(record_size);
+        std::fill_n(buf.get_write(), record_size, 'r');
+        return _sink->append(std::move(buf));
+    }
+
+    template <typename Func>
+    future<size_t> run_writers(Func write_one) {
+        co_await parallel_for_each(std::views::iota(size_t(0), writers), [&write_one] (size_t) -> future<> {
+            for (size_t i = 0; i < records_per_writer; i++) {
+                co_await write_one();
+            }
+        });
+        co_return writers * records_per_writer;
+    }
+};
+
+PERF_TEST_F(log_writers, per_writer_flush)
+{
+    return run_writers([this] { return write_and_flush(); });
+}
+
+PERF_TEST_F(log_writers, group_commit)
+{
+    return run_writers([this] { return append(); });
+}
@@ -84,9 +84,9 @@ linux_perf_event::disable() {
 }
 
 static linux_perf_event
-make_linux_perf_event(unsigned config, pid_t pid = 0, int cpu = -1, int group_fd = -1, unsigned long flags = 0) {
+make_linux_perf_event(unsigned config, uint32_t type = PERF_TYPE_HARDWARE, pid_t pid = 0, int cpu = -1, int group_fd = -1, unsigned long flags = 0) {
     return linux_perf_event(perf_event_attr{
-            .type = PERF_TYPE_HARDWARE,
+            .type = type,
             .size = sizeof(struct perf_event_attr),
             .config = config,
             .disabled = 1,
@@ -109,3 +109,10 @@ linux_perf_event
 linux_perf_event::user_cpu_cycles_retired() {
     return make_linux_perf_event(PERF_COUNT_HW_CPU_CYCLES);
 }
+
+linux_perf_event
+linux_perf_event::user_dtlb_load_misses() {
+    return make_linux_perf_event(PERF_COUNT_HW_CACHE_DTLB
+            | (PERF_COUNT_HW_CACHE_OP_READ << 8)
+            | (PERF_COUNT_HW_CACHE_RESULT_MISS << 16), PERF_TYPE_HW_CACHE);
+}
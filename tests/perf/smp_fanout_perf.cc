@@ -0,0 +1,82 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Compares flat and NUMA-hierarchical broadcasts. The hierarchical variants
+// only differ from the flat one on hosts where the shards span more than one
+// NUMA node, e.g. run with --smp set to the number of cores of a 2- or 4-socket
+// machine.
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/sharded.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/loop.hh>
+#include <array>
+#include <ranges>
+
+using namespace seastar;
+
+// Stands in for a small configuration update pushed to every shard
+using config_payload = std::array<uint64_t, 8>;
+
+struct shard_config {
+    config_payload config{};
+};
+
+struct perf_smp_fanout {
+    sharded<shard_config> configs;
+    config_payload payload{};
+
+    perf_smp_fanout() {
+        configs.start().get();
+    }
+
+    ~perf_smp_fanout() {
+        configs.stop().get();
+    }
+
+    config_payload next_payload() noexcept {
+        payload[0]++;
+        return payload;
+    }
+};
+
+PERF_TEST_F(perf_smp_fanout, flat)
+{
+    return parallel_for_each(std::views::iota(0u, smp::count), [this, p = next_payload()] (unsigned id) {
+        return smp::submit_to(id, [this, p] {
+            configs.local().config = p;
+        });
+    });
+}
+
+PERF_TEST_F(perf_smp_fanout, hierarchical)
+{
+    return smp::invoke_on_all_hierarchical(smp_submit_to_options{}, [this, p = next_payload()] {
+        configs.local().config = p;
+    });
+}
+
+PERF_TEST_F(perf_smp_fanout, sharded_invoke_on_all)
+{
+    return configs.invoke_on_all([p = next_payload()] (shard_config& c) {
+        c.config = p;
+    });
+}
@@ -27,6 +27,7 @@
 #include <seastar/core/do_with.hh>
 #include <seastar/core/loop.hh>
 #include <seastar/core/sleep.hh>
+#include <seastar/core/when_all.hh>
 #include <seastar/util/later.hh>
 
 using namespace seastar;
@@ -115,25 +116,45 @@ class worker {
         return group_size * group_no;
     }
 
-    future<> start_working(unsigned concurrency, respond_type resp, microseconds tmo) {
-        return parallel_for_each(std::views::iota(0u, concurrency), [this, resp, tmo] (unsigned f) {
-            return do_until([this] { return _stop; }, [this, resp, tmo] {
-                return smp::submit_to(_to, [resp, tmo] {
-                    switch (resp) {
-                    case respond_type::ready:
-                        return make_ready_future<>();
-                    case respond_type::yield:
-                        return yield();
-                    case respond_type::io:
-                        return check_for_io_immediately();
-                    case respond_type::timer:
-                        return seastar::sleep<lowres_clock>(tmo);
-                    }
+    static future<> respond(respond_type resp, microseconds tmo) {
+        switch (resp) {
+        case respond_type::ready:
+            return make_ready_future<>();
+        case respond_type::yield:
+            return yield();
+        case respond_type::io:
+            return check_for_io_immediately();
+        case respond_type::timer:
+            return seastar::sleep<lowres_clock>(tmo);
+        }
 
-                    __builtin_unreachable();
-                }).then([this] {
-                    _total++;
-                    return make_ready_future<>();
+        __builtin_unreachable();
+    }
+
+    // Sends one operation, or `bulk` of them in a single smp::bulk_submit_to()
+    // call, to shard `to`
+    future<> submit_one(unsigned to, unsigned bulk, respond_type resp, microseconds tmo) {
+        auto fn = [resp, tmo] { return respond(resp, tmo); };
+        if (bulk == 0) {
+            return smp::submit_to(to, std::move(fn)).then([this] {
+                _total++;
+            });
+        }
+        auto futs = smp::bulk_submit_to(to, smp_submit_to_options{}, std::vector<decltype(fn)>(bulk, fn));
+        return when_all_succeed(futs.begin(), futs.end()).then([this, bulk] {
+            _total += bulk;
+        });
+    }
+
+    future<> start_working(unsigned concurrency, unsigned bulk, bool fanout, respond_type resp, microseconds tmo) {
+        return parallel_for_each(std::views::iota(0u, concurrency), [this, bulk, fanout, resp, tmo] (unsigned f) {
+            return do_until([this] { return _stop; }, [this, bulk, fanout, resp, tmo] {
+                if (!fanout) {
+                    return submit_one(_to, bulk, resp, tmo);
+                }
+                // map-reduce style: every operation touches all other shards
+                return parallel_for_each(std::views::iota(0u, this_smp_shard_count()), [this, bulk, resp, tmo] (unsigned to) {
+                    return to == this_shard_id() ? make_ready_future<>() : submit_one(to, bulk, resp, tmo);
                 });
             });
         });
@@ -147,6 +168,8 @@ class worker {
         respond_type respond;
         microseconds respond_tmo;
         unsigned concurrency;
+        unsigned bulk;
+        bool fanout;
     };
 
     worker(config cfg) noexcept
@@ -154,7 +177,7 @@ class worker {
         , _think(is_target() && (cfg.thinkers > 0) ? std::make_unique<thinker>(cfg.thinkers, cfg.think) : nullptr)
         , _total(0)
         , _stop(false)
-        , _done(start_working(cfg.concurrency, cfg.respond, cfg.respond_tmo))
+        , _done(start_working(cfg.concurrency, cfg.bulk, cfg.fanout, cfg.respond, cfg.respond_tmo))
     {
     }
 
@@ -208,6 +231,8 @@ int main(int ac, char** av) {
             ("respond", bpo::value<std::string>()->default_value("ready"), "how to respond on target (ready, yield, io, timer)")
             ("respond-timeout", bpo::value<unsigned>()->default_value(1), "the 'timer' respond timeout (us)")
             ("concurrency", bpo::value<unsigned>()->default_value(1), "smp::submit_to operations to issue in parallel")
+            ("bulk", bpo::value<unsigned>()->default_value(0), "issue operations in groups of this size with smp::bulk_submit_to (0 to issue them one by one)")
+            ("fanout", bpo::value<bool>()->default_value(false), "send every operation to all other shards instead of to the target shards")
         ;
 
     return at.run(ac, av, [&at] {
@@ -219,6 +244,8 @@ int main(int ac, char** av) {
         cfg.respond = parse_respond_type(at.configuration()["respond"].as<std::string>());
         cfg.respond_tmo = microseconds(at.configuration()["respond-timeout"].as<unsigned>());
         cfg.concurrency = at.configuration()["concurrency"].as<unsigned>();
+        cfg.bulk = at.configuration()["bulk"].as<unsigned>();
+        cfg.fanout = at.configuration()["fanout"].as<bool>();
 
         return async([cfg, duration] {
             sharded<worker> workers;
@@ -0,0 +1,220 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Measures the goodput of the native TCP stack's congestion control
+// algorithms over an emulated lossy link, in the spirit of netem on a
+// loopback device.
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <random>
+#include <ranges>
+#include <fmt/core.h>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/tcp.hh>
+#include <seastar/util/later.hh>
+#include <../../tests/unit/tcp_test_stack.hh>
+
+using namespace seastar;
+using namespace net;
+using namespace std::chrono;
+
+namespace {
+
+struct link_config {
+    double bandwidth;       // bytes per second
+    microseconds delay;     // one way
+    double loss;            // probability of dropping a segment
+    size_t queue_limit;     // bytes
+};
+
+// Segments towards the server port queue for a bottleneck of limited
+// bandwidth and buffer space, may be lost, and then take the propagation
+// delay to arrive. Segments back to the client only take the delay.
+class emulated_link : public tcp_test_stack {
+    using clock_type = steady_clock;
+    struct segment {
+        packet p;
+        // When it was queued, or when it arrives once on the wire
+        clock_type::time_point time;
+    };
+
+    const link_config _cfg;
+    uint16_t _server_port = 0;
+    std::deque<segment> _queue;
+    size_t _queued_bytes = 0;
+    clock_type::time_point _busy_until;
+    std::deque<segment> _forward;
+    std::deque<segment> _reverse;
+    std::mt19937 _rng;
+    std::bernoulli_distribution _drop;
+
+public:
+    struct stats {
+        uint64_t segments = 0;
+        uint64_t lost = 0;
+        uint64_t overflows = 0;
+    };
+
+private:
+    stats _stats;
+
+    void deliver(std::deque<segment>& wire, clock_type::time_point now) {
+        while (!wire.empty() && wire.front().time <= now) {
+            auto p = std::move(wire.front().p);
+            wire.pop_front();
+            tcp_test_stack::deliver(std::move(p));
+        }
+    }
+
+    void transmit(packet p, clock_type::time_point now) {
+        auto th = tcp_hdr::read(p.get_header(0, tcp_hdr::len));
+        if (th.dst_port != _server_port) {
+            _reverse.push_back(segment{std::move(p), now + _cfg.delay});
+            return;
+        }
+        _stats.segments++;
+        if (_drop(_rng)) {
+            _stats.lost++;
+            return;
+        }
+        if (_queued_bytes + p.len() > _cfg.queue_limit) {
+            _stats.overflows++;
+            return;
+        }
+        _queued_bytes += p.len();
+        _queue.push_back(segment{std::move(p), now});
+    }
+
+    virtual void poll() override {
+        auto now = clock_type::now();
+        deliver(_reverse, now);
+        deliver(_forward, now);
+        while (auto l4p = next_segment()) {
+            transmit(std::move(l4p->p), now);
+        }
+        while (!_queue.empty()) {
+            auto start = std::max(_busy_until, _queue.front().time);
+            if (start > now) {
+                break;
+            }
+            auto& s = _queue.front();
+            _busy_until = start + duration_cast<clock_type::duration>(duration<double>(s.p.len() / _cfg.bandwidth));
+            _queued_bytes -= s.p.len();
+            _forward.push_back(segment{std::move(s.p), _busy_until + _cfg.delay});
+            _queue.pop_front();
+        }
+    }
+
+public:
+    explicit emulated_link(link_config cfg)
+        : _cfg(cfg)
+        , _rng(0)
+        , _drop(cfg.loss)
+    {
+        start();
+    }
+
+    // Sends data from a client to a server for the given duration and
+    // returns the rate it was received at, in bytes per second
+    double transfer(tcp_congestion_algorithm algo, bool pacing, clock_type::duration d) {
+        _server_port++;
+        auto listener = _tcp.listen(_server_port);
+        auto client = _tcp.connect(socket_address(ipv4_addr(tcp_test_ip::address, _server_port)));
+        client.set_congestion_control(algo);
+        client.set_pacing(pacing);
+        auto server = listener.accept().get();
+        client.connected().get();
+
+        uint64_t received = 0;
+        auto reader = async([&server, &received] {
+            for (;;) {
+                server.wait_for_data().get();
+                auto p = server.read();
+                if (!p.len()) {
+                    break;
+                }
+                received += p.len();
+            }
+        });
+
+        temporary_buffer<char> chunk(1 << 16);
+        std::fill_n(chunk.get_write(), chunk.size(), 'x');
+        auto start = clock_type::now();
+        while (clock_type::now() < start + d) {
+            std::array<temporary_buffer<char>, 1> bufs = { chunk.share() };
+            client.send(bufs).get();
+        }
+        auto goodput = received / duration<double>(clock_type::now() - start).count();
+
+        client.close_write();
+        reader.get();
+        server.close_write();
+        return goodput;
+    }
+
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+}
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("algorithms", bpo::value<std::string>()->default_value("reno,cubic,bbr"), "comma-separated congestion control algorithms to compare")
+            ("bandwidth", bpo::value<double>()->default_value(100), "bottleneck bandwidth (Mbit/s)")
+            ("rtt", bpo::value<unsigned>()->default_value(20), "round-trip propagation time (ms)")
+            ("loss", bpo::value<double>()->default_value(0.1), "segments lost on the way to the server (%)")
+            ("queue", bpo::value<double>()->default_value(1), "bottleneck buffer (bandwidth-delay products)")
+            ("pacing", bpo::value<bool>()->default_value(false), "pace reno and cubic too")
+            ("duration", bpo::value<unsigned>()->default_value(10), "time to transfer for, per algorithm (seconds)")
+        ;
+
+    return at.run(ac, av, [&at] {
+        auto& config = at.configuration();
+        link_config cfg;
+        cfg.bandwidth = config["bandwidth"].as<double>() * 1e6 / 8;
+        cfg.delay = milliseconds(config["rtt"].as<unsigned>()) / 2;
+        cfg.loss = config["loss"].as<double>() / 100;
+        cfg.queue_limit = cfg.bandwidth * config["rtt"].as<unsigned>() / 1000 * config["queue"].as<double>();
+        auto pacing = config["pacing"].as<bool>();
+        auto d = seconds(config["duration"].as<unsigned>());
+        auto algorithms = config["algorithms"].as<std::string>();
+
+        return async([=] {
+            emulated_link link(cfg);
+            fmt::print("{:>8} {:>16} {:>10} {:>10} {:>10}\n", "algo", "goodput(Mbit/s)", "segments", "lost", "overflows");
+            for (auto name : algorithms | std::views::split(',')) {
+                auto algo = parse_tcp_congestion_algorithm(std::string_view(name.begin(), name.end()));
+                auto before = link.get_stats();
+                auto goodput = link.transfer(algo, pacing, d);
+                auto& after = link.get_stats();
+                fmt::print("{:>8} {:>16.1f} {:>10} {:>10} {:>10}\n", tcp_congestion_algorithm_name(algo), goodput * 8 / 1e6,
+                        after.segments - before.segments, after.lost - before.lost, after.overflows - before.overflows);
+            }
+            link.stop().get();
+        });
+    });
+}
@@ -0,0 +1,242 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Measures what software GSO and GRO save the native TCP stack on a device
+// without offloads: a single host sends to itself through frames built,
+// segmented and merged as the interface does for such a device, and the
+// goodput and the packets the stack handles are compared with the
+// offloads on and off.
+
+#include <array>
+#include <chrono>
+#include <deque>
+#include <ranges>
+#include <fmt/core.h>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/ethernet.hh>
+#include <seastar/net/ip_checksum.hh>
+#include <seastar/net/offload.hh>
+#include <seastar/net/tcp.hh>
+#include <seastar/util/later.hh>
+#include <../../tests/unit/tcp_test_stack.hh>
+
+using namespace seastar;
+using namespace net;
+using namespace std::chrono;
+
+namespace {
+
+struct offload_mode {
+    bool gso;
+    bool gro;
+};
+
+offload_mode parse_mode(std::string_view name) {
+    if (name == "off") {
+        return {false, false};
+    } else if (name == "gso") {
+        return {true, false};
+    } else if (name == "gro") {
+        return {false, true};
+    } else if (name == "gso+gro") {
+        return {true, true};
+    }
+    throw std::invalid_argument(fmt::format("unknown offload mode {}", name));
+}
+
+// The features the stack is shown: none, or segmentation and checksumming
+// when GSO does them
+hw_features stack_features(bool gso) {
+    hw_features features;
+    features.tx_tso = gso;
+    features.tx_csum_l4_offload = gso;
+    return features;
+}
+
+// Frames leave through software_segment() for a device without offloads
+// and come back in batches of up to batch_size, through gro when it's on,
+// with the IP layer's header handling in between
+class emulated_device : public tcp_test_stack {
+    const offload_mode _mode;
+    const unsigned _batch_size;
+    std::optional<gro> _gro;
+    circular_buffer<packet> _wire;
+    uint16_t _ip_id = 0;
+    uint16_t _server_port = 0;
+
+public:
+    struct stats {
+        uint64_t sent = 0;
+        uint64_t frames = 0;
+        uint64_t received = 0;
+    };
+
+private:
+    stats _stats;
+
+    packet frame(ipv4_traits::l4packet l4p) {
+        auto p = std::move(l4p.p);
+        auto iph = p.prepend_header<ip_hdr>();
+        iph->ihl = sizeof(*iph) / 4;
+        iph->ver = 4;
+        iph->dscp = 0;
+        iph->ecn = 0;
+        iph->len = p.len();
+        iph->id = _ip_id++;
+        iph->frag = 0;
+        iph->ttl = 64;
+        iph->ip_proto = uint8_t(l4p.proto_num);
+        iph->csum = 0;
+        iph->src_ip = _l4._inet.host_address();
+        iph->dst_ip = l4p.to;
+        *iph = hton(*iph);
+        checksummer csum;
+        csum.sum(reinterpret_cast<char*>(iph), sizeof(*iph));
+        iph->csum = csum.get();
+        auto eh = p.prepend_header<eth_hdr>();
+        eh->dst_mac = l4p.e_dst;
+        eh->src_mac = l4p.e_dst;
+        eh->eth_proto = uint16_t(eth_protocol_num::ipv4);
+        *eh = hton(*eh);
+        return p;
+    }
+
+    void deliver_frame(packet p) {
+        _stats.received++;
+        auto iph = p.get_header<ip_hdr>(eth_hdr_len);
+        if (!p.offload_info_ref().rx_csum_verified) {
+            checksummer csum;
+            csum.sum(reinterpret_cast<char*>(iph), sizeof(*iph));
+            if (csum.get() != 0) {
+                return;
+            }
+        }
+        auto h = ntoh(*iph);
+        p.trim_front(eth_hdr_len + h.ihl * 4);
+        _tcp.received(std::move(p), h.src_ip, h.dst_ip);
+    }
+
+    virtual void poll() override {
+        for (unsigned i = 0; i < _batch_size && !_wire.empty(); i++) {
+            auto p = std::move(_wire.front());
+            _wire.pop_front();
+            if (_gro) {
+                _gro->receive(std::move(p));
+            } else {
+                deliver_frame(std::move(p));
+            }
+        }
+        if (_gro) {
+            _gro->flush();
+        }
+        while (auto l4p = next_segment()) {
+            _stats.sent++;
+            auto before = _wire.size();
+            software_segment(frame(std::move(*l4p)), hw_features{}, _wire);
+            _stats.frames += _wire.size() - before;
+        }
+    }
+
+public:
+    emulated_device(offload_mode mode, unsigned batch_size)
+        : tcp_test_stack(stack_features(mode.gso))
+        , _mode(mode)
+        , _batch_size(batch_size)
+    {
+        if (_mode.gro) {
+            _gro.emplace(hw_features{}, [this] (packet p) { deliver_frame(std::move(p)); });
+        }
+        start();
+    }
+
+    // Sends data from a client to a server for the given duration and
+    // returns the rate it was received at, in bytes per second
+    double transfer(steady_clock::duration d) {
+        _server_port++;
+        auto listener = _tcp.listen(_server_port);
+        auto client = _tcp.connect(socket_address(ipv4_addr(tcp_test_ip::address, _server_port)));
+        auto server = listener.accept().get();
+        client.connected().get();
+
+        uint64_t received = 0;
+        auto reader = async([&server, &received] {
+            for (;;) {
+                server.wait_for_data().get();
+                auto p = server.read();
+                if (!p.len()) {
+                    break;
+                }
+                received += p.len();
+            }
+        });
+
+        temporary_buffer<char> chunk(1 << 16);
+        std::fill_n(chunk.get_write(), chunk.size(), 'x');
+        auto start = steady_clock::now();
+        while (steady_clock::now() < start + d) {
+            std::array<temporary_buffer<char>, 1> bufs = { chunk.share() };
+            client.send(bufs).get();
+        }
+        auto goodput = received / duration<double>(steady_clock::now() - start).count();
+
+        client.close_write();
+        reader.get();
+        server.close_write();
+        return goodput;
+    }
+
+    const stats& get_stats() const noexcept { return _stats; }
+};
+
+}
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("modes", bpo::value<std::string>()->default_value("off,gso,gro,gso+gro"), "comma-separated offload modes to compare (off, gso, gro, gso+gro)")
+            ("batch", bpo::value<unsigned>()->default_value(32), "frames received per poll")
+            ("duration", bpo::value<unsigned>()->default_value(5), "time to transfer for, per mode (seconds)")
+        ;
+
+    return at.run(ac, av, [&at] {
+        auto& config = at.configuration();
+        auto batch = config["batch"].as<unsigned>();
+        auto d = seconds(config["duration"].as<unsigned>());
+        auto modes = config["modes"].as<std::string>();
+
+        return async([=] {
+            fmt::print("{:>8} {:>16} {:>14} {:>14} {:>14}\n", "mode", "goodput(Gbit/s)", "sent(Kpps)", "frames(Kpps)", "received(Kpps)");
+            for (auto name : modes | std::views::split(',')) {
+                auto mode_name = std::string_view(name.begin(), name.end());
+                emulated_device dev(parse_mode(mode_name), batch);
+                auto goodput = dev.transfer(d);
+                auto& stats = dev.get_stats();
+                auto kpps = [&] (uint64_t n) { return n / duration<double>(d).count() / 1e3; };
+                fmt::print("{:>8} {:>16.2f} {:>14.1f} {:>14.1f} {:>14.1f}\n", mode_name, goodput * 8 / 1e9,
+                        kpps(stats.sent), kpps(stats.frames), kpps(stats.received));
+                dev.stop().get();
+            }
+        });
+    });
+}
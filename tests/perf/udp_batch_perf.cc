@@ -0,0 +1,154 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Measures the datagram rate of posix datagram channels over loopback, on
+// a single shard, with datagrams sent:
+//  - single: one send() per datagram
+//  - mmsg:   in batches, alternating between the receivers, which the
+//            kernel gets in one sendmmsg() but can't segment
+//  - gso:    in batches, in a run per receiver, which the kernel segments
+//            (UDP_SEGMENT) and may deliver coalesced (UDP_GRO)
+// Receivers always batch with recvmmsg().
+
+#include <chrono>
+#include <ranges>
+#include <vector>
+#include <fmt/core.h>
+#include <seastar/core/app-template.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/api.hh>
+#include <seastar/util/later.hh>
+
+using namespace seastar;
+using namespace std::chrono;
+
+namespace {
+
+constexpr unsigned nr_receivers = 2;
+
+struct result {
+    uint64_t sent = 0;
+    uint64_t received = 0;
+};
+
+result run(std::string_view mode, size_t size, unsigned batch_size, steady_clock::duration d) {
+    std::vector<net::datagram_channel> receivers;
+    for (unsigned i = 0; i < nr_receivers; i++) {
+        receivers.push_back(make_bound_datagram_channel(ipv4_addr("127.0.0.1", 0)));
+    }
+    auto sender = make_unbound_datagram_channel(AF_INET);
+
+    result res;
+    std::vector<future<>> readers;
+    for (auto& r : receivers) {
+        readers.push_back(async([&r, &res] {
+            try {
+                for (;;) {
+                    auto d = r.receive().get();
+                    if (d.get_buffers().empty() || !d.get_buffers()[0].size()) {
+                        break;
+                    }
+                    res.received++;
+                }
+            } catch (...) {
+                // Shut down
+            }
+        }));
+    }
+
+    temporary_buffer<char> payload(size);
+    std::fill_n(payload.get_write(), size, 'x');
+    auto dst = [&] (unsigned i) {
+        if (mode == "gso") {
+            return receivers[i * nr_receivers / batch_size].local_address();
+        }
+        return receivers[i % nr_receivers].local_address();
+    };
+    auto start = steady_clock::now();
+    while (steady_clock::now() < start + d) {
+        if (mode == "single") {
+            for (unsigned i = 0; i < batch_size; i++) {
+                auto buf = payload.share();
+                sender.send(dst(i), std::span(&buf, 1)).get();
+            }
+        } else {
+            std::vector<net::outgoing_datagram> batch;
+            for (unsigned i = 0; i < batch_size; i++) {
+                batch.push_back(net::outgoing_datagram{dst(i), payload.share()});
+            }
+            sender.send(batch).get();
+        }
+        res.sent += batch_size;
+        // Let the receivers run
+        yield().get();
+    }
+    // Stragglers still in the socket buffers
+    sleep(milliseconds(100)).get();
+    for (auto& r : receivers) {
+        r.shutdown_input();
+    }
+    for (auto& f : readers) {
+        f.get();
+    }
+    for (auto& r : receivers) {
+        r.close();
+    }
+    sender.close();
+    return res;
+}
+
+}
+
+int main(int ac, char** av) {
+    app_template at;
+    namespace bpo = boost::program_options;
+    at.add_options()
+            ("modes", bpo::value<std::string>()->default_value("single,mmsg,gso"), "comma-separated send modes to compare (single, mmsg, gso)")
+            ("size", bpo::value<size_t>()->default_value(1200), "datagram size (bytes)")
+            ("batch", bpo::value<unsigned>()->default_value(32), "datagrams per batch")
+            ("duration", bpo::value<unsigned>()->default_value(5), "time to send for, per mode (seconds)")
+        ;
+
+    return at.run(ac, av, [&at] {
+        auto& config = at.configuration();
+        auto size = config["size"].as<size_t>();
+        auto batch = config["batch"].as<unsigned>();
+        auto d = seconds(config["duration"].as<unsigned>());
+        auto modes = config["modes"].as<std::string>();
+
+        return async([=] {
+            fmt::print("{:>8} {:>14} {:>16} {:>10}\n", "mode", "sent(Kpps)", "received(Kpps)", "lost(%)");
+            for (auto name : modes | std::views::split(',')) {
+                auto mode = std::string_view(name.begin(), name.end());
+                if (mode != "single" && mode != "mmsg" && mode != "gso") {
+                    throw std::invalid_argument(fmt::format("unknown send mode {}", mode));
+                }
+                auto res = run(mode, size, batch, d);
+                auto secs = duration<double>(d).count();
+                fmt::print("{:>8} {:>14.1f} {:>16.1f} {:>10.2f}\n", mode, res.sent / secs / 1e3, res.received / secs / 1e3,
+                        res.sent ? 100.0 * (res.sent - std::min(res.sent, res.received)) / res.sent : 0.0);
+            }
+        });
+    });
+}
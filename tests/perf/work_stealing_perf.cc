@@ -0,0 +1,79 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Skewed CPU-bound load: all the jobs are submitted on shard 0 (where perf
+// tests run) while the other shards are idle. The time per run is the
+// makespan of the batch. Compare runs with --enable-work-stealing against
+// runs without it, with --smp > 1.
+
+#include <seastar/testing/perf_tests.hh>
+#include <seastar/core/smp.hh>
+#include <seastar/core/when_all.hh>
+#include <random>
+#include <vector>
+
+using namespace seastar;
+
+struct skewed_checksums {
+    static constexpr size_t jobs = 256;
+    static constexpr size_t job_size = 64 << 10;
+
+    std::vector<uint8_t> _data;
+
+    skewed_checksums() : _data(jobs * job_size) {
+        std::mt19937 rng(jobs);
+        std::ranges::generate(_data, [&rng] { return uint8_t(rng()); });
+    }
+
+    // FNV-1a, a stand-in for checksumming or compressing a block
+    static uint64_t checksum(const uint8_t* p, size_t len) noexcept {
+        uint64_t h = 14695981039346656037ull;
+        for (size_t i = 0; i < len; i++) {
+            h = (h ^ p[i]) * 1099511628211ull;
+        }
+        return h;
+    }
+
+    future<size_t> submit_jobs(bool stealable) {
+        std::vector<future<uint64_t>> futs;
+        futs.reserve(jobs);
+        for (size_t i = 0; i < jobs; i++) {
+            auto job = [p = _data.data() + i * job_size] {
+                return checksum(p, job_size);
+            };
+            futs.push_back(stealable ? smp::submit_stealable(std::move(job)) : smp::submit_to(this_shard_id(), std::move(job)));
+        }
+        return when_all_succeed(futs.begin(), futs.end()).then([] (std::vector<uint64_t> sums) {
+            perf_tests::do_not_optimize(sums);
+            return jobs;
+        });
+    }
+};
+
+PERF_TEST_F(skewed_checksums, local)
+{
+    return submit_jobs(false);
+}
+
+PERF_TEST_F(skewed_checksums, stealable)
+{
+    return submit_jobs(true);
+}
@@ -0,0 +1,102 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Measures large socket writes over loopback TCP. Run it with and without
+// --zerocopy-send-threshold (and with --reactor-backend io_uring) to compare
+// the copying and the zero-copy send paths, e.g.
+//
+//   zerocopy_send_perf --reactor-backend io_uring --zerocopy-send-threshold 64k
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/temporary_buffer.hh>
+#include <seastar/net/api.hh>
+#include <seastar/testing/perf_tests.hh>
+
+using namespace seastar;
+
+class zerocopy_send {
+    server_socket _server;
+    future<> _drain;
+    connected_socket _client;
+    output_stream<char> _out;
+    uint64_t _zc_bytes;
+    uint64_t _copied_bytes;
+
+    static server_socket make_server() {
+        listen_options lo;
+        lo.reuse_address = true;
+        return seastar::listen(ipv4_addr("127.0.0.1", 0), lo);
+    }
+
+    static future<> drain(accept_result ar) {
+        auto in = ar.connection.input();
+        while (auto buf = co_await in.read()) {
+        }
+        co_await in.close();
+    }
+public:
+    zerocopy_send()
+        : _server(make_server())
+        , _drain(_server.accept().then(drain))
+        , _client(connect(_server.local_address()).get())
+        , _out(_client.output())
+        , _zc_bytes(engine().get_io_stats().zerocopy_send_bytes)
+        , _copied_bytes(engine().get_io_stats().zerocopy_send_copied_bytes)
+    {}
+
+    ~zerocopy_send() {
+        _out.close().get();
+        _drain.get();
+        const auto& stats = engine().get_io_stats();
+        fmt::print("zero-copy bytes: {}, copied bytes: {}\n",
+                stats.zerocopy_send_bytes - _zc_bytes, stats.zerocopy_send_copied_bytes - _copied_bytes);
+    }
+
+    future<size_t> send(size_t size, unsigned count) {
+        temporary_buffer<char> payload(size);
+        std::fill_n(payload.get_write(), size, 'x');
+        perf_tests::start_measuring_time();
+        for (unsigned i = 0; i < count; ++i) {
+            co_await _out.write(payload.share());
+        }
+        co_await _out.flush();
+        perf_tests::stop_measuring_time();
+        co_return count;
+    }
+};
+
+PERF_TEST_CN(zerocopy_send, send_4k) {
+    return send(4 << 10, 256);
+}
+
+PERF_TEST_CN(zerocopy_send, send_64k) {
+    return send(64 << 10, 64);
+}
+
+PERF_TEST_CN(zerocopy_send, send_1m) {
+    return send(1 << 20, 8);
+}
+
+PERF_TEST_CN(zerocopy_send, send_16m) {
+    return send(16 << 20, 1);
+}
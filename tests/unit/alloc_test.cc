@@ -158,6 +158,41 @@ SEASTAR_TEST_CASE(test_memory_diagnostics) {
     return make_ready_future<>();
 }
 
+SEASTAR_TEST_CASE(test_detailed_stats) {
+    auto before = memory::detailed_stats();
+#ifdef SEASTAR_DEFAULT_ALLOCATOR
+    BOOST_REQUIRE(before.small_pools.empty());
+    BOOST_REQUIRE(before.free_spans.empty());
+#else
+    constexpr size_t object_size = 48;
+    auto pool_for = [] (const memory::detailed_statistics& ds) {
+        auto it = std::find_if(ds.small_pools.begin(), ds.small_pools.end(), [] (const memory::small_pool_stats& sp) {
+            return sp.object_size >= object_size;
+        });
+        BOOST_REQUIRE(it != ds.small_pools.end());
+        return *it;
+    };
+    std::vector<std::unique_ptr<char[]>> objects;
+    for (int i = 0; i < 1000; ++i) {
+        objects.emplace_back(new char[object_size]);
+    }
+    auto after = memory::detailed_stats();
+    auto free_memory = memory::free_memory();
+    BOOST_REQUIRE_EQUAL(after.small_pools.size(), memory::small_pool_count());
+    BOOST_REQUIRE_GE(pool_for(after).objects_in_use, pool_for(before).objects_in_use + 1000);
+    BOOST_REQUIRE_GE(pool_for(after).memory, pool_for(after).objects_in_use * pool_for(after).object_size);
+
+    BOOST_REQUIRE_EQUAL(after.free_spans.size(), memory::free_span_orders());
+    uint64_t free_bytes = 0;
+    for (auto& fs : after.free_spans) {
+        BOOST_REQUIRE_EQUAL(fs.span_size, memory::page_size << fs.order);
+        free_bytes += fs.free_spans * fs.span_size;
+    }
+    BOOST_REQUIRE_EQUAL(free_bytes, free_memory);
+#endif
+    return make_ready_future<>();
+}
+
 SEASTAR_THREAD_TEST_CASE(test_cross_thread_realloc) {
     // Tests that realloc seems to do the right thing with various sizes of
     // buffer, including cases where the initial allocation is on another
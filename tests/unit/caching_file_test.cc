@@ -0,0 +1,161 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/core/caching_file.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/util/closeable.hh>
+#include <seastar/util/tmp_file.hh>
+
+using namespace seastar;
+
+namespace seastar::testing {
+
+class block_cache_test {
+public:
+    static memory::reclaiming_result reclaim(block_cache& cache, size_t bytes) {
+        return cache.reclaim(bytes);
+    }
+};
+
+}
+
+static constexpr size_t block_size = 4096;
+
+static file make_test_file(tmp_dir& t, size_t len) {
+    auto f = open_file_dma((t.get_path() / "testfile.tmp").native(), open_flags::rw | open_flags::create | open_flags::truncate).get();
+    auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), len);
+    for (size_t i = 0; i < len; i++) {
+        buf.get_write()[i] = char(i / block_size);
+    }
+    f.dma_write(0, buf.get(), len).get();
+    return f;
+}
+
+SEASTAR_TEST_CASE(test_caching_file_hits_and_misses) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        block_cache cache({ .capacity = 1 << 20, .block_size = block_size });
+        auto f = make_caching_file(make_test_file(t, 8 * block_size), cache);
+        auto close_f = deferred_close(f);
+
+        // Unaligned read crossing two blocks
+        auto buf = f.dma_read_bulk<char>(block_size - 10, 20).get();
+        BOOST_REQUIRE_EQUAL(buf.size(), 20);
+        BOOST_REQUIRE_EQUAL(buf[0], 0);
+        BOOST_REQUIRE_EQUAL(buf[19], 1);
+        BOOST_REQUIRE_EQUAL(cache.get_stats().misses, 2);
+
+        f.dma_read_bulk<char>(0, block_size).get();
+        BOOST_REQUIRE_EQUAL(cache.get_stats().misses, 2);
+        BOOST_REQUIRE_EQUAL(cache.get_stats().hits, 1);
+
+        // Reading past EOF is short, as with the underlying file
+        buf = f.dma_read_bulk<char>(7 * block_size, 2 * block_size).get();
+        BOOST_REQUIRE_EQUAL(buf.size(), block_size);
+        BOOST_REQUIRE_EQUAL(buf[0], 7);
+    });
+}
+
+SEASTAR_TEST_CASE(test_caching_file_shared_misses) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        block_cache cache({ .capacity = 1 << 20, .block_size = block_size });
+        auto f = make_caching_file(make_test_file(t, 4 * block_size), cache);
+        auto close_f = deferred_close(f);
+
+        std::vector<future<temporary_buffer<char>>> reads;
+        for (int i = 0; i < 8; i++) {
+            reads.push_back(f.dma_read_bulk<char>(2 * block_size, block_size));
+        }
+        for (auto& r : when_all_succeed(reads.begin(), reads.end()).get()) {
+            BOOST_REQUIRE_EQUAL(r.size(), block_size);
+            BOOST_REQUIRE_EQUAL(r[0], 2);
+        }
+        BOOST_REQUIRE_EQUAL(cache.get_stats().misses, 1);
+        BOOST_REQUIRE_EQUAL(cache.get_stats().shared_misses, 7);
+    });
+}
+
+SEASTAR_TEST_CASE(test_caching_file_write_invalidates) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        block_cache cache({ .capacity = 1 << 20, .block_size = block_size });
+        auto f = make_caching_file(make_test_file(t, 4 * block_size), cache);
+        auto close_f = deferred_close(f);
+
+        f.dma_read_bulk<char>(0, 4 * block_size).get();
+        BOOST_REQUIRE_EQUAL(cache.blocks(), 4);
+
+        auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), block_size);
+        std::fill_n(buf.get_write(), block_size, 42);
+        f.dma_write(block_size, buf.get(), block_size).get();
+        BOOST_REQUIRE_EQUAL(cache.blocks(), 3);
+        BOOST_REQUIRE_EQUAL(cache.get_stats().invalidations, 1);
+
+        auto rd = f.dma_read_bulk<char>(block_size, block_size).get();
+        BOOST_REQUIRE_EQUAL(rd[0], 42);
+    });
+}
+
+SEASTAR_TEST_CASE(test_caching_file_eviction) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        // Room for about four blocks
+        block_cache cache({ .capacity = 4 * block_size + 2048, .block_size = block_size });
+        auto f = make_caching_file(make_test_file(t, 16 * block_size), cache);
+        auto close_f = deferred_close(f);
+
+        for (unsigned i = 0; i < 16; i++) {
+            auto buf = f.dma_read_bulk<char>(i * block_size, block_size).get();
+            BOOST_REQUIRE_EQUAL(buf[0], char(i));
+            BOOST_REQUIRE_LE(cache.memory_used(), cache.capacity());
+        }
+        BOOST_REQUIRE_GT(cache.get_stats().evictions, 0);
+        BOOST_REQUIRE_LE(cache.blocks(), 4);
+    });
+}
+
+SEASTAR_TEST_CASE(test_caching_file_reclaim_skips_held_blocks) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        block_cache cache({ .capacity = 1 << 20, .block_size = block_size });
+        auto f = make_caching_file(make_test_file(t, 4 * block_size), cache);
+        auto close_f = deferred_close(f);
+
+        // Held by a reader, block 1 frees nothing when evicted
+        auto held = f.dma_read_bulk<char>(block_size, block_size).get();
+        for (unsigned i = 0; i < 4; i++) {
+            f.dma_read_bulk<char>(i * block_size, block_size).get();
+        }
+        BOOST_REQUIRE_EQUAL(cache.blocks(), 4);
+        auto one_block = cache.memory_used() / 4;
+
+        using testing::block_cache_test;
+        BOOST_REQUIRE(block_cache_test::reclaim(cache, 1 << 20) == memory::reclaiming_result::reclaimed_something);
+        BOOST_REQUIRE_EQUAL(cache.blocks(), 1);
+        BOOST_REQUIRE_EQUAL(cache.memory_used(), one_block);
+        BOOST_REQUIRE_EQUAL(cache.get_stats().reclaimed, 3);
+        BOOST_REQUIRE(block_cache_test::reclaim(cache, 1 << 20) == memory::reclaiming_result::reclaimed_nothing);
+        BOOST_REQUIRE_EQUAL(held[0], 1);
+
+        held = {};
+        BOOST_REQUIRE(block_cache_test::reclaim(cache, 1 << 20) == memory::reclaiming_result::reclaimed_something);
+        BOOST_REQUIRE_EQUAL(cache.blocks(), 0);
+        BOOST_REQUIRE_EQUAL(cache.memory_used(), 0);
+    });
+}
@@ -621,3 +621,121 @@ SEASTAR_THREAD_TEST_CASE(test_fair_queue_nested_wakeups) {
         } while (next());
     }
 }
+
+struct deadline_request {
+    fair_queue_entry fqent;
+    unsigned id;
+
+    deadline_request(unsigned id, fair_queue_entry::deadline_type deadline = fair_queue_entry::deadline_type::max())
+        : fqent(test_weight_scale, deadline)
+        , id(id)
+    {}
+};
+
+static std::vector<unsigned> dispatch_all(fair_queue& fq) {
+    std::vector<unsigned> ids;
+    while (auto* ent = fq.top()) {
+        fq.pop_front();
+        ids.push_back(boost::intrusive::get_parent_from_member(ent, &deadline_request::fqent)->id);
+    }
+    return ids;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fair_queue_deadlines_within_class) {
+    fair_queue fq(fair_queue::config{});
+    fq.register_priority_class(0, 100);
+
+    auto now = std::chrono::steady_clock::now();
+    std::vector<std::unique_ptr<deadline_request>> reqs;
+    reqs.push_back(std::make_unique<deadline_request>(0));
+    reqs.push_back(std::make_unique<deadline_request>(1, now + 3s));
+    reqs.push_back(std::make_unique<deadline_request>(2, now + 1s));
+    reqs.push_back(std::make_unique<deadline_request>(3));
+    reqs.push_back(std::make_unique<deadline_request>(4, now + 2s));
+    for (auto& r : reqs) {
+        fq.queue(0, r->fqent);
+    }
+
+    // Earliest deadline first, then the rest in FIFO order
+    BOOST_REQUIRE(dispatch_all(fq) == std::vector<unsigned>({2, 4, 1, 0, 3}));
+    // With no slack, nothing is served out of turn
+    BOOST_REQUIRE_EQUAL(fq.deadline_dispatches(0), 0);
+    fq.unregister_priority_class(0);
+}
+
+// Class 1 is ahead of class 0, which is then served first until they're
+// even, unless class 1 has an urgent request and enough slack to jump ahead
+static std::vector<unsigned> dispatch_with_urgent_request(uint64_t slack, uint64_t& deadline_dispatches) {
+    fair_queue::config cfg;
+    cfg.forgiving_factor = 1 << 20;
+    cfg.deadline_urgency = 1s;
+    cfg.deadline_slack = slack;
+    fair_queue fq(cfg);
+    fq.register_priority_class(0, 100);
+    fq.register_priority_class(1, 100);
+
+    std::vector<std::unique_ptr<deadline_request>> reqs;
+    for (unsigned i = 0; i < 10; i++) {
+        reqs.push_back(std::make_unique<deadline_request>(100 + i));
+        fq.queue(1, reqs.back()->fqent);
+    }
+    dispatch_all(fq);
+
+    for (unsigned i = 0; i < 10; i++) {
+        reqs.push_back(std::make_unique<deadline_request>(i));
+        fq.queue(0, reqs.back()->fqent);
+    }
+    reqs.push_back(std::make_unique<deadline_request>(100, std::chrono::steady_clock::now() + 100ms));
+    fq.queue(1, reqs.back()->fqent);
+
+    auto ids = dispatch_all(fq);
+    deadline_dispatches = fq.deadline_dispatches(1);
+    fq.unregister_priority_class(0);
+    fq.unregister_priority_class(1);
+    return ids;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fair_queue_deadlines_across_classes) {
+    uint64_t deadline_dispatches;
+
+    // Class 1 is 10 requests (100 cost units at 100 shares) ahead, and the
+    // urgent request costs 10 more, so 110 * 100 of slack is needed
+    auto ids = dispatch_with_urgent_request(20000, deadline_dispatches);
+    BOOST_REQUIRE_EQUAL(ids.size(), 11);
+    BOOST_REQUIRE_EQUAL(ids.front(), 100);
+    BOOST_REQUIRE_EQUAL(deadline_dispatches, 1);
+
+    ids = dispatch_with_urgent_request(5000, deadline_dispatches);
+    BOOST_REQUIRE_EQUAL(ids.size(), 11);
+    BOOST_REQUIRE_NE(ids.front(), 100);
+    BOOST_REQUIRE_EQUAL(deadline_dispatches, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_fair_queue_expired_entries_not_charged) {
+    fair_queue::config cfg;
+    cfg.deadline_urgency = 1s;
+    cfg.deadline_slack = 20000;
+    fair_queue fq(cfg);
+    fq.register_priority_class(0, 100);
+
+    auto now = std::chrono::steady_clock::now();
+    deadline_request expired(0, now - 1s);
+    deadline_request live(1, now + 10s);
+    fq.queue(0, expired.fqent);
+    fq.queue(0, live.fqent);
+
+    // Expire entries like io_queue::poll_io_queue() does
+    std::vector<unsigned> ids;
+    while (auto* ent = fq.top()) {
+        if (ent->deadline() <= std::chrono::steady_clock::now()) {
+            fq.notify_request_cancelled(*ent);
+        }
+        fq.pop_front();
+        ids.push_back(boost::intrusive::get_parent_from_member(ent, &deadline_request::fqent)->id);
+    }
+    BOOST_REQUIRE(ids == std::vector<unsigned>({0, 1}));
+    // Only the live entry is charged
+    BOOST_REQUIRE_EQUAL(fq.pure_accumulated(0), test_weight_scale);
+    BOOST_REQUIRE_EQUAL(fq.accumulated(0), test_weight_scale / 100);
+    fq.unregister_priority_class(0);
+}
@@ -20,6 +20,7 @@
  */
 
 #include <filesystem>
+#include <numeric>
 
 #include <seastar/testing/random.hh>
 #include <seastar/testing/test_case.hh>
@@ -673,6 +674,30 @@ SEASTAR_TEST_CASE(test_file_fcntl) {
     });
 }
 
+SEASTAR_TEST_CASE(test_registered_buffer_read_write) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        sstring filename = (t.get_path() / "testfile.tmp").native();
+        auto f = open_file_dma(filename, open_flags::rw | open_flags::create).get();
+        auto close_f = deferred_close(f);
+
+        // Whether the buffer comes from the registered pool or not depends on
+        // the reactor backend, either way it has to be usable for DMA.
+        static constexpr size_t size = 16 * 1024;
+        auto wbuf = f.allocate_registered_buffer<char>(size);
+        BOOST_REQUIRE_EQUAL(wbuf.size(), size);
+        BOOST_REQUIRE_EQUAL(reinterpret_cast<uintptr_t>(wbuf.get()) % f.memory_dma_alignment(), 0);
+        std::iota(wbuf.get_write(), wbuf.get_write() + size, 0);
+        BOOST_REQUIRE_EQUAL(f.dma_write(0, wbuf.get(), size).get(), size);
+
+        auto rbuf = f.allocate_registered_buffer<char>(size);
+        BOOST_REQUIRE_EQUAL(f.dma_read(0, rbuf.get_write(), size).get(), size);
+        BOOST_REQUIRE(std::equal(rbuf.begin(), rbuf.end(), wbuf.begin()));
+
+        auto bulk = f.dma_read_bulk<char>(0, size).get();
+        BOOST_REQUIRE(std::equal(bulk.begin(), bulk.end(), wbuf.begin(), wbuf.end()));
+    });
+}
+
 SEASTAR_TEST_CASE(test_file_ioctl) {
     return tmp_dir::do_with_thread([] (tmp_dir& t) {
         auto oflags = open_flags::rw | open_flags::create;
@@ -970,6 +995,119 @@ SEASTAR_TEST_CASE(test_dma_iovec) {
     });
 }
 
+SEASTAR_TEST_CASE(test_dma_read_ranges) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        static constexpr size_t alignment = 4096;
+        static constexpr size_t size = 64 * alignment + 100;
+        auto wbuf = allocate_aligned_buffer<char>(alignment, align_up(size, alignment));
+        for (size_t i = 0; i < size; i++) {
+            wbuf.get()[i] = char(i * 7 + i / alignment);
+        }
+        auto filename = (t.get_path() / "testfile.tmp").native();
+        auto f = open_file_dma(filename, open_flags::rw | open_flags::create).get();
+        f.dma_write(0, wbuf.get(), align_up(size, alignment)).get();
+        f.truncate(size).get();
+        f.close().get();
+
+        // Unsorted, unaligned, overlapping, empty and past-EOF ranges
+        std::vector<file::read_range> ranges = {
+            { 10 * alignment + 5, 100 },
+            { 3 * alignment, alignment },
+            { 3 * alignment + 17, 2 * alignment },
+            { 40 * alignment, 0 },
+            { 11 * alignment + 1, 10 },
+            { 64 * alignment, 4096 },
+            { 65 * alignment, 10 },
+        };
+        auto check = [&] (file f) {
+            auto bufs = f.dma_read_ranges<char>(ranges, 2 * alignment).get();
+            BOOST_REQUIRE_EQUAL(bufs.size(), ranges.size());
+            for (size_t i = 0; i < ranges.size(); i++) {
+                auto& r = ranges[i];
+                auto expected = r.offset >= size ? 0 : std::min<uint64_t>(r.size, size - r.offset);
+                BOOST_REQUIRE_EQUAL(bufs[i].size(), expected);
+                BOOST_REQUIRE(std::equal(bufs[i].begin(), bufs[i].end(), wbuf.get() + r.offset));
+            }
+            // Ranges less than max_gap apart are read together
+            BOOST_REQUIRE_EQUAL(bufs[4].get(), bufs[0].get() + (alignment - 4));
+            BOOST_REQUIRE_EQUAL(bufs[2].get(), bufs[1].get() + 17);
+        };
+
+        // posix_file_real_impl
+        f = open_file_dma(filename, open_flags::ro).get();
+        check(f);
+        f.close().get();
+
+        // append_challenged_posix_file_impl
+        f = open_file_dma(filename, open_flags::rw).get();
+        check(f);
+        f.close().get();
+    });
+}
+
+SEASTAR_TEST_CASE(test_file_operations_accounting) {
+    // Whichever way the reactor backend serves them, file operations
+    // behave the same and are accounted for
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        using file_op = reactor::io_stats::file_op;
+        auto count = [] (file_op op) {
+            auto& s = engine().get_io_stats();
+            return s.native_file_ops[size_t(op)] + s.pool_file_ops[size_t(op)];
+        };
+        auto opens = count(file_op::open);
+        auto stats = count(file_op::stat);
+        auto renames = count(file_op::rename);
+        auto removes = count(file_op::remove);
+
+        auto name = (t.get_path() / "testfile.tmp").native();
+        auto f = open_file_dma(name, open_flags::rw | open_flags::create).get();
+        auto buf = temporary_buffer<char>::aligned(f.memory_dma_alignment(), 4096);
+        f.dma_write(0, buf.get(), buf.size()).get();
+        f.allocate(0, 1 << 20).get();
+        BOOST_REQUIRE_EQUAL(f.stat().get().st_size, 4096);
+        f.close().get();
+        BOOST_REQUIRE_GE(count(file_op::open), opens + 1);
+
+        auto new_name = (t.get_path() / "renamed.tmp").native();
+        rename_file(name, new_name).get();
+        BOOST_REQUIRE_EQUAL(count(file_op::rename), renames + 1);
+        BOOST_REQUIRE_EQUAL(file_stat(new_name).get().size, 4096);
+        BOOST_REQUIRE_THROW(file_stat(name).get(), std::filesystem::filesystem_error);
+        BOOST_REQUIRE_GE(count(file_op::stat), stats + 3);
+
+        BOOST_REQUIRE_THROW(open_file_dma(name, open_flags::ro).get(), std::filesystem::filesystem_error);
+        remove_file(new_name).get();
+        BOOST_REQUIRE(!file_exists(new_name).get());
+
+        auto dir = (t.get_path() / "dir").native();
+        make_directory(dir).get();
+        remove_file(dir).get();
+        BOOST_REQUIRE(!file_exists(dir).get());
+        BOOST_REQUIRE_EQUAL(count(file_op::remove), removes + 2);
+    });
+}
+
+SEASTAR_TEST_CASE(test_writable_open_accounting) {
+    // A writable open with an extent size hint is counted once, on the
+    // path that actually opened the file
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        using file_op = reactor::io_stats::file_op;
+        auto& s = engine().get_io_stats();
+        auto native = s.native_file_ops[size_t(file_op::open)];
+        auto pool = s.pool_file_ops[size_t(file_op::open)];
+
+        file_open_options options;
+        options.extent_allocation_size_hint = 1 << 20;
+        auto name = (t.get_path() / "testfile.tmp").native();
+        auto f = open_file_dma(name, open_flags::wo | open_flags::create, options).get();
+        f.close().get();
+
+        auto native_opens = s.native_file_ops[size_t(file_op::open)] - native;
+        auto pool_opens = s.pool_file_ops[size_t(file_op::open)] - pool;
+        BOOST_REQUIRE_EQUAL(native_opens + pool_opens, 1);
+    });
+}
+
 SEASTAR_TEST_CASE(test_intent) {
     return tmp_dir::do_with_thread([] (tmp_dir& t) {
         sstring filename = (t.get_path() / "testfile.tmp").native();
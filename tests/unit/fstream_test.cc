@@ -24,6 +24,7 @@
 #include <numeric>
 #include <seastar/core/fstream.hh>
 #include <seastar/core/smp.hh>
+#include <seastar/core/reactor.hh>
 #include <seastar/core/shared_ptr.hh>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/do_with.hh>
@@ -346,6 +347,52 @@ SEASTAR_TEST_CASE(test_input_stream_esp_around_eof) {
     });
 }
 
+SEASTAR_TEST_CASE(test_adaptive_read_ahead) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        auto flen = uint64_t(1 << 20);
+        auto data = boost::copy_range<std::vector<uint8_t>>(
+                boost::irange<uint64_t>(0, flen)
+                | boost::adaptors::transformed([] (uint64_t x) { return uint8_t(x * 7); }));
+        auto filename = (t.get_path() / "testfile.tmp").native();
+        auto f = open_file_dma(filename,
+                open_flags::rw | open_flags::create | open_flags::truncate).get();
+        auto close_f = deferred_close(f);
+        auto out = make_file_output_stream(f).get();
+        out.write(reinterpret_cast<const char*>(data.data()), data.size()).get();
+        out.flush().get();
+
+        // A budget of a few buffers makes the streams compete for it
+        set_file_input_stream_read_ahead_budget(16 << 10);
+        auto reset_budget = defer([] () noexcept { set_file_input_stream_read_ahead_budget(0); });
+        auto& stats = engine().get_io_stats();
+
+        auto opt = file_input_stream_options();
+        opt.buffer_size = 4096;
+        opt.adaptive_read_ahead = true;
+        auto in1 = make_file_input_stream(f, opt);
+        auto in2 = make_file_input_stream(f, flen / 2, opt);
+        std::vector<uint8_t> readback1, readback2;
+        in2.skip(4096).get();
+        while (true) {
+            auto b1 = in1.read().get();
+            auto b2 = in2.read().get();
+            readback1.insert(readback1.end(), b1.get(), b1.get() + b1.size());
+            readback2.insert(readback2.end(), b2.get(), b2.get() + b2.size());
+            BOOST_REQUIRE_LE(stats.fstream_read_ahead_memory, 16 << 10);
+            if (b1.empty() && b2.empty()) {
+                break;
+            }
+        }
+        in1.close().get();
+        in2.close().get();
+
+        BOOST_REQUIRE(readback1 == data);
+        BOOST_REQUIRE(std::equal(readback2.begin(), readback2.end(), data.begin() + flen / 2 + 4096, data.end()));
+        BOOST_REQUIRE_EQUAL(readback2.size(), flen / 2 - 4096);
+        BOOST_REQUIRE_EQUAL(stats.fstream_read_ahead_memory, 0);
+    });
+}
+
 SEASTAR_TEST_CASE(without_api_prefix) {
     return tmp_dir::do_with_thread([](tmp_dir& t) {
         auto filename = (t.get_path() / "testfile.tmp").native();
@@ -0,0 +1,119 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/core/group_commit_sink.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/util/tmp_file.hh>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+static temporary_buffer<char> make_record(size_t i) {
+    temporary_buffer<char> buf(1 + i * 37 % 300);
+    std::fill_n(buf.get_write(), buf.size(), char('a' + i % 26));
+    return buf;
+}
+
+static sstring read_whole_file(sstring name) {
+    auto f = open_file_dma(name, open_flags::ro).get();
+    auto size = f.size().get();
+    auto buf = f.dma_read_exactly<char>(0, size).get();
+    f.close().get();
+    return sstring(buf.get(), buf.size());
+}
+
+SEASTAR_TEST_CASE(test_group_commit_sink_concurrent_appends) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        auto name = (t.get_path() / "log").native();
+        group_commit_sink sink(open_file_dma(name, open_flags::rw | open_flags::create).get(), 0);
+
+        sstring expected;
+        std::vector<future<>> appends;
+        for (size_t i = 0; i < 100; i++) {
+            auto rec = make_record(i);
+            expected += sstring(rec.get(), rec.size());
+            appends.push_back(sink.append(std::move(rec)));
+        }
+        BOOST_REQUIRE_EQUAL(sink.position(), expected.size());
+        when_all_succeed(appends.begin(), appends.end()).get();
+        BOOST_REQUIRE_EQUAL(sink.get_stats().records, 100);
+        // The first record is committed alone, the rest wait for it
+        BOOST_REQUIRE_EQUAL(sink.get_stats().batches, 2);
+        sink.close().get();
+
+        BOOST_REQUIRE_EQUAL(read_whole_file(name), expected);
+    });
+}
+
+SEASTAR_TEST_CASE(test_group_commit_sink_unaligned_start) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        auto name = (t.get_path() / "log").native();
+        sstring expected;
+        {
+            group_commit_sink sink(open_file_dma(name, open_flags::rw | open_flags::create).get(), 0);
+            auto rec = make_record(3);
+            expected += sstring(rec.get(), rec.size());
+            sink.append(std::move(rec)).get();
+            sink.close().get();
+        }
+
+        // Reopened sinks rewrite the partial last block with its old contents
+        group_commit_sink sink(open_file_dma(name, open_flags::rw).get(), expected.size());
+        for (size_t i = 0; i < 30; i++) {
+            auto rec = make_record(i);
+            expected += sstring(rec.get(), rec.size());
+            sink.append(std::move(rec)).get();
+        }
+        BOOST_REQUIRE_EQUAL(sink.get_stats().batches, 30);
+        sink.close().get();
+
+        BOOST_REQUIRE_EQUAL(read_whole_file(name), expected);
+    });
+}
+
+SEASTAR_TEST_CASE(test_group_commit_sink_batch_bounds) {
+    return tmp_dir::do_with_thread([] (tmp_dir& t) {
+        auto name = (t.get_path() / "log").native();
+        group_commit_sink sink(open_file_dma(name, open_flags::rw | open_flags::create).get(), 0,
+                { .max_batch_size = 1000, .max_delay = 100ms });
+
+        // Ten records of 300 bytes fit three to a batch
+        std::vector<future<>> appends;
+        for (size_t i = 0; i < 10; i++) {
+            temporary_buffer<char> rec(300);
+            std::fill_n(rec.get_write(), rec.size(), 'x');
+            appends.push_back(sink.append(std::move(rec)));
+        }
+        when_all_succeed(appends.begin(), appends.end()).get();
+        BOOST_REQUIRE_EQUAL(sink.get_stats().batches, 4);
+
+        // A lone record waits for max_delay for company
+        auto start = std::chrono::steady_clock::now();
+        sink.append(make_record(1)).get();
+        BOOST_REQUIRE_GE(std::chrono::steady_clock::now() - start, 100ms);
+        BOOST_REQUIRE_EQUAL(sink.get_stats().batches, 5);
+        sink.close().get();
+
+        BOOST_REQUIRE_EQUAL(read_whole_file(name).size(), 3000 + make_record(1).size());
+    });
+}
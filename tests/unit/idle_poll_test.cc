@@ -0,0 +1,70 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/core/metrics_api.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+#include <chrono>
+#include <optional>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+// Runs with --adaptive-idle-poll, see CMakeLists.txt
+
+// Value of a reactor metric of this shard, or std::nullopt if it isn't
+// registered
+static std::optional<double> reactor_metric(sstring name) {
+    const auto& values = seastar::metrics::impl::get_value_map();
+    auto mf = values.find("reactor_" + name);
+    if (mf == values.end() || mf->second.empty()) {
+        return std::nullopt;
+    }
+    return mf->second.begin()->second->get_function()().d();
+}
+
+static double require_metric(sstring name) {
+    auto v = reactor_metric(name);
+    BOOST_REQUIRE_MESSAGE(v, "reactor_" + name + " is not registered");
+    return *v;
+}
+
+SEASTAR_THREAD_TEST_CASE(test_adaptive_idle_poll_follows_arrivals) {
+    // Work arriving every 100us is within any poll budget (200us, or 2ms
+    // when virtualized), so the reactor should learn to poll for it
+    auto pauses = require_metric("idle_pause_polls");
+    for (int i = 0; i < 200; i++) {
+        seastar::sleep(100us).get();
+    }
+    BOOST_REQUIRE_GT(require_metric("idle_pause_polls"), pauses);
+    BOOST_REQUIRE_GT(require_metric("idle_period_estimate_us"), 0);
+    BOOST_REQUIRE_GT(require_metric("idle_poll_window_us"), 0);
+
+    // Work arriving 20ms apart is beyond it, so the reactor should stop
+    // polling and sleep right away
+    auto sleeps = require_metric("idle_sleeps");
+    for (int i = 0; i < 30; i++) {
+        seastar::sleep(20ms).get();
+    }
+    BOOST_REQUIRE_GT(require_metric("idle_sleeps"), sleeps);
+    BOOST_REQUIRE_EQUAL(require_metric("idle_poll_window_us"), 0);
+}
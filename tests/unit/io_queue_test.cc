@@ -33,7 +33,9 @@
 #include <seastar/core/when_all.hh>
 #include <seastar/core/file.hh>
 #include <seastar/core/io_queue.hh>
+#include <seastar/core/metrics_api.hh>
 #include <seastar/core/io_intent.hh>
+#include <seastar/core/timed_out_error.hh>
 #include <seastar/core/disk_params.hh>
 #include <seastar/core/internal/io_request.hh>
 #include <seastar/core/internal/io_sink.hh>
@@ -213,6 +215,94 @@ SEASTAR_THREAD_TEST_CASE(test_large_request_flow_error) {
     do_test_large_request_flow(part_flaw::error);
 }
 
+SEASTAR_THREAD_TEST_CASE(test_adjacent_request_merging) {
+    io_queue::config cfg{0};
+    cfg.merge_max_latency = std::chrono::seconds(1);
+    io_queue_for_tests tio(cfg);
+    fake_file file;
+
+    // Four adjacent writes, then one that's not adjacent to them
+    std::vector<int> offsets = { 0, 1, 2, 3, 10 };
+    std::vector<int> values = { 13, 42, 73, 7, 99 };
+    std::vector<future<size_t>> futures;
+    for (unsigned i = 0; i < offsets.size(); i++) {
+        futures.push_back(tio.queue_request(get_default_pc(), internal::io_direction_and_length(internal::io_direction_and_length::write_idx, 1),
+                file.make_write_req(offsets[i], &values[i]), nullptr, {}));
+    }
+
+    seastar::sleep(std::chrono::milliseconds(500)).get();
+    tio.queue.poll_io_queue();
+    std::vector<size_t> submitted;
+    tio.sink.drain([&file, &submitted] (const internal::io_request& rq, io_completion* desc) -> bool {
+        if (rq.opcode() == internal::io_request::operation::writev) {
+            submitted.push_back(rq.as<internal::io_request::operation::writev>().iov_len);
+            file.execute_writev_req(rq, desc);
+        } else {
+            submitted.push_back(1);
+            file.execute_write_req(rq, desc);
+        }
+        return true;
+    });
+
+    BOOST_REQUIRE_EQUAL(submitted.size(), 2);
+    BOOST_REQUIRE_EQUAL(submitted[0], 4);
+    BOOST_REQUIRE_EQUAL(submitted[1], 1);
+    for (unsigned i = 0; i < offsets.size(); i++) {
+        // Every original request is completed with its own slice
+        BOOST_REQUIRE_EQUAL(futures[i].get(), 1);
+        BOOST_REQUIRE_EQUAL(file.data[offsets[i]], values[i]);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_merged_request_short_result) {
+    io_queue::config cfg{0};
+    cfg.merge_max_latency = std::chrono::seconds(1);
+    io_queue_for_tests tio(cfg);
+    fake_file file;
+
+    std::vector<int> values = { 13, 42, 73, 7 };
+    std::vector<future<size_t>> futures;
+    for (unsigned i = 0; i < values.size(); i++) {
+        futures.push_back(tio.queue_request(get_default_pc(), internal::io_direction_and_length(internal::io_direction_and_length::write_idx, 1),
+                file.make_write_req(i, &values[i]), nullptr, {}));
+    }
+
+    seastar::sleep(std::chrono::milliseconds(500)).get();
+    tio.queue.poll_io_queue();
+    // The merged write only gets through its first slice. It's completed
+    // after draining, as the completion submits requests again.
+    unsigned merged = 0;
+    io_completion* merged_desc = nullptr;
+    tio.sink.drain([&file, &merged, &merged_desc] (const internal::io_request& rq, io_completion* desc) -> bool {
+        BOOST_REQUIRE(rq.opcode() == internal::io_request::operation::writev);
+        const auto& op = rq.as<internal::io_request::operation::writev>();
+        merged = op.iov_len;
+        file.data[op.pos] = *reinterpret_cast<int*>(op.iovec[0].iov_base);
+        merged_desc = desc;
+        return true;
+    });
+    BOOST_REQUIRE_EQUAL(merged, values.size());
+    merged_desc->complete_with(1);
+    BOOST_REQUIRE(futures[0].available());
+    BOOST_REQUIRE_EQUAL(futures[0].get(), 1);
+
+    // The others are submitted again on their own rather than completed
+    // with 0, which reads as EOF
+    unsigned resubmitted = 0;
+    tio.sink.drain([&file, &resubmitted] (const internal::io_request& rq, io_completion* desc) -> bool {
+        resubmitted++;
+        file.execute_write_req(rq, desc);
+        return true;
+    });
+    BOOST_REQUIRE_EQUAL(resubmitted, values.size() - 1);
+    for (unsigned i = 0; i < values.size(); i++) {
+        if (i) {
+            BOOST_REQUIRE_EQUAL(futures[i].get(), 1);
+        }
+        BOOST_REQUIRE_EQUAL(file.data[i], values[i]);
+    }
+}
+
 SEASTAR_THREAD_TEST_CASE(test_intent_safe_ref) {
     auto get_cancelled = [] (internal::intent_reference& iref) -> bool {
         try {
@@ -998,3 +1088,115 @@ SEASTAR_THREAD_TEST_CASE(test_get_all_io_queues) {
         BOOST_CHECK(std::find(queues.begin(), queues.end(), q) != queues.end());
     }
 }
+
+SEASTAR_THREAD_TEST_CASE(test_throttler_calibration) {
+    io_throttler::config cfg;
+    cfg.rate_limit_duration = std::chrono::milliseconds(1);
+    io_throttler fg(cfg, 1);
+    const auto nominal_rate = fg.token_bucket().rate();
+    const auto goal = fg.rate_limit_duration();
+
+    // Slow completions scale the rate down multiplicatively, but not below the minimum
+    for (int i = 0; i < 20; i++) {
+        fg.account_latency(goal * 2 * 100, 100);
+        fg.calibrate(goal, 0.1);
+    }
+    BOOST_REQUIRE_CLOSE(fg.rate_ratio(), 0.1, 0.001);
+    BOOST_REQUIRE_LT(fg.token_bucket().rate(), nominal_rate);
+    BOOST_REQUIRE_GT(fg.rate_decreases(), 0);
+    // The latency goal is derived from the configured rate and doesn't drift
+    BOOST_REQUIRE(fg.rate_limit_duration() == goal);
+
+    // Latency within the goal, but not well below it, keeps the rate
+    auto ratio = fg.rate_ratio();
+    fg.account_latency(goal * 0.9 * 100, 100);
+    fg.calibrate(goal, 0.1);
+    BOOST_REQUIRE_EQUAL(fg.rate_ratio(), ratio);
+
+    // Fast completions (or no completions at all) grow it back up to the configured rate
+    for (int i = 0; i < 100; i++) {
+        if (i % 2) {
+            fg.account_latency(goal * 0.1 * 100, 100);
+        }
+        fg.calibrate(goal, 0.1);
+    }
+    BOOST_REQUIRE_EQUAL(fg.rate_ratio(), 1.0);
+    BOOST_REQUIRE_EQUAL(fg.token_bucket().rate(), nominal_rate);
+    BOOST_REQUIRE_GT(fg.rate_increases(), 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_latency_histograms) {
+    io_queue::config cfg{0};
+    cfg.mountpoint = "latency-histograms";
+    cfg.duplex = true;
+    io_queue_for_tests tio(cfg);
+    fake_file file;
+
+    int values[4] = { 1, 2, 3, 4 };
+    std::vector<future<size_t>> writes;
+    for (unsigned i = 0; i < 4; i++) {
+        writes.push_back(tio.queue_request(get_default_pc(), internal::io_direction_and_length(internal::io_direction_and_length::write_idx, 1),
+                file.make_write_req(i, &values[i]), nullptr, {}));
+    }
+
+    seastar::sleep(std::chrono::milliseconds(10)).get();
+    tio.queue.poll_io_queue();
+    seastar::sleep(std::chrono::milliseconds(20)).get();
+    tio.sink.drain([&file] (const internal::io_request& rq, io_completion* desc) -> bool {
+        file.execute_write_req(rq, desc);
+        return true;
+    });
+    when_all_succeed(writes.begin(), writes.end()).get();
+
+    auto get_histogram = [] (sstring name, sstring stream) {
+        const auto& values = seastar::metrics::impl::get_value_map();
+        auto mf = values.find(name);
+        BOOST_REQUIRE(mf != values.end());
+        for (auto&& mi : mf->second) {
+            auto& labels = mi.first.labels();
+            if (labels.at("mountpoint").value() == "latency-histograms" && labels.at("stream").value() == stream) {
+                return mi.second->get_function()().get_histogram();
+            }
+        }
+        BOOST_FAIL("cannot find requested metrics");
+        return seastar::metrics::histogram();
+    };
+
+    auto queue = get_histogram("io_queue_queue_latency", "write");
+    auto disk = get_histogram("io_queue_disk_latency", "write");
+    auto total = get_histogram("io_queue_total_latency", "write");
+    BOOST_REQUIRE_EQUAL(queue.sample_count, 4);
+    BOOST_REQUIRE_EQUAL(disk.sample_count, 4);
+    BOOST_REQUIRE_EQUAL(total.sample_count, 4);
+    BOOST_REQUIRE_GE(queue.sample_sum, 4 * 10000);
+    BOOST_REQUIRE_GE(disk.sample_sum, 4 * 20000);
+    BOOST_REQUIRE_GE(total.sample_sum, 4 * 30000);
+    BOOST_REQUIRE_EQUAL(get_histogram("io_queue_total_latency", "read").sample_count, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_expired_deadline) {
+    io_queue_for_tests tio;
+    fake_file file;
+    int values[2] = { 13, 42 };
+
+    io_intent expired(std::chrono::steady_clock::now() - std::chrono::milliseconds(1));
+    io_intent pending(std::chrono::steady_clock::now() + std::chrono::hours(1));
+    auto f0 = tio.queue_request(get_default_pc(), internal::io_direction_and_length(internal::io_direction_and_length::write_idx, 0),
+            file.make_write_req(0, &values[0]), &expired, {});
+    auto f1 = tio.queue_request(get_default_pc(), internal::io_direction_and_length(internal::io_direction_and_length::write_idx, 0),
+            file.make_write_req(1, &values[1]), &pending, {});
+
+    seastar::sleep(std::chrono::milliseconds(500)).get();
+    tio.queue.poll_io_queue();
+    auto submitted = tio.sink.drain([&file] (const internal::io_request& rq, io_completion* desc) -> bool {
+        file.execute_write_req(rq, desc);
+        return true;
+    });
+
+    // The expired request never reaches the disk
+    BOOST_REQUIRE_EQUAL(submitted, 1);
+    BOOST_REQUIRE_THROW(f0.get(), timed_out_error);
+    f1.get();
+    BOOST_REQUIRE(!file.data.contains(0));
+    BOOST_REQUIRE_EQUAL(file.data[1], 42);
+}
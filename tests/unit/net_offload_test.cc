@@ -0,0 +1,332 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/reactor.hh>
+#include <seastar/core/shared_ptr.hh>
+#include <seastar/util/later.hh>
+#include <seastar/net/ethernet.hh>
+#include <seastar/net/ip.hh>
+#include <seastar/net/ip_checksum.hh>
+#include <seastar/net/offload.hh>
+#include <seastar/net/tcp.hh>
+#include <string>
+#include <vector>
+
+using namespace seastar;
+using namespace net;
+
+namespace {
+
+constexpr uint32_t src_addr = 0x0a000001;
+constexpr uint32_t dst_addr = 0x0a000002;
+constexpr size_t hdr_len = eth_hdr_len + 20 + tcp_hdr::len;
+
+std::string payload_of(size_t len, size_t offset = 0) {
+    std::string s(len, 0);
+    for (size_t i = 0; i < len; i++) {
+        s[i] = char('a' + (offset + i) % 26);
+    }
+    return s;
+}
+
+std::string linearize(const packet& p, size_t offset = 0) {
+    std::string s;
+    for (auto& f : p.fragments()) {
+        s.append(f.base, f.size);
+    }
+    return s.substr(offset);
+}
+
+// A frame as the stack builds it for a device with L4 checksum offload and,
+// when seg_size is given, TSO
+packet make_frame(const std::string& data, uint32_t seq, uint16_t port, bool psh, uint16_t seg_size = 0) {
+    packet p(data.data(), data.size());
+    auto th = p.prepend_uninitialized_header(tcp_hdr::len);
+    tcp_hdr t{};
+    t.src_port = port;
+    t.dst_port = 80;
+    t.seq = make_seq(seq);
+    t.ack = make_seq(1);
+    t.data_offset = tcp_hdr::len / 4;
+    t.f_ack = true;
+    t.f_psh = psh;
+    t.window = 1000;
+    t.write(th);
+    checksummer csum;
+    ipv4_traits::tcp_pseudo_header_checksum(csum, ipv4_address(src_addr), ipv4_address(dst_addr),
+            seg_size ? 0 : tcp_hdr::len + data.size());
+    tcp_hdr::write_nbo_checksum(th, ~csum.get());
+
+    auto iph = p.prepend_header<ip_hdr>();
+    iph->ihl = 5;
+    iph->ver = 4;
+    iph->dscp = 0;
+    iph->ecn = 0;
+    iph->len = p.len();
+    iph->id = 100;
+    iph->frag = 0;
+    iph->ttl = 64;
+    iph->ip_proto = uint8_t(ip_protocol_num::tcp);
+    iph->csum = 0;
+    iph->src_ip = ipv4_address(src_addr);
+    iph->dst_ip = ipv4_address(dst_addr);
+    *iph = hton(*iph);
+    checksummer ipcsum;
+    ipcsum.sum(reinterpret_cast<char*>(iph), sizeof(*iph));
+    iph->csum = ipcsum.get();
+
+    auto eh = p.prepend_header<eth_hdr>();
+    eh->dst_mac = ethernet_address{1, 2, 3, 4, 5, 6};
+    eh->src_mac = ethernet_address{6, 5, 4, 3, 2, 1};
+    eh->eth_proto = uint16_t(eth_protocol_num::ipv4);
+    *eh = hton(*eh);
+
+    offload_info oi;
+    oi.protocol = ip_protocol_num::tcp;
+    oi.needs_csum = true;
+    oi.tso_seg_size = seg_size;
+    p.set_offload_info(oi);
+    return p;
+}
+
+ip_hdr ip_of(packet& p) {
+    return ntoh(*p.get_header<ip_hdr>(eth_hdr_len));
+}
+
+tcp_hdr tcp_of(packet& p) {
+    return tcp_hdr::read(p.get_header(eth_hdr_len + 20, tcp_hdr::len));
+}
+
+bool checksums_valid(packet& p) {
+    checksummer csum;
+    csum.sum(p.get_header(eth_hdr_len, 20), 20);
+    if (csum.get() != 0) {
+        return false;
+    }
+    auto data = linearize(p, eth_hdr_len + 20);
+    checksummer l4csum;
+    ipv4_traits::tcp_pseudo_header_checksum(l4csum, ipv4_address(src_addr), ipv4_address(dst_addr), data.size());
+    l4csum.sum(data.data(), data.size());
+    return l4csum.get() == 0;
+}
+
+// A device without offloads, whose single queue keeps what's sent
+class fake_qp : public qp {
+public:
+    std::vector<packet> sent;
+    virtual future<> send(packet p) override {
+        sent.push_back(std::move(p));
+        return make_ready_future<>();
+    }
+};
+
+class fake_device : public device {
+    fake_qp* _qp;
+public:
+    fake_device() {
+        auto q = std::make_unique<fake_qp>();
+        _qp = q.get();
+        set_local_queue(std::move(q));
+    }
+    fake_qp& queue() noexcept { return *_qp; }
+    virtual ethernet_address hw_address() override { return ethernet_address{6, 5, 4, 3, 2, 1}; }
+    virtual net::hw_features hw_features() override { return net::hw_features{}; }
+    virtual std::unique_ptr<qp> init_local_queue(const program_options::option_group&, uint16_t) override {
+        abort();
+    }
+};
+
+std::vector<packet> segment(packet frame) {
+    circular_buffer<packet> out;
+    software_segment(std::move(frame), hw_features{}, out);
+    std::vector<packet> v;
+    for (auto& p : out) {
+        v.push_back(std::move(p));
+    }
+    return v;
+}
+
+}
+
+BOOST_AUTO_TEST_CASE(test_segment_splits_tso_frame) {
+    auto data = payload_of(5000);
+    auto segs = segment(make_frame(data, 1000, 5000, true, 1460));
+    BOOST_REQUIRE_EQUAL(segs.size(), 4);
+    size_t offset = 0;
+    for (size_t i = 0; i < segs.size(); i++) {
+        auto& s = segs[i];
+        auto len = std::min<size_t>(1460, data.size() - offset);
+        auto ip = ip_of(s);
+        auto th = tcp_of(s);
+        BOOST_REQUIRE_EQUAL(ip.len, 20 + tcp_hdr::len + len);
+        BOOST_REQUIRE_EQUAL(ip.id, 100 + i);
+        BOOST_REQUIRE_EQUAL(th.seq.raw, 1000 + offset);
+        BOOST_REQUIRE_EQUAL(bool(th.f_psh), i == segs.size() - 1);
+        BOOST_REQUIRE(checksums_valid(s));
+        BOOST_REQUIRE(!s.get_offload_info().needs_csum);
+        BOOST_REQUIRE_EQUAL(s.get_offload_info().tso_seg_size, 0);
+        BOOST_REQUIRE(linearize(s, hdr_len) == data.substr(offset, len));
+        offset += len;
+    }
+}
+
+BOOST_AUTO_TEST_CASE(test_segment_completes_checksum) {
+    auto data = payload_of(700);
+    auto segs = segment(make_frame(data, 1000, 5000, false));
+    BOOST_REQUIRE_EQUAL(segs.size(), 1);
+    BOOST_REQUIRE(checksums_valid(segs[0]));
+    BOOST_REQUIRE(linearize(segs[0], hdr_len) == data);
+
+    // A device that checksums gets the frame as it is
+    circular_buffer<packet> out;
+    hw_features hw;
+    hw.tx_csum_l4_offload = true;
+    BOOST_REQUIRE(!needs_software_offload(make_frame(data, 1000, 5000, false).get_offload_info(), hw));
+    software_segment(make_frame(data, 1000, 5000, false), hw, out);
+    BOOST_REQUIRE_EQUAL(out.size(), 1);
+    BOOST_REQUIRE(out.front().get_offload_info().needs_csum);
+}
+
+BOOST_AUTO_TEST_CASE(test_gro_merges_segmented_frame) {
+    auto data = payload_of(5000);
+    std::vector<packet> delivered;
+    gro g(hw_features{}, [&] (packet p) { delivered.push_back(std::move(p)); });
+    for (auto& s : segment(make_frame(data, 1000, 5000, true, 1460))) {
+        g.receive(std::move(s));
+    }
+    // PSH on the last segment delivers the lot without waiting for a flush
+    BOOST_REQUIRE_EQUAL(delivered.size(), 1);
+    BOOST_REQUIRE(!g.flush());
+    auto& p = delivered[0];
+    BOOST_REQUIRE_EQUAL(ip_of(p).len, 20 + tcp_hdr::len + data.size());
+    BOOST_REQUIRE_EQUAL(tcp_of(p).seq.raw, 1000);
+    BOOST_REQUIRE(tcp_of(p).f_psh);
+    BOOST_REQUIRE(p.get_offload_info().rx_csum_verified);
+    BOOST_REQUIRE(linearize(p, hdr_len) == data);
+    checksummer csum;
+    csum.sum(p.get_header(eth_hdr_len, 20), 20);
+    BOOST_REQUIRE_EQUAL(csum.get(), 0);
+    BOOST_REQUIRE_EQUAL(g.get_stats().frames, 4);
+    BOOST_REQUIRE_EQUAL(g.get_stats().merged, 3);
+}
+
+BOOST_AUTO_TEST_CASE(test_gro_keeps_flows_apart_and_in_order) {
+    std::vector<packet> delivered;
+    gro g(hw_features{}, [&] (packet p) { delivered.push_back(std::move(p)); });
+    auto seg = [] (uint32_t index, uint16_t port) {
+        return std::move(segment(make_frame(payload_of(1000, index * 1000), 1000 + index * 1000, port, false))[0]);
+    };
+
+    // Two flows interleaved merge separately
+    g.receive(seg(0, 5000));
+    g.receive(seg(0, 5001));
+    g.receive(seg(1, 5000));
+    g.receive(seg(1, 5001));
+    BOOST_REQUIRE(delivered.empty());
+    // A gap delivers what's held before what follows it
+    g.receive(seg(3, 5000));
+    g.receive(seg(2, 5000));
+    BOOST_REQUIRE(g.flush());
+    BOOST_REQUIRE_EQUAL(delivered.size(), 4);
+    BOOST_REQUIRE_EQUAL(tcp_of(delivered[0]).src_port, 5000);
+    BOOST_REQUIRE_EQUAL(ip_of(delivered[0]).len, 40 + 2000);
+    BOOST_REQUIRE(linearize(delivered[0], hdr_len) == payload_of(2000));
+    BOOST_REQUIRE_EQUAL(tcp_of(delivered[1]).seq.raw, 4000);
+    BOOST_REQUIRE_EQUAL(tcp_of(delivered[2]).src_port, 5001);
+    BOOST_REQUIRE_EQUAL(ip_of(delivered[2]).len, 40 + 2000);
+    BOOST_REQUIRE_EQUAL(tcp_of(delivered[3]).seq.raw, 3000);
+}
+
+BOOST_AUTO_TEST_CASE(test_gro_passes_corrupted_segment_unverified) {
+    std::vector<packet> delivered;
+    gro g(hw_features{}, [&] (packet p) { delivered.push_back(std::move(p)); });
+    auto good = std::move(segment(make_frame(payload_of(1000), 1000, 5000, false))[0]);
+    auto bad = std::move(segment(make_frame(payload_of(1000, 1000), 2000, 5000, false))[0]);
+    auto data = linearize(bad);
+    data[hdr_len + 10] ^= 1;
+    packet corrupted(data.data(), data.size());
+    g.receive(std::move(good));
+    g.receive(std::move(corrupted));
+    g.flush();
+    // Left for the stack to drop
+    BOOST_REQUIRE_EQUAL(delivered.size(), 2);
+    BOOST_REQUIRE(delivered[0].get_offload_info().rx_csum_verified);
+    BOOST_REQUIRE(!delivered[1].get_offload_info().rx_csum_verified);
+    BOOST_REQUIRE_EQUAL(g.get_stats().merged, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_interface_software_offloads) {
+    auto dev = std::make_shared<fake_device>();
+    auto& q = dev->queue();
+    auto owned = std::make_unique<interface>(dev, true, true);
+    auto& iface = *owned;
+    // The device's queue lives, and keeps calling the interface, until the
+    // reactor is destroyed
+    internal::at_destroy([owned = std::move(owned)] {});
+
+    // The stack is shown the offloads GSO does for the device
+    BOOST_REQUIRE(iface.hw_features().tx_tso);
+    BOOST_REQUIRE(iface.hw_features().tx_csum_l4_offload);
+
+    // A 64KB TSO frame leaves segmented, with checksums completed
+    auto data = payload_of(ip_packet_len_max - 20 - tcp_hdr::len);
+    auto frame = make_frame(data, 1000, 5000, true, 1460);
+    frame.trim_front(eth_hdr_len);
+    auto tx = make_lw_shared<std::optional<l3_protocol::l3packet>>(
+            l3_protocol::l3packet{eth_protocol_num::ipv4, ethernet_address{1, 2, 3, 4, 5, 6}, std::move(frame)});
+    iface.register_packet_provider([tx] {
+        return std::exchange(*tx, std::nullopt);
+    });
+    const size_t nr_segments = (data.size() + 1459) / 1460;
+    for (int i = 0; i < 1000 && q.sent.size() < nr_segments; i++) {
+        yield().get();
+    }
+    BOOST_REQUIRE_EQUAL(q.sent.size(), nr_segments);
+    std::string sent_data;
+    for (auto& s : q.sent) {
+        BOOST_REQUIRE_LE(s.len(), hdr_len + 1460);
+        BOOST_REQUIRE(checksums_valid(s));
+        sent_data += linearize(s, hdr_len);
+    }
+    BOOST_REQUIRE(sent_data == data);
+
+    // Received back, the segments reach the stack merged into one
+    auto received = make_lw_shared<std::vector<packet>>();
+    (void)iface.register_l3(eth_protocol_num::ipv4, [received] (packet p, ethernet_address) {
+        received->push_back(std::move(p));
+        return make_ready_future<>();
+    }, [] (forward_hash&, packet&, size_t) { return false; });
+    for (auto& s : q.sent) {
+        dev->l2receive(std::move(s));
+    }
+    q.sent.clear();
+    for (int i = 0; i < 1000 && received->empty(); i++) {
+        yield().get();
+    }
+    BOOST_REQUIRE_EQUAL(received->size(), 1);
+    auto& p = received->front();
+    auto ip = ntoh(*p.get_header<ip_hdr>(0));
+    BOOST_REQUIRE_EQUAL(ip.len, 20 + tcp_hdr::len + data.size());
+    BOOST_REQUIRE(p.get_offload_info().rx_csum_verified);
+    BOOST_REQUIRE(linearize(p, 20 + tcp_hdr::len) == data);
+}
@@ -207,6 +207,21 @@ SEASTAR_THREAD_TEST_CASE(invoke_on_all_sharded_arg) {
     arg.stop().get();
 }
 
+SEASTAR_THREAD_TEST_CASE(invoke_on_all_single_instance) {
+    struct counter {
+        unsigned calls = 0;
+        future<> stop() { return make_ready_future<>(); }
+    };
+    seastar::sharded<counter> srv;
+    srv.start_single().get();
+    srv.invoke_on_all([] (counter& c) {
+        BOOST_REQUIRE_EQUAL(this_shard_id(), 0);
+        c.calls++;
+    }).get();
+    BOOST_REQUIRE_EQUAL(srv.local().calls, 1);
+    srv.stop().get();
+}
+
 SEASTAR_THREAD_TEST_CASE(invoke_on_modifiers) {
     class checker {
     public:
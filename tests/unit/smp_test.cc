@@ -19,10 +19,14 @@
  * Copyright (C) 2014 Cloudius Systems, Ltd.
  */
 
+#include <atomic>
+#include <chrono>
+
 #include <seastar/core/reactor.hh>
 #include <seastar/core/smp.hh>
 #include <seastar/core/app-template.hh>
 #include <seastar/core/print.hh>
+#include <seastar/core/when_all.hh>
 
 using namespace seastar;
 
@@ -58,6 +62,85 @@ future<bool> test_smp_exception() {
     });
 }
 
+future<bool> test_smp_bulk_call() {
+    std::vector<std::function<int()>> funcs;
+    for (int i = 0; i < 100; ++i) {
+        funcs.emplace_back([i] { return i * 2; });
+    }
+    auto futs = smp::bulk_submit_to(1, smp_submit_to_options{}, std::move(funcs));
+    return when_all_succeed(futs.begin(), futs.end()).then([] (std::vector<int> rets) {
+        for (int i = 0; i < 100; ++i) {
+            if (rets[i] != i * 2) {
+                return make_ready_future<bool>(false);
+            }
+        }
+        return make_ready_future<bool>(rets.size() == 100);
+    });
+}
+
+// More functions than the service group admits at once go in chunks
+future<bool> test_smp_bulk_call_over_capacity() {
+    smp_service_group_config ssgc;
+    ssgc.max_nonlocal_requests = 4 * (this_smp_shard_count() - 1);
+    return create_smp_service_group(ssgc).then([] (smp_service_group ssg) {
+        std::vector<std::function<int()>> funcs;
+        for (int i = 0; i < 10; ++i) {
+            funcs.emplace_back([i] { return i * 2; });
+        }
+        auto futs = smp::bulk_submit_to(1, smp_submit_to_options(ssg), std::move(funcs));
+        return when_all_succeed(futs.begin(), futs.end()).then([] (std::vector<int> rets) {
+            for (int i = 0; i < 10; ++i) {
+                if (rets[i] != i * 2) {
+                    return false;
+                }
+            }
+            return rets.size() == 10;
+        }).finally([ssg] {
+            return destroy_smp_service_group(ssg);
+        });
+    });
+}
+
+future<bool> test_smp_stealable() {
+    // Counts items computed away from the submitting shard. Each item spins
+    // for a while, so idle shards get a chance to steal from this one.
+    static std::atomic<unsigned> stolen;
+    stolen = 0;
+    auto origin = this_shard_id();
+    std::vector<future<int>> futs;
+    for (int i = 0; i < 100; ++i) {
+        futs.push_back(smp::submit_stealable([i, origin] {
+            auto end = std::chrono::steady_clock::now() + std::chrono::milliseconds(1);
+            while (std::chrono::steady_clock::now() < end) {
+            }
+            if (this_shard_id() != origin) {
+                stolen.fetch_add(1, std::memory_order_relaxed);
+            }
+            return i * 2;
+        }));
+    }
+    futs.push_back(smp::submit_stealable([] () -> int { throw nasty_exception(); }));
+    return when_all(futs.begin(), futs.end()).then([] (std::vector<future<int>> rets) {
+        for (int i = 0; i < 100; ++i) {
+            if (rets[i].get() != i * 2) {
+                return make_ready_future<bool>(false);
+            }
+        }
+        try {
+            rets[100].get();
+            return make_ready_future<bool>(false);
+        } catch (nasty_exception&) {
+        }
+        // Run with --enable-work-stealing; with a single shard there is
+        // nobody to steal.
+        if (this_smp_shard_count() > 1 && stolen.load(std::memory_order_relaxed) == 0) {
+            fmt::print("no stealable item ran on another shard\n");
+            return make_ready_future<bool>(false);
+        }
+        return make_ready_future<bool>(true);
+    });
+}
+
 int tests, fails;
 
 future<>
@@ -73,6 +156,12 @@ int main(int ac, char** av) {
     return app_template().run_deprecated(ac, av, [] {
        return report("smp call", test_smp_call()).then([] {
            return report("smp exception", test_smp_exception());
+       }).then([] {
+           return report("smp bulk call", test_smp_bulk_call());
+       }).then([] {
+           return report("smp bulk call over capacity", test_smp_bulk_call_over_capacity());
+       }).then([] {
+           return report("smp stealable", test_smp_stealable());
        }).then([] {
            fmt::print("\n{:d} tests / {:d} failures\n", tests, fails);
            engine().exit(fails ? 1 : 0);
@@ -568,3 +568,50 @@ SEASTAR_THREAD_TEST_CASE(inet_local_remote_address_sanity) {
     ss.wait_input_shutdown().get();
     BOOST_CHECK(ss.remote_address().is_unspecified());
 }
+
+SEASTAR_THREAD_TEST_CASE(datagram_batch_send_receive_test) {
+    // Runs of equal-sized datagrams to one receiver, which the kernel may
+    // segment and coalesce, interleaved with datagrams of other sizes and
+    // to another receiver; all must arrive one by one, intact and in order
+    auto r1 = make_bound_datagram_channel(ipv4_addr("127.0.0.1", 0));
+    auto r2 = make_bound_datagram_channel(ipv4_addr("127.0.0.1", 0));
+    auto sender = make_unbound_datagram_channel(AF_INET);
+
+    std::vector<std::pair<unsigned, size_t>> to_r1, to_r2;
+    std::vector<net::outgoing_datagram> batch;
+    auto add = [&] (unsigned index, size_t size, bool second) {
+        temporary_buffer<char> buf(size);
+        std::fill_n(buf.get_write(), size, char(index));
+        std::memcpy(buf.get_write(), &index, sizeof(index));
+        batch.push_back(net::outgoing_datagram{second ? r2.local_address() : r1.local_address(), std::move(buf)});
+        (second ? to_r2 : to_r1).emplace_back(index, size);
+    };
+    unsigned index = 0;
+    for (unsigned i = 0; i < 40; i++) {
+        add(index++, 1200, false);
+    }
+    add(index++, 700, false);
+    for (unsigned i = 0; i < 50; i++) {
+        add(index++, 100 + i, i % 2);
+    }
+    sender.send(batch).get();
+
+    auto check = [] (net::datagram_channel& chan, const std::vector<std::pair<unsigned, size_t>>& expected) {
+        for (auto [index, size] : expected) {
+            auto d = chan.receive().get();
+            auto bufs = d.get_buffers();
+            BOOST_REQUIRE_EQUAL(bufs.size(), 1);
+            BOOST_REQUIRE_EQUAL(bufs[0].size(), size);
+            unsigned received_index;
+            std::memcpy(&received_index, bufs[0].get(), sizeof(received_index));
+            BOOST_REQUIRE_EQUAL(received_index, index);
+            BOOST_REQUIRE_EQUAL(bufs[0][size - 1], char(index));
+            BOOST_REQUIRE_EQUAL(d.get_dst_port(), chan.local_address().port());
+        }
+    };
+    check(r1, to_r1);
+    check(r2, to_r2);
+    r1.close();
+    r2.close();
+    sender.close();
+}
@@ -0,0 +1,226 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#define BOOST_TEST_MODULE core
+
+#include <boost/test/unit_test.hpp>
+#include <seastar/net/tcp-congestion.hh>
+#include <algorithm>
+#include <stdexcept>
+
+using namespace seastar;
+using namespace net;
+using namespace std::chrono_literals;
+
+using clock_type = tcp_congestion_control::clock_type;
+
+static constexpr uint16_t mss = 1000;
+
+// Acknowledges \c in_flight bytes one segment at a time, spread over an
+// RTT; each ACK also carries a delivery rate of in_flight per RTT
+static void ack_round(tcp_congestion_control& cc, tcp_congestion_window& w, clock_type::time_point& now,
+        uint64_t& delivered, uint32_t in_flight, std::chrono::microseconds rtt, bool app_limited = false) {
+    auto segments = std::max(in_flight / mss, 1u);
+    for (unsigned i = 0; i < segments; i++) {
+        now += rtt / segments;
+        delivered += mss;
+        cc.on_ack(w, tcp_congestion_control::ack_sample{
+            .acked_bytes = mss,
+            .mss = mss,
+            .in_flight = in_flight - (i + 1) * mss,
+            .rtt = rtt,
+            .delivered = delivered,
+            .prior_delivered = delivered - in_flight,
+            .interval = rtt,
+            .app_limited = app_limited,
+            .in_recovery = false,
+            .now = now,
+        });
+    }
+}
+
+// A loss ends up with the window at ssthresh, once fast recovery is over
+static void lose_one(tcp_congestion_control& cc, tcp_congestion_window& w, clock_type::time_point now) {
+    auto flight = w.cwnd;
+    cc.on_loss(w, mss, flight, now);
+    w.cwnd = w.ssthresh + 3 * mss;
+    cc.on_recovery_exit(w, mss, flight);
+}
+
+BOOST_AUTO_TEST_CASE(test_algorithm_names) {
+    for (auto algo : { tcp_congestion_algorithm::reno, tcp_congestion_algorithm::cubic, tcp_congestion_algorithm::bbr }) {
+        BOOST_REQUIRE(parse_tcp_congestion_algorithm(tcp_congestion_algorithm_name(algo)) == algo);
+        BOOST_REQUIRE(make_tcp_congestion_control(algo)->algorithm() == algo);
+    }
+    BOOST_REQUIRE_THROW(parse_tcp_congestion_algorithm("vegas"), std::invalid_argument);
+}
+
+BOOST_AUTO_TEST_CASE(test_reno) {
+    auto cc = make_tcp_congestion_control(tcp_congestion_algorithm::reno);
+    tcp_congestion_window w{ .cwnd = 100 * mss, .ssthresh = 50 * mss };
+    auto now = clock_type::time_point(1s);
+    uint64_t delivered = 0;
+
+    // About one segment per RTT in congestion avoidance
+    ack_round(*cc, w, now, delivered, w.cwnd, 10ms);
+    BOOST_REQUIRE_GT(w.cwnd, 100 * mss + mss / 2);
+    BOOST_REQUIRE_LE(w.cwnd, 101 * mss);
+
+    auto before = w.cwnd;
+    lose_one(*cc, w, now);
+    BOOST_REQUIRE_EQUAL(w.ssthresh, before / 2);
+    BOOST_REQUIRE_EQUAL(w.cwnd, w.ssthresh);
+
+    cc->on_timeout(w, mss, w.cwnd, true);
+    BOOST_REQUIRE_EQUAL(w.cwnd, mss);
+    BOOST_REQUIRE_EQUAL(w.ssthresh, before / 4);
+
+    // Slow start doubles the window every RTT
+    ack_round(*cc, w, now, delivered, w.cwnd, 10ms);
+    BOOST_REQUIRE_EQUAL(w.cwnd, 2 * mss);
+}
+
+BOOST_AUTO_TEST_CASE(test_cubic_recovers_from_loss) {
+    auto cubic = make_tcp_congestion_control(tcp_congestion_algorithm::cubic);
+    auto reno = make_tcp_congestion_control(tcp_congestion_algorithm::reno);
+    constexpr uint32_t w_max = 1000 * mss;
+    tcp_congestion_window wc{ .cwnd = w_max, .ssthresh = w_max };
+    tcp_congestion_window wr = wc;
+    auto now = clock_type::time_point(1s);
+    uint64_t delivered = 0;
+
+    lose_one(*cubic, wc, now);
+    lose_one(*reno, wr, now);
+    BOOST_REQUIRE_EQUAL(wc.cwnd, w_max * 7 / 10);
+    BOOST_REQUIRE_EQUAL(wr.cwnd, w_max / 2);
+
+    // With a 100ms RTT, CUBIC gets back to the window it lost at after
+    // K = cbrt(300 / 0.4) = 9.1 seconds, while Reno regains one segment
+    // per round trip
+    auto tc = now;
+    auto tr = now;
+    for (int i = 0; i < 80; i++) {
+        ack_round(*cubic, wc, tc, delivered, wc.cwnd, 100ms);
+        ack_round(*reno, wr, tr, delivered, wr.cwnd, 100ms);
+    }
+    BOOST_REQUIRE_GT(wc.cwnd, w_max * 9 / 10);
+    BOOST_REQUIRE_LT(wc.cwnd, w_max);
+    BOOST_REQUIRE_LT(wr.cwnd, w_max / 2 + 80 * mss);
+
+    // It then plateaus around the old maximum before probing further
+    for (int i = 0; i < 20; i++) {
+        ack_round(*cubic, wc, tc, delivered, wc.cwnd, 100ms);
+    }
+    BOOST_REQUIRE_GT(wc.cwnd, w_max);
+    BOOST_REQUIRE_LT(wc.cwnd, w_max * 11 / 10);
+
+    // A second loss before regaining the maximum lowers it, leaving room
+    // for other flows (fast convergence)
+    lose_one(*cubic, wc, tc);
+    auto before = wc.cwnd;
+    lose_one(*cubic, wc, tc);
+    BOOST_REQUIRE_EQUAL(wc.cwnd, uint32_t(before * 7 / 10));
+}
+
+BOOST_AUTO_TEST_CASE(test_bbr_models_the_path) {
+    auto cc = make_tcp_congestion_control(tcp_congestion_algorithm::bbr);
+    BOOST_REQUIRE(cc->needs_pacing());
+
+    constexpr double bandwidth = 10e6;  // bytes per second
+    constexpr auto min_rtt = 20ms;
+    constexpr double bdp = bandwidth * 0.02;
+    tcp_congestion_window w{ .cwnd = 10 * mss, .ssthresh = 10 * mss };
+    auto now = clock_type::time_point(1s);
+    uint64_t delivered = 0;
+
+    // The sender keeps as much in flight as both the window and the pacing
+    // rate allow; beyond the BDP it only builds a queue and the RTT grows
+    for (int i = 0; i < 60; i++) {
+        double in_flight = w.cwnd;
+        if (auto rate = cc->pacing_rate(w, min_rtt)) {
+            in_flight = std::min(in_flight, rate * 0.02 + mss);
+        }
+        auto rtt = std::max<std::chrono::microseconds>(min_rtt, std::chrono::microseconds(uint64_t(in_flight / bandwidth * 1e6)));
+        ack_round(*cc, w, now, delivered, in_flight, rtt);
+    }
+    auto rate = cc->pacing_rate(w, min_rtt);
+    BOOST_REQUIRE_GT(rate, bandwidth * 0.7);
+    BOOST_REQUIRE_LT(rate, bandwidth * 1.3);
+    BOOST_REQUIRE_GE(w.cwnd, bdp);
+    BOOST_REQUIRE_LE(w.cwnd, 2.1 * bdp + 3 * mss);
+
+    // An isolated loss doesn't shrink the window past recovery
+    auto before = w.cwnd;
+    lose_one(*cc, w, now);
+    BOOST_REQUIRE_GE(w.cwnd, before);
+
+    // After a timeout the window regrows up to the model's, not from
+    // slow start
+    cc->on_timeout(w, mss, w.cwnd, true);
+    BOOST_REQUIRE_EQUAL(w.cwnd, mss);
+    ack_round(*cc, w, now, delivered, before, min_rtt);
+    BOOST_REQUIRE_GE(w.cwnd, bdp);
+}
+
+BOOST_AUTO_TEST_CASE(test_bbr_ignores_app_limited_samples) {
+    auto cc = make_tcp_congestion_control(tcp_congestion_algorithm::bbr);
+
+    constexpr double bandwidth = 10e6;  // bytes per second
+    constexpr auto min_rtt = 20ms;
+    tcp_congestion_window w{ .cwnd = 10 * mss, .ssthresh = 10 * mss };
+    auto now = clock_type::time_point(1s);
+    uint64_t delivered = 0;
+
+    for (int i = 0; i < 60; i++) {
+        double in_flight = w.cwnd;
+        if (auto rate = cc->pacing_rate(w, min_rtt)) {
+            in_flight = std::min(in_flight, rate * 0.02 + mss);
+        }
+        auto rtt = std::max<std::chrono::microseconds>(min_rtt, std::chrono::microseconds(uint64_t(in_flight / bandwidth * 1e6)));
+        ack_round(*cc, w, now, delivered, in_flight, rtt);
+    }
+    BOOST_REQUIRE_GT(cc->pacing_rate(w, min_rtt), bandwidth * 0.7);
+
+    // The application then only sends a tenth of what the path carries, for
+    // longer than the bandwidth filter's window; its slow samples mustn't
+    // age the path's bandwidth out of the model
+    for (int i = 0; i < 20; i++) {
+        ack_round(*cc, w, now, delivered, bandwidth * 0.002, min_rtt, true);
+    }
+    BOOST_REQUIRE_GT(cc->pacing_rate(w, min_rtt), bandwidth * 0.5);
+
+    // Unless they are faster than the model
+    for (int i = 0; i < 20; i++) {
+        ack_round(*cc, w, now, delivered, 2 * bandwidth * 0.02, min_rtt, true);
+    }
+    BOOST_REQUIRE_GT(cc->pacing_rate(w, min_rtt), bandwidth * 1.4);
+}
+
+BOOST_AUTO_TEST_CASE(test_default_pacing_rate) {
+    auto cc = make_tcp_congestion_control(tcp_congestion_algorithm::cubic);
+    BOOST_REQUIRE(!cc->needs_pacing());
+    tcp_congestion_window w{ .cwnd = 10 * mss, .ssthresh = 100 * mss };
+    BOOST_REQUIRE_EQUAL(cc->pacing_rate(w, 0us), 0);
+    // Twice the window per RTT in slow start
+    BOOST_REQUIRE_EQUAL(cc->pacing_rate(w, 10ms), 2000000);
+    w.ssthresh = w.cwnd;
+    BOOST_REQUIRE_EQUAL(cc->pacing_rate(w, 10ms), 1200000);
+}
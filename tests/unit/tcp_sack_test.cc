@@ -0,0 +1,272 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/loop.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/tcp.hh>
+#include <seastar/util/later.hh>
+#include <deque>
+#include <functional>
+#include <map>
+#include <optional>
+#include <vector>
+
+#include "tcp_test_stack.hh"
+
+using namespace seastar;
+using namespace net;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr uint16_t server_port = 10000;
+constexpr uint32_t mss = 1460;
+
+// Carries segments from a client to a server on the same tcp<> and back,
+// each way taking a fixed delay, 10ms unless given. The client's data segments are dropped as
+// a script decides, given the segment's index in the stream and how many
+// times it was sent before.
+class lossy_loopback : public tcp_test_stack {
+    using clock_type = std::chrono::steady_clock;
+    struct segment {
+        packet p;
+        clock_type::time_point arrival;
+    };
+    using drop_script = std::function<bool (uint32_t index, unsigned transmission)>;
+
+    drop_script _drop;
+    clock_type::duration _delay;
+    std::deque<segment> _wire;
+    std::optional<net::tcp_seq> _isn;
+    std::map<uint32_t, unsigned> _transmissions;
+    bool _sack_seen = false;
+
+    void transmit(packet p, clock_type::time_point now) {
+        auto th = tcp_hdr::read(p.get_header(0, tcp_hdr::len));
+        auto payload = p.len() - th.data_offset * 4;
+        if (th.dst_port == server_port && th.f_syn) {
+            _isn = th.seq;
+        } else if (th.dst_port == server_port && payload) {
+            auto index = uint32_t(th.seq - *_isn - 1) / mss;
+            if (_drop(index, _transmissions[index]++)) {
+                return;
+            }
+        } else if (th.src_port == server_port && !th.f_syn && th.data_offset * 4 > tcp_hdr::len) {
+            _sack_seen = true;
+        }
+        _wire.push_back(segment{std::move(p), now + _delay});
+    }
+
+    virtual void poll() override {
+        auto now = clock_type::now();
+        while (!_wire.empty() && _wire.front().arrival <= now) {
+            auto p = std::move(_wire.front().p);
+            _wire.pop_front();
+            deliver(std::move(p));
+        }
+        while (auto l4p = next_segment()) {
+            transmit(std::move(l4p->p), now);
+        }
+    }
+
+public:
+    explicit lossy_loopback(drop_script drop, clock_type::duration delay = 10ms)
+        : _drop(std::move(drop))
+        , _delay(delay)
+    {
+        start();
+    }
+
+    ~lossy_loopback() {
+        stop().get();
+    }
+
+    // Sends nr_segments full segments to the server, checks they arrive
+    // intact, and returns how long that took. The client connection is
+    // shown to inspect before it's closed.
+    clock_type::duration transfer(uint32_t nr_segments, std::function<void (tcp<tcp_test_traits>::connection&)> setup = {},
+            std::function<void (tcp<tcp_test_traits>::connection&)> inspect = {}) {
+        auto listener = _tcp.listen(server_port);
+        auto client = _tcp.connect(socket_address(ipv4_addr(tcp_test_ip::address, server_port)));
+        auto server = listener.accept().get();
+        client.connected().get();
+        if (setup) {
+            setup(client);
+        }
+
+        std::vector<temporary_buffer<char>> bufs;
+        for (uint32_t i = 0; i < nr_segments; i++) {
+            temporary_buffer<char> buf(mss);
+            std::fill_n(buf.get_write(), buf.size(), char('a' + i % 26));
+            bufs.push_back(std::move(buf));
+        }
+
+        auto start = clock_type::now();
+        client.send(bufs).get();
+        sstring received;
+        while (received.size() < nr_segments * mss) {
+            server.wait_for_data().get();
+            auto p = server.read();
+            BOOST_REQUIRE(p.len());
+            for (auto& f : p.fragments()) {
+                received.append(f.base, f.size);
+            }
+        }
+        auto elapsed = clock_type::now() - start;
+        for (uint32_t i = 0; i < nr_segments; i++) {
+            BOOST_REQUIRE_EQUAL(received[i * mss], char('a' + i % 26));
+            BOOST_REQUIRE_EQUAL(received[i * mss + mss - 1], char('a' + i % 26));
+        }
+        if (inspect) {
+            inspect(client);
+        }
+
+        client.close_write();
+        server.wait_for_data().get();
+        server.close_write();
+        client.wait_input_shutdown().get();
+        // Let the last ACK reach the server
+        sleep(50ms).get();
+        return elapsed;
+    }
+
+    unsigned transmissions(uint32_t index) const {
+        auto it = _transmissions.find(index);
+        return it == _transmissions.end() ? 0 : it->second;
+    }
+
+    // Transmissions beyond the first of each segment
+    unsigned retransmissions() const {
+        unsigned n = 0;
+        for (auto& [index, nr] : _transmissions) {
+            n += nr - 1;
+        }
+        return n;
+    }
+
+    bool sack_seen() const noexcept { return _sack_seen; }
+};
+
+// The retransmission timeout is never below a second
+constexpr auto rto_min = 1s;
+
+}
+
+BOOST_AUTO_TEST_CASE(test_sack_option_encoding) {
+    tcp_option local;
+    local._local_mss = mss;
+    tcp_hdr syn{};
+    syn.f_syn = true;
+    char buf[tcp_hdr::len + 40];
+
+    // SACK is offered on SYNs
+    auto size = local.get_size(true, false);
+    BOOST_REQUIRE_EQUAL(local.fill(buf, &syn, size), size);
+    tcp_option remote;
+    remote.parse(reinterpret_cast<uint8_t*>(buf) + tcp_hdr::len, reinterpret_cast<uint8_t*>(buf) + tcp_hdr::len + size);
+    BOOST_REQUIRE(remote._sack_received);
+    BOOST_REQUIRE_EQUAL(remote._remote_mss, mss);
+
+    // Blocks, including one across the wrap of the sequence space, survive
+    // the trip
+    tcp_hdr ack{};
+    ack.f_ack = true;
+    local._local_sack_blocks[0] = { make_seq(1000), make_seq(2460) };
+    local._local_sack_blocks[1] = { make_seq(0xfffffff0), make_seq(0x10) };
+    local._local_sack_blocks[2] = { make_seq(5000), make_seq(9000) };
+    local._nr_local_sack_blocks = 3;
+    size = local.get_size(false, true);
+    BOOST_REQUIRE_EQUAL(size, 28);
+    BOOST_REQUIRE_EQUAL(local.fill(buf, &ack, size), size);
+    remote.parse(reinterpret_cast<uint8_t*>(buf) + tcp_hdr::len, reinterpret_cast<uint8_t*>(buf) + tcp_hdr::len + size);
+    BOOST_REQUIRE_EQUAL(remote._nr_remote_sack_blocks, 3);
+    for (unsigned i = 0; i < 3; i++) {
+        BOOST_REQUIRE_EQUAL(remote._remote_sack_blocks[i].left, local._local_sack_blocks[i].left);
+        BOOST_REQUIRE_EQUAL(remote._remote_sack_blocks[i].right, local._local_sack_blocks[i].right);
+    }
+
+    // A segment without the option carries no blocks
+    remote.parse(nullptr, nullptr);
+    BOOST_REQUIRE_EQUAL(remote._nr_remote_sack_blocks, 0);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_sack_repairs_multiple_losses) {
+    lossy_loopback link([] (uint32_t index, unsigned transmission) {
+        return transmission == 0 && (index == 10 || index == 12 || index == 14);
+    });
+    auto elapsed = link.transfer(60);
+    BOOST_REQUIRE(link.sack_seen());
+    // Each lost segment is resent once, all in the same recovery and well
+    // before a retransmission timeout
+    BOOST_REQUIRE_EQUAL(link.transmissions(10), 2);
+    BOOST_REQUIRE_EQUAL(link.transmissions(12), 2);
+    BOOST_REQUIRE_EQUAL(link.transmissions(14), 2);
+    BOOST_REQUIRE_EQUAL(link.transmissions(11), 1);
+    BOOST_REQUIRE_EQUAL(link.transmissions(13), 1);
+    // Allow for a spurious tail loss probe
+    BOOST_REQUIRE_LE(link.retransmissions(), 4);
+    BOOST_REQUIRE_LT(elapsed, rto_min);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_rack_detects_lost_retransmission) {
+    // The retransmission is lost too; RACK sees segments sent after it
+    // being delivered and resends it again
+    lossy_loopback link([] (uint32_t index, unsigned transmission) {
+        return index == 10 && transmission < 2;
+    });
+    auto elapsed = link.transfer(60);
+    BOOST_REQUIRE_EQUAL(link.transmissions(10), 3);
+    BOOST_REQUIRE_LE(link.retransmissions(), 3);
+    BOOST_REQUIRE_LT(elapsed, rto_min);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_tail_loss_probe) {
+    // Nothing follows the lost tail to be SACKed; the probe is what
+    // reveals it
+    lossy_loopback link([] (uint32_t index, unsigned transmission) {
+        return transmission == 0 && (index == 18 || index == 19);
+    });
+    auto elapsed = link.transfer(20);
+    BOOST_REQUIRE_EQUAL(link.transmissions(18), 2);
+    BOOST_REQUIRE_EQUAL(link.transmissions(19), 2);
+    BOOST_REQUIRE_LT(elapsed, rto_min);
+}
+
+SEASTAR_THREAD_TEST_CASE(test_rtt_sampled_below_lowres_tick) {
+    // A 2ms RTT is below the lowres clock's 10ms tick, yet must be measured,
+    // and give BBR a delivery rate to pace at
+    lossy_loopback link([] (uint32_t, unsigned) { return false; }, 1ms);
+    std::chrono::microseconds srtt{};
+    uint64_t pacing_rate = 0;
+    link.transfer(200, [] (auto& client) {
+        client.set_congestion_control(tcp_congestion_algorithm::bbr);
+    }, [&] (auto& client) {
+        srtt = client.smoothed_rtt();
+        pacing_rate = client.pacing_rate();
+    });
+    BOOST_TEST_MESSAGE(fmt::format("srtt {}us, pacing at {} bytes/s", srtt.count(), pacing_rate));
+    BOOST_REQUIRE_GE(srtt, 2ms);
+    BOOST_REQUIRE_LT(srtt, 1s);
+    BOOST_REQUIRE_GT(pacing_rate, 0);
+}
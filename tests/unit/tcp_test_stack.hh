@@ -0,0 +1,127 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#pragma once
+
+#include <seastar/core/loop.hh>
+#include <seastar/net/tcp.hh>
+#include <seastar/util/later.hh>
+#include <optional>
+
+namespace seastar {
+
+// Stand-ins for the IP layer under net::tcp<>: a single host whose
+// segments, instead of leaving through a device, are carried back to it
+// by a tcp_test_stack.
+struct tcp_test_interface {
+    unsigned hash2cpu(uint32_t) const noexcept { return this_shard_id(); }
+    rss_key_type rss_key() const noexcept { return default_rsskey_40bytes; }
+};
+
+// Segments carried in memory aren't corrupted, so by default the stack
+// is shown a device that checksums them
+inline net::hw_features tcp_test_checksum_offloads() {
+    net::hw_features features;
+    features.tx_csum_l4_offload = true;
+    features.rx_csum_offload = true;
+    return features;
+}
+
+struct tcp_test_ip {
+    static constexpr uint32_t address = 0x0a000001;
+    net::hw_features features;
+    tcp_test_interface interface;
+
+    explicit tcp_test_ip(const net::hw_features& f) : features(f) {}
+    net::ipv4_address host_address() const noexcept { return net::ipv4_address(address); }
+    const net::hw_features& hw_features() const noexcept { return features; }
+    tcp_test_interface* netif() noexcept { return &interface; }
+};
+
+struct tcp_test_l4 {
+    tcp_test_ip _inet;
+    net::ipv4_traits::packet_provider_type provider;
+
+    explicit tcp_test_l4(const net::hw_features& f) : _inet(f) {}
+    void register_packet_provider(net::ipv4_traits::packet_provider_type func) {
+        provider = std::move(func);
+    }
+    future<net::ethernet_address> get_l2_dst_address(net::ipv4_address) {
+        return make_ready_future<net::ethernet_address>();
+    }
+};
+
+struct tcp_test_traits {
+    using address_type = net::ipv4_address;
+    using inet_type = tcp_test_l4;
+    using l4packet = net::ipv4_traits::l4packet;
+    using packet_provider_type = net::ipv4_traits::packet_provider_type;
+    static void tcp_pseudo_header_checksum(net::checksummer& csum, net::ipv4_address src, net::ipv4_address dst, uint16_t len) {
+        net::ipv4_traits::tcp_pseudo_header_checksum(csum, src, dst, len);
+    }
+    static constexpr uint8_t ip_hdr_len_min = net::ipv4_traits::ip_hdr_len_min;
+};
+
+// A net::tcp<> on a single host, polled from a fiber until stopped. On
+// each poll, subclasses take the segments the stack sends with
+// next_segment() and hand them back, when and if they arrive, with
+// deliver().
+class tcp_test_stack {
+protected:
+    tcp_test_l4 _l4;
+    net::tcp<tcp_test_traits> _tcp;
+private:
+    bool _stopped = false;
+    future<> _done = make_ready_future<>();
+protected:
+    explicit tcp_test_stack(const net::hw_features& features = tcp_test_checksum_offloads())
+        : _l4(features)
+        , _tcp(_l4)
+    {}
+
+    // To be called by the subclass' constructor, once poll() can run
+    void start() {
+        _done = do_until([this] { return _stopped; }, [this] {
+            poll();
+            return yield();
+        });
+    }
+
+    virtual void poll() = 0;
+
+    std::optional<net::ipv4_traits::l4packet> next_segment() {
+        return _l4.provider();
+    }
+
+    void deliver(net::packet p) {
+        auto addr = _l4._inet.host_address();
+        _tcp.received(std::move(p), addr, addr);
+    }
+public:
+    virtual ~tcp_test_stack() = default;
+
+    future<> stop() {
+        _stopped = true;
+        return std::move(_done);
+    }
+};
+
+}
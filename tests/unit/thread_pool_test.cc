@@ -0,0 +1,70 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/core/coroutine.hh>
+#include <seastar/core/posix.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/util/later.hh>
+
+#include "core/thread_pool.hh"
+
+#include <chrono>
+#include <thread>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+// Runs two calls that each block for `nap` on a pool of `nr_threads`
+// syscall threads (as with --syscall-threads), and returns how long the
+// pair took.
+static future<std::chrono::steady_clock::duration> time_two_sleeps(unsigned nr_threads, std::chrono::milliseconds nap) {
+    auto notify = file_desc::eventfd(0, EFD_CLOEXEC);
+    thread_pool pool("test-syscall", notify, nr_threads);
+    auto sleeper = [&pool, nap] {
+        return pool.submit<int>(internal::thread_pool_submit_reason::file_operation, [nap] {
+            std::this_thread::sleep_for(nap);
+            return 0;
+        });
+    };
+    auto start = std::chrono::steady_clock::now();
+    auto both = when_all_succeed(sleeper(), sleeper());
+    // Nobody else polls this pool for completions, so do it here.
+    while (!both.available()) {
+        pool.complete();
+        co_await yield();
+    }
+    co_await std::move(both);
+    co_return std::chrono::steady_clock::now() - start;
+}
+
+SEASTAR_TEST_CASE(test_syscall_threads_run_calls_in_parallel) {
+    constexpr auto nap = 200ms;
+    auto elapsed = co_await time_two_sleeps(2, nap);
+    BOOST_REQUIRE_GE(elapsed, nap);
+    BOOST_REQUIRE_LT(elapsed, nap * 3 / 2);
+}
+
+SEASTAR_TEST_CASE(test_single_syscall_thread_serializes_calls) {
+    constexpr auto nap = 200ms;
+    auto elapsed = co_await time_two_sleeps(1, nap);
+    BOOST_REQUIRE_GE(elapsed, nap * 2);
+}
@@ -22,6 +22,7 @@
 
 #include <ranges>
 #include <iostream>
+#include <fstream>
 
 #include <seastar/core/do_with.hh>
 #include <seastar/core/sstring.hh>
@@ -35,6 +36,7 @@
 #include <seastar/core/iostream.hh>
 #include <seastar/core/when_all.hh>
 #include <seastar/core/with_timeout.hh>
+#include <seastar/core/metrics_api.hh>
 #include <seastar/util/std-compat.hh>
 #include <seastar/util/process.hh>
 #include <seastar/net/tls.hh>
@@ -2135,9 +2137,16 @@ SEASTAR_THREAD_TEST_CASE(test_send_recv_alloc_limits) {
     }
 }
 
-static std::pair<connected_socket, connected_socket> tls_socketpair() {
+static std::pair<connected_socket, connected_socket> tls_socketpair(bool kernel_tls = false,
+        std::optional<tls::tls_version> min_version = std::nullopt) {
     auto certs = ::make_shared<tls::server_credentials>(::make_shared<tls::dh_params>());
     certs->set_x509_key_file(certfile("test.crt"), certfile("test.key"), tls::x509_crt_format::PEM).get();
+    if (kernel_tls) {
+        certs->enable_kernel_tls();
+    }
+    if (min_version) {
+        certs->set_minimum_tls_version(*min_version);
+    }
 
     ::listen_options opts;
     opts.reuse_address = true;
@@ -2145,6 +2154,9 @@ static std::pair<connected_socket, connected_socket> tls_socketpair() {
     auto ss = tls::listen(certs, addr, opts);
     tls::credentials_builder b;
     b.set_x509_trust_file(certfile("catest.pem"), tls::x509_crt_format::PEM).get();
+    if (kernel_tls) {
+        b.enable_kernel_tls();
+    }
 
     auto cf = tls::connect(b.build_certificate_credentials(), addr);
     auto ar = ss.accept().get();
@@ -2246,3 +2258,129 @@ SEASTAR_THREAD_TEST_CASE(test_send_two_large) {
 
     seastar::when_all(std::move(sender), std::move(receiver)).discard_result().get();
 }
+
+// Whether the kernel has the "tls" upper layer protocol loaded
+static bool kernel_tls_available() {
+    std::ifstream ulps("/proc/sys/net/ipv4/tcp_available_ulp");
+    std::string ulp;
+    while (ulps >> ulp) {
+        if (ulp == "tls") {
+            return true;
+        }
+    }
+    return false;
+}
+
+// Value of the tls_ktls_tx_sessions counter of this shard; it only exists
+// once a session asked for kernel TLS
+static uint64_t ktls_tx_sessions() {
+    const auto& values = seastar::metrics::impl::get_value_map();
+    auto mf = values.find("tls_ktls_tx_sessions");
+    if (mf == values.end() || mf->second.empty()) {
+        return 0;
+    }
+    return mf->second.begin()->second->get_function()().ui();
+}
+
+SEASTAR_THREAD_TEST_CASE(test_kernel_tls_echo) {
+    // Both ends ask for kernel TLS transmit offload. Whether or not the
+    // running kernel provides it, the data must make it across intact,
+    // and the close_notify must be seen as a clean EOF.
+    auto offloaded_before = ktls_tx_sessions();
+    auto p = tls_socketpair(true);
+
+    constexpr size_t total_size = 4 * 1024 * 1024 + 17;
+
+    std::default_random_engine random_engine(4711);
+    auto dist = std::uniform_int_distribution<char>();
+
+    auto expected_data = temporary_buffer<char>(total_size);
+    std::generate(expected_data.get_write(), expected_data.get_write() + total_size,
+                  [&] { return dist(random_engine); });
+
+    auto server = seastar::async([s = std::move(p.first)] () mutable {
+        auto in = s.input();
+        auto out = s.output();
+        while (true) {
+            auto buf = in.read().get();
+            if (buf.empty()) {
+                break;
+            }
+            out.write(std::move(buf)).get();
+            out.flush().get();
+        }
+        out.close().get();
+        in.close().get();
+    });
+
+    auto client = seastar::async([c = std::move(p.second), expected = expected_data.share(), total_size] () mutable {
+        auto in = c.input();
+        auto out = c.output();
+        auto writer = out.write(expected.get(), expected.size()).then([&out] {
+            return out.flush();
+        }).then([&out] {
+            return out.close();
+        });
+        temporary_buffer<char> received_data(total_size);
+        size_t bytes_received = 0;
+        while (true) {
+            auto buf = in.read().get();
+            if (buf.empty()) {
+                break;
+            }
+            BOOST_REQUIRE_LE(bytes_received + buf.size(), total_size);
+            std::copy_n(buf.get(), buf.size(), received_data.get_write() + bytes_received);
+            bytes_received += buf.size();
+        }
+        writer.get();
+        BOOST_CHECK_EQUAL(bytes_received, total_size);
+        BOOST_CHECK(std::equal(expected.get(), expected.get() + total_size, received_data.get()));
+        in.close().get();
+    });
+
+    seastar::when_all(std::move(server), std::move(client)).discard_result().get();
+
+    // Only counted once the kernel accepted the keys
+    if (kernel_tls_available()) {
+        BOOST_REQUIRE_GT(ktls_tx_sessions(), offloaded_before);
+    }
+}
+
+SEASTAR_THREAD_TEST_CASE(test_kernel_tls_data_after_session_tickets) {
+    // A TLS 1.3 server sends its NewSessionTicket messages after the
+    // handshake, through the kernel as handshake records. Application
+    // data written after them must still go out as application data.
+    auto p = tls_socketpair(true, tls::tls_version::tlsv1_3);
+
+    constexpr int rounds = 16;
+    const sstring msg = "after the session tickets";
+
+    auto server = seastar::async([s = std::move(p.first), &msg] () mutable {
+        auto in = s.input();
+        auto out = s.output();
+        for (int i = 0; i < rounds; ++i) {
+            out.write(msg).get();
+            out.flush().get();
+            auto buf = in.read_exactly(msg.size()).get();
+            BOOST_REQUIRE_EQUAL(std::string_view(buf.get(), buf.size()), msg);
+        }
+        out.close().get();
+        in.close().get();
+    });
+
+    auto client = seastar::async([c = std::move(p.second), &msg] () mutable {
+        auto in = c.input();
+        auto out = c.output();
+        for (int i = 0; i < rounds; ++i) {
+            auto buf = in.read_exactly(msg.size()).get();
+            BOOST_REQUIRE_EQUAL(std::string_view(buf.get(), buf.size()), msg);
+            out.write(msg).get();
+            out.flush().get();
+        }
+        BOOST_REQUIRE(in.read().get().empty());
+        out.close().get();
+        in.close().get();
+    });
+
+    seastar::when_all(std::move(server), std::move(client)).discard_result().get();
+}
@@ -0,0 +1,185 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+#include <seastar/core/reactor.hh>
+#include <seastar/core/seastar.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/core/when_all.hh>
+#include <seastar/net/api.hh>
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+
+using namespace seastar;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr size_t payload_size = 256 * 1024;
+
+temporary_buffer<char> make_payload() {
+    temporary_buffer<char> payload(payload_size);
+    for (size_t pos = 0; pos < payload_size; ++pos) {
+        payload.get_write()[pos] = char(pos % 251);
+    }
+    return payload;
+}
+
+void send_payload(const server_socket& ss, const temporary_buffer<char>& payload) {
+    connected_socket socket = connect(ss.local_address()).get();
+    auto out = socket.output();
+    out.write(payload.get(), payload.size()).get();
+    out.close().get();
+}
+
+bool multishot_enabled() {
+    return engine().get_backend_name() == "io_uring" && engine().get_io_stats().uring_multishot_accepts;
+}
+
+}
+
+// Runs with a tiny provided buffer ring (see CMakeLists.txt), so that holding
+// on to received buffers exhausts it and receives have to fall back.
+SEASTAR_THREAD_TEST_CASE(multishot_accept_and_recv_test) {
+    static constexpr unsigned connections = 8;
+
+    listen_options lo;
+    lo.reuse_address = true;
+    server_socket ss = seastar::listen(ipv4_addr(0), lo);
+    const auto before = engine().get_io_stats();
+
+    unsigned accepted = 0;
+    auto server = seastar::async([&] {
+        for (unsigned i = 0; i < connections; ++i) {
+            accept_result acc = ss.accept().get();
+            ++accepted;
+            auto in = acc.connection.input();
+            // Keep every buffer alive until the end of the stream
+            std::vector<temporary_buffer<char>> received;
+            size_t total = 0;
+            while (auto buf = in.read().get()) {
+                total += buf.size();
+                received.push_back(std::move(buf));
+            }
+            BOOST_REQUIRE_EQUAL(total, payload_size);
+            size_t pos = 0;
+            for (auto& buf : received) {
+                for (auto c : buf) {
+                    BOOST_REQUIRE_EQUAL(c, char(pos++ % 251));
+                }
+            }
+            in.close().get();
+        }
+    });
+
+    auto client = seastar::async([&] {
+        auto payload = make_payload();
+        for (unsigned i = 0; i < connections; ++i) {
+            send_payload(ss, payload);
+        }
+    });
+
+    when_all(std::move(server), std::move(client)).get();
+    BOOST_REQUIRE_EQUAL(accepted, connections);
+
+    const auto& stats = engine().get_io_stats();
+    BOOST_TEST_MESSAGE(fmt::format("backend {}: {} multishot accepts, {} multishot recvs, ring exhausted {} times, {} fallback recvs",
+            engine().get_backend_name(), stats.uring_multishot_accepts, stats.uring_multishot_recvs,
+            stats.uring_buf_ring_exhausted, stats.uring_buf_ring_fallback_recvs));
+    if (!multishot_enabled()) {
+        return;
+    }
+    BOOST_REQUIRE_EQUAL(stats.uring_multishot_accepts - before.uring_multishot_accepts, connections);
+    // Holding on to all 4 buffers of the ring forces fallback receives, and
+    // each connection gets more buffers than the ring has, so they must
+    // have been given back to it
+    BOOST_REQUIRE_GT(stats.uring_buf_ring_fallback_recvs, before.uring_buf_ring_fallback_recvs);
+    BOOST_REQUIRE_GT(stats.uring_multishot_recvs - before.uring_multishot_recvs, connections * 4);
+}
+
+// Buffers released as soon as they are read go back to the ring, so the
+// receives never run out of them and never fall back.
+SEASTAR_THREAD_TEST_CASE(multishot_recv_recycles_buffers_test) {
+    listen_options lo;
+    lo.reuse_address = true;
+    server_socket ss = seastar::listen(ipv4_addr(0), lo);
+    const auto before = engine().get_io_stats();
+
+    size_t total = 0;
+    auto server = seastar::async([&] {
+        accept_result acc = ss.accept().get();
+        auto in = acc.connection.input();
+        while (auto buf = in.read().get()) {
+            for (auto c : buf) {
+                BOOST_REQUIRE_EQUAL(c, char(total++ % 251));
+            }
+        }
+        in.close().get();
+    });
+
+    auto client = seastar::async([&] {
+        send_payload(ss, make_payload());
+    });
+
+    when_all(std::move(server), std::move(client)).get();
+    BOOST_REQUIRE_EQUAL(total, payload_size);
+    if (!multishot_enabled()) {
+        return;
+    }
+    const auto& stats = engine().get_io_stats();
+    BOOST_REQUIRE_EQUAL(stats.uring_buf_ring_fallback_recvs, before.uring_buf_ring_fallback_recvs);
+    BOOST_REQUIRE_GT(stats.uring_multishot_recvs - before.uring_multishot_recvs, 4);
+}
+
+// A reader that falls behind gets its multishot receive paused once two
+// buffers (see CMakeLists.txt) wait to be read, and resumed as it catches
+// up, without losing or reordering any data.
+SEASTAR_THREAD_TEST_CASE(multishot_recv_pauses_for_slow_reader_test) {
+    listen_options lo;
+    lo.reuse_address = true;
+    server_socket ss = seastar::listen(ipv4_addr(0), lo);
+    const auto before = engine().get_io_stats();
+
+    size_t total = 0;
+    auto server = seastar::async([&] {
+        accept_result acc = ss.accept().get();
+        auto in = acc.connection.input();
+        while (auto buf = in.read().get()) {
+            for (auto c : buf) {
+                BOOST_REQUIRE_EQUAL(c, char(total++ % 251));
+            }
+            sleep(1ms).get();
+        }
+        in.close().get();
+    });
+
+    auto client = seastar::async([&] {
+        send_payload(ss, make_payload());
+    });
+
+    when_all(std::move(server), std::move(client)).get();
+    BOOST_REQUIRE_EQUAL(total, payload_size);
+    if (!multishot_enabled()) {
+        return;
+    }
+    const auto& stats = engine().get_io_stats();
+    BOOST_REQUIRE_GT(stats.uring_multishot_recv_pauses, before.uring_multishot_recv_pauses);
+}
@@ -0,0 +1,159 @@
+/*
+ * This file is open source software, licensed to you under the terms
+ * of the Apache License, Version 2.0 (the "License").  See the NOTICE file
+ * distributed with this work for additional information regarding copyright
+ * ownership.  You may not use this file except in compliance with the License.
+ *
+ * You may obtain a copy of the License at
+ *
+ *   http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing,
+ * software distributed under the License is distributed on an
+ * "AS IS" BASIS, WITHOUT WARRANTIES OR CONDITIONS OF ANY
+ * KIND, either express or implied.  See the License for the
+ * specific language governing permissions and limitations
+ * under the License.
+ */
+/*
+ * Copyright (C) 2026 ScyllaDB
+ */
+
+// Runs the AF_XDP device over a veth pair, in copy mode with the program in
+// generic mode as veth supports. Creating the pair takes CAP_NET_ADMIN;
+// the test does nothing without it.
+
+#include <seastar/testing/test_case.hh>
+#include <seastar/testing/thread_test_case.hh>
+#include <seastar/core/sleep.hh>
+#include <seastar/core/thread.hh>
+#include <seastar/net/native-stack.hh>
+#include <seastar/net/ethernet.hh>
+#include <seastar/net/xdp.hh>
+#include <cstdlib>
+#include <cstring>
+#include <linux/if_packet.h>
+#include <net/if.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+using namespace seastar;
+using namespace net;
+using namespace std::chrono_literals;
+
+namespace {
+
+constexpr const char* seastar_end = "sxdp0";
+constexpr const char* peer_end = "sxdp1";
+// IEEE 802 local experimental ethertype, which nothing else on the link uses
+constexpr uint16_t test_proto = 0x88b5;
+
+struct veth_pair {
+    bool created;
+    veth_pair() {
+        created = ::geteuid() == 0
+            && std::system(fmt::format("ip link add {} type veth peer name {} 2>/dev/null", seastar_end, peer_end).c_str()) == 0;
+        if (created) {
+            std::system(fmt::format("ip link set {} up && ip link set {} up", seastar_end, peer_end).c_str());
+        }
+    }
+    ~veth_pair() {
+        if (created) {
+            std::system(fmt::format("ip link del {}", seastar_end).c_str());
+        }
+    }
+};
+
+// A raw socket on the peer end of the pair
+class peer_socket {
+    file_desc _fd;
+    unsigned _ifindex;
+public:
+    peer_socket()
+        : _fd(file_desc::socket(AF_PACKET, SOCK_RAW | SOCK_NONBLOCK | SOCK_CLOEXEC, htons(test_proto)))
+        , _ifindex(::if_nametoindex(peer_end))
+    {
+        sockaddr_ll sll = {};
+        sll.sll_family = AF_PACKET;
+        sll.sll_protocol = htons(test_proto);
+        sll.sll_ifindex = _ifindex;
+        _fd.bind(reinterpret_cast<sockaddr&>(sll), sizeof(sll));
+    }
+    void send(const std::string& frame) {
+        BOOST_REQUIRE_EQUAL(::send(_fd.get(), frame.data(), frame.size(), 0), ssize_t(frame.size()));
+    }
+    std::optional<std::string> receive() {
+        for (int i = 0; i < 5000; i++) {
+            char buf[2048];
+            auto r = ::recv(_fd.get(), buf, sizeof(buf), 0);
+            if (r > 0) {
+                return std::string(buf, r);
+            }
+            sleep(1ms).get();
+        }
+        return std::nullopt;
+    }
+};
+
+std::string make_frame(net::ethernet_address dst, const std::string& payload) {
+    net::eth_hdr eh;
+    eh.dst_mac = dst;
+    eh.src_mac = net::ethernet_address{0x02, 0, 0, 0, 0, 1};
+    eh.eth_proto = test_proto;
+    eh = hton(eh);
+    return std::string(reinterpret_cast<const char*>(&eh), sizeof(eh)) + payload;
+}
+
+}
+
+SEASTAR_THREAD_TEST_CASE(test_xdp_veth_smoke) {
+    veth_pair veth;
+    if (!veth.created) {
+        BOOST_TEST_MESSAGE("cannot create a veth pair, skipping");
+        return;
+    }
+    // Only the options the device reads are set
+    static net::native_stack_options opts;
+    opts.xdp_opts.xdp_interface.set_value(seastar_end);
+    opts.xdp_opts.xdp_ring_size.set_value(64);
+    opts.xdp_opts.xdp_bind_mode.set_value("copy");
+    opts.xdp_opts.xdp_attach_mode.set_value("generic");
+
+    // The queue lives until the reactor is destroyed, like the native
+    // stack's, and uses the device until then
+    static std::unique_ptr<net::device> dev = create_xdp_net_device(opts.xdp_opts);
+    BOOST_REQUIRE_EQUAL(dev->hw_queues_count(), 1);
+    dev->set_local_queue(dev->init_local_queue(opts, 0));
+
+    std::optional<std::string> received;
+    (void)dev->receive([&received] (packet p) {
+        auto eh = ntoh(*p.get_header<net::eth_hdr>());
+        if (eh.eth_proto == test_proto && !received) {
+            p.trim_front(sizeof(net::eth_hdr));
+            received.emplace();
+            for (auto& f : p.fragments()) {
+                received->append(f.base, f.size);
+            }
+        }
+        return make_ready_future<>();
+    });
+
+    peer_socket peer;
+    peer.send(make_frame(dev->hw_address(), "to seastar"));
+    for (int i = 0; i < 5000 && !received; i++) {
+        sleep(1ms).get();
+    }
+    BOOST_REQUIRE(received);
+    BOOST_REQUIRE_EQUAL(received->substr(0, 10), "to seastar");
+
+    // A frame too large to fit is dropped, the next one goes out
+    circular_buffer<packet> out;
+    out.push_back(packet(std::string(8192, 'x').data(), 8192));
+    auto frame = make_frame(net::ethernet_address{0x02, 0, 0, 0, 0, 1}, "from seastar");
+    out.push_back(packet(frame.data(), frame.size()));
+    BOOST_REQUIRE_EQUAL(dev->local_queue().send(out), 1);
+    BOOST_REQUIRE(out.empty());
+    auto sent = peer.receive();
+    BOOST_REQUIRE(sent);
+    BOOST_REQUIRE_EQUAL(sent->substr(sizeof(net::eth_hdr), 12), "from seastar");
+}